@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+
+#include "TransferPipeline.h"
+
+#include <bmx/essence_parser/SoundConversion.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+TransferBatch::TransferBatch(size_t num_input_tracks)
+{
+    num_read = 0;
+    add_pcm_padding = false;
+    frames.resize(num_input_tracks, 0);
+    mSoundData.resize(num_input_tracks);
+}
+
+TransferBatch::~TransferBatch()
+{
+    Reset();
+
+    size_t i, k;
+    for (i = 0; i < mSoundData.size(); i++) {
+        for (k = 0; k < mSoundData[i].size(); k++)
+            delete mSoundData[i][k].buffer;
+    }
+}
+
+void TransferBatch::Reset()
+{
+    num_read = 0;
+    add_pcm_padding = false;
+
+    size_t i, k;
+    for (i = 0; i < frames.size(); i++) {
+        delete frames[i];
+        frames[i] = 0;
+    }
+    for (i = 0; i < mSoundData.size(); i++) {
+        for (k = 0; k < mSoundData[i].size(); k++)
+            mSoundData[i][k].have_data = false;
+    }
+}
+
+bool TransferBatch::HaveSoundData(size_t input_track_index, size_t output_index) const
+{
+    return input_track_index < mSoundData.size() &&
+           output_index < mSoundData[input_track_index].size() &&
+           mSoundData[input_track_index][output_index].have_data;
+}
+
+ByteArray* TransferBatch::GetSoundData(size_t input_track_index, size_t output_index)
+{
+    BMX_ASSERT(HaveSoundData(input_track_index, output_index));
+    return mSoundData[input_track_index][output_index].buffer;
+}
+
+uint32_t TransferBatch::GetSoundNumSamples(size_t input_track_index, size_t output_index) const
+{
+    BMX_ASSERT(HaveSoundData(input_track_index, output_index));
+    return mSoundData[input_track_index][output_index].num_samples;
+}
+
+
+
+TransferPipeline::BatchQueue::BatchQueue()
+{
+    mClosed = false;
+}
+
+void TransferPipeline::BatchQueue::Push(TransferBatch *batch)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mQueue.push_back(batch);
+    }
+    mCond.notify_one();
+}
+
+TransferBatch* TransferPipeline::BatchQueue::Pop(int64_t *stall_count)
+{
+    unique_lock<mutex> lock(mMutex);
+    if (mQueue.empty() && !mClosed) {
+        (*stall_count)++;
+        mCond.wait(lock, [this] { return !mQueue.empty() || mClosed; });
+    }
+    if (mQueue.empty())
+        return 0;
+
+    TransferBatch *batch = mQueue.front();
+    mQueue.pop_front();
+    return batch;
+}
+
+void TransferPipeline::BatchQueue::Close()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mClosed = true;
+    }
+    mCond.notify_all();
+}
+
+void TransferPipeline::BatchQueue::Reopen()
+{
+    lock_guard<mutex> lock(mMutex);
+    mQueue.clear();
+    mClosed = false;
+}
+
+
+
+TransferPipeline::TransferPipeline(const vector<MXFInputTrack*> &input_tracks, ReadFunction read_func,
+                                   int64_t read_duration, uint32_t max_samples_per_read,
+                                   bool ignore_d10_aes3_flags, uint32_t num_batches)
+{
+    BMX_CHECK(num_batches > 0);
+
+    mInputTracks = input_tracks;
+    mReadFunction = read_func;
+    mReadDuration = read_duration;
+    mMaxSamplesPerRead = max_samples_per_read;
+    mIgnoreD10AES3Flags = ignore_d10_aes3_flags;
+    mStarted = false;
+    mStop = false;
+    mInFlight = 0;
+    memset(&mStats, 0, sizeof(mStats));
+
+    uint32_t i;
+    for (i = 0; i < num_batches; i++)
+        mBatches.push_back(new TransferBatch(mInputTracks.size()));
+}
+
+TransferPipeline::~TransferPipeline()
+{
+    Stop();
+
+    size_t i;
+    for (i = 0; i < mBatches.size(); i++)
+        delete mBatches[i];
+}
+
+void TransferPipeline::Start()
+{
+    BMX_CHECK(!mStarted);
+
+    mFreeQueue.Reopen();
+    mReadQueue.Reopen();
+    mConvertedQueue.Reopen();
+
+    size_t i;
+    for (i = 0; i < mBatches.size(); i++) {
+        mBatches[i]->Reset();
+        mFreeQueue.Push(mBatches[i]);
+    }
+
+    mStop = false;
+    mStarted = true;
+    mReadThread = thread(&TransferPipeline::ReadThread, this);
+    mConvertThread = thread(&TransferPipeline::ConvertThread, this);
+}
+
+void TransferPipeline::Stop()
+{
+    if (!mStarted)
+        return;
+
+    {
+        lock_guard<mutex> lock(mStateMutex);
+        mStop = true;
+    }
+    mFreeQueue.Close();
+    mReadQueue.Close();
+    mConvertedQueue.Close();
+
+    if (mReadThread.joinable())
+        mReadThread.join();
+    if (mConvertThread.joinable())
+        mConvertThread.join();
+
+    mStarted = false;
+}
+
+TransferBatch* TransferPipeline::NextBatch()
+{
+    TransferBatch *batch = mConvertedQueue.Pop(&mStats.writer_stalls);
+    if (!batch) {
+        lock_guard<mutex> lock(mStateMutex);
+        if (mError)
+            rethrow_exception(mError);
+        return 0;
+    }
+
+    mStats.batch_count++;
+    return batch;
+}
+
+void TransferPipeline::ReleaseBatch(TransferBatch *batch)
+{
+    batch->Reset();
+    UpdateInFlight(-1);
+    mFreeQueue.Push(batch);
+}
+
+void TransferPipeline::ReadThread()
+{
+    try
+    {
+        int64_t total_read = 0;
+        while (mReadDuration < 0 || total_read < mReadDuration) {
+            TransferBatch *batch = mFreeQueue.Pop(&mStats.reader_stalls);
+            if (!batch)
+                break;
+            {
+                lock_guard<mutex> lock(mStateMutex);
+                if (mStop) {
+                    mFreeQueue.Push(batch);
+                    break;
+                }
+            }
+
+            bool add_pcm_padding = false;
+            uint32_t num_read = mReadFunction(&add_pcm_padding);
+            if (num_read == 0) {
+                mFreeQueue.Push(batch);
+                break;
+            }
+
+            batch->num_read = num_read;
+            batch->add_pcm_padding = add_pcm_padding;
+            size_t i;
+            for (i = 0; i < mInputTracks.size(); i++) {
+                if (mInputTracks[i]->GetTrackInfo()->essence_type == TIMED_TEXT)
+                    continue;
+                batch->frames[i] = mInputTracks[i]->GetFrameBuffer()->GetLastFrame(true);
+                BMX_ASSERT(batch->frames[i]);
+            }
+
+            UpdateInFlight(1);
+            mReadQueue.Push(batch);
+
+            total_read += num_read;
+            if (mMaxSamplesPerRead > 1 && num_read < mMaxSamplesPerRead)
+                break;
+        }
+    }
+    catch (...)
+    {
+        SetError(current_exception());
+    }
+
+    mReadQueue.Close();
+}
+
+void TransferPipeline::ConvertThread()
+{
+    try
+    {
+        TransferBatch *batch;
+        while ((batch = mReadQueue.Pop(&mStats.convert_stalls))) {
+            ConvertBatch(batch);
+            mConvertedQueue.Push(batch);
+        }
+    }
+    catch (...)
+    {
+        SetError(current_exception());
+    }
+
+    mConvertedQueue.Close();
+}
+
+void TransferPipeline::ConvertBatch(TransferBatch *batch)
+{
+    size_t i;
+    for (i = 0; i < mInputTracks.size(); i++) {
+        MXFInputTrack *input_track = mInputTracks[i];
+        Frame *frame = batch->frames[i];
+        if (!frame || frame->IsEmpty())
+            continue;
+
+        const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
+        const MXFSoundTrackInfo *input_sound_info = dynamic_cast<const MXFSoundTrackInfo*>(input_track_info);
+        if (!(input_sound_info && input_sound_info->channel_count > 1) &&
+                input_track_info->essence_type != D10_AES3_PCM)
+        {
+            continue;
+        }
+
+        uint32_t bits_per_sample = 0;
+        uint16_t channel_block_align = 0;
+        if (input_sound_info) {
+            bits_per_sample     = input_sound_info->bits_per_sample;
+            channel_block_align = (bits_per_sample + 7) / 8;
+        }
+
+        vector<TransferBatch::SoundData> &sound_data = batch->mSoundData[i];
+        while (sound_data.size() < input_track->GetOutputTrackCount()) {
+            TransferBatch::SoundData data;
+            data.buffer = new ByteArray();
+            data.num_samples = 0;
+            data.have_data = false;
+            sound_data.push_back(data);
+        }
+
+        uint16_t channel_count;
+        uint32_t num_samples;
+        if (input_track_info->essence_type == D10_AES3_PCM) {
+            channel_count = 8;
+            num_samples = get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
+        } else {
+            channel_count = input_sound_info->channel_count;
+            num_samples = frame->GetSize() / (channel_count * channel_block_align);
+        }
+        uint32_t channel_size = num_samples * channel_block_align;
+
+        // each input channel is written directly into the buffer of the first output track that uses it
+        vector<unsigned char*> channel_data(channel_count, 0);
+        size_t k;
+        for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
+            uint32_t input_channel_index = input_track->GetInputChannelIndex(k);
+            BMX_ASSERT(input_channel_index < channel_count);
+            ByteArray *buffer = sound_data[k].buffer;
+
+            buffer->Allocate(frame->GetSize()); // more than enough
+            if (!channel_data[input_channel_index])
+                channel_data[input_channel_index] = buffer->GetBytes();
+            sound_data[k].num_samples = num_samples;
+            sound_data[k].have_data = true;
+        }
+
+        if (input_track_info->essence_type == D10_AES3_PCM) {
+            convert_aes3_to_pcm_channels(frame->GetBytes(), frame->GetSize(), mIgnoreD10AES3Flags,
+                                         bits_per_sample, (uint8_t)channel_count,
+                                         &channel_data[0], channel_size);
+        } else {
+            deinterleave_audio_channels(frame->GetBytes(), frame->GetSize(),
+                                        bits_per_sample, channel_count,
+                                        &channel_data[0], channel_size);
+        }
+
+        for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
+            unsigned char *channel_bytes = channel_data[input_track->GetInputChannelIndex(k)];
+            if (sound_data[k].buffer->GetBytes() != channel_bytes)
+                memcpy(sound_data[k].buffer->GetBytes(), channel_bytes, channel_size);
+        }
+    }
+}
+
+void TransferPipeline::SetError(exception_ptr error)
+{
+    lock_guard<mutex> lock(mStateMutex);
+    if (!mError)
+        mError = error;
+}
+
+void TransferPipeline::UpdateInFlight(int inc)
+{
+    lock_guard<mutex> lock(mStateMutex);
+    mInFlight += inc;
+    if (mInFlight > mStats.max_in_flight)
+        mStats.max_in_flight = mInFlight;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_TRANSFER_PIPELINE_H_
+#define BMX_TRANSFER_PIPELINE_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+#include <bmx/frame/Frame.h>
+#include <bmx/ByteArray.h>
+
+#include "MXFInputTrack.h"
+
+
+namespace bmx
+{
+
+
+class TransferBatch
+{
+public:
+    TransferBatch(size_t num_input_tracks);
+    ~TransferBatch();
+
+    void Reset();
+
+    bool HaveSoundData(size_t input_track_index, size_t output_index) const;
+    ByteArray* GetSoundData(size_t input_track_index, size_t output_index);
+    uint32_t GetSoundNumSamples(size_t input_track_index, size_t output_index) const;
+
+public:
+    uint32_t num_read;
+    bool add_pcm_padding;
+    std::vector<Frame*> frames;     // owned until popped by the writer; NULL for timed text tracks
+
+private:
+    friend class TransferPipeline;
+
+    typedef struct
+    {
+        ByteArray *buffer;
+        uint32_t num_samples;
+        bool have_data;
+    } SoundData;
+
+    std::vector<std::vector<SoundData> > mSoundData;
+};
+
+
+class TransferPipeline
+{
+public:
+    typedef std::function<uint32_t(bool*)> ReadFunction;
+
+    typedef struct
+    {
+        int64_t batch_count;
+        uint32_t max_in_flight;
+        int64_t reader_stalls;      // reader waited for a free batch, i.e. conversion or writing is the bottleneck
+        int64_t convert_stalls;     // conversion stage waited for a read batch
+        int64_t writer_stalls;      // writer waited for a converted batch, i.e. reading is the bottleneck
+    } Stats;
+
+public:
+    TransferPipeline(const std::vector<MXFInputTrack*> &input_tracks, ReadFunction read_func,
+                     int64_t read_duration, uint32_t max_samples_per_read,
+                     bool ignore_d10_aes3_flags, uint32_t num_batches);
+    ~TransferPipeline();
+
+    void Start();
+    void Stop();
+
+    TransferBatch* NextBatch();
+    void ReleaseBatch(TransferBatch *batch);
+
+    const Stats& GetStats() const { return mStats; }
+
+private:
+    class BatchQueue
+    {
+    public:
+        BatchQueue();
+
+        void Push(TransferBatch *batch);
+        TransferBatch* Pop(int64_t *stall_count);
+        void Close();
+        void Reopen();
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mCond;
+        std::deque<TransferBatch*> mQueue;
+        bool mClosed;
+    };
+
+private:
+    void ReadThread();
+    void ConvertThread();
+    void ConvertBatch(TransferBatch *batch);
+    void SetError(std::exception_ptr error);
+    void UpdateInFlight(int inc);
+
+private:
+    std::vector<MXFInputTrack*> mInputTracks;
+    ReadFunction mReadFunction;
+    int64_t mReadDuration;
+    uint32_t mMaxSamplesPerRead;
+    bool mIgnoreD10AES3Flags;
+
+    std::vector<TransferBatch*> mBatches;
+    BatchQueue mFreeQueue;
+    BatchQueue mReadQueue;
+    BatchQueue mConvertedQueue;
+
+    std::thread mReadThread;
+    std::thread mConvertThread;
+    bool mStarted;
+
+    std::mutex mStateMutex;
+    std::exception_ptr mError;
+    bool mStop;
+    uint32_t mInFlight;
+    Stats mStats;
+};
+
+
+};
+
+
+#endif
@@ -44,9 +44,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <algorithm>
 
 #include "MXFInputTrack.h"
+#include "TransferPipeline.h"
 #include "../writers/OutputTrack.h"
 #include "../writers/TrackMapper.h"
 #include <bmx/mxf_reader/MXFFileReader.h>
@@ -54,6 +56,8 @@
 #include <bmx/mxf_reader/MXFSequenceReader.h>
 #include <bmx/mxf_reader/MXFFrameMetadata.h>
 #include <bmx/mxf_reader/MXFTimedTextTrackReader.h>
+#include <bmx/mxf_reader/GrowingFileFollower.h>
+#include <bmx/frame/SliceFrame.h>
 #include <bmx/essence_parser/SoundConversion.h>
 #include <bmx/essence_parser/MPEG2AspectRatioFilter.h>
 #include <bmx/mxf_helper/RDD36MXFDescriptorHelper.h>
@@ -89,6 +93,7 @@ using namespace mxfpp;
 #define DEFAULT_GF_RETRIES          10
 #define DEFAULT_GF_RETRY_DELAY      1.0
 #define DEFAULT_GF_RATE_AFTER_FAIL  1.5
+#define DEFAULT_GF_POLL_INTERVAL    10
 
 #define DEFAULT_ST436_MANIFEST_COUNT    2
 
@@ -121,6 +126,9 @@ static const uint16_t DEFAULT_RDD6_LINES[2] = {9, 572};     /* ST 274, line 9 fi
 static const uint8_t DEFAULT_RDD6_SDID      = 4;            /* first channel pair is 5/6 */
 
 static const uint32_t DEFAULT_HTTP_MIN_READ = 1024 * 1024;
+static const uint32_t DEFAULT_HTTP_READ_AHEAD = 8;
+
+static const uint32_t DEFAULT_PIPELINE_SIZE = 8;
 
 
 namespace bmx
@@ -279,8 +287,9 @@ static void construct_anc_rdd6(RDD6MetadataFrame *rdd6_frame,
     output_element.Construct(anc_buffer);
 }
 
-static uint32_t read_samples(MXFReader *reader, const vector<uint32_t> &sample_sequence,
-                             uint32_t *sample_sequence_offset, uint32_t max_samples_per_read)
+static uint32_t read_samples(MXFReader *reader, GrowingFileFollower *gf_follower,
+                             const vector<uint32_t> &sample_sequence, uint32_t *sample_sequence_offset,
+                             uint32_t max_samples_per_read)
 {
     uint32_t num_read;
 
@@ -288,17 +297,67 @@ static uint32_t read_samples(MXFReader *reader, const vector<uint32_t> &sample_s
         uint32_t num_frame_samples = sample_sequence[*sample_sequence_offset];
         *sample_sequence_offset = (*sample_sequence_offset + 1) % sample_sequence.size();
 
-        num_read = reader->Read(num_frame_samples);
+        if (gf_follower)
+            num_read = gf_follower->Read(num_frame_samples);
+        else
+            num_read = reader->Read(num_frame_samples);
         if (num_read != num_frame_samples)
             num_read = 0;
     } else {
         BMX_ASSERT(sample_sequence.size() == 1 && sample_sequence[0] == 1);
-        num_read = reader->Read(max_samples_per_read);
+        if (gf_follower)
+            num_read = gf_follower->Read(max_samples_per_read);
+        else
+            num_read = reader->Read(max_samples_per_read);
     }
 
     return num_read;
 }
 
+static bool check_incomplete_frames(const vector<MXFInputTrack*> &input_tracks, uint32_t max_samples_per_read,
+                                    ClipWriterType clip_type, bool *add_pcm_padding)
+{
+    *add_pcm_padding = false;
+
+    size_t i;
+    for (i = 0; i < input_tracks.size(); i++) {
+        MXFInputTrack *input_track = input_tracks[i];
+        if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT) {
+            // timed text is handled elsewhere
+            continue;
+        }
+
+        Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(false);
+        BMX_ASSERT(frame);
+
+        // If a single output sample (edit unit) is read from the input and it is incomplete then
+        // check if padding can be added
+        if (max_samples_per_read == 1 && !frame->IsComplete()) {
+            const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
+            // only support padding with PCM samples and where the input edit rate equals audio sampling rate
+            if (input_track_info->essence_type != WAVE_PCM ||
+                input_track_info->edit_rate != ((MXFSoundTrackInfo*)input_track_info)->sampling_rate)
+            {
+                log_warn("Unable to provide PCM padding data for incomplete frame\n");
+                return false;
+            }
+
+            // transferring partial frame data is only supported for the WAVE clip type
+            if (!frame->IsEmpty() && clip_type != CW_WAVE_CLIP_TYPE) {
+                log_warn("Transferring partial PCM frame data is only supported for %s\n",
+                         clip_type_to_string(CW_WAVE_CLIP_TYPE, NO_CLIP_SUB_TYPE));
+                return false;
+            }
+
+            // only pad partial frames if not outputting to WAVE
+            if (clip_type != CW_WAVE_CLIP_TYPE)
+                *add_pcm_padding = true;
+        }
+    }
+
+    return true;
+}
+
 static void write_anc_samples(OutputTrack *output_track, Frame *frame, set<ANCDataType> &filter, bmx::ByteArray &anc_buffer)
 {
     BMX_CHECK(frame->num_samples == 1);
@@ -407,30 +466,67 @@ static void usage(const char *cmd)
     fprintf(stderr, "  --group                 Use the group reader instead of the sequence reader\n");
     fprintf(stderr, "                          Use this option if the files have different material packages\n");
     fprintf(stderr, "                          but actually belong to the same virtual package / group\n");
+    fprintf(stderr, "  --group-threads <count>\n");
+    fprintf(stderr, "                          Read the group members concurrently using <count> threads\n");
+    fprintf(stderr, "  --open-threads <count>\n");
+    fprintf(stderr, "                          Read the partition packs and index table segments concurrently using <count> threads\n");
+    fprintf(stderr, "                          when opening the input file(s)\n");
+    fprintf(stderr, "                          This helps when each read has a high latency, e.g. HTTP files with partitions further apart\n");
+    fprintf(stderr, "                          than the HTTP read-ahead window. It is slower for local files that are in the page cache\n");
+    fprintf(stderr, "  --lazy-index <mib>\n");
+    fprintf(stderr, "                          Read the index table entries on demand rather than when opening the input file(s)\n");
+    fprintf(stderr, "                          and keep at most <mib> MiB of index entries in memory, where 0 means no limit\n");
+    fprintf(stderr, "                          <mib> can be a fraction, e.g. 0.5 for 512 KiB\n");
+    fprintf(stderr, "  --open-cache <dir>\n");
+    fprintf(stderr, "                          Store the partition packs and index table of the input file(s) in sidecar files in <dir>\n");
+    fprintf(stderr, "                          and use them to open the file(s) faster the next time if the file(s) are unchanged\n");
+    fprintf(stderr, "                          The directory <dir> is created if it does not exist\n");
+    fprintf(stderr, "  --read-ahead <count>\n");
+    fprintf(stderr, "                          Read the essence of up to <count> edit units ahead of the current position, using the index table\n");
+    fprintf(stderr, "                          to locate the data in frame wrapped input file(s). The reads are cancelled when seeking\n");
     fprintf(stderr, "  --no-reorder            Don't attempt to order the inputs in a sequence\n");
     fprintf(stderr, "                          Use this option for files with broken timecode\n");
     fprintf(stderr, "  --rt <factor>           Transwrap at realtime rate x <factor>, where <factor> is a floating point value\n");
     fprintf(stderr, "                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
-    fprintf(stderr, "  --gf                    Support growing files. Retry reading a frame when it fails\n");
-    fprintf(stderr, "  --gf-retries <max>      Set the maximum times to retry reading a frame. The default is %u.\n", DEFAULT_GF_RETRIES);
-    fprintf(stderr, "  --gf-delay <sec>        Set the delay (in seconds) between a failure to read and a retry. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
+    fprintf(stderr, "  --gf                    Support growing files. Wait for the file to grow and retry reading a frame when it fails\n");
+    fprintf(stderr, "  --gf-retries <max>      Set the maximum number of consecutive waits without the file growing. The default is %u.\n", DEFAULT_GF_RETRIES);
+    fprintf(stderr, "  --gf-delay <sec>        Set the maximum time (in seconds) to wait for the file to grow after a failure to read. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
     fprintf(stderr, "  --gf-rate <factor>      Limit the read rate to realtime rate x <factor> after a read failure. The default is %f\n", DEFAULT_GF_RATE_AFTER_FAIL);
     fprintf(stderr, "                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    fprintf(stderr, "  --gf-poll <msec>        Set the interval (in milliseconds) for checking the file size when file change\n");
+    fprintf(stderr, "                          notifications are not available. The default is %u.\n", DEFAULT_GF_POLL_INTERVAL);
     if (mxf_http_is_supported()) {
         fprintf(stderr, " --http-min-read <bytes>\n");
         fprintf(stderr, "                          Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
+        fprintf(stderr, " --http-read-ahead <count>\n");
+        fprintf(stderr, "                          Set the maximum number of parallel HTTP range requests used to read ahead. The default is %u.\n", DEFAULT_HTTP_READ_AHEAD);
+        fprintf(stderr, "                          Read-ahead is disabled if <count> is 0\n");
     }
     fprintf(stderr, "  --no-precharge          Don't output clip/track with precharge. Adjust the start position and duration instead\n");
     fprintf(stderr, "  --no-rollout            Don't output clip/track with rollout. Adjust the duration instead\n");
     fprintf(stderr, "  --rw-intl               Interleave input reads with output writes\n");
     fprintf(stderr, "  --rw-intl-size          The interleave size. Default is %u\n", DEFAULT_RW_INTL_SIZE);
     fprintf(stderr, "                          Value must be a multiple of the system page size, %u\n", mxf_get_system_page_size());
-#if defined(_WIN32)
+    fprintf(stderr, "  --pipeline              Read, convert audio and write in separate threads\n");
+    fprintf(stderr, "                          This option can't be used together with --rt, --gf or --rw-intl\n");
+    fprintf(stderr, "  --pipeline-size <n>     Set the maximum number of reads in flight in the pipeline. The default is %u\n", DEFAULT_PIPELINE_SIZE);
     fprintf(stderr, "  --seq-scan              Set the sequential scan hint for optimizing file caching whilst reading\n");
 #if !defined(__MINGW32__)
     fprintf(stderr, "  --mmap-file             Use memory-mapped file I/O for the MXF files\n");
     fprintf(stderr, "                          Note: this may reduce file I/O performance and was found to be slower over network drives\n");
 #endif
+#if !defined(_WIN32)
+    fprintf(stderr, "  --direct-io             Write the output MXF files using direct I/O, bypassing the page cache where supported\n");
+    fprintf(stderr, "                          Single file outputs are preallocated using the input file size\n");
+    fprintf(stderr, "  --cache-hint <mode>     Set the page cache hint for the input and output MXF files. <mode> is one of the following:\n");
+    fprintf(stderr, "                            'none': (default) no hint, or only sequential access if --seq-scan is set\n");
+    fprintf(stderr, "                            'seq': sequential access, with data requested a window ahead of the read position\n");
+    fprintf(stderr, "                            'stream': same as 'seq', and data more than a window behind the read and write position is dropped\n");
+    fprintf(stderr, "                                      This bounds the page cache used by each file to about 2 windows\n");
+    fprintf(stderr, "  --cache-window <mib>    Set the window size in MiB for --cache-hint. The default is %u\n",
+            MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW / (1024 * 1024));
+    fprintf(stderr, "  --cache-sync            Write back output file data before it is dropped with '--cache-hint stream'\n");
+    fprintf(stderr, "                          Otherwise written data is only dropped once the kernel has written it back\n");
 #endif
     fprintf(stderr, "  --avcihead <format> <file> <offset>\n");
     fprintf(stderr, "                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
@@ -627,6 +723,8 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --loose-checks          Don't stop processing on detected compliancy violations\n");
     fprintf(stderr, "    --print-checks          Print default values of mpeg descriptors and report on descriptors either found in mpeg headers or copied from mxf headers\n");
     fprintf(stderr, "    --max-same-warnings <value>  Max same violations warnings logged, default 3\n");
+    fprintf(stderr, "    --mpeg-checks-thread <size>  Run the mpeg compliancy checks on a separate thread with a queue of up to <size> frames\n");
+    fprintf(stderr, "    --mpeg-checks-gop <n>   Only check the frames in every <n>th GOP. Default is 1, i.e. check all GOPs\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "  as11d10/d10:\n");
     fprintf(stderr, "    --d10-mute <flags>      Indicate using a string of 8 '0' or '1' which sound channels should be muted. The lsb is the rightmost digit\n");
@@ -672,6 +770,9 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --ignore-d10-aes3-flags   Ignore D10 AES3 audio validity flags and assume they are all valid\n");
     fprintf(stderr, "                              This workarounds an issue with Avid transfer manager which sets channel flags 4 to 8 to invalid\n");
     fprintf(stderr, "\n");
+    fprintf(stderr, "  as02/avid:\n");
+    fprintf(stderr, "    --track-threads <size>  Write each track file on its own thread with a queue of up to <size> sample writes\n");
+    fprintf(stderr, "\n");
     fprintf(stderr, "  op1a/avid:\n");
     fprintf(stderr, "    --force-no-avci-head    Strip AVCI header (512 bytes, sequence and picture parameter sets) if present\n");
     fprintf(stderr, "\n");
@@ -802,10 +903,18 @@ int main(int argc, const char** argv)
     bool as10_loose_checks = false;
     int max_mpeg_check_same_warn_messages = 3;
     bool print_mpeg_checks = false;
+    uint32_t mpeg_checks_thread_queue_size = 0;
+    uint32_t mpeg_checks_gop_interval = 1;
     bool pass_dm = false;
     const char *segmentation_filename = 0;
     bool do_print_version = false;
     bool use_group_reader = false;
+    uint32_t group_read_threads = 0;
+    uint32_t open_threads = 1;
+    bool lazy_index = false;
+    double lazy_index_mib = 0.0;
+    const char *open_cache_dir = 0;
+    uint32_t read_ahead = 0;
     bool keep_input_order = false;
     BMX_OPT_PROP_DECL_DEF(uint8_t, user_afd, 0);
     vector<AVCIHeaderInput> avci_header_inputs;
@@ -852,6 +961,8 @@ int main(int argc, const char** argv)
     bool no_rollout = false;
     bool rw_interleave = false;
     uint32_t rw_interleave_size = DEFAULT_RW_INTL_SIZE;
+    bool pipeline = false;
+    uint32_t pipeline_size = DEFAULT_PIPELINE_SIZE;
     uint32_t system_page_size = mxf_get_system_page_size();
     uint8_t d10_mute_sound_flags = 0;
     uint8_t d10_invalid_sound_flags = 0;
@@ -882,6 +993,7 @@ int main(int argc, const char** argv)
     unsigned int gf_retries = DEFAULT_GF_RETRIES;
     float gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
     float gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
+    uint32_t gf_poll_interval = DEFAULT_GF_POLL_INTERVAL;
     bool product_info_set = false;
     string company_name;
     string product_name;
@@ -893,6 +1005,7 @@ int main(int argc, const char** argv)
     bool ps_avcihead = false;
     bool replace_avid_avcihead = false;
     bool avid_gf = false;
+    uint32_t track_threads_queue_size = 0;
     int64_t avid_gf_duration = -1;
     set<ANCDataType> pass_anc;
     bool pass_vbi = false;
@@ -906,9 +1019,16 @@ int main(int argc, const char** argv)
     uint16_t rdd6_lines[2] = {DEFAULT_RDD6_LINES[0], DEFAULT_RDD6_LINES[1]};
     uint8_t rdd6_sdid = DEFAULT_RDD6_SDID;
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
+    uint32_t http_read_ahead = DEFAULT_HTTP_READ_AHEAD;
     bool mp_track_num = false;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
+#if !defined(_WIN32)
+    bool direct_io_output = false;
+    int cache_hint_flags = MXF_POSIX_CACHE_HINT_DEFAULT;
+    uint32_t cache_window_mib = 0;
+    bool cache_sync = false;
+#endif
 #endif
     vector<EmbedXMLInfo> embed_xml;
     EmbedXMLInfo next_embed_xml;
@@ -1187,6 +1307,83 @@ int main(int argc, const char** argv)
         {
             use_group_reader = true;
         }
+        else if (strcmp(argv[cmdln_index], "--group-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &group_read_threads) != 1 || group_read_threads == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &open_threads) != 1 || open_threads == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--lazy-index") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%lf", &lazy_index_mib) != 1 || lazy_index_mib < 0.0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            lazy_index = true;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-cache") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            open_cache_dir = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_ahead = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--no-reorder") == 0)
         {
             keep_input_order = true;
@@ -1263,6 +1460,24 @@ int main(int argc, const char** argv)
             growing_file = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--gf-poll") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            gf_poll_interval = (uint32_t)(uvalue);
+            growing_file = true;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--http-min-read") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -1280,6 +1495,23 @@ int main(int argc, const char** argv)
             http_min_read = (uint32_t)(uvalue);
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--http-read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_read_ahead = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--no-precharge") == 0)
         {
             no_precharge = true;
@@ -1310,10 +1542,35 @@ int main(int argc, const char** argv)
             rw_interleave_size = uvalue;
             cmdln_index++;
         }
-#if defined(_WIN32)
+        else if (strcmp(argv[cmdln_index], "--pipeline") == 0)
+        {
+            pipeline = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--pipeline-size") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            pipeline_size = uvalue;
+            pipeline = true;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--seq-scan") == 0)
         {
+#if defined(_WIN32)
             input_file_flags |= MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
+#else
+            input_file_flags |= MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN;
+#endif
         }
 #if !defined(__MINGW32__)
         else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
@@ -1321,6 +1578,47 @@ int main(int argc, const char** argv)
             use_mmap_file = true;
         }
 #endif
+#if !defined(_WIN32)
+        else if (strcmp(argv[cmdln_index], "--direct-io") == 0)
+        {
+            direct_io_output = true;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-hint") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (!parse_cache_hint(argv[cmdln_index + 1], &cache_hint_flags))
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-window") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &cache_window_mib) != 1 || cache_window_mib == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-sync") == 0)
+        {
+            cache_sync = true;
+        }
 #endif
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
@@ -1899,6 +2197,40 @@ int main(int argc, const char** argv)
         {
             print_mpeg_checks = true;
         }
+        else if (strcmp(argv[cmdln_index], "--mpeg-checks-thread") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            mpeg_checks_thread_queue_size = uvalue;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--mpeg-checks-gop") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            mpeg_checks_gop_interval = uvalue;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--max-same-warnings") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2566,6 +2898,23 @@ int main(int argc, const char** argv)
         {
             avid_gf = true;
         }
+        else if (strcmp(argv[cmdln_index], "--track-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            track_threads_queue_size = uvalue;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--avid-gf-dur") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2797,6 +3146,12 @@ int main(int argc, const char** argv)
         as10_shim = get_as10_shim(as10_shim_name);
     }
 
+    if (pipeline && (realtime || growing_file || rw_interleave)) {
+        usage(argv[0]);
+        fprintf(stderr, "The --pipeline option can't be used together with --rt, --gf or --rw-intl\n");
+        return 1;
+    }
+
     if (op1a_clip_wrap && (clip_type != CW_OP1A_CLIP_TYPE || clip_sub_type == AS11_CLIP_SUB_TYPE)) {
         fprintf(stderr, "Ignoring unsupported --clip-wrap option\n");
         op1a_clip_wrap = false;
@@ -2856,9 +3211,19 @@ int main(int argc, const char** argv)
         if (rw_interleave)
             file_factory.SetRWInterleave(rw_interleave_size);
         file_factory.SetHTTPMinReadSize(http_min_read);
-#if defined(_WIN32) && !defined(__MINGW32__)
+        file_factory.SetHTTPReadAhead(http_read_ahead);
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
+#if !defined(_WIN32)
+        if (cache_hint_flags != MXF_POSIX_CACHE_HINT_DEFAULT) {
+            int output_cache_hint_flags = cache_hint_flags;
+            if (cache_sync)
+                output_cache_hint_flags |= MXF_POSIX_CACHE_HINT_SYNC_WRITES;
+            file_factory.SetCacheHints(cache_hint_flags, output_cache_hint_flags,
+                                       (int64_t)cache_window_mib * 1024 * 1024);
+        }
+#endif
 
         if (use_group_reader && input_filenames.size() > 1) {
             MXFGroupReader *group_reader = new MXFGroupReader();
@@ -2869,6 +3234,11 @@ int main(int argc, const char** argv)
                 grp_file_reader->SetFileFactory(&file_factory, false);
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+                grp_file_reader->SetOpenThreads(open_threads);
+                grp_file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+                grp_file_reader->SetReadAhead(read_ahead);
+                if (open_cache_dir)
+                    grp_file_reader->SetOpenCacheDir(open_cache_dir);
                 result = grp_file_reader->Open(input_filenames[i]);
                 if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
@@ -2881,6 +3251,13 @@ int main(int argc, const char** argv)
             }
             if (!group_reader->Finalize())
                 throw false;
+            if (group_read_threads > 1) {
+                // the read/write interleaver is shared by all the input files
+                if (rw_interleave)
+                    log_warn("Ignoring --group-threads because it is incompatible with --rw-intl\n");
+                else
+                    group_reader->SetReadThreads(group_read_threads);
+            }
 
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
@@ -2892,6 +3269,11 @@ int main(int argc, const char** argv)
                 seq_file_reader->SetFileFactory(&file_factory, false);
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+                seq_file_reader->SetOpenThreads(open_threads);
+                seq_file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+                seq_file_reader->SetReadAhead(read_ahead);
+                if (open_cache_dir)
+                    seq_file_reader->SetOpenCacheDir(open_cache_dir);
                 result = seq_file_reader->Open(input_filenames[i]);
                 if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", input_filenames[i],
@@ -2912,6 +3294,11 @@ int main(int argc, const char** argv)
             file_reader->SetFileFactory(&file_factory, false);
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+            file_reader->SetOpenThreads(open_threads);
+            file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+            file_reader->SetReadAhead(read_ahead);
+            if (open_cache_dir)
+                file_reader->SetOpenCacheDir(open_cache_dir);
             if (pass_dm && clip_sub_type == AS11_CLIP_SUB_TYPE)
                 AS11Info::RegisterExtensions(file_reader->GetHeaderMetadata());
             if (pass_dm && clip_sub_type == AS10_CLIP_SUB_TYPE)
@@ -3350,6 +3737,17 @@ int main(int argc, const char** argv)
         }
 
 
+        // frames from memory mapped input files reference the file data rather than copy it
+
+        if (use_mmap_file) {
+            for (i = 0; i < reader->GetNumTrackReaders(); i++) {
+                MXFTrackReader *track_reader = reader->GetTrackReader(i);
+                if (track_reader->IsEnabled())
+                    track_reader->GetFrameBuffer()->SetFrameFactory(new SliceFrameFactory(), true);
+            }
+        }
+
+
         // map input to output tracks
 
         // map WAVE PCM tracks
@@ -3548,6 +3946,22 @@ int main(int argc, const char** argv)
             if (avid_gf)
                 flavour |= AVID_GROWING_FILE_FLAVOUR;
         }
+#if !defined(_WIN32)
+        if (direct_io_output) {
+            // preallocate single file outputs using the input file size scaled to the duration being read
+            int64_t preallocate_size = 0;
+            if ((clip_type == CW_OP1A_CLIP_TYPE || clip_type == CW_D10_CLIP_TYPE || clip_type == CW_RDD9_CLIP_TYPE) &&
+                reader->GetDuration() > 0 && reader->GetReadDuration() > 0)
+            {
+                for (i = 0; i < input_filenames.size(); i++) {
+                    if (input_filenames[i][0] && !mxf_http_is_url(input_filenames[i]))
+                        preallocate_size += get_file_size(input_filenames[i]);
+                }
+                preallocate_size = (int64_t)(preallocate_size * ((double)reader->GetReadDuration() / reader->GetDuration()));
+            }
+            file_factory.SetDirectIOOutput(true, preallocate_size);
+        }
+#endif
         ClipWriter *clip = 0;
         Rational clip_frame_rate = (input_edit_rate_is_sampling_rate ? timecode_rate : frame_rate);
         switch (clip_type)
@@ -4082,10 +4496,14 @@ int main(int argc, const char** argv)
                     if (mpeg_descr_frame_checks && (flavour & RDD9_AS10_FLAVOUR)) {
                         RDD9MPEG2LGTrack *rdd9_mpeglgtrack = dynamic_cast<RDD9MPEG2LGTrack*>(clip_track->GetRDD9Track());
                         if (rdd9_mpeglgtrack) {
-                            rdd9_mpeglgtrack->SetValidator(new AS10MPEG2Validator(as10_shim, mpeg_descr_defaults_name,
-                                                                                  max_mpeg_check_same_warn_messages,
-                                                                                  print_mpeg_checks,
-                                                                                  as10_loose_checks));
+                            AS10MPEG2Validator *validator = new AS10MPEG2Validator(as10_shim, mpeg_descr_defaults_name,
+                                                                                   max_mpeg_check_same_warn_messages,
+                                                                                   print_mpeg_checks,
+                                                                                   as10_loose_checks);
+                            validator->SetGOPSampleInterval(mpeg_checks_gop_interval);
+                            if (mpeg_checks_thread_queue_size > 0)
+                                validator->SetValidationThread(mpeg_checks_thread_queue_size);
+                            rdd9_mpeglgtrack->SetValidator(validator);
                         }
                     }
                     break;
@@ -4435,14 +4853,28 @@ int main(int argc, const char** argv)
 
         // growing input files
 
-        unsigned int gf_retry_count = 0;
+        unique_ptr<GrowingFileFollower> gf_follower;
         bool gf_read_failure = false;
         int64_t gf_failure_num_read = 0;
         uint32_t gf_failure_start = 0;
+        if (growing_file) {
+            vector<string> gf_filenames;
+            size_t i;
+            for (i = 0; i < input_filenames.size(); i++) {
+                if (!mxf_http_is_url(input_filenames[i]))
+                    gf_filenames.push_back(input_filenames[i]);
+            }
+            gf_follower.reset(new GrowingFileFollower(reader, gf_filenames));
+            gf_follower->SetMaxWaits(gf_retries, (uint32_t)(gf_retry_delay * 1000));
+            gf_follower->SetPollInterval(gf_poll_interval);
+        }
 
 
         // create clip file(s) and write samples
 
+        if (track_threads_queue_size > 0 && (clip_type == CW_AS02_CLIP_TYPE || clip_type == CW_AVID_CLIP_TYPE))
+            clip->SetTrackWriterThreads(track_threads_queue_size);
+
         clip->PrepareWrite();
 
         float next_progress_update;
@@ -4456,63 +4888,55 @@ int main(int argc, const char** argv)
         int64_t container_duration;
         int64_t prev_container_duration = -1;
         bmx::ByteArray sound_buffer;
-        while (read_duration < 0 || total_read < read_duration) {
-            uint32_t num_read = read_samples(reader, sample_sequence, &sample_sequence_offset, max_samples_per_read);
-            if (num_read == 0) {
-                if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
-                    break;
-                gf_retry_count++;
-                gf_read_failure = true;
-                if (gf_retry_delay > 0.0) {
-                    rt_sleep(1.0f / gf_retry_delay, get_tick_count(), frame_rate,
-                             frame_rate.numerator / frame_rate.denominator);
-                }
-                continue;
-            }
-            if (growing_file && gf_retry_count > 0) {
-                gf_failure_num_read = total_read;
-                gf_failure_start    = get_tick_count();
-                gf_retry_count      = 0;
-            }
 
-            // check whether any incomplete frames (where requested samples < read samples) are supported
-            bool add_pcm_padding = false;
-            for (i = 0; i < input_tracks.size(); i++) {
-                MXFInputTrack *input_track = input_tracks[i];
-                if (input_track->GetTrackInfo()->essence_type == TIMED_TEXT) {
-                    // timed text is handled elsewhere
-                    continue;
-                }
-
-                Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(false);
-                BMX_ASSERT(frame);
-
-                // If a single output sample (edit unit) is read from the input and it is incomplete then
-                // check if padding can be added
-                if (max_samples_per_read == 1 && !frame->IsComplete()) {
-                    const MXFTrackInfo *input_track_info = input_track->GetTrackInfo();
-                    // only support padding with PCM samples and where the input edit rate equals audio sampling rate
-                    if (input_track_info->essence_type != WAVE_PCM ||
-                        input_track_info->edit_rate != ((MXFSoundTrackInfo*)input_track_info)->sampling_rate)
+        // in pipeline mode the reads and audio conversions happen in separate threads and this thread
+        // only writes. The pipeline reads stop at the same point as the serial loop below would stop.
+        // The pipeline is destroyed, which stops and joins its threads, if an exception is thrown before
+        // the reader and clip are deleted
+
+        unique_ptr<TransferPipeline> transfer_pipeline;
+        if (pipeline) {
+            transfer_pipeline.reset(new TransferPipeline(
+                input_tracks,
+                [&](bool *add_pcm_padding) -> uint32_t {
+                    uint32_t num_read = read_samples(reader, 0, sample_sequence, &sample_sequence_offset,
+                                                     max_samples_per_read);
+                    if (num_read > 0 &&
+                        !check_incomplete_frames(input_tracks, max_samples_per_read, clip_type, add_pcm_padding))
                     {
-                        log_warn("Unable to provide PCM padding data for incomplete frame\n");
-                        break;
-                    }
-
-                    // transferring partial frame data is only supported for the WAVE clip type
-                    if (!frame->IsEmpty() && clip_type != CW_WAVE_CLIP_TYPE) {
-                        log_warn("Transferring partial PCM frame data is only supported for %s\n",
-                                 clip_type_to_string(CW_WAVE_CLIP_TYPE, NO_CLIP_SUB_TYPE));
-                        break;
+                        num_read = 0;
                     }
+                    return num_read;
+                },
+                read_duration, max_samples_per_read, ignore_d10_aes3_flags, pipeline_size));
+            transfer_pipeline->Start();
+        }
 
-                    // only pad partial frames if not outputting to WAVE
-                    if (clip_type != CW_WAVE_CLIP_TYPE)
-                        add_pcm_padding = true;
+        while (read_duration < 0 || total_read < read_duration) {
+            TransferBatch *batch = 0;
+            uint32_t num_read;
+            bool add_pcm_padding = false;
+            if (transfer_pipeline) {
+                batch = transfer_pipeline->NextBatch();
+                if (!batch)
+                    break;
+                num_read = batch->num_read;
+                add_pcm_padding = batch->add_pcm_padding;
+            } else {
+                num_read = read_samples(reader, gf_follower.get(), sample_sequence, &sample_sequence_offset,
+                                        max_samples_per_read);
+                if (num_read == 0)
+                    break;
+                if (gf_follower && gf_follower->HaveWaited()) {
+                    gf_read_failure     = true;
+                    gf_failure_num_read = total_read;
+                    gf_failure_start    = get_tick_count();
                 }
+
+                // check whether any incomplete frames (where requested samples < read samples) are supported
+                if (!check_incomplete_frames(input_tracks, max_samples_per_read, clip_type, &add_pcm_padding))
+                    break;
             }
-            if (i < input_tracks.size())
-                break;
 
             if (clip_type == CW_AS02_CLIP_TYPE && (precharge || rollout)) {
                 container_duration = clip->GetDuration();
@@ -4535,7 +4959,13 @@ int main(int argc, const char** argv)
                     continue;
                 }
 
-                Frame *frame = input_track->GetFrameBuffer()->GetLastFrame(true);
+                Frame *frame;
+                if (batch) {
+                    frame = batch->frames[i];
+                    batch->frames[i] = 0;
+                } else {
+                    frame = input_track->GetFrameBuffer()->GetLastFrame(true);
+                }
                 BMX_ASSERT(frame);
 
                 if (clip_type == CW_AVID_CLIP_TYPE && convert_ess_marks) {
@@ -4556,6 +4986,10 @@ int main(int argc, const char** argv)
                     }
                 }
 
+                // multi-channel sound frames are split into sound_channels once for all output tracks
+                vector<unsigned char*> sound_channels;
+                uint32_t sound_channel_num_samples = 0;
+
                 size_t k;
                 for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
                     OutputTrack *output_track = input_track->GetOutputTrack(k);
@@ -4579,25 +5013,52 @@ int main(int argc, const char** argv)
                     }
                     else if (!frame->IsEmpty())
                     {
-                        if ((input_sound_info && input_sound_info->channel_count > 1) ||
+                        if (batch && batch->HaveSoundData(i, k))
+                        {
+                            num_samples = batch->GetSoundNumSamples(i, k);
+                            output_track->WriteSamples(output_channel_index,
+                                                       batch->GetSoundData(i, k)->GetBytes(),
+                                                       num_samples * channel_block_align,
+                                                       num_samples);
+                        }
+                        else if ((input_sound_info && input_sound_info->channel_count > 1) ||
                                 input_track_info->essence_type == D10_AES3_PCM)
                         {
-                            sound_buffer.Allocate(frame->GetSize()); // more than enough
-                            if (input_track_info->essence_type == D10_AES3_PCM) {
-                                convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), ignore_d10_aes3_flags,
-                                                    bits_per_sample, input_channel_index,
-                                                    sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                num_samples = get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
-                            } else {
-                                deinterleave_audio(frame->GetBytes(), frame->GetSize(),
-                                                   bits_per_sample,
-                                                   input_sound_info->channel_count, input_channel_index,
-                                                   sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                num_samples = frame->GetSize() / (input_sound_info->channel_count * channel_block_align);
+                            if (sound_channels.empty()) {
+                                uint16_t channel_count;
+                                if (input_track_info->essence_type == D10_AES3_PCM) {
+                                    channel_count = 8;
+                                    sound_channel_num_samples = get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
+                                } else {
+                                    channel_count = input_sound_info->channel_count;
+                                    sound_channel_num_samples = frame->GetSize() / (channel_count * channel_block_align);
+                                }
+                                uint32_t channel_size = sound_channel_num_samples * channel_block_align;
+                                sound_buffer.Allocate(frame->GetSize()); // more than enough
+
+                                // channels not mapped to an output track are skipped
+                                sound_channels.resize(channel_count, 0);
+                                size_t m;
+                                for (m = 0; m < input_track->GetOutputTrackCount(); m++) {
+                                    uint32_t c = input_track->GetInputChannelIndex(m);
+                                    BMX_ASSERT(c < channel_count);
+                                    sound_channels[c] = sound_buffer.GetBytes() + c * channel_size;
+                                }
+
+                                if (input_track_info->essence_type == D10_AES3_PCM) {
+                                    convert_aes3_to_pcm_channels(frame->GetBytes(), frame->GetSize(), ignore_d10_aes3_flags,
+                                                                 bits_per_sample, (uint8_t)channel_count,
+                                                                 &sound_channels[0], channel_size);
+                                } else {
+                                    deinterleave_audio_channels(frame->GetBytes(), frame->GetSize(),
+                                                                bits_per_sample, channel_count,
+                                                                &sound_channels[0], channel_size);
+                                }
                             }
+                            num_samples = sound_channel_num_samples;
 
                             output_track->WriteSamples(output_channel_index,
-                                                       sound_buffer.GetBytes(),
+                                                       sound_channels[input_channel_index],
                                                        num_samples * channel_block_align,
                                                        num_samples);
                         }
@@ -4670,6 +5131,9 @@ int main(int argc, const char** argv)
 
             total_read += num_read;
 
+            if (batch)
+                transfer_pipeline->ReleaseBatch(batch);
+
 
             if (show_progress)
                 print_progress(total_read, read_duration, &next_progress_update);
@@ -4682,10 +5146,20 @@ int main(int argc, const char** argv)
             else if (realtime)
                 rt_sleep(rt_factor, rt_start, frame_rate, total_read);
         }
+        if (transfer_pipeline) {
+            transfer_pipeline->Stop();
+
+            const TransferPipeline::Stats &stats = transfer_pipeline->GetStats();
+            log_info("Pipeline: %" PRId64 " reads, max %u in flight, stalls: read %" PRId64 ", convert %" PRId64 ", write %" PRId64 "\n",
+                     stats.batch_count, stats.max_in_flight,
+                     stats.reader_stalls, stats.convert_stalls, stats.writer_stalls);
+
+            transfer_pipeline.reset();
+        }
         if (reader->ReadError()) {
             bmx::log(reader->IsComplete() ? ERROR_LOG : WARN_LOG,
                      "A read error occurred: %s\n", reader->ReadErrorMessage().c_str());
-            if (gf_retry_count >= gf_retries)
+            if (gf_follower && gf_follower->ReachedMaxWaits())
                 log_warn("Reached maximum growing file retries, %u\n", gf_retries);
             if (reader->IsComplete())
                 cmd_result = 1;
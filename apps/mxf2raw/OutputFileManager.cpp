@@ -36,6 +36,11 @@
 #include <errno.h>
 #include <string.h>
 
+#include <vector>
+
+#include <mxf/mxf.h>
+
+#include <bmx/essence_parser/SoundConversion.h>
 #include <bmx/BMXException.h>
 #include <bmx/Utils.h>
 #include <bmx/Logging.h>
@@ -44,6 +49,69 @@ using namespace std;
 using namespace bmx;
 
 
+
+static void write_data(FILE *file, const string &filename, const unsigned char *data, uint32_t size,
+                       bool wrap_klv, const mxfKey *key)
+{
+#define CHECK_WRITE(dt, sz)                                                                                     \
+    if (fwrite(dt, 1, sz, file) != sz) {                                                                        \
+        log_error("Failed to write to raw file '%s': %s\n", filename.c_str(), bmx_strerror(errno).c_str());     \
+        throw false;                                                                                            \
+    }
+
+    if (wrap_klv) {
+        // write KL with 8-byte Length
+        unsigned char len_bytes[8] = {0x87};
+        mxf_set_uint32(size, &len_bytes[4]);
+
+        CHECK_WRITE((const unsigned char*)&key->octet0, 16)
+        CHECK_WRITE(len_bytes, 8)
+    }
+
+    CHECK_WRITE(data, size)
+}
+
+
+
+void OutputFileManager::WriteFrame(TrackFiles &track_files, const MXFTrackInfo *track_info, Frame *frame,
+                                   bool deinterleave, bool wrap_klv, ByteArray *sound_buffer)
+{
+    const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track_info);
+    if (sound_info && deinterleave && sound_info->channel_count > 1) {
+        uint32_t channel_size;
+        if (sound_info->essence_type == D10_AES3_PCM) {
+            channel_size = sound_info->block_align / sound_info->channel_count *
+                                get_aes3_sample_count(frame->GetBytes(), frame->GetSize());
+        } else {
+            channel_size = frame->GetSize() / sound_info->channel_count;
+        }
+        sound_buffer->Allocate(channel_size * sound_info->channel_count);
+        vector<unsigned char*> channel_data(sound_info->channel_count);
+        uint32_t c;
+        for (c = 0; c < sound_info->channel_count; c++)
+            channel_data[c] = sound_buffer->GetBytes() + c * channel_size;
+        if (sound_info->essence_type == D10_AES3_PCM) {
+            convert_aes3_to_pcm_channels(frame->GetBytes(), frame->GetSize(), false,
+                                         sound_info->bits_per_sample, sound_info->channel_count,
+                                         &channel_data[0], channel_size);
+        } else {
+            deinterleave_audio_channels(frame->GetBytes(), frame->GetSize(),
+                                        sound_info->bits_per_sample, sound_info->channel_count,
+                                        &channel_data[0], channel_size);
+        }
+        for (c = 0; c < sound_info->channel_count; c++) {
+            FileInfo &file_info = track_files.at(c);
+            write_data(file_info.file, file_info.filename, channel_data[c], channel_size, wrap_klv,
+                       &frame->element_key);
+        }
+    } else {
+        FileInfo &file_info = track_files.at((uint32_t)(-1));
+        write_data(file_info.file, file_info.filename, frame->GetBytes(), frame->GetSize(), wrap_klv,
+                   &frame->element_key);
+    }
+}
+
+
 OutputFileManager::OutputFileManager()
 {
     mSoundDeinterleave = false;
@@ -53,7 +121,7 @@ OutputFileManager::~OutputFileManager()
 {
     map<size_t, TrackFileInfo>::const_iterator iter1;
     for (iter1 = mTrackFiles.begin(); iter1 != mTrackFiles.end(); iter1++) {
-        map<uint32_t, FileInfo>::const_iterator iter2;
+        TrackFiles::const_iterator iter2;
         for (iter2 = iter1->second.children.begin(); iter2 != iter1->second.children.end(); iter2++) {
             if (iter2->second.file) {
                 fclose(iter2->second.file);
@@ -191,3 +259,8 @@ void OutputFileManager::GetTrackFile(size_t track_index,
 {
     return GetTrackFile(track_index, (uint32_t)(-1), file, filename);
 }
+
+OutputFileManager::TrackFiles& OutputFileManager::GetTrackFiles(size_t track_index)
+{
+    return mTrackFiles.at(track_index).children;
+}
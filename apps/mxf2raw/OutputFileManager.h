@@ -35,11 +35,27 @@
 #include <map>
 
 #include <bmx/BMXTypes.h>
+#include <bmx/ByteArray.h>
+#include <bmx/frame/Frame.h>
 #include <bmx/mxf_reader/MXFTrackInfo.h>
 
 
 class OutputFileManager
 {
+public:
+    typedef struct
+    {
+        std::string filename;
+        FILE *file;
+    } FileInfo;
+
+    // a track's output files, indexed by sound channel or (uint32_t)(-1) if the track has a single output file
+    typedef std::map<uint32_t, FileInfo> TrackFiles;
+
+public:
+    static void WriteFrame(TrackFiles &track_files, const bmx::MXFTrackInfo *track_info, bmx::Frame *frame,
+                           bool deinterleave, bool wrap_klv, bmx::ByteArray *sound_buffer);
+
 public:
     OutputFileManager();
     ~OutputFileManager();
@@ -51,17 +67,12 @@ public:
 
     void GetTrackFile(size_t track_index, uint32_t child_index, FILE **file, std::string *filename);
     void GetTrackFile(size_t track_index, FILE **file, std::string *filename);
+    TrackFiles& GetTrackFiles(size_t track_index);
 
 private:
     typedef struct
     {
-        std::string filename;
-        FILE *file;
-    } FileInfo;
-
-    typedef struct
-    {
-        std::map<uint32_t, FileInfo> children;
+        TrackFiles children;
     } TrackFileInfo;
 
 private:
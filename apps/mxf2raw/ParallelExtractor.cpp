@@ -0,0 +1,633 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_FORMAT_MACROS
+
+#include <cstdio>
+#include <cerrno>
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "ParallelExtractor.h"
+
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define COPY_BUFFER_SIZE    (4 * 1024 * 1024)
+
+// the key and 8-byte length written before each frame when wrapping in KLV
+#define KLV_HEADER_SIZE     24
+
+
+static int seek_file(FILE *file, int64_t offset, int whence)
+{
+#if defined(_WIN32)
+    return _fseeki64(file, offset, whence);
+#else
+    return fseeko(file, offset, whence);
+#endif
+}
+
+static int64_t tell_file(FILE *file)
+{
+#if defined(_WIN32)
+    return _ftelli64(file);
+#else
+    return ftello(file);
+#endif
+}
+
+static int truncate_file(FILE *file, int64_t size)
+{
+#if defined(_WIN32)
+    return _chsize_s(_fileno(file), size);
+#else
+    return ftruncate(fileno(file), size);
+#endif
+}
+
+
+
+ParallelExtractor::ParallelExtractor(MXFFileReader *file_reader, OpenReaderFunction open_reader,
+                                     OutputFileManager *output_file_manager, uint32_t num_threads)
+{
+    mFileReader = file_reader;
+    mOpenReader = open_reader;
+    mOutputFileManager = output_file_manager;
+    mNumThreads = (num_threads > 0 ? num_threads : 1);
+    mDeinterleave = false;
+    mMaxSamplesPerRead = 1;
+    mMinRangeDuration = 250;
+    mNumRanges = 0;
+    mReadError = false;
+}
+
+ParallelExtractor::~ParallelExtractor()
+{
+    Cleanup();
+}
+
+void ParallelExtractor::AddTrack(size_t track_index, const MXFTrackInfo *track_info, bool wrap_klv)
+{
+    Track track;
+    track.track_index = track_index;
+    track.track_info  = track_info;
+    track.wrap_klv    = wrap_klv;
+    track.direct      = false;
+    mTracks.push_back(track);
+}
+
+int64_t ParallelExtractor::Extract(int64_t start_position, int64_t duration)
+{
+    if (mTracks.empty() || duration <= 0)
+        return 0;
+
+    CreateWorkItems(start_position, duration);
+    PrepareTrackFiles();
+
+    log_info("Extracting %" PRIszt " tracks in %u ranges using %u threads\n",
+             mTracks.size(), mNumRanges, mNumThreads);
+
+    RunThreads(mWorkItems.size(), [this](size_t index) { ExtractRange(mWorkItems[index]); });
+
+    // a track's output ends with the first range that failed to read completely, as it would when reading serially
+    vector<uint32_t> num_good_ranges(mTracks.size(), mNumRanges);
+    vector<int64_t> track_num_read(mTracks.size(), 0);
+    size_t i;
+    for (i = 0; i < mWorkItems.size(); i++) {
+        WorkItem *item = mWorkItems[i];
+        if (item->range_index >= num_good_ranges[item->track_num])
+            continue;
+        track_num_read[item->track_num] += item->num_read;
+        if (item->read_error || item->num_read < item->duration) {
+            num_good_ranges[item->track_num] = item->range_index + 1;
+            if (item->read_error && !mReadError) {
+                mReadError = true;
+                mReadErrorMessage = item->read_error_message;
+            }
+        }
+    }
+
+    CompleteDirectTracks(num_good_ranges);
+    StitchParts(num_good_ranges);
+
+    int64_t total_num_read = track_num_read[0];
+    for (i = 1; i < track_num_read.size(); i++) {
+        if (track_num_read[i] < total_num_read)
+            total_num_read = track_num_read[i];
+    }
+
+    Cleanup();
+
+    return total_num_read;
+}
+
+void ParallelExtractor::CreateWorkItems(int64_t start_position, int64_t duration)
+{
+    // split each track into enough edit unit ranges to occupy all threads
+    int64_t min_range_duration = mMinRangeDuration;
+    if (min_range_duration < mMaxSamplesPerRead)
+        min_range_duration = mMaxSamplesPerRead;
+    int64_t num_ranges = (mNumThreads + mTracks.size() - 1) / mTracks.size();
+    if (num_ranges > duration / min_range_duration)
+        num_ranges = duration / min_range_duration;
+    if (num_ranges < 1)
+        num_ranges = 1;
+    mNumRanges = (uint32_t)num_ranges;
+
+    // range boundaries are aligned to the read size so that the frames (and any KLV wrapping) match a serial read
+    int64_t num_reads = (duration + mMaxSamplesPerRead - 1) / mMaxSamplesPerRead;
+    uint32_t r;
+    mRangeStarts.clear();
+    for (r = 0; r < mNumRanges; r++)
+        mRangeStarts.push_back(start_position + num_reads * r / mNumRanges * mMaxSamplesPerRead);
+    mRangeStarts.push_back(start_position + duration);
+
+    size_t t;
+    for (t = 0; t < mTracks.size(); t++)
+        mTracks[t].direct = CalcRangeSizes(&mTracks[t]);
+
+    // the readers and range files are opened by the threads
+    for (r = 0; r < mNumRanges; r++) {
+        for (t = 0; t < mTracks.size(); t++) {
+            WorkItem *item = new WorkItem;
+            item->track_num      = t;
+            item->range_index    = r;
+            item->start_position = mRangeStarts[r];
+            item->duration       = mRangeStarts[r + 1] - mRangeStarts[r];
+            item->range_offset   = 0;
+            item->num_read       = 0;
+            item->output_size    = 0;
+            item->read_error     = false;
+            if (mTracks[t].direct && r > 0)
+                item->range_offset = mWorkItems[(r - 1) * mTracks.size() + t]->range_offset + mTracks[t].range_sizes[r - 1];
+            mWorkItems.push_back(item);
+        }
+    }
+}
+
+bool ParallelExtractor::CalcRangeSizes(Track *track)
+{
+    const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track->track_info);
+    int64_t num_files = 1;
+    if (sound_info && mDeinterleave && sound_info->channel_count > 1)
+        num_files = sound_info->channel_count;
+
+    track->range_sizes.clear();
+    uint32_t r;
+    if (mFileReader->IsClipWrapped()) {
+        // a clip wrapped track is read as one frame per read and the index provides the size of each edit unit
+        MXFTrackReader *track_reader = mFileReader->GetTrackReader(track->track_index);
+        int64_t overhead;
+        if (!GetClipWrappedOverhead(track_reader, &overhead))
+            return false;
+
+        vector<int64_t> offsets;
+        MXFIndexEntryExt entry;
+        for (r = 0; r < mNumRanges; r++) {
+            if (!track_reader->GetIndexEntry(&entry, mRangeStarts[r]))
+                return false;
+            offsets.push_back(entry.container_offset);
+        }
+        if (!track_reader->GetIndexEntry(&entry, mRangeStarts[mNumRanges] - 1))
+            return false;
+        offsets.push_back(entry.container_offset + entry.edit_unit_size);
+
+        for (r = 0; r < mNumRanges; r++) {
+            int64_t duration = mRangeStarts[r + 1] - mRangeStarts[r];
+            int64_t data_size = offsets[r + 1] - offsets[r] - duration * overhead;
+            if (data_size < 0 || data_size % num_files != 0)
+                return false;
+            int64_t size = data_size / num_files;
+            if (track->wrap_klv)
+                size += KLV_HEADER_SIZE * ((duration + mMaxSamplesPerRead - 1) / mMaxSamplesPerRead);
+            track->range_sizes.push_back(size);
+        }
+    } else if (mFileReader->IsFrameWrapped()) {
+        // a frame wrapped PCM track has a constant sample size if the sampling rate is a multiple of the edit rate
+        if (!sound_info || sound_info->essence_type != WAVE_PCM)
+            return false;
+        Rational edit_rate = mFileReader->GetEditRate();
+        int64_t num = (int64_t)sound_info->sampling_rate.numerator * edit_rate.denominator;
+        int64_t den = (int64_t)sound_info->sampling_rate.denominator * edit_rate.numerator;
+        if (num <= 0 || den <= 0 || num % den != 0)
+            return false;
+        int64_t frame_size = num / den * sound_info->block_align;
+        if (frame_size % num_files != 0)
+            return false;
+        int64_t edit_unit_size = frame_size / num_files;
+        if (track->wrap_klv)
+            edit_unit_size += KLV_HEADER_SIZE;
+
+        for (r = 0; r < mNumRanges; r++)
+            track->range_sizes.push_back((mRangeStarts[r + 1] - mRangeStarts[r]) * edit_unit_size);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool ParallelExtractor::GetClipWrappedOverhead(MXFTrackReader *track_reader, int64_t *overhead)
+{
+    *overhead = 0;
+    if (track_reader->GetTrackInfo()->data_def != MXF_PICTURE_DDEF)
+        return true;
+
+    // the index edit unit size includes the image start and end offsets (Avid uncompressed) that are excluded from
+    // the frame data. Read the first edit unit using the main reader to get the difference
+    MXFIndexEntryExt entry;
+    if (!track_reader->GetIndexEntry(&entry, mRangeStarts[0]))
+        return false;
+    bool have_frame = false;
+    mFileReader->Seek(mRangeStarts[0]);
+    if (mFileReader->Read(1) == 1) {
+        Frame *frame = track_reader->GetFrameBuffer()->GetLastFrame(true);
+        if (frame) {
+            *overhead = entry.edit_unit_size - frame->GetSize();
+            have_frame = true;
+            delete frame;
+        }
+    }
+    mFileReader->ClearFrameBuffers(true);
+    mFileReader->Seek(mRangeStarts[0]);
+
+    return have_frame && *overhead >= 0;
+}
+
+void ParallelExtractor::PrepareTrackFiles()
+{
+    // the track file handles are flushed because the ranges write to the files using separate handles
+    size_t t;
+    for (t = 0; t < mTracks.size(); t++) {
+        Track &track = mTracks[t];
+        if (!track.direct)
+            continue;
+
+        int64_t total_size = 0;
+        uint32_t r;
+        for (r = 0; r < mNumRanges; r++)
+            total_size += track.range_sizes[r];
+
+        OutputFileManager::TrackFiles &track_files = mOutputFileManager->GetTrackFiles(track.track_index);
+        OutputFileManager::TrackFiles::iterator iter;
+        for (iter = track_files.begin(); iter != track_files.end(); iter++) {
+            int64_t offset = -1;
+            if (fflush(iter->second.file) == 0)
+                offset = tell_file(iter->second.file);
+            if (offset < 0) {
+                log_error("Failed to flush raw file '%s': %s\n",
+                          iter->second.filename.c_str(), bmx_strerror(errno).c_str());
+                throw false;
+            }
+            track.file_offsets[iter->first] = offset;
+
+#if defined(__linux__)
+            // reserve space for the ranges so that the positional writes below don't fragment the file
+            if (total_size > 0)
+                posix_fallocate(fileno(iter->second.file), offset, total_size);
+#endif
+        }
+    }
+}
+
+void ParallelExtractor::OpenRangeFiles(WorkItem *item)
+{
+    const Track &track = mTracks[item->track_num];
+    if (!track.direct && item->range_index == 0)
+        return;
+
+    // direct ranges open a separate handle positioned at the range's offset in the track file and the other
+    // ranges after the first write to part files that are copied into the track file afterwards
+    const OutputFileManager::TrackFiles &track_files = mOutputFileManager->GetTrackFiles(track.track_index);
+    OutputFileManager::TrackFiles::const_iterator iter;
+    for (iter = track_files.begin(); iter != track_files.end(); iter++) {
+        OutputFileManager::FileInfo range_info;
+        if (track.direct) {
+            int64_t offset = track.file_offsets.at(iter->first) + item->range_offset;
+            range_info.filename = iter->second.filename;
+            range_info.file = fopen(range_info.filename.c_str(), "r+b");
+            if (!range_info.file || seek_file(range_info.file, offset, SEEK_SET) != 0) {
+                log_error("Failed to open raw file '%s' for writing at offset %" PRId64 ": %s\n",
+                          range_info.filename.c_str(), offset, bmx_strerror(errno).c_str());
+                if (range_info.file)
+                    fclose(range_info.file);
+                throw false;
+            }
+        } else {
+            char suffix[32];
+            bmx_snprintf(suffix, sizeof(suffix), ".part%u", item->range_index);
+            range_info.filename = iter->second.filename + suffix;
+            range_info.file = fopen(range_info.filename.c_str(), "wb");
+            if (!range_info.file) {
+                log_error("Failed to open part file '%s': %s\n",
+                          range_info.filename.c_str(), bmx_strerror(errno).c_str());
+                throw false;
+            }
+        }
+        item->range_files[iter->first] = range_info;
+    }
+}
+
+void ParallelExtractor::CloseRangeFiles(WorkItem *item)
+{
+    const Track &track = mTracks[item->track_num];
+    bool complete = (!item->read_error && item->num_read >= item->duration);
+
+    OutputFileManager::TrackFiles::iterator iter;
+    for (iter = item->range_files.begin(); iter != item->range_files.end(); iter++) {
+        int64_t size = tell_file(iter->second.file);
+        if (size >= 0 && track.direct)
+            size -= track.file_offsets.at(iter->first) + item->range_offset;
+        int close_result = fclose(iter->second.file);
+        iter->second.file = 0;
+        if (size < 0 || close_result != 0) {
+            log_error("Failed to complete range output in file '%s': %s\n",
+                      iter->second.filename.c_str(), bmx_strerror(errno).c_str());
+            throw false;
+        }
+
+        // the calculated size determines the offsets of the ranges that follow
+        if (track.direct &&
+            (size > track.range_sizes[item->range_index] ||
+                (complete && size != track.range_sizes[item->range_index])))
+        {
+            log_error("Range output size %" PRId64 " in raw file '%s' differs from the calculated size %" PRId64 "\n",
+                      size, iter->second.filename.c_str(), track.range_sizes[item->range_index]);
+            throw false;
+        }
+
+        item->output_size = size;
+    }
+}
+
+void ParallelExtractor::RunThreads(size_t num_items, function<void(size_t)> process_item)
+{
+    atomic<size_t> next_item(0);
+    mutex error_mutex;
+    exception_ptr error;
+
+    auto worker = [&]() {
+        while (true) {
+            {
+                lock_guard<mutex> lock(error_mutex);
+                if (error)
+                    break;
+            }
+            size_t index = next_item++;
+            if (index >= num_items)
+                break;
+            try {
+                process_item(index);
+            } catch (...) {
+                lock_guard<mutex> lock(error_mutex);
+                if (!error)
+                    error = current_exception();
+            }
+        }
+    };
+
+    size_t num_threads = mNumThreads;
+    if (num_threads > num_items)
+        num_threads = num_items;
+    vector<thread> threads;
+    size_t i;
+    for (i = 0; i < num_threads; i++)
+        threads.push_back(thread(worker));
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    if (error)
+        rethrow_exception(error);
+}
+
+void ParallelExtractor::ExtractRange(WorkItem *item)
+{
+    const Track &track = mTracks[item->track_num];
+
+    // each item has its own reader and therefore its own MXFFile handle
+    unique_ptr<MXFReader> reader(mOpenReader());
+    BMX_CHECK(reader->GetNumTrackReaders() > track.track_index);
+    size_t i;
+    for (i = 0; i < reader->GetNumTrackReaders(); i++)
+        reader->GetTrackReader(i)->SetEnable(i == track.track_index);
+    reader->SetReadLimits(item->start_position, item->duration, true);
+
+    OpenRangeFiles(item);
+    OutputFileManager::TrackFiles &track_files =
+        (item->range_files.empty() ? mOutputFileManager->GetTrackFiles(track.track_index) : item->range_files);
+    MXFTrackReader *track_reader = reader->GetTrackReader(track.track_index);
+    ByteArray sound_buffer;
+
+    while (item->num_read < item->duration) {
+        uint32_t num_read = reader->Read(mMaxSamplesPerRead);
+        if (num_read == 0)
+            break;
+        item->num_read += num_read;
+
+        while (true) {
+            Frame *frame = track_reader->GetFrameBuffer()->GetLastFrame(true);
+            if (!frame)
+                break;
+            if (frame->IsEmpty()) {
+                delete frame;
+                continue;
+            }
+
+            try {
+                OutputFileManager::WriteFrame(track_files, track.track_info, frame, mDeinterleave, track.wrap_klv,
+                                              &sound_buffer);
+            } catch (...) {
+                delete frame;
+                throw;
+            }
+            delete frame;
+        }
+    }
+
+    if (reader->ReadError()) {
+        item->read_error = true;
+        item->read_error_message = reader->ReadErrorMessage();
+    }
+
+    CloseRangeFiles(item);
+}
+
+void ParallelExtractor::CompleteDirectTracks(const vector<uint32_t> &num_good_ranges)
+{
+    // remove any preallocated space and the output of ranges after the last good range, and position the track file
+    // handles at the end of the output
+    size_t t;
+    for (t = 0; t < mTracks.size(); t++) {
+        const Track &track = mTracks[t];
+        if (!track.direct)
+            continue;
+
+        const WorkItem *last_item = mWorkItems[(num_good_ranges[t] - 1) * mTracks.size() + t];
+        int64_t size = last_item->range_offset + last_item->output_size;
+
+        OutputFileManager::TrackFiles &track_files = mOutputFileManager->GetTrackFiles(track.track_index);
+        OutputFileManager::TrackFiles::iterator iter;
+        for (iter = track_files.begin(); iter != track_files.end(); iter++) {
+            int64_t end_offset = track.file_offsets.at(iter->first) + size;
+            if (truncate_file(iter->second.file, end_offset) != 0 ||
+                seek_file(iter->second.file, end_offset, SEEK_SET) != 0)
+            {
+                log_error("Failed to complete raw file '%s': %s\n",
+                          iter->second.filename.c_str(), bmx_strerror(errno).c_str());
+                throw false;
+            }
+        }
+    }
+}
+
+void ParallelExtractor::StitchParts(const vector<uint32_t> &num_good_ranges)
+{
+    // assign each part its offset in the track file
+    vector<CopyItem> copy_items;
+    vector<string> copy_filenames;
+    size_t t;
+    for (t = 0; t < mTracks.size(); t++) {
+        if (mTracks[t].direct)
+            continue;
+
+        OutputFileManager::TrackFiles &track_files = mOutputFileManager->GetTrackFiles(mTracks[t].track_index);
+        OutputFileManager::TrackFiles::iterator iter;
+        for (iter = track_files.begin(); iter != track_files.end(); iter++) {
+            if (fflush(iter->second.file) != 0) {
+                log_error("Failed to flush raw file '%s': %s\n",
+                          iter->second.filename.c_str(), bmx_strerror(errno).c_str());
+                throw false;
+            }
+            int64_t offset = tell_file(iter->second.file);
+
+            uint32_t r;
+            for (r = 1; r < num_good_ranges[t]; r++) {
+                const WorkItem *item = mWorkItems[r * mTracks.size() + t];
+                if (item->output_size == 0)
+                    continue;
+
+                CopyItem copy_item;
+                copy_item.filename = item->range_files.at(iter->first).filename;
+                copy_item.offset   = offset;
+                copy_items.push_back(copy_item);
+                copy_filenames.push_back(iter->second.filename);
+                offset += item->output_size;
+            }
+
+#if defined(__linux__)
+            // reserve space for the parts so that the positional writes below don't fragment the file
+            int64_t base_offset = tell_file(iter->second.file);
+            if (offset > base_offset)
+                posix_fallocate(fileno(iter->second.file), base_offset, offset - base_offset);
+#endif
+        }
+    }
+
+    RunThreads(copy_items.size(), [&](size_t index) {
+        CopyPart(copy_items[index].filename, copy_filenames[index], copy_items[index].offset);
+    });
+}
+void ParallelExtractor::CopyPart(const string &part_filename, const string &filename, int64_t offset)
+{
+    FILE *part_file = fopen(part_filename.c_str(), "rb");
+    if (!part_file) {
+        log_error("Failed to open part file '%s': %s\n", part_filename.c_str(), bmx_strerror(errno).c_str());
+        throw false;
+    }
+    FILE *file = fopen(filename.c_str(), "r+b");
+    if (!file || seek_file(file, offset, SEEK_SET) != 0) {
+        log_error("Failed to open raw file '%s' for writing at offset %" PRId64 ": %s\n",
+                  filename.c_str(), offset, bmx_strerror(errno).c_str());
+        if (file)
+            fclose(file);
+        fclose(part_file);
+        throw false;
+    }
+
+    ByteArray buffer(COPY_BUFFER_SIZE);
+    bool failed = false;
+    while (true) {
+        size_t num_read = fread(buffer.GetBytes(), 1, buffer.GetAllocatedSize(), part_file);
+        if (num_read == 0) {
+            failed = (ferror(part_file) != 0);
+            break;
+        }
+        if (fwrite(buffer.GetBytes(), 1, num_read, file) != num_read) {
+            failed = true;
+            break;
+        }
+    }
+    if (fclose(file) != 0)
+        failed = true;
+    fclose(part_file);
+
+    if (failed) {
+        log_error("Failed to copy part file '%s' to raw file '%s': %s\n",
+                  part_filename.c_str(), filename.c_str(), bmx_strerror(errno).c_str());
+        throw false;
+    }
+}
+
+void ParallelExtractor::Cleanup()
+{
+    size_t i;
+    for (i = 0; i < mWorkItems.size(); i++) {
+        WorkItem *item = mWorkItems[i];
+        OutputFileManager::TrackFiles::iterator iter;
+        for (iter = item->range_files.begin(); iter != item->range_files.end(); iter++) {
+            if (iter->second.file)
+                fclose(iter->second.file);
+            if (!mTracks[item->track_num].direct)
+                remove(iter->second.filename.c_str());
+        }
+        delete item;
+    }
+    mWorkItems.clear();
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BMX_PARALLEL_EXTRACTOR_H_
+#define BMX_PARALLEL_EXTRACTOR_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+
+#include <bmx/mxf_reader/MXFFileReader.h>
+
+#include "OutputFileManager.h"
+
+
+namespace bmx
+{
+
+
+class ParallelExtractor
+{
+public:
+    // returns a newly opened reader for the input file, with the same track layout as the main reader
+    typedef std::function<MXFReader*()> OpenReaderFunction;
+
+public:
+    // the main file reader is used to calculate the output size of each range before extraction
+    ParallelExtractor(MXFFileReader *file_reader, OpenReaderFunction open_reader,
+                      OutputFileManager *output_file_manager, uint32_t num_threads);
+    ~ParallelExtractor();
+
+    void SetSoundDeinterleave(bool enable)            { mDeinterleave = enable; }
+    void SetMaxSamplesPerRead(uint32_t max_samples)   { mMaxSamplesPerRead = max_samples; }
+    void SetMinRangeDuration(int64_t duration)        { mMinRangeDuration = duration; }
+
+    void AddTrack(size_t track_index, const MXFTrackInfo *track_info, bool wrap_klv);
+
+    // extracts the tracks over the given read limits and returns the number of edit units read
+    int64_t Extract(int64_t start_position, int64_t duration);
+
+    bool ReadError() const                  { return mReadError; }
+    std::string ReadErrorMessage() const    { return mReadErrorMessage; }
+
+private:
+    typedef struct
+    {
+        size_t track_index;
+        const MXFTrackInfo *track_info;
+        bool wrap_klv;
+        bool direct;                                // ranges are written directly at their offset in the track files
+        std::vector<int64_t> range_sizes;           // output size of each range in each track file if direct
+        std::map<uint32_t, int64_t> file_offsets;   // start offset of the output in each track file if direct
+    } Track;
+
+    typedef struct
+    {
+        size_t track_num;
+        uint32_t range_index;
+        int64_t start_position;
+        int64_t duration;
+        int64_t range_offset;                       // offset of the range output in the track output if direct
+        OutputFileManager::TrackFiles range_files;  // empty if writing to the track files using their handles
+        int64_t num_read;
+        int64_t output_size;
+        bool read_error;
+        std::string read_error_message;
+    } WorkItem;
+
+    typedef struct
+    {
+        std::string filename;
+        int64_t offset;
+    } CopyItem;
+
+private:
+    void CreateWorkItems(int64_t start_position, int64_t duration);
+    bool CalcRangeSizes(Track *track);
+    bool GetClipWrappedOverhead(MXFTrackReader *track_reader, int64_t *overhead);
+    void PrepareTrackFiles();
+    void OpenRangeFiles(WorkItem *item);
+    void CloseRangeFiles(WorkItem *item);
+    void RunThreads(size_t num_items, std::function<void(size_t)> process_item);
+    void ExtractRange(WorkItem *item);
+    void CompleteDirectTracks(const std::vector<uint32_t> &num_good_ranges);
+    void StitchParts(const std::vector<uint32_t> &num_good_ranges);
+    void CopyPart(const std::string &part_filename, const std::string &filename, int64_t offset);
+    void Cleanup();
+
+private:
+    MXFFileReader *mFileReader;
+    OpenReaderFunction mOpenReader;
+    OutputFileManager *mOutputFileManager;
+    uint32_t mNumThreads;
+    bool mDeinterleave;
+    uint32_t mMaxSamplesPerRead;
+    int64_t mMinRangeDuration;
+
+    std::vector<Track> mTracks;
+    std::vector<WorkItem*> mWorkItems;
+    std::vector<int64_t> mRangeStarts;
+    uint32_t mNumRanges;
+
+    bool mReadError;
+    std::string mReadErrorMessage;
+};
+
+
+};
+
+
+
+#endif
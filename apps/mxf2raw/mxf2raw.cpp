@@ -48,12 +48,16 @@
 
 #include <map>
 #include <set>
+#include <vector>
+#include <mutex>
+#include <memory>
 
 #include <bmx/mxf_reader/MXFFileReader.h>
 #include <bmx/mxf_reader/MXFGroupReader.h>
 #include <bmx/mxf_reader/MXFSequenceReader.h>
 #include <bmx/mxf_reader/MXFFrameMetadata.h>
 #include <bmx/mxf_reader/MXFTimedTextTrackReader.h>
+#include <bmx/mxf_reader/GrowingFileFollower.h>
 #include <bmx/essence_parser/SoundConversion.h>
 #include <bmx/st436/ST436Element.h>
 #include <bmx/st436/RDD6Metadata.h>
@@ -73,6 +77,7 @@
 #include "APPInfoOutput.h"
 #include "AvidInfoOutput.h"
 #include "OutputFileManager.h"
+#include "ParallelExtractor.h"
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
@@ -84,6 +89,7 @@ using namespace mxfpp;
 #define DEFAULT_GF_RETRIES          10
 #define DEFAULT_GF_RETRY_DELAY      1.0
 #define DEFAULT_GF_RATE_AFTER_FAIL  1.5
+#define DEFAULT_GF_POLL_INTERVAL    10
 
 #define DEFAULT_ST436_MANIFEST_COUNT    2
 
@@ -140,6 +146,7 @@ static const char *XML_INFO_WRITER_VERSION      = "0.1"; // format <major>.<mino
 static const char* STDIN_FILENAME = "stdin:";
 
 static const uint32_t DEFAULT_HTTP_MIN_READ = 1024 * 1024;
+static const uint32_t DEFAULT_HTTP_READ_AHEAD = 8;
 
 
 namespace bmx
@@ -289,9 +296,13 @@ static void dump_log_messages()
 
 static void mxf2raw_vlog2(LogLevel level, const char *source, const char *format, va_list p_arg)
 {
-    if (level < LOG_LEVEL)
+    if (!is_log_level_enabled(level))
         return;
 
+    // messages can be logged by the --ess-threads extraction threads
+    static std::mutex log_mutex;
+    std::lock_guard<std::mutex> lock(log_mutex);
+
     char message[1024];
     bmx_vsnprintf(message, sizeof(message), format, p_arg);
 
@@ -1336,27 +1347,6 @@ static void write_log_messages(AppInfoWriter *info_writer)
         text_writer->PopItemValueIndent();
 }
 
-static void write_data(FILE *file, const string &filename, const unsigned char *data, uint32_t size,
-                       bool wrap_klv, const mxfKey *key)
-{
-#define CHECK_WRITE(dt, sz)                                                                                     \
-    if (fwrite(dt, 1, sz, file) != sz) {                                                                        \
-        log_error("Failed to write to raw file '%s': %s\n", filename.c_str(), bmx_strerror(errno).c_str());     \
-        throw false;                                                                                            \
-    }
-
-    if (wrap_klv) {
-        // write KL with 8-byte Length
-        unsigned char len_bytes[8] = {0x87};
-        mxf_set_uint32(size, &len_bytes[4]);
-
-        CHECK_WRITE((const unsigned char*)&key->octet0, 16)
-        CHECK_WRITE(len_bytes, 8)
-    }
-
-    CHECK_WRITE(data, size)
-}
-
 static bool update_rdd6_xml(Frame *frame, RDD6MetadataFrame *rdd6_frame, vector<string> *cumulative_desc_chars,
                             vector<bool> *have_start, vector<bool> *have_end, bool *done)
 {
@@ -1661,6 +1651,24 @@ static void usage(const char *cmd)
     fprintf(stderr, " --group               Use the group reader instead of the sequence reader\n");
     fprintf(stderr, "                       Use this option if the files have different material packages\n");
     fprintf(stderr, "                       but actually belong to the same virtual package / group\n");
+    fprintf(stderr, " --group-threads <count>\n");
+    fprintf(stderr, "                       Read the group members concurrently using <count> threads\n");
+    fprintf(stderr, " --open-threads <count>\n");
+    fprintf(stderr, "                       Read the partition packs and index table segments concurrently using <count> threads\n");
+    fprintf(stderr, "                       when opening the input file(s)\n");
+    fprintf(stderr, "                       This helps when each read has a high latency, e.g. HTTP files with partitions further apart\n");
+    fprintf(stderr, "                       than the HTTP read-ahead window. It is slower for local files that are in the page cache\n");
+    fprintf(stderr, " --lazy-index <mib>\n");
+    fprintf(stderr, "                       Read the index table entries on demand rather than when opening the input file(s)\n");
+    fprintf(stderr, "                       and keep at most <mib> MiB of index entries in memory, where 0 means no limit\n");
+    fprintf(stderr, "                       <mib> can be a fraction, e.g. 0.5 for 512 KiB\n");
+    fprintf(stderr, " --open-cache <dir>\n");
+    fprintf(stderr, "                       Store the partition packs and index table of the input file(s) in sidecar files in <dir>\n");
+    fprintf(stderr, "                       and use them to open the file(s) faster the next time if the file(s) are unchanged\n");
+    fprintf(stderr, "                       The directory <dir> is created if it does not exist\n");
+    fprintf(stderr, " --read-ahead <count>\n");
+    fprintf(stderr, "                       Read the essence of up to <count> edit units ahead of the current position, using the index table\n");
+    fprintf(stderr, "                       to locate the data in frame wrapped input file(s). The reads are cancelled when seeking\n");
     fprintf(stderr, " --no-reorder          Don't attempt to re-order the inputs, based on timecode, when constructing a sequence\n");
     fprintf(stderr, "                       Use this option for files with broken timecode\n");
     fprintf(stderr, "\n");
@@ -1715,6 +1723,10 @@ static void usage(const char *cmd)
     fprintf(stderr, "                           v=video, a=audio, d=data\n");
     fprintf(stderr, " --read-ess            Read the essence data, even when no other option requires it\n");
     fprintf(stderr, " --deint               De-interleave multi-channel / AES-3 sound\n");
+    fprintf(stderr, " --ess-threads <count> Extract essence using <count> threads, each with its own input file handle\n");
+    fprintf(stderr, "                       Tracks are split into edit unit ranges. Each range is written at its offset in the output file\n");
+    fprintf(stderr, "                       if the index or PCM sample size provides it, otherwise to a part file that is copied afterwards\n");
+    fprintf(stderr, "                       Only supported for extracting essence (--ess-out) from a single, complete and seekable file\n");
     fprintf(stderr, " --start <count>       Set the start edit unit to read from. Default is 0\n");
     fprintf(stderr, " --dur <count>         Set the duration in edit units. Default is minimum available duration\n");
     fprintf(stderr, " --end <edit_unit>     Set the last edit unit to read (inclusive).");
@@ -1722,21 +1734,33 @@ static void usage(const char *cmd)
     fprintf(stderr, " --noro                Don't include roll-out frames\n");
     fprintf(stderr, " --rt <factor>         Read at realtime rate x <factor>, where <factor> is a floating point value\n");
     fprintf(stderr, "                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
-#if defined(_WIN32)
     fprintf(stderr, " --no-seq-scan         Do not set the sequential scan hint for optimizing file caching\n");
+#if !defined(_WIN32)
+    fprintf(stderr, " --cache-hint <mode>   Set the page cache hint for the MXF files. <mode> is one of the following:\n");
+    fprintf(stderr, "                         'none': no hint, or only sequential access if --no-seq-scan is not set (default)\n");
+    fprintf(stderr, "                         'seq': sequential access, with data requested a window ahead of the read position\n");
+    fprintf(stderr, "                         'stream': same as 'seq', and data more than a window behind the read position is dropped\n");
+    fprintf(stderr, "                                   This bounds the page cache used by each file to about 2 windows\n");
+    fprintf(stderr, " --cache-window <mib>  Set the window size in MiB for --cache-hint. The default is %u\n",
+            MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW / (1024 * 1024));
+#endif
 #if !defined(__MINGW32__)
     fprintf(stderr, " --mmap-file           Use memory-mapped file I/O for the MXF files\n");
     fprintf(stderr, "                       Note: this may reduce file I/O performance and was found to be slower over network drives\n");
 #endif
-#endif
-    fprintf(stderr, " --gf                  Support growing files. Retry reading a frame when it fails\n");
-    fprintf(stderr, " --gf-retries <max>    Set the maximum times to retry reading a frame. The default is %u.\n", DEFAULT_GF_RETRIES);
-    fprintf(stderr, " --gf-delay <sec>      Set the delay (in seconds) between a failure to read and a retry. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
+    fprintf(stderr, " --gf                  Support growing files. Wait for the file to grow and retry reading a frame when it fails\n");
+    fprintf(stderr, " --gf-retries <max>    Set the maximum number of consecutive waits without the file growing. The default is %u.\n", DEFAULT_GF_RETRIES);
+    fprintf(stderr, " --gf-delay <sec>      Set the maximum time (in seconds) to wait for the file to grow after a failure to read. The default is %f.\n", DEFAULT_GF_RETRY_DELAY);
     fprintf(stderr, " --gf-rate <factor>    Limit the read rate to realtime rate x <factor> after a read failure. The default is %f\n", DEFAULT_GF_RATE_AFTER_FAIL);
     fprintf(stderr, "                       <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+    fprintf(stderr, " --gf-poll <msec>      Set the interval (in milliseconds) for checking the file size when file change\n");
+    fprintf(stderr, "                       notifications are not available. The default is %u.\n", DEFAULT_GF_POLL_INTERVAL);
     if (mxf_http_is_supported()) {
         fprintf(stderr, " --http-min-read <bytes>\n");
         fprintf(stderr, "                       Set the minimum number of bytes to read when accessing a file over HTTP. The default is %u.\n", DEFAULT_HTTP_MIN_READ);
+        fprintf(stderr, " --http-read-ahead <count>\n");
+        fprintf(stderr, "                       Set the maximum number of parallel HTTP range requests used to read ahead. The default is %u.\n", DEFAULT_HTTP_READ_AHEAD);
+        fprintf(stderr, "                       Read-ahead is disabled if <count> is 0\n");
     }
     fprintf(stderr, "\n");
     fprintf(stderr, " --text-out <prefix>   Extract text based objects to files starting with <prefix>\n");
@@ -1763,6 +1787,12 @@ int main(int argc, const char** argv)
     LogLevel log_level = INFO_LOG;
     set<ChecksumType> file_checksum_only_types;
     bool use_group_reader = false;
+    uint32_t group_read_threads = 0;
+    uint32_t open_threads = 1;
+    bool lazy_index = false;
+    double lazy_index_mib = 0.0;
+    const char *open_cache_dir = 0;
+    uint32_t read_ahead = 0;
     bool keep_input_order = false;
     bool check_end = false;
     bool check_complete = false;
@@ -1799,6 +1829,7 @@ int main(int argc, const char** argv)
     map<size_t, bool> disable_video;
     map<size_t, bool> disable_data;
     bool deinterleave = false;
+    uint32_t ess_threads = 0;
     int64_t start = 0;
     bool start_set = false;
     int64_t duration = -1;
@@ -1809,7 +1840,7 @@ int main(int argc, const char** argv)
 #if defined(_WIN32)
     int file_flags = MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
 #else
-    int file_flags = 0;
+    int file_flags = MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN;
 #endif
     bool realtime = false;
     float rt_factor = 1.0;
@@ -1817,10 +1848,16 @@ int main(int argc, const char** argv)
     unsigned int gf_retries = DEFAULT_GF_RETRIES;
     float gf_retry_delay = DEFAULT_GF_RETRY_DELAY;
     float gf_rate_after_fail = DEFAULT_GF_RATE_AFTER_FAIL;
+    uint32_t gf_poll_interval = DEFAULT_GF_POLL_INTERVAL;
     uint32_t http_min_read = DEFAULT_HTTP_MIN_READ;
+    uint32_t http_read_ahead = DEFAULT_HTTP_READ_AHEAD;
     ChecksumType checkum_type;
-#if defined(_WIN32) && !defined(__MINGW32__)
+#if !defined(__MINGW32__)
     bool use_mmap_file = false;
+#endif
+#if !defined(_WIN32)
+    int cache_hint_flags = MXF_POSIX_CACHE_HINT_DEFAULT;
+    uint32_t cache_window_mib = 0;
 #endif
     const char *text_output_prefix = 0;
     bool mca_detail = false;
@@ -1897,6 +1934,83 @@ int main(int argc, const char** argv)
         {
             use_group_reader = true;
         }
+        else if (strcmp(argv[cmdln_index], "--group-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &group_read_threads) != 1 || group_read_threads == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &open_threads) != 1 || open_threads == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--lazy-index") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%lf", &lazy_index_mib) != 1 || lazy_index_mib < 0.0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            lazy_index = true;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--open-cache") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            open_cache_dir = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            read_ahead = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--no-reorder") == 0)
         {
             keep_input_order = true;
@@ -2152,6 +2266,22 @@ int main(int argc, const char** argv)
         {
             deinterleave = true;
         }
+        else if (strcmp(argv[cmdln_index], "--ess-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &ess_threads) != 1 || ess_threads == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--start") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2226,17 +2356,53 @@ int main(int argc, const char** argv)
             realtime = true;
             cmdln_index++;
         }
-#if defined(_WIN32)
         else if (strcmp(argv[cmdln_index], "--no-seq-scan") == 0)
         {
+#if defined(_WIN32)
             file_flags &= ~MXF_WIN32_FLAG_SEQUENTIAL_SCAN;
+#else
+            file_flags &= ~MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN;
+#endif
+        }
+#if !defined(_WIN32)
+        else if (strcmp(argv[cmdln_index], "--cache-hint") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (!parse_cache_hint(argv[cmdln_index + 1], &cache_hint_flags))
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-window") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &cache_window_mib) != 1 || cache_window_mib == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
         }
+#endif
 #if !defined(__MINGW32__)
         else if (strcmp(argv[cmdln_index], "--mmap-file") == 0)
         {
             use_mmap_file = true;
         }
-#endif
 #endif
         else if (strcmp(argv[cmdln_index], "--gf") == 0)
         {
@@ -2293,6 +2459,24 @@ int main(int argc, const char** argv)
             growing_file = true;
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--gf-poll") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            gf_poll_interval = (uint32_t)(uvalue);
+            growing_file = true;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--text-out") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2321,6 +2505,23 @@ int main(int argc, const char** argv)
             http_min_read = (uint32_t)(uvalue);
             cmdln_index++;
         }
+        else if (strcmp(argv[cmdln_index], "--http-read-ahead") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            http_read_ahead = (uint32_t)(uvalue);
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--regtest") == 0)
         {
             BMX_REGRESSION_TEST = true;
@@ -2562,9 +2763,14 @@ int main(int argc, const char** argv)
             file_factory.SetInputChecksumTypes(file_checksum_types);
         file_factory.SetInputFlags(file_flags);
         file_factory.SetHTTPMinReadSize(http_min_read);
-#if defined(_WIN32) && !defined(__MINGW32__)
+        file_factory.SetHTTPReadAhead(http_read_ahead);
+#if !defined(__MINGW32__)
         file_factory.SetUseMMapFile(use_mmap_file);
 #endif
+#if !defined(_WIN32)
+        file_factory.SetCacheHints(cache_hint_flags, MXF_POSIX_CACHE_HINT_DEFAULT,
+                                   (int64_t)cache_window_mib * 1024 * 1024);
+#endif
 
         int input_open_flags = do_parse_read && !do_ess_read ? MXFFileReader::MXF_MODE_PARSE_ONLY : 0;
         if (use_group_reader && input_filenames.size() > 1) {
@@ -2576,6 +2782,11 @@ int main(int argc, const char** argv)
                 grp_file_reader->SetFileFactory(&file_factory, false);
                 grp_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 grp_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+                grp_file_reader->SetOpenThreads(open_threads);
+                grp_file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+                grp_file_reader->SetReadAhead(read_ahead);
+                if (open_cache_dir)
+                    grp_file_reader->SetOpenCacheDir(open_cache_dir);
                 result = grp_file_reader->Open(input_filenames[i], input_open_flags);
                 if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
@@ -2589,6 +2800,8 @@ int main(int argc, const char** argv)
             }
             if (!group_reader->Finalize())
                 throw false;
+            if (group_read_threads > 1)
+                group_reader->SetReadThreads(group_read_threads);
 
             reader = group_reader;
         } else if (input_filenames.size() > 1) {
@@ -2600,6 +2813,11 @@ int main(int argc, const char** argv)
                 seq_file_reader->SetFileFactory(&file_factory, false);
                 seq_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
                 seq_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+                seq_file_reader->SetOpenThreads(open_threads);
+                seq_file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+                seq_file_reader->SetReadAhead(read_ahead);
+                if (open_cache_dir)
+                    seq_file_reader->SetOpenCacheDir(open_cache_dir);
                 result = seq_file_reader->Open(input_filenames[i], input_open_flags);
                 if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
                     log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[i]),
@@ -2620,6 +2838,11 @@ int main(int argc, const char** argv)
             file_reader->SetFileFactory(&file_factory, false);
             file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
             file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+            file_reader->SetOpenThreads(open_threads);
+            file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+            file_reader->SetReadAhead(read_ahead);
+            if (open_cache_dir)
+                file_reader->SetOpenCacheDir(open_cache_dir);
             if (do_as11_info)
                 as11_register_extensions(file_reader);
             if (do_as10_info)
@@ -2905,32 +3128,95 @@ int main(int argc, const char** argv)
                 rt_start = get_tick_count();
 
             // growing file
-            unsigned int gf_retry_count = 0;
+            unique_ptr<GrowingFileFollower> gf_follower;
             bool gf_read_failure = false;
             int64_t gf_failure_num_read = 0;
             uint32_t gf_failure_start = 0;
+            if (growing_file) {
+                vector<string> gf_filenames;
+                size_t i;
+                for (i = 0; i < input_filenames.size(); i++) {
+                    if (!mxf_http_is_url(input_filenames[i]))
+                        gf_filenames.push_back(input_filenames[i]);
+                }
+                gf_follower.reset(new GrowingFileFollower(reader, gf_filenames));
+                gf_follower->SetMaxWaits(gf_retries, (uint32_t)(gf_retry_delay * 1000));
+                gf_follower->SetPollInterval(gf_poll_interval);
+            }
+
+            // multi-threaded extraction is limited to writing essence from a single, complete file
+            bool use_ess_threads = false;
+            if (ess_threads > 1) {
+                if (!ess_output_prefix || !file_reader || !reader->IsComplete() || !reader->IsSeekable() ||
+                    realtime || growing_file || !file_checksum_types.empty() || !track_checksums.empty() ||
+                    check_app_crc32 || app_crc32_file || app_tc_file || all_tc_file || do_index_info || rdd6_filename)
+                {
+                    log_warn("Options are incompatible with --ess-threads; extracting essence using a single thread\n");
+                }
+                else
+                {
+                    use_ess_threads = true;
+                }
+            }
 
             // read data
             bmx::ByteArray sound_buffer;
             int64_t total_num_read = 0;
-            while (true)
-            {
-                uint32_t num_read = reader->Read(max_samples_per_read);
-                if (num_read == 0) {
-                    if (!growing_file || !reader->ReadError() || gf_retry_count >= gf_retries)
-                        break;
-                    gf_retry_count++;
-                    gf_read_failure = true;
-                    if (gf_retry_delay > 0.0) {
-                        rt_sleep(1.0f / gf_retry_delay, get_tick_count(), edit_rate,
-                                 edit_rate.numerator / edit_rate.denominator);
-                    }
-                    continue;
+            if (use_ess_threads) {
+                // the readers are opened by the extraction threads; the file factory has no input checksums to
+                // update because those are incompatible with --ess-threads
+                ParallelExtractor extractor(
+                    file_reader,
+                    [&]() -> MXFReader* {
+                        MXFFileReader *ess_file_reader = new MXFFileReader();
+                        ess_file_reader->SetFileFactory(&file_factory, false);
+                        ess_file_reader->GetPackageResolver()->SetFileFactory(&file_factory, false);
+                        ess_file_reader->SetST436ManifestFrameCount(st436_manifest_count);
+                        ess_file_reader->SetOpenThreads(open_threads);
+                        ess_file_reader->SetLazyIndex(lazy_index, (uint64_t)(lazy_index_mib * 1048576.0));
+                        ess_file_reader->SetReadAhead(read_ahead);
+                        if (open_cache_dir)
+                            ess_file_reader->SetOpenCacheDir(open_cache_dir);
+                        MXFFileReader::OpenResult result = ess_file_reader->Open(input_filenames[0], input_open_flags);
+                        if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+                            log_error("Failed to open MXF file '%s': %s\n", get_input_filename(input_filenames[0]),
+                                      MXFFileReader::ResultToString(result).c_str());
+                            delete ess_file_reader;
+                            throw false;
+                        }
+                        return ess_file_reader;
+                    },
+                    &output_file_manager, ess_threads);
+                extractor.SetSoundDeinterleave(deinterleave);
+                extractor.SetMaxSamplesPerRead(max_samples_per_read);
+
+                size_t i;
+                for (i = 0; i < reader->GetNumTrackReaders(); i++) {
+                    const MXFTrackInfo *track_info = reader->GetTrackReader(i)->GetTrackInfo();
+                    if (!reader->GetTrackReader(i)->IsEnabled() || track_info->essence_type == TIMED_TEXT)
+                        continue;
+                    extractor.AddTrack(i, track_info, (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()));
+                }
+
+                total_num_read = extractor.Extract(reader->GetReadStartPosition(), reader->GetReadDuration());
+                if (extractor.ReadError()) {
+                    log_error("A read error occurred: %s\n", extractor.ReadErrorMessage().c_str());
+                    cmd_result = 1;
                 }
-                if (growing_file && gf_retry_count > 0) {
+            }
+            while (!use_ess_threads)
+            {
+                uint32_t num_read;
+                if (gf_follower)
+                    num_read = gf_follower->Read(max_samples_per_read);
+                else
+                    num_read = reader->Read(max_samples_per_read);
+                if (num_read == 0)
+                    break;
+                if (gf_follower && gf_follower->HaveWaited()) {
+                    gf_read_failure     = true;
                     gf_failure_num_read = total_num_read;
                     gf_failure_start    = get_tick_count();
-                    gf_retry_count      = 0;
                 }
                 total_num_read += num_read;
 
@@ -3033,45 +3319,11 @@ int main(int argc, const char** argv)
                             write_index(info_writer, total_num_read - num_read, i, frame);
                         }
 
-                        if (ess_output_prefix) {
-                            FILE *file;
-                            string filename;
-                            const MXFSoundTrackInfo *sound_info = dynamic_cast<const MXFSoundTrackInfo*>(track_info);
-                            if (sound_info && deinterleave && sound_info->channel_count > 1) {
-                                sound_buffer.Allocate(frame->GetSize()); // more than enough
-                                uint32_t c;
-                                for (c = 0; c < sound_info->channel_count; c++) {
-                                    if (sound_info->essence_type == D10_AES3_PCM) {
-                                        convert_aes3_to_pcm(frame->GetBytes(), frame->GetSize(), false,
-                                                            sound_info->bits_per_sample, c,
-                                                            sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(sound_info->block_align / sound_info->channel_count *
-                                                                get_aes3_sample_count(frame->GetBytes(), frame->GetSize()));
-                                    } else {
-                                        deinterleave_audio(frame->GetBytes(), frame->GetSize(),
-                                                           sound_info->bits_per_sample, sound_info->channel_count, c,
-                                                           sound_buffer.GetBytes(), sound_buffer.GetAllocatedSize());
-                                        sound_buffer.SetSize(frame->GetSize() / sound_info->channel_count);
-                                    }
-                                    output_file_manager.GetTrackFile(i, c, &file, &filename);
-                                    write_data(file, filename,
-                                               sound_buffer.GetBytes(), sound_buffer.GetSize(),
-                                               (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
-                                               &frame->element_key);
-                                }
-                            } else if (track_info->essence_type != TIMED_TEXT) {  // timed text is written at the end
-                                output_file_manager.GetTrackFile(i, &file, &filename);
-
-                                uint32_t frame_size = frame->GetSize();
-                                //printf("%d -> %d [%s]\n", i, frame_size, filename.c_str());
-
-                                write_data(file,
-                                           filename,
-                                           frame->GetBytes(),
-                                           frame_size,
-                                           (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
-                                           &frame->element_key);
-                            }
+                        if (ess_output_prefix && track_info->essence_type != TIMED_TEXT) {  // timed text is written at the end
+                            OutputFileManager::WriteFrame(output_file_manager.GetTrackFiles(i), track_info, frame,
+                                                          deinterleave,
+                                                          (wrap_klv_mask.find(track_info->data_def) != wrap_klv_mask.end()),
+                                                          &sound_buffer);
                         }
 
                         if (track_info->essence_type == ANC_DATA && rdd6_filename && !rdd6_failed && !rdd6_done) {
@@ -3120,7 +3372,7 @@ int main(int argc, const char** argv)
             if (reader->ReadError()) {
                 bmx::log(reader->IsComplete() ? ERROR_LOG : WARN_LOG,
                          "A read error occurred: %s\n", reader->ReadErrorMessage().c_str());
-                if (gf_retry_count >= gf_retries)
+                if (gf_follower && gf_follower->ReachedMaxWaits())
                     log_warn("Reached maximum growing file retries, %u\n", gf_retries);
                 if (reader->IsComplete())
                     cmd_result = 1;
@@ -80,6 +80,7 @@
 #include <bmx/Utils.h>
 #include <bmx/Version.h>
 #include <bmx/apps/AppUtils.h>
+#include <bmx/apps/AppMXFFileFactory.h>
 #include <bmx/apps/TimedTextManifestParser.h>
 #include <bmx/as11/AS11Labels.h>
 #include <bmx/as10/AS10ShimNames.h>
@@ -142,6 +143,8 @@ struct RawInput
     uint32_t klv_track_num;
     const char *file_pattern;
     bool fill_pattern_gaps;
+    uint32_t pattern_prefetch;
+    bool pattern_frame_files;
 
     int64_t output_start_offset;
     int64_t output_end_offset;
@@ -282,6 +285,8 @@ static bool open_raw_reader(RawInput *input)
         essence_source = file_source;
     } else {
         FilePatternEssenceSource *file_pattern_source = new FilePatternEssenceSource(input->fill_pattern_gaps);
+        if (input->pattern_prefetch > 0)
+            file_pattern_source->SetPrefetch(input->pattern_prefetch);
         if (!file_pattern_source->Open(input->file_pattern, input->file_start_offset)) {
             log_error("Failed to open file pattern '%s' at start offset %" PRId64 ": %s\n",
                     input->file_pattern, input->file_start_offset, file_pattern_source->GetStrError().c_str());
@@ -329,6 +334,12 @@ static bool open_raw_reader(RawInput *input)
     }
     if (input->ess_max_length > 0)
         input->raw_reader->SetMaxReadLength(input->ess_max_length);
+    if (input->pattern_frame_files) {
+        if (input->parse_klv)
+            log_warn("Ignoring --pattern-frame-files for KLV wrapped input\n");
+        else
+            input->raw_reader->SetSampleSizeFromSource(true);
+    }
 
     return true;
 }
@@ -447,6 +458,17 @@ static void usage(const char *cmd)
     fprintf(stderr, "  --dur <frame>           Set the duration in frames in frame rate units. Default is minimum input duration\n");
     fprintf(stderr, "  --rt <factor>           Wrap at realtime rate x <factor>, where <factor> is a floating point value\n");
     fprintf(stderr, "                          <factor> value 1.0 results in realtime rate, value < 1.0 slower and > 1.0 faster\n");
+#if !defined(_WIN32)
+    fprintf(stderr, "  --cache-hint <mode>     Set the page cache hint for the output MXF files. <mode> is one of the following:\n");
+    fprintf(stderr, "                            'none': (default) no hint\n");
+    fprintf(stderr, "                            'seq': sequential access\n");
+    fprintf(stderr, "                            'stream': data more than a window behind the write position is dropped\n");
+    fprintf(stderr, "                                      This bounds the page cache used by each file to about 2 windows\n");
+    fprintf(stderr, "  --cache-window <mib>    Set the window size in MiB for --cache-hint. The default is %u\n",
+            MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW / (1024 * 1024));
+    fprintf(stderr, "  --cache-sync            Write back output file data before it is dropped with '--cache-hint stream'\n");
+    fprintf(stderr, "                          Otherwise written data is only dropped once the kernel has written it back\n");
+#endif
     fprintf(stderr, "  --avcihead <format> <file> <offset>\n");
     fprintf(stderr, "                          Default AVC-Intra sequence header data (512 bytes) to use when the input file does not have it\n");
     fprintf(stderr, "                          <format> is a comma separated list of one or more of the following integer values:\n");
@@ -564,6 +586,8 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --loose-checks          Don't stop processing on detected compliancy violations\n");
     fprintf(stderr, "    --print-checks          Print default values of mpeg descriptors and report on descriptors either found in mpeg headers or copied from mxf headers\n");
     fprintf(stderr, "    --max-same-warnings <value>  Max same violations warnings logged, default 3\n");
+    fprintf(stderr, "    --mpeg-checks-thread <size>  Run the mpeg compliancy checks on a separate thread with a queue of up to <size> frames\n");
+    fprintf(stderr, "    --mpeg-checks-gop <n>   Only check the frames in every <n>th GOP. Default is 1, i.e. check all GOPs\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "  as11op1a/as11d10/op1a/d10/rdd9/as10:\n");
     fprintf(stderr, "    --mp-uid <umid>         Set the Material Package UID. Autogenerated by default\n");
@@ -602,6 +626,9 @@ static void usage(const char *cmd)
     fprintf(stderr, "    --avid-gf-dur <dur>     Set the duration which should be shown whilst the file is growing\n");
     fprintf(stderr, "                            Avid will show 'Capture in Progress' when this option is used\n");
     fprintf(stderr, "\n");
+    fprintf(stderr, "  as02/avid:\n");
+    fprintf(stderr, "    --track-threads <size>  Write each track file on its own thread with a queue of up to <size> sample writes\n");
+    fprintf(stderr, "\n");
     fprintf(stderr, "  op1a/avid:\n");
     fprintf(stderr, "    --force-no-avci-head    Strip AVCI header (512 bytes, sequence and picture parameter sets) if present\n");
     fprintf(stderr, "\n");
@@ -689,6 +716,9 @@ static void usage(const char *cmd)
     fprintf(stderr, "                            - optional '0x' followed by 8 hexadecimal characters which represents the 4-byte track number part of a generic container essence Key\n");
     fprintf(stderr, "                            - 32 hexadecimal characters representing a 16-byte Key\n");
     fprintf(stderr, "  --fill-pattern-gaps     Fill gaps in a numbered sequence pattern of raw files by repeating the contents of the file at the start of a gap\n");
+    fprintf(stderr, "  --pattern-prefetch <n>  Read up to <n> files ahead in a numbered sequence pattern of raw files using <n> threads\n");
+    fprintf(stderr, "  --pattern-frame-files   Each file in a numbered sequence pattern of raw files contains a single frame\n");
+    fprintf(stderr, "                          The file size is used as the frame size and the essence is not parsed to find frame boundaries\n");
     fprintf(stderr, "  --track-num <num>       Set the output track number. Default track number equals last track number of same picture/sound type + 1\n");
     fprintf(stderr, "                          For as11d10/d10 the track number must be > 0 and <= 8 because the AES-3 channel index equals track number - 1\n");
     fprintf(stderr, "  --avci-guess <i/p>      Guess interlaced ('i') or progressive ('p') AVC-Intra when using the --avci option with 1080p25/i50 or 1080p30/i60\n");
@@ -873,6 +903,8 @@ int main(int argc, const char** argv)
     bool mpeg_descr_frame_checks = true;
     int max_mpeg_check_same_warn_messages = 3;
     bool print_mpeg_checks = false;
+    uint32_t mpeg_checks_thread_queue_size = 0;
+    uint32_t mpeg_checks_gop_interval = 1;
     bool as10_loose_checks = true;
     const char *output_name = "";
     map<EssenceType, string> filename_essence_type_names;
@@ -911,6 +943,11 @@ int main(int argc, const char** argv)
     vector<AVCIHeaderInput> avci_header_inputs;
     bool single_pass = false;
     bool file_md5 = false;
+#if !defined(_WIN32)
+    int cache_hint_flags = MXF_POSIX_CACHE_HINT_DEFAULT;
+    uint32_t cache_window_mib = 0;
+    bool cache_sync = false;
+#endif
     uint8_t d10_mute_sound_flags = 0;
     uint8_t d10_invalid_sound_flags = 0;
     const char *originator = DEFAULT_BEXT_ORIGINATOR;
@@ -944,6 +981,7 @@ int main(int argc, const char** argv)
     bool creation_date_set = false;
     bool ps_avcihead = false;
     bool avid_gf = false;
+    uint32_t track_threads_queue_size = 0;
     int64_t avid_gf_duration = -1;
     int64_t regtest_end = -1;
     bool have_anc = false;
@@ -1187,6 +1225,44 @@ int main(int argc, const char** argv)
             realtime = true;
             cmdln_index++;
         }
+#if !defined(_WIN32)
+        else if (strcmp(argv[cmdln_index], "--cache-hint") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (!parse_cache_hint(argv[cmdln_index + 1], &cache_hint_flags))
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-window") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &cache_window_mib) != 1 || cache_window_mib == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--cache-sync") == 0)
+        {
+            cache_sync = true;
+        }
+#endif
         else if (strcmp(argv[cmdln_index], "--avcihead") == 0)
         {
             if (cmdln_index + 3 >= argc)
@@ -1249,6 +1325,40 @@ int main(int argc, const char** argv)
         {
             print_mpeg_checks = true;
         }
+        else if (strcmp(argv[cmdln_index], "--mpeg-checks-thread") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            mpeg_checks_thread_queue_size = uvalue;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "--mpeg-checks-gop") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            mpeg_checks_gop_interval = uvalue;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--max-same-warnings") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -1781,6 +1891,23 @@ int main(int argc, const char** argv)
         {
             avid_gf = true;
         }
+        else if (strcmp(argv[cmdln_index], "--track-threads") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            track_threads_queue_size = uvalue;
+            cmdln_index++;
+        }
         else if (strcmp(argv[cmdln_index], "--avid-gf-dur") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -2656,6 +2783,29 @@ int main(int argc, const char** argv)
             input.fill_pattern_gaps = true;
             continue; // skip input reset at the end
         }
+        else if (strcmp(argv[cmdln_index], "--pattern-prefetch") == 0)
+        {
+            if (cmdln_index + 1 >= argc)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Missing argument for Option '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &uvalue) != 1 || uvalue == 0 || uvalue > 64)
+            {
+                usage(argv[0]);
+                fprintf(stderr, "Invalid value '%s' for Option '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            input.pattern_prefetch = uvalue;
+            cmdln_index++;
+            continue; // skip input reset at the end
+        }
+        else if (strcmp(argv[cmdln_index], "--pattern-frame-files") == 0)
+        {
+            input.pattern_frame_files = true;
+            continue; // skip input reset at the end
+        }
         else if (strcmp(argv[cmdln_index], "--track-num") == 0)
         {
             if (cmdln_index + 1 >= argc)
@@ -5055,7 +5205,13 @@ int main(int argc, const char** argv)
             if (avid_gf)
                 flavour |= AVID_GROWING_FILE_FLAVOUR;
         }
-        DefaultMXFFileFactory file_factory;
+        AppMXFFileFactory file_factory;
+#if !defined(_WIN32)
+        if (cache_sync)
+            cache_hint_flags |= MXF_POSIX_CACHE_HINT_SYNC_WRITES;
+        file_factory.SetCacheHints(MXF_POSIX_CACHE_HINT_DEFAULT, cache_hint_flags,
+                                   (int64_t)cache_window_mib * 1024 * 1024);
+#endif
         ClipWriter *clip = 0;
         switch (clip_type)
         {
@@ -5523,10 +5679,14 @@ int main(int argc, const char** argv)
                     if (mpeg_descr_frame_checks && (flavour & RDD9_AS10_FLAVOUR)) {
                         RDD9MPEG2LGTrack *rdd9_mpeglgtrack = dynamic_cast<RDD9MPEG2LGTrack*>(clip_track->GetRDD9Track());
                         if (rdd9_mpeglgtrack) {
-                            rdd9_mpeglgtrack->SetValidator(new AS10MPEG2Validator(as10_shim, mpeg_descr_defaults_name,
-                                                                                  max_mpeg_check_same_warn_messages,
-                                                                                  print_mpeg_checks,
-                                                                                  as10_loose_checks));
+                            AS10MPEG2Validator *validator = new AS10MPEG2Validator(as10_shim, mpeg_descr_defaults_name,
+                                                                                   max_mpeg_check_same_warn_messages,
+                                                                                   print_mpeg_checks,
+                                                                                   as10_loose_checks);
+                            validator->SetGOPSampleInterval(mpeg_checks_gop_interval);
+                            if (mpeg_checks_thread_queue_size > 0)
+                                validator->SetValidationThread(mpeg_checks_thread_queue_size);
+                            rdd9_mpeglgtrack->SetValidator(validator);
                         }
                     }
                     break;
@@ -5991,6 +6151,9 @@ int main(int argc, const char** argv)
 
         // create clip file(s) and write samples
 
+        if (track_threads_queue_size > 0 && (clip_type == CW_AS02_CLIP_TYPE || clip_type == CW_AVID_CLIP_TYPE))
+            clip->SetTrackWriterThreads(track_threads_queue_size);
+
         clip->PrepareWrite();
 
         // write samples
@@ -6038,6 +6201,9 @@ int main(int argc, const char** argv)
                     continue;
                 }
 
+                // multi-channel wave samples are split into pcm_channels once for all output tracks
+                vector<unsigned char*> pcm_channels;
+
                 size_t k;
                 for (k = 0; k < input_track->GetOutputTrackCount(); k++) {
                     OutputTrack *output_track = input_track->GetOutputTrack(k);
@@ -6049,13 +6215,26 @@ int main(int argc, const char** argv)
                         if (max_samples_per_read > 1 && num_samples > min_num_samples)
                             num_samples = min_num_samples;
                         if (input->essence_type == WAVE_PCM && input->channel_count > 1) {
-                            pcm_buffer.Allocate(input->raw_reader->GetSampleDataSize() / input->channel_count);
-                            deinterleave_audio(input->raw_reader->GetSampleData(), input->raw_reader->GetSampleDataSize(),
-                                               input->bits_per_sample, input->channel_count, input_channel_index,
-                                               pcm_buffer.GetBytes(), pcm_buffer.GetAllocatedSize());
-                            pcm_buffer.SetSize(input->raw_reader->GetSampleDataSize() / input->channel_count);
+                            uint32_t channel_size = input->raw_reader->GetSampleDataSize() / input->channel_count;
+                            if (pcm_channels.empty()) {
+                                pcm_buffer.Allocate(input->raw_reader->GetSampleDataSize());
+
+                                // channels not mapped to an output track are skipped
+                                pcm_channels.resize(input->channel_count, 0);
+                                size_t m;
+                                for (m = 0; m < input_track->GetOutputTrackCount(); m++) {
+                                    uint32_t c = input_track->GetInputChannelIndex(m);
+                                    BMX_ASSERT(c < input->channel_count);
+                                    pcm_channels[c] = pcm_buffer.GetBytes() + c * channel_size;
+                                }
+
+                                deinterleave_audio_channels(input->raw_reader->GetSampleData(),
+                                                            input->raw_reader->GetSampleDataSize(),
+                                                            input->bits_per_sample, input->channel_count,
+                                                            &pcm_channels[0], channel_size);
+                            }
                             output_track->WriteSamples(output_channel_index,
-                                                       pcm_buffer.GetBytes(), pcm_buffer.GetSize(),
+                                                       pcm_channels[input_channel_index], channel_size,
                                                        num_samples);
                         } else {
                             //log_info("Write Track %d\n", i);
@@ -1120,10 +1120,11 @@ int mxf_avid_get_product_version_item(MXFMetadataSet *set, const mxfKey *itemKey
     return 1;
 }
 
-int mxf_avid_read_index_table_segment_2(MXFFile *mxfFile, uint64_t segmentLen,
-                                        mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
-                                        mxf_add_index_entry *addIndexEntry, void *addIndexEntryData,
-                                        MXFIndexTableSegment **segment)
+static int read_index_table_segment(MXFFile *mxfFile, uint64_t segmentLen,
+                                    mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
+                                    mxf_add_index_entry *addIndexEntry, void *addIndexEntryData,
+                                    int skipIndexEntries, uint32_t *numIndexEntries,
+                                    MXFIndexTableSegment **segment)
 {
     MXFIndexTableSegment *newSegment = NULL;
     mxfLocalTag localTag;
@@ -1244,6 +1245,15 @@ int mxf_avid_read_index_table_segment_2(MXFFile *mxfFile, uint64_t segmentLen,
             case 0x3f0a:
                 /* NOTE: Avid ignores the local len and only looks at the index array len value */
                 actualLen = 0;
+                if (skipIndexEntries)
+                {
+                    CHK_OFAIL(mxf_read_uint32(mxfFile, &indexEntryArrayLen));
+                    CHK_OFAIL(mxf_read_uint32(mxfFile, &indexEntryLen));
+                    CHK_OFAIL(mxf_skip(mxfFile, (uint64_t)indexEntryArrayLen * indexEntryLen));
+                    actualLen = 8 + (uint64_t)indexEntryArrayLen * indexEntryLen;
+                    *numIndexEntries = indexEntryArrayLen;
+                    break;
+                }
                 if (newSegment->sliceCount > 0)
                 {
                     CHK_MALLOC_ARRAY_ORET(sliceOffset, uint32_t, newSegment->sliceCount);
@@ -1324,6 +1334,24 @@ fail:
     return 0;
 }
 
+int mxf_avid_read_index_table_segment_2(MXFFile *mxfFile, uint64_t segmentLen,
+                                        mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
+                                        mxf_add_index_entry *addIndexEntry, void *addIndexEntryData,
+                                        MXFIndexTableSegment **segment)
+{
+    return read_index_table_segment(mxfFile, segmentLen, addDeltaEntry, addDeltaEntryData,
+                                    addIndexEntry, addIndexEntryData, 0, NULL, segment);
+}
+
+int mxf_avid_read_index_table_segment_header(MXFFile *mxfFile, uint64_t segmentLen,
+                                             mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
+                                             uint32_t *numIndexEntries, MXFIndexTableSegment **segment)
+{
+    *numIndexEntries = 0;
+    return read_index_table_segment(mxfFile, segmentLen, addDeltaEntry, addDeltaEntryData,
+                                    NULL, NULL, 1, numIndexEntries, segment);
+}
+
 int mxf_avid_read_index_table_segment(MXFFile *mxfFile, uint64_t segmentLen, MXFIndexTableSegment **segment)
 {
     CHK_ORET(mxf_avid_read_index_table_segment_2(mxfFile, segmentLen, mxf_default_add_delta_entry, NULL,
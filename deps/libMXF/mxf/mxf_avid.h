@@ -136,6 +136,10 @@ int mxf_avid_read_index_table_segment_2(MXFFile *mxfFile, uint64_t segmentLen,
                                         mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
                                         mxf_add_index_entry *addIndexEntry, void *addIndexEntryData,
                                         MXFIndexTableSegment **segment);
+/* reads the index table segment without the index entries, which are skipped over, and returns the entry count */
+int mxf_avid_read_index_table_segment_header(MXFFile *mxfFile, uint64_t segmentLen,
+                                             mxf_add_delta_entry *addDeltaEntry, void *addDeltaEntryData,
+                                             uint32_t *numIndexEntries, MXFIndexTableSegment **segment);
 
 
 int mxf_avid_is_mjpeg_essence_element(const mxfKey *key);
@@ -381,6 +381,25 @@ int64_t mxf_file_size(MXFFile *mxfFile)
     return mxfFile->size(mxfFile->sysData);
 }
 
+int mxf_file_read_ref(MXFFile *mxfFile, uint32_t count, const uint8_t **data, MXFFileDataRef **ref)
+{
+    /* returns 0 if the file doesn't support it or the data isn't available in one block, in which case
+       the file position is unchanged and mxf_file_read should be used instead */
+    if (!mxfFile->read_ref)
+        return 0;
+
+    return mxfFile->read_ref(mxfFile->sysData, count, data, ref);
+}
+
+void mxf_file_release_ref(MXFFileDataRef **ref)
+{
+    if (!(*ref))
+        return;
+
+    (*ref)->release(*ref);
+    *ref = NULL;
+}
+
 
 void mxf_file_set_min_llen(MXFFile *mxfFile, uint8_t llen)
 {
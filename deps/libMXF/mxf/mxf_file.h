@@ -46,6 +46,14 @@ extern "C"
 
 typedef struct MXFFileSysData MXFFileSysData;
 
+/* A reference to file data returned by mxf_file_read_ref. The data remains valid until the reference
+   is released, which may happen after the file has been closed */
+typedef struct MXFFileDataRef MXFFileDataRef;
+struct MXFFileDataRef
+{
+    void (*release)(MXFFileDataRef *ref);
+};
+
 typedef struct
 {
     /* MXF file implementations must set and implement these functions */
@@ -69,6 +77,11 @@ typedef struct
     uint16_t runinLen;
     uint8_t *zerosBuffer;
     uint32_t zerosBufferSize;
+
+    /* MXF file implementations can optionally implement this function to provide direct access to
+       file data, e.g. memory mapped data, instead of copying it */
+    int         (*read_ref)     (MXFFileSysData *sysData, uint32_t count, const uint8_t **data,
+                                 MXFFileDataRef **ref);
 } MXFFile;
 
 
@@ -92,6 +105,8 @@ int mxf_file_seek(MXFFile *mxfFile, int64_t offset, int whence);
 int64_t mxf_file_tell(MXFFile *mxfFile);
 int mxf_file_is_seekable(MXFFile *mxfFile);
 int64_t mxf_file_size(MXFFile *mxfFile);
+int mxf_file_read_ref(MXFFile *mxfFile, uint32_t count, const uint8_t **data, MXFFileDataRef **ref);
+void mxf_file_release_ref(MXFFileDataRef **ref);
 
 
 void mxf_file_set_min_llen(MXFFile *mxfFile, uint8_t llen);
@@ -45,6 +45,17 @@
 #include <mxf/mxf_macros.h>
 
 
+/* a set's item index is only created once the linear search through the items list becomes costly */
+#define ITEM_INDEX_MIN_ITEMS    8
+
+
+typedef struct
+{
+    mxfKey key;
+    MXFList sets;
+} SetKeyBucket;
+
+
 
 static void free_metadata_item_value(MXFMetadataItem *item)
 {
@@ -99,6 +110,143 @@ static int eq_pointer(void *data, void *info)
     return data == info;
 }
 
+static int compare_set_instanceuid(void *left, void *right)
+{
+    return memcmp(&((MXFMetadataSet*)left)->instanceUID, &((MXFMetadataSet*)right)->instanceUID, sizeof(mxfUUID));
+}
+
+static int compare_set_key_bucket(void *left, void *right)
+{
+    return memcmp(&((SetKeyBucket*)left)->key, &((SetKeyBucket*)right)->key, sizeof(mxfKey));
+}
+
+static int compare_item_key(void *left, void *right)
+{
+    return memcmp(&((MXFMetadataItem*)left)->key, &((MXFMetadataItem*)right)->key, sizeof(mxfKey));
+}
+
+static void free_set_key_bucket_in_tree(void *data)
+{
+    SetKeyBucket *bucket;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    bucket = (SetKeyBucket*)data;
+    mxf_clear_list(&bucket->sets);
+    free(bucket);
+}
+
+static int index_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
+{
+    SetKeyBucket bucketKey;
+    SetKeyBucket *bucket;
+    int isDuplicate;
+
+    /* mxf_dereference returns the first set added with a given instance UID */
+    isDuplicate = (mxf_tree_find(&headerMetadata->setIndex, set) != NULL);
+    if (isDuplicate)
+    {
+        headerMetadata->numDuplicateUIDs++;
+    }
+    else
+    {
+        CHK_ORET(mxf_tree_insert(&headerMetadata->setIndex, set));
+    }
+
+    bucketKey.key = set->key;
+    bucket = (SetKeyBucket*)mxf_tree_find(&headerMetadata->setKeyIndex, &bucketKey);
+    if (bucket == NULL)
+    {
+        CHK_MALLOC_OFAIL(bucket, SetKeyBucket);
+        bucket->key = set->key;
+        mxf_initialise_list(&bucket->sets, NULL);
+        if (!mxf_tree_insert(&headerMetadata->setKeyIndex, bucket))
+        {
+            free(bucket);
+            goto fail;
+        }
+    }
+    CHK_OFAIL(mxf_append_list_element(&bucket->sets, (void*)set));
+
+    return 1;
+
+fail:
+    if (isDuplicate)
+    {
+        headerMetadata->numDuplicateUIDs--;
+    }
+    else
+    {
+        mxf_tree_remove(&headerMetadata->setIndex, set);
+    }
+    return 0;
+}
+
+/* must be called after the set has been removed from headerMetadata->sets */
+static void unindex_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
+{
+    SetKeyBucket bucketKey;
+    SetKeyBucket *bucket;
+    MXFMetadataSet *indexedSet;
+
+    indexedSet = (MXFMetadataSet*)mxf_tree_find(&headerMetadata->setIndex, set);
+    if (indexedSet == set)
+    {
+        mxf_tree_remove(&headerMetadata->setIndex, set);
+        if (headerMetadata->numDuplicateUIDs > 0)
+        {
+            /* index the next set with the same instance UID, if there is one */
+            indexedSet = (MXFMetadataSet*)mxf_find_list_element(&headerMetadata->sets, (void*)&set->instanceUID,
+                                                                set_eq_instanceuid);
+            if (indexedSet != NULL && mxf_tree_insert(&headerMetadata->setIndex, indexedSet))
+            {
+                headerMetadata->numDuplicateUIDs--;
+            }
+        }
+    }
+    else if (indexedSet != NULL)
+    {
+        headerMetadata->numDuplicateUIDs--;
+    }
+
+    bucketKey.key = set->key;
+    bucket = (SetKeyBucket*)mxf_tree_find(&headerMetadata->setKeyIndex, &bucketKey);
+    if (bucket != NULL)
+    {
+        mxf_remove_list_element(&bucket->sets, (void*)set, eq_pointer);
+        if (mxf_get_list_length(&bucket->sets) == 0)
+        {
+            mxf_tree_remove(&headerMetadata->setKeyIndex, bucket);
+        }
+    }
+}
+
+static int create_item_index(MXFMetadataSet *set)
+{
+    MXFListIterator iter;
+
+    CHK_ORET(mxf_tree_create(&set->itemIndex, 0, compare_item_key, NULL));
+
+    mxf_initialise_list_iter(&iter, &set->items);
+    while (mxf_next_list_iter_element(&iter))
+    {
+        MXFMetadataItem *item = (MXFMetadataItem*)mxf_get_iter_element(&iter);
+        if (mxf_tree_find(set->itemIndex, item) == NULL)
+        {
+            CHK_OFAIL(mxf_tree_insert(set->itemIndex, item));
+        }
+    }
+
+    return 1;
+
+fail:
+    mxf_tree_free(&set->itemIndex);
+    return 0;
+}
+
 static int get_or_create_set_item(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set,
                                   const mxfKey *itemKey, MXFMetadataItem **item)
 {
@@ -149,7 +297,31 @@ static int add_item(MXFMetadataSet *set, MXFMetadataItem *item)
         CHK_ORET(mxf_remove_item(item->set, &item->key, &removedItem));
     }
 
-    CHK_ORET(mxf_append_list_element(&set->items, (void*)item));
+    if (set->itemIndex != NULL)
+    {
+        /* mxf_get_item returns the first item added with a given key */
+        if (mxf_tree_find(set->itemIndex, item) == NULL)
+        {
+            CHK_ORET(mxf_tree_insert(set->itemIndex, item));
+        }
+        if (!mxf_append_list_element(&set->items, (void*)item))
+        {
+            if (mxf_tree_find(set->itemIndex, item) == item)
+            {
+                mxf_tree_remove(set->itemIndex, item);
+            }
+            return 0;
+        }
+    }
+    else
+    {
+        CHK_ORET(mxf_append_list_element(&set->items, (void*)item));
+        if (mxf_get_list_length(&set->items) > ITEM_INDEX_MIN_ITEMS)
+        {
+            /* not having an index isn't an error */
+            create_item_index(set);
+        }
+    }
     item->set = set;
 
     return 1;
@@ -403,6 +575,8 @@ int mxf_create_header_metadata(MXFHeaderMetadata **headerMetadata, MXFDataModel
     memset(newHeaderMetadata, 0, sizeof(MXFHeaderMetadata));
     newHeaderMetadata->dataModel = dataModel;
     mxf_initialise_list(&newHeaderMetadata->sets, free_metadata_set_in_list);
+    mxf_tree_init(&newHeaderMetadata->setIndex, 0, compare_set_instanceuid, NULL);
+    mxf_tree_init(&newHeaderMetadata->setKeyIndex, 0, compare_set_key_bucket, free_set_key_bucket_in_tree);
     CHK_OFAIL(mxf_create_primer_pack(&newHeaderMetadata->primerPack));
 
     *headerMetadata = newHeaderMetadata;
@@ -431,6 +605,10 @@ int mxf_create_set(MXFHeaderMetadata *headerMetadata, const mxfKey *key, MXFMeta
     return 1;
 
 fail:
+    if (newSet->headerMetadata != NULL)
+    {
+        mxf_remove_set(newSet->headerMetadata, newSet);
+    }
     mxf_free_set(&newSet);
     return 0;
 }
@@ -462,6 +640,8 @@ void mxf_free_header_metadata(MXFHeaderMetadata **headerMetadata)
         return;
     }
 
+    mxf_tree_clear(&(*headerMetadata)->setIndex);
+    mxf_tree_clear(&(*headerMetadata)->setKeyIndex);
     mxf_clear_list(&(*headerMetadata)->sets);
     mxf_free_primer_pack(&(*headerMetadata)->primerPack);
     SAFE_FREE(*headerMetadata);
@@ -474,6 +654,7 @@ void mxf_free_set(MXFMetadataSet **set)
         return;
     }
 
+    mxf_tree_free(&(*set)->itemIndex);
     mxf_clear_list(&(*set)->items);
     SAFE_FREE(*set);
 }
@@ -503,7 +684,12 @@ int mxf_add_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
         CHK_ORET(mxf_remove_set(set->headerMetadata, set));
     }
 
-    CHK_ORET(mxf_append_list_element(&headerMetadata->sets, (void*)set));
+    CHK_ORET(index_set(headerMetadata, set));
+    if (!mxf_append_list_element(&headerMetadata->sets, (void*)set))
+    {
+        unindex_set(headerMetadata, set);
+        return 0;
+    }
     set->headerMetadata = headerMetadata;
 
     return 1;
@@ -562,6 +748,7 @@ int mxf_remove_set(MXFHeaderMetadata *headerMetadata, MXFMetadataSet *set)
 
     if ((result = mxf_remove_list_element(&headerMetadata->sets, (void*)set, eq_pointer)) != NULL)
     {
+        unindex_set(headerMetadata, set);
         set->headerMetadata = NULL;
         return 1;
     }
@@ -576,6 +763,17 @@ int mxf_remove_item(MXFMetadataSet *set, const mxfKey *itemKey, MXFMetadataItem
     if ((result = mxf_remove_list_element(&set->items, (void*)itemKey, item_eq_key)) != NULL)
     {
         *item = (MXFMetadataItem*)result;
+        if (set->itemIndex != NULL)
+        {
+            mxf_tree_remove(set->itemIndex, *item);
+            /* index the next item with the same key, if there is one */
+            result = mxf_find_list_element(&set->items, (void*)itemKey, item_eq_key);
+            if (result != NULL && !mxf_tree_insert(set->itemIndex, result))
+            {
+                /* fall back to searching the items list */
+                mxf_tree_free(&set->itemIndex);
+            }
+        }
         (*item)->set = NULL;
         return 1;
     }
@@ -587,16 +785,19 @@ int mxf_find_set_by_key(MXFHeaderMetadata *headerMetadata, const mxfKey *key, MX
 {
     MXFListIterator iter;
     MXFList *newList = NULL;
+    SetKeyBucket bucketKey;
+    SetKeyBucket *bucket;
 
     CHK_ORET(mxf_create_list(&newList, NULL)); /* free func == NULL because newList doesn't own the data */
 
-    mxf_initialise_list_iter(&iter, &headerMetadata->sets);
-    while (mxf_next_list_iter_element(&iter))
+    bucketKey.key = *key;
+    bucket = (SetKeyBucket*)mxf_tree_find(&headerMetadata->setKeyIndex, &bucketKey);
+    if (bucket != NULL)
     {
-        MXFMetadataSet *set = (MXFMetadataSet*)mxf_get_iter_element(&iter);
-        if (mxf_equals_key(key, &set->key))
+        mxf_initialise_list_iter(&iter, &bucket->sets);
+        while (mxf_next_list_iter_element(&iter))
         {
-            CHK_OFAIL(mxf_append_list_element(newList, (void*)set));
+            CHK_OFAIL(mxf_append_list_element(newList, mxf_get_iter_element(&iter)));
         }
     }
 
@@ -637,8 +838,18 @@ fail:
 int mxf_get_item(MXFMetadataSet *set, const mxfKey *key, MXFMetadataItem **resultItem)
 {
     void *result;
+    MXFMetadataItem keyItem;
 
-    if ((result = mxf_find_list_element(&set->items, (void*)key, item_eq_key)) != NULL)
+    if (set->itemIndex != NULL)
+    {
+        keyItem.key = *key;
+        result = mxf_tree_find(set->itemIndex, &keyItem);
+    }
+    else
+    {
+        result = mxf_find_list_element(&set->items, (void*)key, item_eq_key);
+    }
+    if (result != NULL)
     {
         *resultItem = (MXFMetadataItem*)result;
         return 1;
@@ -1407,8 +1618,10 @@ int mxf_get_weakref(MXFHeaderMetadata *headerMetadata, const uint8_t *value, MXF
 int mxf_dereference(MXFHeaderMetadata *headerMetadata, const mxfUUID *uuid, MXFMetadataSet **set)
 {
     void *result;
+    MXFMetadataSet keySet;
 
-    if ((result = mxf_find_list_element(&headerMetadata->sets, (void*)uuid, set_eq_instanceuid)) == NULL)
+    keySet.instanceUID = *uuid;
+    if ((result = mxf_tree_find(&headerMetadata->setIndex, &keySet)) == NULL)
     {
         return 0;
     }
@@ -1441,56 +1654,13 @@ int mxf_get_weakref_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIt
     return mxf_dereference_s(headerMetadata, setsIter, &uuid, set);
 }
 
-/* this will be faster is we de-reference multiple sets in the same order as they were written */
+/* the sets iterator is no longer used now that the sets are indexed by instance UID */
 int mxf_dereference_s(MXFHeaderMetadata *headerMetadata, MXFListIterator *setsIter, const mxfUUID *uuid,
                       MXFMetadataSet **set)
 {
-    MXFMetadataSet *setInList;
-    size_t startIndex = mxf_get_list_iter_index(setsIter);
-    MXFListIterator origSetsIter;
+    (void)setsIter;
 
-    mxf_copy_list_iter(setsIter, &origSetsIter);
-
-    /* try find it at the previous position in the list */
-    if (startIndex != MXF_LIST_NPOS)
-    {
-        setInList = (MXFMetadataSet*)mxf_get_iter_element(setsIter);
-        if (mxf_equals_uuid(uuid, &setInList->instanceUID))
-        {
-            *set = setInList;
-            return 1;
-        }
-    }
-
-    /* try find it starting from the previous position in the list */
-    while (mxf_next_list_iter_element(setsIter))
-    {
-        setInList = (MXFMetadataSet*)mxf_get_iter_element(setsIter);
-
-        if (mxf_equals_uuid(uuid, &setInList->instanceUID))
-        {
-            *set = setInList;
-            return 1;
-        }
-    }
-
-    /* go back to beginning and try find it before the previous position in the list */
-    mxf_initialise_sets_iter(headerMetadata, setsIter);
-    while (mxf_next_list_iter_element(setsIter) &&
-           (startIndex == MXF_LIST_NPOS || mxf_get_list_iter_index(setsIter) < startIndex))
-    {
-        setInList = (MXFMetadataSet*)mxf_get_iter_element(setsIter);
-
-        if (mxf_equals_uuid(uuid, &setInList->instanceUID))
-        {
-            *set = setInList;
-            return 1;
-        }
-    }
-
-    mxf_copy_list_iter(&origSetsIter, setsIter);
-
-    return 0;
+    return mxf_dereference(headerMetadata, uuid, set);
 }
 
 
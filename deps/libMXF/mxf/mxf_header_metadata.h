@@ -56,6 +56,7 @@ typedef struct MXFMetadataSet
     mxfKey key;
     mxfUUID instanceUID;
     MXFList items;
+    MXFTree *itemIndex;     /* items by key; only created once the set has more than a few items */
     struct MXFHeaderMetadata *headerMetadata;
     uint64_t fixedSpaceAllocation;
 } MXFMetadataSet;
@@ -65,6 +66,9 @@ typedef struct MXFHeaderMetadata
     MXFDataModel *dataModel;
     MXFPrimerPack *primerPack;
     MXFList sets;
+    MXFTree setIndex;       /* sets by instance UID. Only the first of any sets with the same UID is included */
+    MXFTree setKeyIndex;    /* lists of sets by set key */
+    size_t numDuplicateUIDs;
 } MXFHeaderMetadata;
 
 typedef struct
@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// sync_file_range is a GNU extension
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_cache_hint.h>
+#include <mxf/mxf_macros.h>
+
+
+#define MIN_WINDOW_SIZE     (1024 * 1024)     // 1 MB
+#define PAGE_ALIGNMENT      4096
+
+#define ALIGN_DOWN(v)       ((v) & ~((int64_t)PAGE_ALIGNMENT - 1))
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+#define HAVE_FADVISE        1
+#endif
+#if defined(__linux__) && defined(SYNC_FILE_RANGE_WRITE)
+#define HAVE_SYNC_RANGE     1
+#endif
+
+
+typedef enum
+{
+    NEW_MODE,
+    READ_MODE,
+    MODIFY_MODE,
+} OpenMode;
+
+struct MXFFileSysData
+{
+    FILE *file;
+    int fd;
+    OpenMode mode;
+    int flags;
+
+    int64_t windowSize;
+    int64_t chunkSize;          // minimum size of a range that is advised or dropped
+
+    int64_t position;
+    int64_t runStart;           // start of the current run that has not been dropped
+    int64_t runEnd;             // furthest position reached in the current run
+    int64_t willNeedEnd;        // end of the range advised as needed
+    int64_t writeBackEnd;       // end of the range for which write back was started
+};
+
+
+
+static void advise(MXFFileSysData *sysData, int64_t offset, int64_t len, int advice)
+{
+#if defined(HAVE_FADVISE)
+    // advice is only a hint and so failure is ignored
+    posix_fadvise(sysData->fd, (off_t)offset, (off_t)len, advice);
+#else
+    (void)sysData;
+    (void)offset;
+    (void)len;
+    (void)advice;
+#endif
+}
+
+static void sync_range(MXFFileSysData *sysData, int64_t offset, int64_t len, int wait)
+{
+#if defined(HAVE_SYNC_RANGE)
+    unsigned int syncFlags = SYNC_FILE_RANGE_WRITE;
+    if (wait)
+        syncFlags |= SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WAIT_AFTER;
+    sync_file_range(sysData->fd, (off64_t)offset, (off64_t)len, syncFlags);
+#else
+    (void)sysData;
+    (void)offset;
+    (void)len;
+    (void)wait;
+#endif
+}
+
+static void drop_range(MXFFileSysData *sysData, int64_t offset, int64_t len)
+{
+    if (sysData->mode != READ_MODE && (sysData->flags & MXF_POSIX_CACHE_HINT_SYNC_WRITES))
+        sync_range(sysData, offset, len, 1);
+#if defined(HAVE_FADVISE)
+    advise(sysData, offset, len, POSIX_FADV_DONTNEED);
+#endif
+}
+
+static void update_hints(MXFFileSysData *sysData)
+{
+    int64_t position = sysData->position;
+    int64_t end;
+
+    // only the first access to data extends the run, e.g. patching a KL behind the write position doesn't
+    if (position <= sysData->runEnd)
+        return;
+    sysData->runEnd = position;
+
+#if defined(HAVE_FADVISE)
+    if (sysData->mode == READ_MODE && position + sysData->windowSize / 2 > sysData->willNeedEnd) {
+        int64_t start = position;
+        if (start < sysData->willNeedEnd)
+            start = sysData->willNeedEnd;
+        end = position + sysData->windowSize;
+        advise(sysData, start, end - start, POSIX_FADV_WILLNEED);
+        sysData->willNeedEnd = end;
+    }
+#endif
+
+    if (!(sysData->flags & MXF_POSIX_CACHE_HINT_STREAMING))
+        return;
+
+    // start write back early so that it has (mostly) completed when the data is dropped
+    if (sysData->mode != READ_MODE && (sysData->flags & MXF_POSIX_CACHE_HINT_SYNC_WRITES)) {
+        end = ALIGN_DOWN(position - sysData->windowSize / 2);
+        if (end - sysData->writeBackEnd >= sysData->chunkSize) {
+            sync_range(sysData, sysData->writeBackEnd, end - sysData->writeBackEnd, 0);
+            sysData->writeBackEnd = end;
+        }
+    }
+
+    end = ALIGN_DOWN(position - sysData->windowSize);
+    if (end - sysData->runStart >= sysData->chunkSize) {
+        drop_range(sysData, sysData->runStart, end - sysData->runStart);
+        sysData->runStart = end;
+    }
+}
+
+static void start_run(MXFFileSysData *sysData, int64_t position)
+{
+    if ((sysData->flags & MXF_POSIX_CACHE_HINT_STREAMING) && sysData->runEnd > sysData->runStart)
+        drop_range(sysData, sysData->runStart, sysData->runEnd - sysData->runStart);
+
+    sysData->runStart     = position;
+    sysData->runEnd       = position;
+    sysData->willNeedEnd  = position;
+    sysData->writeBackEnd = ALIGN_DOWN(position);
+}
+
+
+static void hint_file_close(MXFFileSysData *sysData)
+{
+    if (!sysData->file)
+        return;
+
+    if (sysData->flags & MXF_POSIX_CACHE_HINT_STREAMING) {
+        fflush(sysData->file);
+        if (sysData->mode != READ_MODE && (sysData->flags & MXF_POSIX_CACHE_HINT_SYNC_WRITES))
+            sync_range(sysData, 0, 0, 1);
+#if defined(HAVE_FADVISE)
+        advise(sysData, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    }
+
+    fclose(sysData->file);
+    sysData->file = NULL;
+    sysData->fd   = -1;
+}
+
+static uint32_t hint_file_read(MXFFileSysData *sysData, uint8_t *data, uint32_t count)
+{
+    char errorBuf[128];
+    uint32_t result = (uint32_t)fread(data, 1, count, sysData->file);
+    if (result != count && ferror(sysData->file))
+        mxf_log_error("fread failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+
+    sysData->position += result;
+    update_hints(sysData);
+
+    return result;
+}
+
+static uint32_t hint_file_write(MXFFileSysData *sysData, const uint8_t *data, uint32_t count)
+{
+    char errorBuf[128];
+    uint32_t result = (uint32_t)fwrite(data, 1, count, sysData->file);
+    if (result != count)
+        mxf_log_error("fwrite failed: %s\n", mxf_strerror(errno, errorBuf, sizeof(errorBuf)));
+
+    sysData->position += result;
+    update_hints(sysData);
+
+    return result;
+}
+
+static int hint_file_getchar(MXFFileSysData *sysData)
+{
+    int c = fgetc(sysData->file);
+    if (c != EOF)
+        sysData->position++;
+    return c;
+}
+
+static int hint_file_putchar(MXFFileSysData *sysData, int c)
+{
+    int result = fputc(c, sysData->file);
+    if (result != EOF)
+        sysData->position++;
+    return result;
+}
+
+static int hint_file_eof(MXFFileSysData *sysData)
+{
+    return feof(sysData->file);
+}
+
+static int hint_file_seek(MXFFileSysData *sysData, int64_t offset, int whence)
+{
+    int64_t position;
+
+    if (fseeko(sysData->file, offset, whence) != 0)
+        return 0;
+
+    if (whence == SEEK_SET) {
+        position = offset;
+    } else if (whence == SEEK_CUR) {
+        position = sysData->position + offset;
+    } else {
+        position = ftello(sysData->file);
+        if (position < 0)
+            return 0;
+    }
+    sysData->position = position;
+
+    // a reader that moves away from the current run, e.g. to read the footer or to seek to a frame, starts a new
+    // run. Writers only move back to patch data and then return to the end of the file
+    if (sysData->mode == READ_MODE &&
+        (position < sysData->runStart || position > sysData->runEnd + sysData->windowSize))
+    {
+        start_run(sysData, position);
+    }
+
+    return 1;
+}
+
+static int64_t hint_file_tell(MXFFileSysData *sysData)
+{
+    return sysData->position;
+}
+
+static int hint_file_is_seekable(MXFFileSysData *sysData)
+{
+    (void)sysData;
+    return 1;
+}
+
+static int64_t hint_file_size(MXFFileSysData *sysData)
+{
+    struct stat statBuf;
+
+    // flush user-space data because fstat uses the stream's integer descriptor
+    if (sysData->mode == NEW_MODE || sysData->mode == MODIFY_MODE)
+        fflush(sysData->file);
+
+    if (fstat(sysData->fd, &statBuf) != 0)
+        return -1;
+
+    return statBuf.st_size;
+}
+
+static void free_hint_file(MXFFileSysData *sysData)
+{
+    free(sysData);
+}
+
+
+static int hint_file_open(const char *filename, int flags, int64_t windowSize, OpenMode mode, MXFFile **mxfFile)
+{
+    MXFFile *newMXFFile = NULL;
+    MXFFileSysData *newDiskFile = NULL;
+    struct stat statBuf;
+    FILE *file;
+
+    if (mode == NEW_MODE)
+        file = fopen(filename, "w+b");
+    else if (mode == READ_MODE)
+        file = fopen(filename, "rb");
+    else
+        file = fopen(filename, "r+b");
+    if (!file)
+        return 0;
+
+    if (fstat(fileno(file), &statBuf) != 0 || !S_ISREG(statBuf.st_mode)) {
+        // pipes etc. are handled by the standard disk file, which wraps them in a stream file
+        fclose(file);
+        if (mode == NEW_MODE)
+            return mxf_disk_file_open_new(filename, mxfFile);
+        else if (mode == READ_MODE)
+            return mxf_disk_file_open_read(filename, mxfFile);
+        else
+            return mxf_disk_file_open_modify(filename, mxfFile);
+    }
+
+    if (flags & MXF_POSIX_CACHE_HINT_STREAMING)
+        flags |= MXF_POSIX_CACHE_HINT_SEQUENTIAL;
+    if (windowSize <= 0)
+        windowSize = MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW;
+    else if (windowSize < MIN_WINDOW_SIZE)
+        windowSize = MIN_WINDOW_SIZE;
+
+    CHK_MALLOC_OFAIL(newMXFFile, MXFFile);
+    memset(newMXFFile, 0, sizeof(MXFFile));
+    CHK_MALLOC_OFAIL(newDiskFile, MXFFileSysData);
+    memset(newDiskFile, 0, sizeof(MXFFileSysData));
+
+    newDiskFile->file       = file;
+    newDiskFile->fd         = fileno(file);
+    newDiskFile->mode       = mode;
+    newDiskFile->flags      = flags;
+    newDiskFile->windowSize = windowSize;
+    newDiskFile->chunkSize  = windowSize / 4;
+
+#if defined(HAVE_FADVISE)
+    if (mode == READ_MODE && (flags & MXF_POSIX_CACHE_HINT_SEQUENTIAL))
+        advise(newDiskFile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    newMXFFile->close         = hint_file_close;
+    newMXFFile->read          = hint_file_read;
+    newMXFFile->write         = hint_file_write;
+    newMXFFile->get_char      = hint_file_getchar;
+    newMXFFile->put_char      = hint_file_putchar;
+    newMXFFile->eof           = hint_file_eof;
+    newMXFFile->seek          = hint_file_seek;
+    newMXFFile->tell          = hint_file_tell;
+    newMXFFile->is_seekable   = hint_file_is_seekable;
+    newMXFFile->size          = hint_file_size;
+    newMXFFile->free_sys_data = free_hint_file;
+    newMXFFile->sysData       = newDiskFile;
+
+    *mxfFile = newMXFFile;
+    return 1;
+
+fail:
+    fclose(file);
+    SAFE_FREE(newMXFFile);
+    SAFE_FREE(newDiskFile);
+    return 0;
+}
+
+
+int mxf_posix_cache_hint_open_new(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile)
+{
+    return hint_file_open(filename, flags, windowSize, NEW_MODE, mxfFile);
+}
+
+int mxf_posix_cache_hint_open_read(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile)
+{
+    return hint_file_open(filename, flags, windowSize, READ_MODE, mxfFile);
+}
+
+int mxf_posix_cache_hint_open_modify(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile)
+{
+    return hint_file_open(filename, flags, windowSize, MODIFY_MODE, mxfFile);
+}
+
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MXF_POSIX_CACHE_HINT_H_
+#define MXF_POSIX_CACHE_HINT_H_
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+#include <mxf/mxf_file.h>
+
+
+#define MXF_POSIX_CACHE_HINT_DEFAULT        0x00
+#define MXF_POSIX_CACHE_HINT_SEQUENTIAL     0x01
+#define MXF_POSIX_CACHE_HINT_STREAMING      0x02
+#define MXF_POSIX_CACHE_HINT_SYNC_WRITES    0x04
+
+#define MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW (32 * 1024 * 1024)
+
+
+/* A disk file that gives the kernel page cache hints as the file is accessed.
+   The sequential flag advises sequential access and requests the data in a window ahead of the read position.
+   The streaming flag implies sequential and in addition drops the data more than a window behind the furthest
+   read or write position from the page cache, as well as the whole file when it is closed. This bounds the
+   page cache used by the file to about 2 windows. Written data can only be dropped once it has been written
+   back; the sync writes flag starts write back half a window behind the write position and waits for it to
+   complete before dropping. Otherwise written data is left to the kernel's write back.
+   A windowSize of 0 selects MXF_POSIX_CACHE_HINT_DEFAULT_WINDOW. The hints are ignored where posix_fadvise is
+   not available. Files that are not regular files are opened as a standard disk file */
+
+int mxf_posix_cache_hint_open_new(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile);
+int mxf_posix_cache_hint_open_read(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile);
+int mxf_posix_cache_hint_open_modify(const char *filename, int flags, int64_t windowSize, MXFFile **mxfFile);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
+
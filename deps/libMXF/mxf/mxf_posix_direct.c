@@ -0,0 +1,614 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// O_DIRECT and fallocate are GNU extensions
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_direct.h>
+#include <mxf/mxf_macros.h>
+
+
+#define BUFFER_SIZE         (8 * 1024 * 1024)     // 8 MB
+#define BLOCK_ALIGNMENT     4096
+#define PATCH_BUFFER_SIZE   (64 * 1024)           // 64 KB
+
+#define ALIGN_DOWN(v)       ((v) & ~((int64_t)BLOCK_ALIGNMENT - 1))
+#define ALIGN_UP(v)         ALIGN_DOWN((v) + BLOCK_ALIGNMENT - 1)
+
+
+// A buffer holding a BUFFER_SIZE aligned window of the file
+typedef struct
+{
+    uint8_t *data;
+    int64_t offset;     // location of the window in the file
+    uint32_t size;      // number of valid bytes at the start of data
+    int dirty;
+} DirectBuffer;
+
+struct MXFFileSysData
+{
+    int fd;
+
+    int64_t preallocateSize;
+    int64_t position;
+    int64_t fileSize;           // logical file size; the file is truncated to this when closed
+
+    DirectBuffer buffers[2];
+    DirectBuffer *active;       // the buffer holding the window that is being written
+    uint8_t *patchData;         // aligned data for reading and writing before the active window
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    int haveThread;
+    int stopThread;
+    DirectBuffer *flushBuffer;  // the buffer being written by the thread
+    int flushError;             // errno value of the first failed write
+};
+
+
+static void log_errno(const char *operation, int errnum, const char *file, int line)
+{
+    char errorBuf[128];
+    mxf_log_error("%s failed: %s, in %s:%d\n", operation, mxf_strerror(errnum, errorBuf, sizeof(errorBuf)), file, line);
+}
+
+static int disable_direct_io(MXFFileSysData *sysData)
+{
+#if defined(O_DIRECT)
+    int flags = fcntl(sysData->fd, F_GETFL);
+    if (flags >= 0 && (flags & O_DIRECT)) {
+        // the file system accepted O_DIRECT at open but not for this write
+        if (fcntl(sysData->fd, F_SETFL, flags & ~O_DIRECT) == 0)
+            return 1;
+    }
+#else
+    (void)sysData;
+#endif
+    return 0;
+}
+
+static int write_fully(MXFFileSysData *sysData, const uint8_t *data, size_t size, int64_t offset)
+{
+    ssize_t result;
+
+    while (size > 0) {
+        result = pwrite(sysData->fd, data, size, (off_t)offset);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EINVAL && disable_direct_io(sysData))
+                continue;
+            return errno;
+        }
+        data   += result;
+        size   -= result;
+        offset += result;
+    }
+
+    return 0;
+}
+
+static ssize_t read_fully(MXFFileSysData *sysData, uint8_t *data, size_t size, int64_t offset)
+{
+    size_t total = 0;
+    ssize_t result;
+
+    while (total < size) {
+        result = pread(sysData->fd, data + total, size - total, (off_t)(offset + total));
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EINVAL && disable_direct_io(sysData))
+                continue;
+            return -1;
+        }
+        if (result == 0)
+            break;
+        total += result;
+    }
+
+    return (ssize_t)total;
+}
+
+static int flush_buffer(MXFFileSysData *sysData, DirectBuffer *buffer)
+{
+    uint32_t writeSize = (uint32_t)ALIGN_UP(buffer->size);
+
+    // the file is truncated to the logical size when closed
+    memset(buffer->data + buffer->size, 0, writeSize - buffer->size);
+
+    return write_fully(sysData, buffer->data, writeSize, buffer->offset);
+}
+
+static void* flush_thread(void *arg)
+{
+    MXFFileSysData *sysData = (MXFFileSysData*)arg;
+    DirectBuffer *buffer;
+    int result;
+
+    pthread_mutex_lock(&sysData->mutex);
+    while (1) {
+        while (!sysData->flushBuffer && !sysData->stopThread)
+            pthread_cond_wait(&sysData->cond, &sysData->mutex);
+        if (!sysData->flushBuffer)
+            break;
+
+        buffer = sysData->flushBuffer;
+        pthread_mutex_unlock(&sysData->mutex);
+
+        result = flush_buffer(sysData, buffer);
+        if (result)
+            log_errno("pwrite", result, __FILENAME__, __LINE__);
+
+        pthread_mutex_lock(&sysData->mutex);
+        if (result && !sysData->flushError)
+            sysData->flushError = result;
+        sysData->flushBuffer = NULL;
+        pthread_cond_broadcast(&sysData->cond);
+    }
+    pthread_mutex_unlock(&sysData->mutex);
+
+    return NULL;
+}
+
+// wait until the thread is no longer writing a buffer and return 0 if a write has failed
+static int wait_flush(MXFFileSysData *sysData)
+{
+    int flushError;
+
+    if (!sysData->haveThread)
+        return !sysData->flushError;
+
+    pthread_mutex_lock(&sysData->mutex);
+    while (sysData->flushBuffer)
+        pthread_cond_wait(&sysData->cond, &sysData->mutex);
+    flushError = sysData->flushError;
+    pthread_mutex_unlock(&sysData->mutex);
+
+    return !flushError;
+}
+
+static int start_flush(MXFFileSysData *sysData, DirectBuffer *buffer)
+{
+    int result;
+
+    buffer->dirty = 0;
+
+    if (!sysData->haveThread) {
+        if (pthread_create(&sysData->thread, NULL, flush_thread, sysData) == 0) {
+            sysData->haveThread = 1;
+        } else {
+            // fall back to writing synchronously
+            result = flush_buffer(sysData, buffer);
+            if (result) {
+                log_errno("pwrite", result, __FILENAME__, __LINE__);
+                sysData->flushError = result;
+                return 0;
+            }
+            return 1;
+        }
+    }
+
+    pthread_mutex_lock(&sysData->mutex);
+    sysData->flushBuffer = buffer;
+    pthread_cond_signal(&sysData->cond);
+    pthread_mutex_unlock(&sysData->mutex);
+
+    return 1;
+}
+
+// make the other buffer the active buffer, holding the window starting at offset, whilst
+// the current active buffer is written in the background
+static int switch_window(MXFFileSysData *sysData, int64_t offset)
+{
+    DirectBuffer *next = (sysData->active == &sysData->buffers[0] ? &sysData->buffers[1] : &sysData->buffers[0]);
+    uint32_t loadSize;
+    ssize_t numRead;
+
+    // the other buffer could still be in flight
+    if (!wait_flush(sysData))
+        return 0;
+
+    if (sysData->active->dirty && !start_flush(sysData, sysData->active))
+        return 0;
+
+    next->offset = offset;
+    next->size   = 0;
+    next->dirty  = 0;
+
+    // load existing data, e.g. when moving forward again after reading or patching an earlier window
+    if (offset < sysData->fileSize) {
+        if (sysData->fileSize - offset < BUFFER_SIZE)
+            loadSize = (uint32_t)(sysData->fileSize - offset);
+        else
+            loadSize = BUFFER_SIZE;
+
+        numRead = read_fully(sysData, next->data, (size_t)ALIGN_UP(loadSize), offset);
+        if (numRead < 0) {
+            log_errno("pread", errno, __FILENAME__, __LINE__);
+            return 0;
+        }
+        if ((uint32_t)numRead < loadSize)
+            memset(next->data + numRead, 0, loadSize - numRead);
+        next->size = loadSize;
+    }
+
+    sysData->active = next;
+
+    return 1;
+}
+
+// read or write data located before the active window using an aligned read-modify-write
+static uint32_t patch_io(MXFFileSysData *sysData, uint8_t *readData, const uint8_t *writeData, uint32_t count)
+{
+    int64_t blockStart;
+    uint32_t patchOffset;
+    uint32_t patchCount;
+    uint32_t ioSize;
+    ssize_t numRead;
+    int result;
+
+    // the data on disk must be up to date
+    if (!wait_flush(sysData))
+        return 0;
+
+    blockStart  = ALIGN_DOWN(sysData->position);
+    patchOffset = (uint32_t)(sysData->position - blockStart);
+    patchCount  = count;
+    if (patchCount > PATCH_BUFFER_SIZE - patchOffset)
+        patchCount = PATCH_BUFFER_SIZE - patchOffset;
+    if (patchCount > sysData->active->offset - sysData->position)
+        patchCount = (uint32_t)(sysData->active->offset - sysData->position);
+    ioSize = (uint32_t)ALIGN_UP(patchOffset + patchCount);
+
+    numRead = read_fully(sysData, sysData->patchData, ioSize, blockStart);
+    if (numRead < 0) {
+        log_errno("pread", errno, __FILENAME__, __LINE__);
+        return 0;
+    }
+    if ((uint32_t)numRead < ioSize)
+        memset(sysData->patchData + numRead, 0, ioSize - numRead);
+
+    if (readData) {
+        memcpy(readData, sysData->patchData + patchOffset, patchCount);
+    } else {
+        memcpy(sysData->patchData + patchOffset, writeData, patchCount);
+        result = write_fully(sysData, sysData->patchData, ioSize, blockStart);
+        if (result) {
+            log_errno("pwrite", result, __FILENAME__, __LINE__);
+            return 0;
+        }
+    }
+
+    return patchCount;
+}
+
+static void posix_direct_close(MXFFileSysData *sysData)
+{
+    int result;
+
+    if (sysData->fd < 0)
+        return;
+
+    wait_flush(sysData);
+    if (sysData->haveThread) {
+        pthread_mutex_lock(&sysData->mutex);
+        sysData->stopThread = 1;
+        pthread_cond_signal(&sysData->cond);
+        pthread_mutex_unlock(&sysData->mutex);
+        pthread_join(sysData->thread, NULL);
+        sysData->haveThread = 0;
+    }
+
+    if (sysData->active->dirty) {
+        result = flush_buffer(sysData, sysData->active);
+        if (result)
+            log_errno("pwrite", result, __FILENAME__, __LINE__);
+        sysData->active->dirty = 0;
+    }
+
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    // release blocks that were preallocated but not written
+    if (sysData->preallocateSize > ALIGN_UP(sysData->fileSize)) {
+        fallocate(sysData->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                  (off_t)ALIGN_UP(sysData->fileSize), (off_t)(sysData->preallocateSize - ALIGN_UP(sysData->fileSize)));
+    }
+#endif
+
+    // remove the padding written with the last block
+    if (ftruncate(sysData->fd, (off_t)sysData->fileSize) != 0)
+        log_errno("ftruncate", errno, __FILENAME__, __LINE__);
+
+    close(sysData->fd);
+    sysData->fd = -1;
+}
+
+static uint32_t posix_direct_read(MXFFileSysData *sysData, uint8_t *data, uint32_t count)
+{
+    DirectBuffer *active;
+    uint32_t totalRead = 0;
+    uint32_t bufferOffset;
+    uint32_t avail;
+
+    while (totalRead < count && sysData->position < sysData->fileSize) {
+        active = sysData->active;
+        if (sysData->position >= active->offset + BUFFER_SIZE) {
+            if (!switch_window(sysData, sysData->position - sysData->position % BUFFER_SIZE))
+                break;
+            continue;
+        }
+
+        avail = count - totalRead;
+        if (sysData->fileSize - sysData->position < avail)
+            avail = (uint32_t)(sysData->fileSize - sysData->position);
+
+        if (sysData->position >= active->offset) {
+            bufferOffset = (uint32_t)(sysData->position - active->offset);
+            if (bufferOffset >= active->size)
+                break;
+            if (avail > active->size - bufferOffset)
+                avail = active->size - bufferOffset;
+            memcpy(data + totalRead, active->data + bufferOffset, avail);
+        } else {
+            avail = patch_io(sysData, data + totalRead, NULL, avail);
+            if (avail == 0)
+                break;
+        }
+
+        sysData->position += avail;
+        totalRead += avail;
+    }
+
+    return totalRead;
+}
+
+static uint32_t posix_direct_write(MXFFileSysData *sysData, const uint8_t *data, uint32_t count)
+{
+    DirectBuffer *active;
+    uint32_t totalWritten = 0;
+    uint32_t bufferOffset;
+    uint32_t avail;
+
+    while (totalWritten < count) {
+        active = sysData->active;
+        if (sysData->position >= active->offset + BUFFER_SIZE) {
+            if (!switch_window(sysData, sysData->position - sysData->position % BUFFER_SIZE))
+                break;
+            continue;
+        }
+
+        avail = count - totalWritten;
+        if (sysData->position >= active->offset) {
+            bufferOffset = (uint32_t)(sysData->position - active->offset);
+            if (avail > BUFFER_SIZE - bufferOffset)
+                avail = BUFFER_SIZE - bufferOffset;
+            if (bufferOffset > active->size)
+                memset(active->data + active->size, 0, bufferOffset - active->size);
+            memcpy(active->data + bufferOffset, data + totalWritten, avail);
+            if (active->size < bufferOffset + avail)
+                active->size = bufferOffset + avail;
+            active->dirty = 1;
+        } else {
+            avail = patch_io(sysData, NULL, data + totalWritten, avail);
+            if (avail == 0)
+                break;
+        }
+
+        sysData->position += avail;
+        totalWritten += avail;
+    }
+
+    // move EOF, if data was written after the current EOF
+    if (sysData->fileSize < sysData->position)
+        sysData->fileSize = sysData->position;
+
+    return totalWritten;
+}
+
+static int posix_direct_getchar(MXFFileSysData *sysData)
+{
+    uint8_t data;
+
+    if (posix_direct_read(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_direct_putchar(MXFFileSysData *sysData, int c)
+{
+    uint8_t data = (uint8_t)c;
+    if (posix_direct_write(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_direct_eof(MXFFileSysData *sysData)
+{
+    return sysData->position >= sysData->fileSize;
+}
+
+static int posix_direct_seek(MXFFileSysData *sysData, int64_t offset, int whence)
+{
+    int64_t newPosition;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            newPosition = offset;
+            break;
+        case SEEK_CUR:
+            newPosition = sysData->position + offset;
+            break;
+        case SEEK_END:
+            newPosition = sysData->fileSize + offset;
+            break;
+        default:
+            return 0;
+    }
+
+    if (newPosition < 0)
+        return 0;
+
+    // the window is switched when the data is accessed
+    sysData->position = newPosition;
+
+    return 1;
+}
+
+static int64_t posix_direct_tell(MXFFileSysData *sysData)
+{
+    return sysData->position;
+}
+
+static int posix_direct_is_seekable(MXFFileSysData *sysData)
+{
+    (void)sysData;
+    return 1;
+}
+
+static int64_t posix_direct_size(MXFFileSysData *sysData)
+{
+    return sysData->fileSize;
+}
+
+static void free_posix_direct(MXFFileSysData *sysData)
+{
+    if (!sysData)
+        return;
+
+    pthread_cond_destroy(&sysData->cond);
+    pthread_mutex_destroy(&sysData->mutex);
+    free(sysData->buffers[0].data);
+    free(sysData->buffers[1].data);
+    free(sysData->patchData);
+    free(sysData);
+}
+
+static int alloc_aligned(uint8_t **data, size_t size)
+{
+    void *alignedData;
+
+    if (posix_memalign(&alignedData, BLOCK_ALIGNMENT, size) != 0) {
+        mxf_log_error("Failed to allocate aligned buffer, in %s:%d\n", __FILENAME__, __LINE__);
+        return 0;
+    }
+
+    *data = (uint8_t*)alignedData;
+    return 1;
+}
+
+int mxf_posix_direct_open_new(const char *filename, int64_t preallocateSize, MXFFile **mxfFile)
+{
+    MXFFile *newMXFFile = NULL;
+    MXFFileSysData *newDiskFile = NULL;
+    int fd;
+
+#if defined(O_DIRECT)
+    fd = open(filename, O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+    if (fd < 0 && errno == EINVAL) {
+        // the file system doesn't support direct I/O
+        fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    }
+#else
+    fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0666);
+#endif
+    if (fd < 0)
+        return 0;
+
+#if defined(F_NOCACHE)
+    fcntl(fd, F_NOCACHE, 1);
+#endif
+
+    CHK_MALLOC_OFAIL(newMXFFile, MXFFile);
+    memset(newMXFFile, 0, sizeof(MXFFile));
+    CHK_MALLOC_OFAIL(newDiskFile, MXFFileSysData);
+    memset(newDiskFile, 0, sizeof(MXFFileSysData));
+    newDiskFile->fd = -1;
+
+    pthread_mutex_init(&newDiskFile->mutex, NULL);
+    pthread_cond_init(&newDiskFile->cond, NULL);
+
+    CHK_OFAIL(alloc_aligned(&newDiskFile->buffers[0].data, BUFFER_SIZE));
+    CHK_OFAIL(alloc_aligned(&newDiskFile->buffers[1].data, BUFFER_SIZE));
+    CHK_OFAIL(alloc_aligned(&newDiskFile->patchData, PATCH_BUFFER_SIZE));
+
+    newDiskFile->fd     = fd;
+    newDiskFile->active = &newDiskFile->buffers[0];
+
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    // preallocation is an optimisation and so failure is ignored
+    if (preallocateSize > 0 && fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)preallocateSize) == 0)
+        newDiskFile->preallocateSize = preallocateSize;
+#else
+    (void)preallocateSize;
+#endif
+
+    newMXFFile->close         = posix_direct_close;
+    newMXFFile->read          = posix_direct_read;
+    newMXFFile->write         = posix_direct_write;
+    newMXFFile->get_char      = posix_direct_getchar;
+    newMXFFile->put_char      = posix_direct_putchar;
+    newMXFFile->eof           = posix_direct_eof;
+    newMXFFile->seek          = posix_direct_seek;
+    newMXFFile->tell          = posix_direct_tell;
+    newMXFFile->is_seekable   = posix_direct_is_seekable;
+    newMXFFile->size          = posix_direct_size;
+
+    newMXFFile->free_sys_data = free_posix_direct;
+    newMXFFile->sysData       = newDiskFile;
+
+    *mxfFile = newMXFFile;
+    return 1;
+
+fail:
+    close(fd);
+    free_posix_direct(newDiskFile);
+    SAFE_FREE(newMXFFile);
+    return 0;
+}
@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_mmap.h>
+#include <mxf/mxf_macros.h>
+
+
+#define DEFAULT_WINDOW_SIZE     (64 * 1024 * 1024)    // 64 MB
+#define FILE_GROW_CHUNK_SIZE    (32 * 1024 * 1024)    // 32 MB
+
+typedef enum
+{
+    NEW_MODE,
+    READ_MODE,
+    MODIFY_MODE,
+} OpenMode;
+
+// A mapped region of the file. The file holds a reference to the current window and each
+// reference returned by read_ref holds another, so that a window is only unmapped once it is no longer used
+typedef struct
+{
+    MXFFileDataRef ref;
+    int refCount;
+
+    uint64_t offset;    // location of data in file
+    uint8_t *data;      // pointer to memory mapped data
+    size_t size;        // number of bytes in data
+} MMapWindow;
+
+struct MXFFileSysData
+{
+    int fd;
+
+    OpenMode openMode;
+    int flags;
+
+    uint32_t pageSize;
+    uint32_t windowSize;
+
+    uint64_t diskFileSize;      // current file size on disk; will be increased in chunks when writing
+    uint64_t logicalFileSize;   // logical file size; file will be resized to this when closed
+
+    uint64_t position;
+    MMapWindow *window;
+};
+
+
+static void log_errno(const char *operation, int errnum, const char *file, int line)
+{
+    char errorBuf[128];
+    mxf_log_error("%s failed: %s, in %s:%d\n", operation, mxf_strerror(errnum, errorBuf, sizeof(errorBuf)), file, line);
+}
+
+static void release_window(MXFFileDataRef *ref)
+{
+    MMapWindow *window = (MMapWindow*)ref;
+
+    if (__atomic_sub_fetch(&window->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        munmap(window->data, window->size);
+        free(window);
+    }
+}
+
+static int update_file_size(MXFFileSysData *sysData)
+{
+    struct stat statBuf;
+
+    // a file opened for reading may still be growing
+    if (fstat(sysData->fd, &statBuf) != 0) {
+        log_errno("fstat", errno, __FILENAME__, __LINE__);
+        return 0;
+    }
+
+    sysData->diskFileSize    = statBuf.st_size;
+    sysData->logicalFileSize = statBuf.st_size;
+    return 1;
+}
+
+static int map_window(MXFFileSysData *sysData, uint32_t minSize)
+{
+    MMapWindow *newWindow;
+    uint64_t offset;
+    uint64_t mapSize;
+    int prot;
+    int mapFlags;
+    void *data;
+
+    offset  = sysData->position - sysData->position % sysData->pageSize;
+    mapSize = sysData->position - offset + minSize;
+    if (mapSize < sysData->windowSize)
+        mapSize = sysData->windowSize;
+
+    if (offset + mapSize > sysData->diskFileSize) {
+        if (sysData->openMode == READ_MODE) {
+            if (!update_file_size(sysData) || sysData->position + minSize > sysData->diskFileSize)
+                return 0;
+            if (offset + mapSize > sysData->diskFileSize)
+                mapSize = sysData->diskFileSize - offset;
+        } else {
+            // grow the file in chunks; file size increments in too small steps hurt the performance
+            uint64_t newDiskFileSize = offset + mapSize;
+            if (newDiskFileSize % FILE_GROW_CHUNK_SIZE)
+                newDiskFileSize += FILE_GROW_CHUNK_SIZE - newDiskFileSize % FILE_GROW_CHUNK_SIZE;
+            if (ftruncate(sysData->fd, (off_t)newDiskFileSize) != 0) {
+                log_errno("ftruncate", errno, __FILENAME__, __LINE__);
+                return 0;
+            }
+            sysData->diskFileSize = newDiskFileSize;
+        }
+    }
+
+    prot     = PROT_READ;
+    mapFlags = MAP_SHARED;
+    if (sysData->openMode != READ_MODE)
+        prot |= PROT_WRITE;
+#if defined(MAP_POPULATE)
+    else if ((sysData->flags & MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN))
+        mapFlags |= MAP_POPULATE;
+#endif
+
+    data = mmap(NULL, (size_t)mapSize, prot, mapFlags, sysData->fd, (off_t)offset);
+    if (data == MAP_FAILED) {
+        log_errno("mmap", errno, __FILENAME__, __LINE__);
+        return 0;
+    }
+
+    if (sysData->openMode == READ_MODE) {
+        if ((sysData->flags & MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN)) {
+            madvise(data, (size_t)mapSize, MADV_SEQUENTIAL);
+#if defined(POSIX_FADV_WILLNEED)
+            // start reading the next window
+            posix_fadvise(sysData->fd, (off_t)(offset + mapSize), sysData->windowSize, POSIX_FADV_WILLNEED);
+#endif
+        } else if ((sysData->flags & MXF_POSIX_MMAP_FLAG_RANDOM_ACCESS)) {
+            madvise(data, (size_t)mapSize, MADV_RANDOM);
+        } else {
+            madvise(data, (size_t)mapSize, MADV_WILLNEED);
+        }
+    }
+
+    newWindow = malloc(sizeof(*newWindow));
+    if (!newWindow) {
+        mxf_log_error("Failed to allocate memory, in %s:%d\n", __FILENAME__, __LINE__);
+        munmap(data, (size_t)mapSize);
+        return 0;
+    }
+    newWindow->ref.release = release_window;
+    newWindow->refCount    = 1;
+    newWindow->offset      = offset;
+    newWindow->data        = (uint8_t*)data;
+    newWindow->size        = (size_t)mapSize;
+
+    if (sysData->window)
+        release_window(&sysData->window->ref);
+    sysData->window = newWindow;
+
+    return 1;
+}
+
+static int ensure_window(MXFFileSysData *sysData, uint32_t minSize)
+{
+    MMapWindow *window = sysData->window;
+
+    if (window &&
+        sysData->position >= window->offset &&
+        sysData->position + minSize <= window->offset + window->size)
+    {
+        return 1;
+    }
+
+    return map_window(sysData, minSize);
+}
+
+static uint32_t window_avail(MXFFileSysData *sysData, uint32_t count)
+{
+    uint64_t windowEnd = sysData->window->offset + sysData->window->size;
+    uint64_t avail;
+
+    if (sysData->openMode == READ_MODE && windowEnd > sysData->logicalFileSize)
+        windowEnd = sysData->logicalFileSize;
+
+    avail = windowEnd - sysData->position;
+    if (avail > count)
+        avail = count;
+
+    return (uint32_t)avail;
+}
+
+static void posix_mmap_close(MXFFileSysData *sysData)
+{
+    if (sysData->window) {
+        release_window(&sysData->window->ref);
+        sysData->window = NULL;
+    }
+
+    if (sysData->fd >= 0) {
+        // truncate file to its logical size
+        if (sysData->openMode != READ_MODE && sysData->logicalFileSize < sysData->diskFileSize) {
+            if (ftruncate(sysData->fd, (off_t)sysData->logicalFileSize) != 0)
+                log_errno("ftruncate", errno, __FILENAME__, __LINE__);
+        }
+
+        close(sysData->fd);
+        sysData->fd = -1;
+    }
+}
+
+static uint32_t posix_mmap_read(MXFFileSysData *sysData, uint8_t *data, uint32_t count)
+{
+    uint32_t totalRead = 0;
+
+    while (totalRead < count) {
+        uint32_t avail;
+
+        if (sysData->position >= sysData->logicalFileSize) {
+            if (sysData->openMode != READ_MODE ||
+                !update_file_size(sysData) ||
+                sysData->position >= sysData->logicalFileSize)
+            {
+                break;
+            }
+        }
+
+        if (!ensure_window(sysData, 1))
+            break;
+
+        avail = window_avail(sysData, count - totalRead);
+        if (sysData->position + avail > sysData->logicalFileSize)
+            avail = (uint32_t)(sysData->logicalFileSize - sysData->position);
+        if (avail == 0)
+            break;
+
+        memcpy(data + totalRead, sysData->window->data + (sysData->position - sysData->window->offset), avail);
+        sysData->position += avail;
+        totalRead += avail;
+    }
+
+    return totalRead;
+}
+
+static uint32_t posix_mmap_write(MXFFileSysData *sysData, const uint8_t *data, uint32_t count)
+{
+    uint32_t totalWritten = 0;
+
+    if (sysData->openMode == READ_MODE)
+        return 0;
+
+    while (totalWritten < count) {
+        uint32_t avail;
+
+        if (!ensure_window(sysData, 1))
+            break;
+
+        avail = window_avail(sysData, count - totalWritten);
+        memcpy(sysData->window->data + (sysData->position - sysData->window->offset), data + totalWritten, avail);
+        sysData->position += avail;
+        totalWritten += avail;
+    }
+
+    // move EOF, if data was written after the current EOF
+    if (sysData->logicalFileSize < sysData->position)
+        sysData->logicalFileSize = sysData->position;
+
+    return totalWritten;
+}
+
+static int posix_mmap_getchar(MXFFileSysData *sysData)
+{
+    uint8_t data;
+
+    if (sysData->window &&
+        sysData->position >= sysData->window->offset &&
+        sysData->position < sysData->window->offset + sysData->window->size &&
+        sysData->position < sysData->logicalFileSize)
+    {
+        return sysData->window->data[sysData->position++ - sysData->window->offset];
+    }
+
+    if (posix_mmap_read(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_mmap_putchar(MXFFileSysData *sysData, int c)
+{
+    uint8_t data = (uint8_t)c;
+    if (posix_mmap_write(sysData, &data, 1) != 1)
+        return EOF;
+
+    return data;
+}
+
+static int posix_mmap_eof(MXFFileSysData *sysData)
+{
+    return sysData->position >= sysData->logicalFileSize;
+}
+
+static int posix_mmap_seek(MXFFileSysData *sysData, int64_t offset, int whence)
+{
+    int64_t newPosition;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            newPosition = offset;
+            break;
+        case SEEK_CUR:
+            newPosition = (int64_t)sysData->position + offset;
+            break;
+        case SEEK_END:
+            if (sysData->openMode == READ_MODE && !update_file_size(sysData))
+                return 0;
+            newPosition = (int64_t)sysData->logicalFileSize + offset;
+            break;
+        default:
+            return 0;
+    }
+
+    if (newPosition < 0)
+        return 0;
+
+    // the window is (re)mapped when the data is accessed
+    sysData->position = (uint64_t)newPosition;
+
+    return 1;
+}
+
+static int64_t posix_mmap_tell(MXFFileSysData *sysData)
+{
+    return (int64_t)sysData->position;
+}
+
+static int posix_mmap_is_seekable(MXFFileSysData *sysData)
+{
+    (void)sysData;
+    return 1;
+}
+
+static int64_t posix_mmap_size(MXFFileSysData *sysData)
+{
+    if (sysData->openMode == READ_MODE && !update_file_size(sysData))
+        return -1;
+
+    return (int64_t)sysData->logicalFileSize;
+}
+
+static int posix_mmap_read_ref(MXFFileSysData *sysData, uint32_t count, const uint8_t **data, MXFFileDataRef **ref)
+{
+    MMapWindow *window;
+
+    // only data that can't change whilst it is referenced is handed out
+    if (sysData->openMode != READ_MODE || count == 0)
+        return 0;
+
+    if (sysData->position + count > sysData->logicalFileSize &&
+        (!update_file_size(sysData) || sysData->position + count > sysData->logicalFileSize))
+    {
+        return 0;
+    }
+
+    if (!ensure_window(sysData, count))
+        return 0;
+
+    window = sysData->window;
+    __atomic_add_fetch(&window->refCount, 1, __ATOMIC_RELAXED);
+
+    *data = window->data + (sysData->position - window->offset);
+    *ref  = &window->ref;
+    sysData->position += count;
+
+    return 1;
+}
+
+static void free_posix_mmap(MXFFileSysData *sysData)
+{
+    SAFE_FREE(sysData);
+}
+
+static int posix_mmap_open(const char *filename, int flags, OpenMode mode, MXFFile **mxfFile)
+{
+    MXFFile *newMXFFile = NULL;
+    MXFFileSysData *newDiskFile = NULL;
+    struct stat statBuf;
+    int openFlags = 0;
+    int fd;
+
+    switch (mode)
+    {
+        case NEW_MODE:
+            openFlags = O_RDWR | O_CREAT | O_TRUNC;
+            break;
+        case READ_MODE:
+            openFlags = O_RDONLY;
+            break;
+        case MODIFY_MODE:
+            openFlags = O_RDWR;
+            break;
+    }
+
+    fd = open(filename, openFlags, 0666);
+    if (fd < 0)
+        return 0;
+
+    // only regular files can be memory mapped
+    if (fstat(fd, &statBuf) != 0) {
+        log_errno("fstat", errno, __FILENAME__, __LINE__);
+        goto fail;
+    }
+    if (!S_ISREG(statBuf.st_mode)) {
+        mxf_log_error("Memory mapped file '%s' is not a regular file\n", filename);
+        goto fail;
+    }
+
+    CHK_MALLOC_OFAIL(newMXFFile, MXFFile);
+    memset(newMXFFile, 0, sizeof(MXFFile));
+    CHK_MALLOC_OFAIL(newDiskFile, MXFFileSysData);
+    memset(newDiskFile, 0, sizeof(MXFFileSysData));
+
+    newDiskFile->fd              = fd;
+    newDiskFile->openMode        = mode;
+    newDiskFile->flags           = flags;
+    newDiskFile->pageSize        = mxf_get_system_page_size();
+    newDiskFile->windowSize      = DEFAULT_WINDOW_SIZE;
+    newDiskFile->diskFileSize    = statBuf.st_size;
+    newDiskFile->logicalFileSize = statBuf.st_size;
+
+    // the window size must be a multiple of the page size
+    if (newDiskFile->windowSize % newDiskFile->pageSize)
+        newDiskFile->windowSize += newDiskFile->pageSize - newDiskFile->windowSize % newDiskFile->pageSize;
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (mode == READ_MODE) {
+        if ((flags & MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN))
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        else if ((flags & MXF_POSIX_MMAP_FLAG_RANDOM_ACCESS))
+            posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    }
+#endif
+
+    newMXFFile->close         = posix_mmap_close;
+    newMXFFile->read          = posix_mmap_read;
+    newMXFFile->write         = posix_mmap_write;
+    newMXFFile->get_char      = posix_mmap_getchar;
+    newMXFFile->put_char      = posix_mmap_putchar;
+    newMXFFile->eof           = posix_mmap_eof;
+    newMXFFile->seek          = posix_mmap_seek;
+    newMXFFile->tell          = posix_mmap_tell;
+    newMXFFile->is_seekable   = posix_mmap_is_seekable;
+    newMXFFile->size          = posix_mmap_size;
+    newMXFFile->read_ref      = posix_mmap_read_ref;
+
+    newMXFFile->free_sys_data = free_posix_mmap;
+    newMXFFile->sysData       = newDiskFile;
+
+    *mxfFile = newMXFFile;
+    return 1;
+
+fail:
+    close(fd);
+    SAFE_FREE(newDiskFile);
+    SAFE_FREE(newMXFFile);
+    return 0;
+}
+
+
+int mxf_posix_mmap_open_new(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return posix_mmap_open(filename, flags, NEW_MODE, mxfFile);
+}
+
+int mxf_posix_mmap_open_read(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return posix_mmap_open(filename, flags, READ_MODE, mxfFile);
+}
+
+int mxf_posix_mmap_open_modify(const char *filename, int flags, MXFFile **mxfFile)
+{
+    return posix_mmap_open(filename, flags, MODIFY_MODE, mxfFile);
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_memory_file.h>
+
+
+/* the number of clips per sequence is limited by the 16-bit local set item length */
+#define DEFAULT_NUM_SETS        100000
+#define CLIPS_PER_SEQUENCE      1000
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static double get_elapsed(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void check_duplicates_and_removal(MXFDataModel *dataModel)
+{
+    MXFHeaderMetadata *headerMetadata;
+    MXFMetadataSet *first;
+    MXFMetadataSet *second;
+    MXFMetadataSet *duplicate;
+    MXFMetadataSet *set;
+    MXFMetadataItem *item;
+    MXFList *setList;
+    mxfTimestamp timestamp;
+    mxfUL ul;
+
+    CHECK(mxf_create_header_metadata(&headerMetadata, dataModel));
+
+    CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(SourceClip), &first));
+    CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(Sequence), &second));
+
+    /* a second set with the same instance UID is only found once the first is removed */
+    CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(SourceClip), &duplicate));
+    CHECK(mxf_remove_set(headerMetadata, duplicate));
+    duplicate->instanceUID = first->instanceUID;
+    CHECK(mxf_add_set(headerMetadata, duplicate));
+    CHECK(mxf_dereference(headerMetadata, &first->instanceUID, &set) && set == first);
+    CHECK(mxf_find_set_by_key(headerMetadata, &MXF_SET_K(SourceClip), &setList));
+    CHECK(mxf_get_list_length(setList) == 2 && mxf_get_list_element(setList, 0) == first);
+    mxf_free_list(&setList);
+
+    CHECK(mxf_remove_set(headerMetadata, first));
+    CHECK(mxf_dereference(headerMetadata, &duplicate->instanceUID, &set) && set == duplicate);
+    CHECK(mxf_remove_set(headerMetadata, duplicate));
+    CHECK(!mxf_dereference(headerMetadata, &duplicate->instanceUID, &set));
+    CHECK(mxf_find_set_by_key(headerMetadata, &MXF_SET_K(SourceClip), &setList));
+    CHECK(mxf_get_list_length(setList) == 0);
+    mxf_free_list(&setList);
+    CHECK(mxf_dereference(headerMetadata, &second->instanceUID, &set) && set == second);
+    mxf_free_set(&first);
+    mxf_free_set(&duplicate);
+
+    /* the Preface has enough items for an item index */
+    CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(Preface), &set));
+    memset(&timestamp, 0, sizeof(timestamp));
+    CHECK(mxf_set_timestamp_item(set, &MXF_ITEM_K(Preface, LastModifiedDate), &timestamp));
+    CHECK(mxf_set_version_type_item(set, &MXF_ITEM_K(Preface, Version), MXF_PREFACE_VER(1, 3)));
+    CHECK(mxf_set_uint32_item(set, &MXF_ITEM_K(Preface, ObjectModelVersion), 1));
+    CHECK(mxf_set_ul_item(set, &MXF_ITEM_K(Preface, OperationalPattern), &MXF_OP_L(1a, UniTrack_Stream_Internal)));
+    CHECK(mxf_set_empty_array_item(set, &MXF_ITEM_K(Preface, EssenceContainers), mxfUL_extlen));
+    CHECK(mxf_set_empty_array_item(set, &MXF_ITEM_K(Preface, DMSchemes), mxfUL_extlen));
+    CHECK(mxf_set_strongref_item(set, &MXF_ITEM_K(Preface, ContentStorage), second));
+    CHECK(mxf_set_weakref_item(set, &MXF_ITEM_K(Preface, PrimaryPackage), second));
+    CHECK(mxf_set_empty_array_item(set, &MXF_ITEM_K(Preface, Identifications), mxfUUID_extlen));
+    CHECK(set->itemIndex != NULL);
+    CHECK(mxf_get_ul_item(set, &MXF_ITEM_K(Preface, OperationalPattern), &ul));
+    CHECK(mxf_equals_ul(&ul, &MXF_OP_L(1a, UniTrack_Stream_Internal)));
+    CHECK(mxf_remove_item(set, &MXF_ITEM_K(Preface, OperationalPattern), &item));
+    mxf_free_item(&item);
+    CHECK(!mxf_have_item(set, &MXF_ITEM_K(Preface, OperationalPattern)));
+    CHECK(mxf_have_item(set, &MXF_ITEM_K(Preface, Identifications)));
+
+    mxf_free_header_metadata(&headerMetadata);
+}
+
+static void create_header_metadata(MXFHeaderMetadata *headerMetadata, uint32_t numSets)
+{
+    MXFMetadataSet *sequenceSet;
+    MXFMetadataSet *clipSet;
+    uint8_t *element = NULL;
+    uint32_t numClips;
+    uint32_t i;
+
+    /* the Preface is required for writing and is not included in numSets */
+    CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(Preface), &sequenceSet));
+
+    for (i = 0; i < numSets; i++)
+    {
+        if (i % (CLIPS_PER_SEQUENCE + 1) == 0)
+        {
+            numClips = numSets - i - 1;
+            if (numClips > CLIPS_PER_SEQUENCE)
+            {
+                numClips = CLIPS_PER_SEQUENCE;
+            }
+            CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(Sequence), &sequenceSet));
+            CHECK(mxf_set_ul_item(sequenceSet, &MXF_ITEM_K(StructuralComponent, DataDefinition),
+                                  &MXF_DDEF_L(Picture)));
+            CHECK(mxf_set_length_item(sequenceSet, &MXF_ITEM_K(StructuralComponent, Duration), numClips));
+            CHECK(mxf_alloc_array_item_elements(sequenceSet, &MXF_ITEM_K(Sequence, StructuralComponents),
+                                                mxfUUID_extlen, numClips, &element));
+            /* reference the clips in reverse order to defeat any sequential search */
+            element += numClips * mxfUUID_extlen;
+            continue;
+        }
+
+        CHECK(mxf_create_set(headerMetadata, &MXF_SET_K(SourceClip), &clipSet));
+        CHECK(mxf_set_ul_item(clipSet, &MXF_ITEM_K(StructuralComponent, DataDefinition), &MXF_DDEF_L(Picture)));
+        CHECK(mxf_set_length_item(clipSet, &MXF_ITEM_K(StructuralComponent, Duration), 1));
+        CHECK(mxf_set_position_item(clipSet, &MXF_ITEM_K(SourceClip, StartPosition), 0));
+        CHECK(mxf_set_umid_item(clipSet, &MXF_ITEM_K(SourceClip, SourcePackageID), &g_Null_UMID));
+        CHECK(mxf_set_uint32_item(clipSet, &MXF_ITEM_K(SourceClip, SourceTrackID), 0));
+
+        element -= mxfUUID_extlen;
+        mxf_set_strongref(clipSet, element);
+    }
+}
+
+static uint32_t dereference_all(MXFHeaderMetadata *headerMetadata)
+{
+    MXFList *sequenceList;
+    MXFListIterator iter;
+    MXFArrayItemIterator arrayIter;
+    MXFMetadataSet *clipSet;
+    uint8_t *element;
+    uint32_t elementLength;
+    uint32_t count = 0;
+
+    CHECK(mxf_find_set_by_key(headerMetadata, &MXF_SET_K(Sequence), &sequenceList));
+    mxf_initialise_list_iter(&iter, sequenceList);
+    while (mxf_next_list_iter_element(&iter))
+    {
+        MXFMetadataSet *sequenceSet = (MXFMetadataSet*)mxf_get_iter_element(&iter);
+
+        CHECK(mxf_initialise_array_item_iterator(sequenceSet, &MXF_ITEM_K(Sequence, StructuralComponents), &arrayIter));
+        while (mxf_next_array_item_element(&arrayIter, &element, &elementLength))
+        {
+            CHECK(mxf_get_strongref(headerMetadata, element, &clipSet));
+            CHECK(mxf_equals_key(&clipSet->key, &MXF_SET_K(SourceClip)));
+            CHECK(mxf_have_item(clipSet, &MXF_ITEM_K(SourceClip, SourceTrackID)));
+            count++;
+        }
+    }
+    mxf_free_list(&sequenceList);
+
+    return count;
+}
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s [num_sets]\n", cmd);
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFDataModel *dataModel;
+    MXFHeaderMetadata *headerMetadata;
+    MXFMemoryFile *memFile;
+    MXFFile *mxfFile;
+    MXFList *setList;
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+    int64_t headerByteCount;
+    uint32_t numSets = DEFAULT_NUM_SETS;
+    uint32_t numClips;
+    clock_t start;
+
+    if (argc > 2 || (argc == 2 && (sscanf(argv[1], "%u", &numSets) != 1 || numSets < 2)))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    CHECK(mxf_load_data_model(&dataModel));
+    CHECK(mxf_finalise_data_model(dataModel));
+
+    check_duplicates_and_removal(dataModel);
+
+
+    /* create and write the header metadata */
+    start = clock();
+    CHECK(mxf_create_header_metadata(&headerMetadata, dataModel));
+    create_header_metadata(headerMetadata, numSets);
+    printf("create:      %.3fs\n", get_elapsed(start));
+
+    CHECK(mxf_mem_file_open_new(1024 * 1024, 0, &memFile));
+    mxfFile = mxf_mem_file_get_file(memFile);
+    CHECK(mxf_write_header_metadata(mxfFile, headerMetadata));
+    headerByteCount = mxf_file_tell(mxfFile);
+    mxf_free_header_metadata(&headerMetadata);
+
+    /* read it back and resolve all the references */
+    start = clock();
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_SET));
+    CHECK(mxf_create_header_metadata(&headerMetadata, dataModel));
+    CHECK(mxf_read_kl(mxfFile, &key, &llen, &len));
+    CHECK(mxf_read_header_metadata(mxfFile, headerMetadata, (uint64_t)headerByteCount, &key, llen, len));
+    printf("read:        %.3fs (%u sets)\n", get_elapsed(start),
+           (uint32_t)mxf_get_list_length(&headerMetadata->sets));
+    CHECK(mxf_get_list_length(&headerMetadata->sets) == numSets + 1);
+
+    start = clock();
+    numClips = dereference_all(headerMetadata);
+    printf("dereference: %.3fs (%u references)\n", get_elapsed(start), numClips);
+    CHECK(numClips == numSets - (numSets + CLIPS_PER_SEQUENCE) / (CLIPS_PER_SEQUENCE + 1));
+
+    start = clock();
+    CHECK(mxf_find_set_by_key(headerMetadata, &MXF_SET_K(Sequence), &setList));
+    CHECK(mxf_get_list_length(setList) == numSets - numClips);
+    mxf_free_list(&setList);
+    printf("find by key: %.3fs\n", get_elapsed(start));
+
+    mxf_free_header_metadata(&headerMetadata);
+    mxf_file_close(&mxfFile);
+    mxf_free_data_model(&dataModel);
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_cache_hint.h>
+
+
+// the streaming window is small compared to the file so that page cache use must stay bounded
+#define WINDOW_SIZE     (4 * 1024 * 1024)
+#define FILE_SIZE       (64 * 1024 * 1024 + 12345)
+#define CHUNK_SIZE      100003
+#define CHECK_INTERVAL  (2 * 1024 * 1024)
+#define MAX_RESIDENT    (3 * WINDOW_SIZE)
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s filename\n", cmd);
+}
+
+static int64_t get_resident_size(const char *filename, int64_t size)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    unsigned char *vec;
+    size_t numPages;
+    size_t i;
+    int64_t count = 0;
+    void *addr;
+    int fd;
+
+    if (size <= 0)
+        return 0;
+
+    fd = open(filename, O_RDONLY);
+    CHECK(fd >= 0);
+    addr = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+    CHECK(addr != MAP_FAILED);
+
+    numPages = (size_t)((size + pageSize - 1) / pageSize);
+    vec = malloc(numPages);
+    CHECK(mincore(addr, (size_t)size, vec) == 0);
+    for (i = 0; i < numPages; i++)
+        count += (vec[i] & 1);
+
+    free(vec);
+    munmap(addr, (size_t)size);
+    close(fd);
+
+    return count * pageSize;
+}
+
+static int drop_file_cache(const char *filename)
+{
+    int fd = open(filename, O_RDONLY);
+    CHECK(fd >= 0);
+    CHECK(fsync(fd) == 0);
+#if defined(POSIX_FADV_DONTNEED)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    close(fd);
+
+    // the page cache may not be droppable, e.g. for tmpfs files
+    return get_resident_size(filename, FILE_SIZE) < FILE_SIZE / 2;
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFFile *mxfFile;
+    unsigned char *expected;
+    unsigned char *readData;
+    uint32_t count;
+    int64_t offset;
+    int64_t nextCheck;
+    int64_t resident;
+    int i;
+
+    if (argc != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    expected = malloc(FILE_SIZE);
+    for (i = 0; i < FILE_SIZE; i++)
+        expected[i] = (unsigned char)(i % 251);
+    readData = malloc(FILE_SIZE);
+
+
+    // write with a streaming hint and check the written data is dropped from the page cache
+
+    CHECK(mxf_posix_cache_hint_open_new(argv[1], MXF_POSIX_CACHE_HINT_STREAMING | MXF_POSIX_CACHE_HINT_SYNC_WRITES,
+                                        WINDOW_SIZE, &mxfFile));
+
+    nextCheck = CHECK_INTERVAL;
+    for (offset = 0; offset < FILE_SIZE - 1; offset += count) {
+        count = CHUNK_SIZE;
+        if (offset + count > FILE_SIZE - 1)
+            count = (uint32_t)(FILE_SIZE - 1 - offset);
+        CHECK(mxf_file_write(mxfFile, &expected[offset], count) == count);
+
+        if (offset + count >= nextCheck) {
+            resident = get_resident_size(argv[1], mxf_file_size(mxfFile));
+            if (resident > MAX_RESIDENT) {
+                fprintf(stderr, "%"PRId64" bytes resident after writing %"PRId64" bytes\n", resident, offset + count);
+                CHECK(resident <= MAX_RESIDENT);
+            }
+            nextCheck += CHECK_INTERVAL;
+        }
+    }
+    CHECK(mxf_file_putc(mxfFile, expected[FILE_SIZE - 1]) == expected[FILE_SIZE - 1]);
+    CHECK(mxf_file_tell(mxfFile) == FILE_SIZE);
+    CHECK(mxf_file_size(mxfFile) == FILE_SIZE);
+
+    // patch data behind the write position
+    memset(&expected[11], 0xf1, 5000);
+    CHECK(mxf_file_seek(mxfFile, 11, SEEK_SET));
+    CHECK(mxf_file_write(mxfFile, &expected[11], 5000) == 5000);
+    CHECK(mxf_file_tell(mxfFile) == 5011);
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_END));
+    CHECK(mxf_file_tell(mxfFile) == FILE_SIZE);
+
+    mxf_file_close(&mxfFile);
+
+
+    // read with a streaming hint and check page cache use stays bounded
+
+    if (!drop_file_cache(argv[1])) {
+        fprintf(stderr, "Skipping page cache residency checks because the page cache can't be dropped\n");
+        CHECK(mxf_posix_cache_hint_open_read(argv[1], MXF_POSIX_CACHE_HINT_DEFAULT, 0, &mxfFile));
+        CHECK(mxf_file_read(mxfFile, readData, FILE_SIZE) == FILE_SIZE);
+        CHECK(memcmp(readData, expected, FILE_SIZE) == 0);
+        mxf_file_close(&mxfFile);
+    } else {
+        CHECK(mxf_posix_cache_hint_open_read(argv[1], MXF_POSIX_CACHE_HINT_STREAMING, WINDOW_SIZE, &mxfFile));
+
+        CHECK(mxf_file_size(mxfFile) == FILE_SIZE);
+        nextCheck = CHECK_INTERVAL;
+        for (offset = 0; offset < FILE_SIZE; offset += count) {
+            count = CHUNK_SIZE;
+            if (offset + count > FILE_SIZE)
+                count = (uint32_t)(FILE_SIZE - offset);
+            CHECK(mxf_file_read(mxfFile, &readData[offset], count) == count);
+
+            if (offset + count >= nextCheck) {
+                resident = get_resident_size(argv[1], FILE_SIZE);
+                if (resident > MAX_RESIDENT) {
+                    fprintf(stderr, "%"PRId64" bytes resident after reading %"PRId64" bytes\n", resident, offset + count);
+                    CHECK(resident <= MAX_RESIDENT);
+                }
+                nextCheck += CHECK_INTERVAL;
+            }
+        }
+        CHECK(memcmp(readData, expected, FILE_SIZE) == 0);
+        CHECK(mxf_file_getc(mxfFile) == EOF);
+        CHECK(mxf_file_eof(mxfFile));
+
+        // seek back to a frame and read it
+        CHECK(mxf_file_seek(mxfFile, FILE_SIZE / 3, SEEK_SET));
+        CHECK(mxf_file_tell(mxfFile) == FILE_SIZE / 3);
+        CHECK(mxf_file_read(mxfFile, readData, CHUNK_SIZE) == CHUNK_SIZE);
+        CHECK(memcmp(readData, &expected[FILE_SIZE / 3], CHUNK_SIZE) == 0);
+        CHECK(mxf_file_tell(mxfFile) == FILE_SIZE / 3 + CHUNK_SIZE);
+
+        mxf_file_close(&mxfFile);
+
+        CHECK(get_resident_size(argv[1], FILE_SIZE) <= MAX_RESIDENT);
+    }
+
+
+    free(expected);
+    free(readData);
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_direct.h>
+
+
+// the file spans 3 write buffers and data is patched before and across the first buffer boundary
+#define BUFFER_SIZE     (8 * 1024 * 1024)
+#define FILE_SIZE       (2 * BUFFER_SIZE + 12345)
+#define CHUNK_SIZE      100003
+#define PATCH_SIZE      5000
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s filename\n", cmd);
+}
+
+static void patch(MXFFile *mxfFile, unsigned char *expected, int64_t offset, unsigned char value)
+{
+    unsigned char patchData[PATCH_SIZE];
+    unsigned char readData[PATCH_SIZE];
+
+    memset(patchData, value, sizeof(patchData));
+    memcpy(&expected[offset], patchData, sizeof(patchData));
+
+    CHECK(mxf_file_seek(mxfFile, offset, SEEK_SET));
+    CHECK(mxf_file_write(mxfFile, patchData, sizeof(patchData)) == sizeof(patchData));
+    CHECK(mxf_file_seek(mxfFile, offset - 1, SEEK_SET));
+    CHECK(mxf_file_read(mxfFile, readData, sizeof(readData)) == sizeof(readData));
+    CHECK(memcmp(readData, &expected[offset - 1], sizeof(readData)) == 0);
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFFile *mxfFile;
+    unsigned char *expected;
+    unsigned char *readData;
+    uint32_t count;
+    int64_t offset;
+    int i;
+
+    if (argc != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    expected = malloc(FILE_SIZE);
+    for (i = 0; i < FILE_SIZE; i++)
+        expected[i] = (unsigned char)(i % 251);
+    readData = malloc(FILE_SIZE);
+
+
+    CHECK(mxf_posix_direct_open_new(argv[1], 3 * BUFFER_SIZE, &mxfFile));
+
+    for (offset = 0; offset < FILE_SIZE - 1; offset += count) {
+        count = CHUNK_SIZE;
+        if (offset + count > FILE_SIZE - 1)
+            count = (uint32_t)(FILE_SIZE - 1 - offset);
+        CHECK(mxf_file_write(mxfFile, &expected[offset], count) == count);
+    }
+    CHECK(mxf_file_putc(mxfFile, expected[FILE_SIZE - 1]) == expected[FILE_SIZE - 1]);
+    CHECK(mxf_file_size(mxfFile) == FILE_SIZE);
+    CHECK(mxf_file_eof(mxfFile));
+
+    patch(mxfFile, expected, 11, 0xf1);
+    patch(mxfFile, expected, BUFFER_SIZE - PATCH_SIZE / 2, 0xf2);
+    patch(mxfFile, expected, FILE_SIZE - PATCH_SIZE, 0xf3);
+    CHECK(mxf_file_getc(mxfFile) == 0xf3);
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_END));
+    CHECK(mxf_file_tell(mxfFile) == FILE_SIZE);
+
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_disk_file_open_read(argv[1], &mxfFile));
+
+    CHECK(mxf_file_size(mxfFile) == FILE_SIZE);
+    CHECK(mxf_file_read(mxfFile, readData, FILE_SIZE) == FILE_SIZE);
+    CHECK(memcmp(readData, expected, FILE_SIZE) == 0);
+
+    mxf_file_close(&mxfFile);
+
+
+    free(expected);
+    free(readData);
+
+    return 0;
+}
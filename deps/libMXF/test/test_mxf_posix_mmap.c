@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <mxf/mxf.h>
+#include <mxf/mxf_posix_mmap.h>
+
+
+#define DATA_SIZE   10000
+
+// the default window size; data written and read at this offset crosses a window boundary
+#define LARGE_OFFSET    (64 * 1024 * 1024)
+
+
+
+#define CHECK(cmd) \
+    if (!(cmd)) \
+    { \
+        fprintf(stderr, "'%s' failed in %s:%d\n", #cmd, __FILENAME__, __LINE__); \
+        exit(1); \
+    }
+
+
+
+static void usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s filename\n", cmd);
+}
+
+int main(int argc, const char *argv[])
+{
+    MXFFile *mxfFile;
+    unsigned char *writeData;
+    unsigned char *readData;
+    const uint8_t *refData;
+    MXFFileDataRef *ref1 = NULL;
+    MXFFileDataRef *ref2 = NULL;
+    int i;
+
+    if (argc != 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    writeData = malloc(DATA_SIZE);
+    for (i = 0; i < DATA_SIZE; i++)
+        writeData[i] = (unsigned char)(i % 251);
+    readData = malloc(DATA_SIZE);
+
+
+    CHECK(mxf_posix_mmap_open_new(argv[1], MXF_POSIX_MMAP_FLAG_DEFAULT, &mxfFile));
+
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+    CHECK(mxf_file_size(mxfFile) == DATA_SIZE);
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_SET));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(memcmp(readData, writeData, DATA_SIZE) == 0);
+    CHECK(mxf_file_eof(mxfFile));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == 0);
+    CHECK(mxf_file_seek(mxfFile, LARGE_OFFSET - DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == DATA_SIZE);
+    CHECK(mxf_file_size(mxfFile) == LARGE_OFFSET + DATA_SIZE / 2);
+    CHECK(mxf_file_seek(mxfFile, -DATA_SIZE, SEEK_END));
+    CHECK(mxf_file_tell(mxfFile) == LARGE_OFFSET - DATA_SIZE / 2);
+    CHECK(mxf_file_getc(mxfFile) == writeData[0]);
+    CHECK(mxf_file_putc(mxfFile, 0xff) == 0xff);
+    CHECK(!mxf_file_read_ref(mxfFile, 1, &refData, &ref1));
+
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_mmap_open_modify(argv[1], MXF_POSIX_MMAP_FLAG_DEFAULT, &mxfFile));
+
+    CHECK(mxf_file_size(mxfFile) == LARGE_OFFSET + DATA_SIZE / 2);
+    CHECK(mxf_file_seek(mxfFile, LARGE_OFFSET + 1 - DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_getc(mxfFile) == 0xff);
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_END));
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE / 2) == DATA_SIZE / 2);
+    CHECK(mxf_file_size(mxfFile) == LARGE_OFFSET + DATA_SIZE);
+
+    mxf_file_close(&mxfFile);
+
+
+    CHECK(mxf_posix_mmap_open_read(argv[1], MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN, &mxfFile));
+
+    CHECK(mxf_file_size(mxfFile) == LARGE_OFFSET + DATA_SIZE);
+    CHECK(mxf_file_is_seekable(mxfFile));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(memcmp(readData, writeData, DATA_SIZE) == 0);
+    CHECK(mxf_file_getc(mxfFile) == 0);
+    CHECK(mxf_file_write(mxfFile, writeData, DATA_SIZE) == 0);
+
+    // read across the window boundary
+    CHECK(mxf_file_seek(mxfFile, LARGE_OFFSET - DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE);
+    CHECK(readData[0] == writeData[0] && readData[1] == 0xff);
+    CHECK(memcmp(&readData[2], &writeData[2], DATA_SIZE - 2) == 0);
+    CHECK(mxf_file_read(mxfFile, readData, DATA_SIZE) == DATA_SIZE / 2);
+    CHECK(memcmp(readData, writeData, DATA_SIZE / 2) == 0);
+    CHECK(mxf_file_eof(mxfFile));
+    CHECK(mxf_file_getc(mxfFile) == EOF);
+
+    // the referenced data remains valid after the window has moved and the file is closed
+    CHECK(mxf_file_seek(mxfFile, 2, SEEK_SET));
+    CHECK(mxf_file_read_ref(mxfFile, DATA_SIZE - 2, &refData, &ref1));
+    CHECK(mxf_file_tell(mxfFile) == DATA_SIZE);
+    CHECK(memcmp(refData, &writeData[2], DATA_SIZE - 2) == 0);
+    CHECK(mxf_file_seek(mxfFile, LARGE_OFFSET + DATA_SIZE / 2, SEEK_SET));
+    CHECK(mxf_file_read_ref(mxfFile, DATA_SIZE / 2, &refData, &ref2));
+    CHECK(memcmp(refData, writeData, DATA_SIZE / 2) == 0);
+    CHECK(!mxf_file_read_ref(mxfFile, 1, &refData, &ref2));
+    mxf_file_release_ref(&ref2);
+    CHECK(mxf_file_seek(mxfFile, 0, SEEK_SET));
+    CHECK(mxf_file_read_ref(mxfFile, DATA_SIZE, &refData, &ref2));
+
+    mxf_file_close(&mxfFile);
+
+    CHECK(memcmp(refData, writeData, DATA_SIZE) == 0);
+    mxf_file_release_ref(&ref2);
+    mxf_file_release_ref(&ref1);
+    CHECK(ref1 == NULL && ref2 == NULL);
+
+
+    free(writeData);
+    free(readData);
+
+    return 0;
+}
@@ -304,6 +304,11 @@ bool File::readHeaderPartition()
 }
 
 bool File::readPartitions()
+{
+    return readPartitions(0);
+}
+
+bool File::readPartitions(PartitionPackReader *packReader)
 {
     mxfKey key;
     uint8_t llen;
@@ -341,15 +346,23 @@ bool File::readPartitions()
             {
                 _partitions.push_back(header_partition);
 
+                std::vector<uint64_t> offsets;
                 mxf_initialise_list_iter(&iter, &rip.entries);
                 while (mxf_next_list_iter_element(&iter)) {
                     rip_entry = (MXFRIPEntry*)mxf_get_iter_element(&iter);
-                    if (rip_entry->thisPartition <= header_partition->getThisPartition())
-                        continue;
+                    if (rip_entry->thisPartition > header_partition->getThisPartition())
+                        offsets.push_back(rip_entry->thisPartition);
+                }
 
-                    seek(mxf_get_runin_len(_cFile) + rip_entry->thisPartition, SEEK_SET);
-                    readKL(&key, &llen, &len);
-                    _partitions.push_back(Partition::read(this, &key, len));
+                if (packReader) {
+                    std::vector<Partition*> partitions = packReader->readPartitionPacks(this, offsets);
+                    _partitions.insert(_partitions.end(), partitions.begin(), partitions.end());
+                } else {
+                    for (i = 0; i < offsets.size(); i++) {
+                        seek(mxf_get_runin_len(_cFile) + offsets[i], SEEK_SET);
+                        readKL(&key, &llen, &len);
+                        _partitions.push_back(Partition::read(this, &key, len));
+                    }
                 }
 
                 mxf_clear_rip(&rip);
@@ -506,6 +519,11 @@ uint32_t File::read(unsigned char *data, uint32_t count)
     return mxf_file_read(_cFile, data, count);
 }
 
+bool File::readRef(uint32_t count, const unsigned char **data, MXFFileDataRef **ref)
+{
+    return mxf_file_read_ref(_cFile, count, data, ref) != 0;
+}
+
 int64_t File::tell()
 {
     return mxf_file_tell(_cFile);
@@ -45,6 +45,18 @@ namespace mxfpp
 {
 
 
+class File;
+
+class PartitionPackReader
+{
+public:
+    virtual ~PartitionPackReader() {}
+
+    // read the partition packs at the given offsets (excluding the run-in), returning them in the same order
+    virtual std::vector<Partition*> readPartitionPacks(File *file, const std::vector<uint64_t> &offsets) = 0;
+};
+
+
 class File
 {
 public:
@@ -72,6 +84,7 @@ public:
 
     bool readHeaderPartition();
     bool readPartitions();
+    bool readPartitions(PartitionPackReader *packReader);
     void readNextPartition(const mxfKey *key, uint64_t len);
 
     uint8_t readUInt8();
@@ -91,6 +104,7 @@ public:
     void readBatchHeader(uint32_t *len, uint32_t *elementLen);
 
     uint32_t read(unsigned char *data, uint32_t count);
+    bool readRef(uint32_t count, const unsigned char **data, MXFFileDataRef **ref);
     int64_t tell();
     void seek(int64_t position, int whence);
     void skip(uint64_t len);
@@ -43,7 +43,13 @@ namespace bmx
 
 
 class InsufficientBytes : public std::exception
-{};
+{
+public:
+    InsufficientBytes() : required_size(0) {}
+    InsufficientBytes(uint64_t required_size_) : required_size(required_size_) {}
+
+    uint64_t required_size; // 0 if unknown
+};
 
 
 class ByteBuffer
@@ -48,6 +48,12 @@ void crc32_init(uint32_t *crc32);
 void crc32_update(uint32_t *crc32, const unsigned char *data, size_t size);
 void crc32_final(uint32_t *crc32);
 
+// The update implementations supported by the CPU, for testing. The first is the portable byte-wise table lookup
+// and crc32_update() uses the last
+typedef uint32_t (*CRC32UpdateFunc)(uint32_t crc32, const unsigned char *data, size_t size);
+size_t crc32_get_num_update_impls();
+CRC32UpdateFunc crc32_get_update_impl(size_t index, const char **name);
+
 std::string crc32_digest_str(uint32_t crc32);
 
 std::string crc32_calc_file(std::string filename);
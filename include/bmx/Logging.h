@@ -60,6 +60,21 @@ extern vlog2_func vlog2;
 extern LogLevel LOG_LEVEL;
 
 
+// Raises the minimum level of messages logged by the calling thread until the object is destroyed. Other
+// threads are not affected.
+class ThreadLogLevel
+{
+public:
+    ThreadLogLevel(LogLevel min_level);
+    ~ThreadLogLevel();
+
+private:
+    int mPrevMinLevel;
+};
+
+bool is_log_level_enabled(LogLevel level);
+
+
 bool open_log_file(std::string filename);
 void close_log_file();
 
@@ -50,6 +50,7 @@ typedef struct MXFChecksumFile MXFChecksumFile;
 MXFChecksumFile* mxf_checksum_file_open(MXFFile *target, ChecksumType type);
 MXFFile* mxf_checksum_file_get_file(MXFChecksumFile *checksum_file);
 void mxf_checksum_file_force_update(MXFChecksumFile *checksum_file);
+void mxf_checksum_file_enable_async_update(MXFChecksumFile *checksum_file);
 bool mxf_checksum_file_final(MXFChecksumFile *checksum_file);
 size_t mxf_checksum_file_digest_size(const MXFChecksumFile *checksum_file);
 void mxf_checksum_file_digest(const MXFChecksumFile *checksum_file, unsigned char *digest, size_t size);
@@ -45,7 +45,10 @@ bool mxf_http_is_supported();
 
 bool mxf_http_is_url(const std::string &url_str);
 
-MXFFile* mxf_http_file_open_read(const std::string &url_str, uint32_t min_read_size);
+// min_read_size is the size of the cached blocks. Up to max_read_ahead_requests range requests are kept in
+// flight when the file is read sequentially; 0 disables read-ahead
+MXFFile* mxf_http_file_open_read(const std::string &url_str, uint32_t min_read_size,
+                                 uint32_t max_read_ahead_requests = 8);
 
 
 };
@@ -56,6 +56,12 @@ void sha1_init(SHA1Context *context);
 void sha1_update(SHA1Context *context, const unsigned char *data, uint32_t len);
 void sha1_final(unsigned char digest[20], SHA1Context *context);
 
+// The block transform implementations supported by the CPU, for testing. The first is the portable transform and
+// sha1_update() uses the last
+typedef void (*SHA1TransformFunc)(uint32_t state[5], const unsigned char *data, size_t num_blocks);
+size_t sha1_get_num_transform_impls();
+SHA1TransformFunc sha1_get_transform_impl(size_t index, const char **name);
+
 std::string sha1_digest_str(const unsigned char digest[20]);
 
 std::string sha1_calc_file(std::string filename);
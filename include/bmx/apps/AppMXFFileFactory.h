@@ -47,6 +47,10 @@
 #if !defined(__MINGW32__)
 #include <mxf/mxf_win32_mmap.h>
 #endif
+#else
+#include <mxf/mxf_posix_mmap.h>
+#include <mxf/mxf_posix_direct.h>
+#include <mxf/mxf_posix_cache_hint.h>
 #endif
 
 
@@ -66,9 +70,14 @@ public:
     void SetInputFlags(int flags);
     void SetRWInterleave(uint32_t rw_interleave_size);
     void SetHTTPMinReadSize(uint32_t size);
-#if defined(_WIN32) && !defined(__MINGW32__)
+    void SetHTTPReadAhead(uint32_t max_requests);
+#if !defined(__MINGW32__)
     void SetUseMMapFile(bool enable);
 #endif
+#if !defined(_WIN32)
+    void SetDirectIOOutput(bool enable, int64_t preallocate_size = 0);
+    void SetCacheHints(int input_flags, int output_flags, int64_t window_size = 0);
+#endif
 
 public:
     virtual mxfpp::File* OpenNew(std::string filename);
@@ -105,9 +114,17 @@ private:
     std::vector<InputChecksumFile> mInputChecksumFiles;
     MXFRWInterleaver *mRWInterleaver;
     uint32_t mHTTPMinReadSize;
-#if defined(_WIN32) && !defined(__MINGW32__)
+    uint32_t mHTTPReadAhead;
+#if !defined(__MINGW32__)
     bool mUseMMapFile;
 #endif
+#if !defined(_WIN32)
+    bool mDirectIOOutput;
+    int64_t mOutputPreallocateSize;
+    int mInputCacheHints;
+    int mOutputCacheHints;
+    int64_t mCacheHintWindow;
+#endif
 };
 
 
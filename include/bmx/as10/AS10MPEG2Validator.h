@@ -32,8 +32,15 @@
 
 #include <string.h>
 #include <map>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 #include <bmx/EssenceType.h>
+#include <bmx/ByteArray.h>
 #include <bmx/mxf_helper/MPEG2Validator.h>
 #include <bmx/as10/AS10ShimNames.h>
 
@@ -96,9 +103,36 @@ public:
                        bool print_defaults, bool loose_checks);
     virtual ~AS10MPEG2Validator();
 
+    // check the frame headers on a separate thread with a queue of up to max_queued frames
+    void SetValidationThread(uint32_t max_queued);
+    // only check the frames in every interval'th GOP
+    void SetGOPSampleInterval(uint32_t interval);
+
     virtual void ProcessFrame(const unsigned char *data, uint32_t size);
     virtual void CompleteWrite();
 
+private:
+    typedef struct
+    {
+        bool single_sequence;
+        uint32_t bit_rate;
+        bool have_gop_header;
+        uint16_t max_gop;
+        bool closed_gop;
+        bool identical_gop;
+    } WriterHelperState;
+
+    typedef struct
+    {
+        ByteArray *buffer;
+        WriterHelperState state;
+    } QueuedFrame;
+
+    void GetWriterHelperState(WriterHelperState *state);
+    void CheckFrame(const unsigned char *data, uint32_t size, const WriterHelperState &state);
+    void StopValidationThread();
+    void ValidationThread();
+
 private:
     void ParseDescriptorRefValues(const char *filename);
     void shim(AS10Shim as10_shim);
@@ -125,7 +159,21 @@ private:
     bool mAllHeadersChecks;
     bool mLooseChecks;
     std::vector<descriptor> mMXFDescriptors;
-    void AllHeadersChecks();
+
+    uint32_t mGOPSampleInterval;
+    uint32_t mGOPCount;
+
+    uint32_t mMaxQueued;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mQueuedCond;
+    std::condition_variable mCheckedCond;
+    std::deque<QueuedFrame> mQueue;
+    std::vector<ByteArray*> mFreeBuffers;
+    bool mStop;
+    std::exception_ptr mError;
+
+    void AllHeadersChecks(const WriterHelperState &state);
     void AssignMapVals();
     void log_warn_descr_value(const DescriptorValue *dv);
     void modify_descriptors(std::vector<descriptor> &mxf_descriptors, const char *name, const int &modified, const char *value);
@@ -76,6 +76,7 @@ public:
     void SetCreationDate(mxfTimestamp creation_date);
     void ReserveHeaderMetadataSpace(uint32_t min_bytes);
     void ForceWriteCBEDuration0(bool enable);
+    void SetTrackWriterThreads(uint32_t queue_size);                // default 0 (disabled); AS02 and Avid only
 
 public:
     ClipWriterTrack* CreateTrack(EssenceType essence_type, std::string track_filename = "");
@@ -124,6 +125,7 @@ private:
     WaveWriter *mWaveClip;
 
     std::vector<ClipWriterTrack*> mTracks;
+    uint32_t mTrackWriterQueueSize;
 };
 
 
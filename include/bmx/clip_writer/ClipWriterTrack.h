@@ -47,6 +47,7 @@
 #include <bmx/mxf_helper/TimedTextManifest.h>
 #include <bmx/mxf_helper/TimedTextMXFResourceProvider.h>
 #include <bmx/apps/AppUtils.h>
+#include <bmx/clip_writer/TrackWriterThread.h>
 
 
 
@@ -121,6 +122,10 @@ public:
 public:
     void WriteSamples(const unsigned char *data, uint32_t size, uint32_t num_samples);
 
+    void StartWriterThread(uint32_t max_queued);
+    void StopWriterThread();
+    bool HaveWriterThread() const { return mWriterThread != 0; }
+
 public:
     bool IsPicture() const;
 
@@ -149,6 +154,11 @@ public:
     D10XMLTrack* GetD10XMLTrack()   const { return mD10XMLTrack; }
     RDD9XMLTrack* GetRDD9XMLTrack() const { return mRDD9XMLTrack; }
 
+private:
+    friend class TrackWriterThread;
+
+    void WriteSamplesInt(const unsigned char *data, uint32_t size, uint32_t num_samples);
+
 private:
     ClipWriterType mClipType;
     EssenceType mEssenceType;
@@ -161,6 +171,7 @@ private:
     OP1AXMLTrack *mOP1AXMLTrack;
     D10XMLTrack *mD10XMLTrack;
     RDD9XMLTrack *mRDD9XMLTrack;
+    TrackWriterThread *mWriterThread;
 };
 
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef BMX_TRACK_WRITER_THREAD_H_
+#define BMX_TRACK_WRITER_THREAD_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <bmx/ByteArray.h>
+
+
+
+namespace bmx
+{
+
+
+class ClipWriterTrack;
+
+
+class TrackWriterThread
+{
+public:
+    TrackWriterThread(ClipWriterTrack *track, uint32_t max_queued);
+    ~TrackWriterThread();
+
+    void WriteSamples(const unsigned char *data, uint32_t size, uint32_t num_samples);
+    void Flush();
+    void Stop();
+
+private:
+    typedef struct
+    {
+        ByteArray *buffer;
+        uint32_t num_samples;
+    } QueuedSamples;
+
+    void WriteThread();
+
+private:
+    ClipWriterTrack *mTrack;
+    uint32_t mMaxQueued;
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mQueuedCond;
+    std::condition_variable mWrittenCond;
+    std::deque<QueuedSamples> mQueue;
+    std::vector<ByteArray*> mFreeBuffers;
+    bool mStop;
+    std::exception_ptr mError;
+};
+
+
+};
+
+
+
+#endif
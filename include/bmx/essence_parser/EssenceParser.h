@@ -48,12 +48,21 @@ namespace bmx
 class EssenceParser
 {
 public:
+    EssenceParser() : mRequiredFrameDataSize(0) {}
     virtual ~EssenceParser() {}
 
     virtual uint32_t ParseFrameStart(const unsigned char *data, uint32_t data_size) = 0;
     virtual uint32_t ParseFrameSize(const unsigned char *data, uint32_t data_size) = 0;
 
     virtual void ParseFrameInfo(const unsigned char *data, uint32_t data_size) = 0;
+
+    // ParseFrameSize is called again with the same data and more bytes appended each time it returns
+    // ESSENCE_PARSER_NULL_OFFSET. Parsers either resume from where they stopped or set the data
+    // size that is known to be required before the frame size can be determined. 0 means unknown
+    uint32_t GetRequiredFrameDataSize() const { return mRequiredFrameDataSize; }
+
+protected:
+    uint32_t mRequiredFrameDataSize;
 };
 
 
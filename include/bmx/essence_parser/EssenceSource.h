@@ -52,6 +52,10 @@ public:
     virtual bool SeekStart() = 0;
     virtual bool Skip(int64_t offset) = 0;
 
+    // Returns the size of the remaining data in the current unit, e.g. a file in a sequence,
+    // or 0 if the source has no units or is at the end
+    virtual uint32_t GetNextUnitSize() { return 0; }
+
     virtual bool HaveError() const = 0;
     virtual int GetErrno() const = 0;
     virtual std::string GetStrError() const = 0;
@@ -31,6 +31,11 @@
 #define BMX_FILE_PATTERN_ESSENCE_SOURCE_H_
 
 #include <map>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <bmx/essence_parser/EssenceSource.h>
 #include <bmx/ByteArray.h>
@@ -46,6 +51,8 @@ public:
     FilePatternEssenceSource(bool fill_gaps);
     virtual ~FilePatternEssenceSource();
 
+    void SetPrefetch(uint32_t num_files);
+
     bool Open(const std::string &pattern, int64_t start_offset);
 
 public:
@@ -53,6 +60,8 @@ public:
     virtual bool SeekStart();
     virtual bool Skip(int64_t offset);
 
+    virtual uint32_t GetNextUnitSize();
+
     virtual bool HaveError() const { return mErrno != 0; }
     virtual int GetErrno() const   { return mErrno; }
     virtual std::string GetStrError() const;
@@ -61,6 +70,13 @@ private:
     int64_t ReadOrSkip(unsigned char *data, uint32_t size, int64_t skip_offset);
     bool NextFile();
     bool BufferFile();
+    bool TakePrefetchedFile();
+
+    void StartPrefetch();
+    void StopPrefetch();
+    void QueuePrefetch();
+    void RecyclePrefetchFile(std::unique_lock<std::mutex> &lock);
+    void PrefetchWorker();
 
     std::string GetCurrentFilePath() const { return mDirname + "/" + mCurrentFilename; }
 
@@ -73,9 +89,30 @@ private:
     std::map<int, std::string> mFilenames;
     std::map<int, std::string>::const_iterator mNextFilenamesIter;
     int64_t mCurrentNumber;
+    int mCurrentFileNumber;
     std::string mCurrentFilename;
-    bmx::ByteArray mFileBuffer;
+    bmx::ByteArray *mFileBuffer;
     uint32_t mFileBufferOffset;
+
+    typedef struct
+    {
+        int number;
+        std::string filepath;
+        bmx::ByteArray *buffer;
+        bool claimed;
+        bool done;
+        int err;
+    } PrefetchFile;
+
+    uint32_t mPrefetchCount;
+    std::vector<std::thread> mPrefetchThreads;
+    std::mutex mPrefetchMutex;
+    std::condition_variable mPrefetchQueuedCond;
+    std::condition_variable mPrefetchDoneCond;
+    std::deque<PrefetchFile*> mPrefetchFiles;
+    std::map<int, std::string>::const_iterator mPrefetchFilenamesIter;
+    std::vector<bmx::ByteArray*> mFreeBuffers;
+    bool mStopPrefetch;
 };
 
 
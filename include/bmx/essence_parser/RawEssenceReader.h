@@ -52,6 +52,7 @@ public:
     void SetMaxReadLength(int64_t len);
 
     void SetFixedSampleSize(uint32_t size);
+    void SetSampleSizeFromSource(bool enable);
 
     virtual void SetEssenceParser(EssenceParser *essence_parser);
     void SetCheckMaxSampleSize(uint32_t size);
@@ -72,6 +73,9 @@ public:
 
 protected:
     bool ReadAndParseSample();
+    bool ReadSourceSample();
+    uint32_t GetParseReadSize(uint32_t sample_num_read) const;
+    void GrowSampleBuffer(uint32_t size);
     uint32_t ReadBytes(uint32_t size);
     void ShiftSampleData(uint32_t to_offset, uint32_t from_offset);
 
@@ -85,6 +89,7 @@ protected:
     uint32_t mMaxSampleSize;
 
     uint32_t mFixedSampleSize;
+    bool mSampleSizeFromSource;
     EssenceParser *mEssenceParser;
 
     ByteArray mSampleBuffer;
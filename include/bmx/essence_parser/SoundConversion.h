@@ -48,6 +48,12 @@ uint32_t convert_aes3_to_pcm(const unsigned char *aes3_data, uint32_t aes3_data_
                              uint32_t bits_per_sample, uint8_t channel_num,
                              unsigned char *pcm_data, uint32_t pcm_data_size);
 
+// Converts channels [0, channel_count) in a single pass. pcm_data has channel_count entries of at least
+// pcm_data_size bytes each and channels with a null entry are skipped
+uint32_t convert_aes3_to_pcm_channels(const unsigned char *aes3_data, uint32_t aes3_data_size, bool ignore_valid_flags,
+                                      uint32_t bits_per_sample, uint8_t channel_count,
+                                      unsigned char * const *pcm_data, uint32_t pcm_data_size);
+
 uint32_t convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t aes3_data_size, bool ignore_valid_flags,
                                 uint32_t bits_per_sample, uint8_t channel_count,
                                 unsigned char *pcm_data, uint32_t pcm_data_size);
@@ -60,6 +66,18 @@ void interleave_audio(const unsigned char *input_data, uint32_t input_data_size,
                       uint32_t bits_per_sample, uint16_t channel_count, uint16_t channel_num,
                       unsigned char *output_data, uint32_t output_data_size);
 
+// Splits all channels in a single pass over the input. output_data has channel_count entries of at least
+// output_data_size bytes each and channels with a null entry are skipped
+void deinterleave_audio_channels(const unsigned char *input_data, uint32_t input_data_size,
+                                 uint32_t bits_per_sample, uint16_t channel_count,
+                                 unsigned char * const *output_data, uint32_t output_data_size);
+
+// Interleaves all channels in a single pass over the output. input_data has channel_count entries of
+// input_data_size bytes each and channels with a null entry are set to silence
+void interleave_audio_channels(const unsigned char * const *input_data, uint32_t input_data_size,
+                               uint32_t bits_per_sample, uint16_t channel_count,
+                               unsigned char *output_data, uint32_t output_data_size);
+
 
 
 };
@@ -38,6 +38,7 @@
 #include <string>
 
 #include <bmx/BMXTypes.h>
+#include <mxf/mxf_file.h>
 #include <bmx/ByteArray.h>
 
 
@@ -80,12 +81,18 @@ public:
     virtual void SetSize(uint32_t size) = 0;
     virtual void IncrementSize(uint32_t inc) = 0;
 
+    // frames that return true can hold a reference to data owned elsewhere, e.g. a memory mapped file region,
+    // and release it when no longer needed. The default implementation copies the data and releases the reference
+    virtual bool CanReferenceData() const { return false; }
+    virtual void ReferenceData(const unsigned char *data, uint32_t size, MXFFileDataRef *ref);
+
     virtual Frame* Clone() = 0;
 
 public:
     bool IsEmpty() const    { return num_samples == 0; }
     bool IsComplete() const { return num_samples == request_num_samples; }
 
+    // the map may contain empty entries if the frame reuses the metadata containers of a previous frame
     const std::map<std::string, std::vector<FrameMetadata*> >& GetMetadata() const { return mMetadata; }
     const std::vector<FrameMetadata*>* GetMetadata(std::string id) const;
     void InsertMetadata(FrameMetadata *metadata);
@@ -114,6 +121,9 @@ public:
 
     mxfKey element_key;
 
+protected:
+    void CopyProperties(const Frame &from);
+
 protected:
     std::map<std::string, std::vector<FrameMetadata*> > mMetadata;
 };
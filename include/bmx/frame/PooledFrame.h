@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_POOLED_FRAME_H_
+#define BMX_POOLED_FRAME_H_
+
+
+#include <vector>
+#include <mutex>
+
+#include <bmx/frame/Frame.h>
+
+
+
+namespace bmx
+{
+
+
+class PooledFramePool;
+
+
+// The data and metadata containers of a pooled frame. The storage is kept in the pool when the frame is
+// deleted and is handed to the next frame, so the data capacity and metadata map entries are reused
+
+class PooledFrameStorage
+{
+public:
+    PooledFrameStorage(PooledFramePool *pool_);
+
+public:
+    PooledFramePool *pool;
+    ByteArray data;
+    std::map<std::string, std::vector<FrameMetadata*> > metadata;
+};
+
+
+// A free list of frame blocks, each holding a PooledFrameStorage followed by the memory for a PooledFrame.
+// The pool is shared by a PooledFrameFactory and the frames it created and is deleted once they are all gone
+
+class PooledFramePool
+{
+public:
+    PooledFramePool(size_t max_free_frames);
+
+    void Retain();
+    void Release();
+
+    void* AllocateFrame(size_t size);
+    void FreeFrame(void *ptr);
+
+    uint64_t GetNumFrameAllocs() const { return mNumFrameAllocs; }
+
+private:
+    ~PooledFramePool();
+
+private:
+    std::mutex mMutex;
+    int mRefCount;
+    size_t mMaxFreeFrames;
+    std::vector<unsigned char*> mFreeBlocks;
+    uint64_t mNumFrameAllocs;
+};
+
+
+class PooledFrame : public Frame
+{
+public:
+    static void* operator new(size_t size, PooledFramePool *pool);
+    static void operator delete(void *ptr, PooledFramePool *pool);
+    static void operator delete(void *ptr);
+
+public:
+    virtual ~PooledFrame();
+
+    virtual uint32_t GetSize() const;
+    virtual const unsigned char* GetBytes() const;
+
+    virtual void Grow(uint32_t min_size);
+    virtual uint32_t GetSizeAvailable() const;
+    virtual unsigned char* GetBytesAvailable() const;
+    virtual void SetSize(uint32_t size);
+    virtual void IncrementSize(uint32_t inc);
+
+    virtual Frame* Clone();
+
+private:
+    friend class PooledFrameFactory;
+
+    PooledFrame();
+    PooledFrame(const PooledFrame &from);
+
+    static PooledFrameStorage* GetStorage(void *ptr);
+
+private:
+    PooledFrameStorage *mStorage;
+};
+
+
+// A frame factory that recycles frames. Each track's frame buffer owns its own factory and therefore has its
+// own free list, which means a recycled frame's data capacity matches the frame sizes of that track
+
+class PooledFrameFactory : public FrameFactory
+{
+public:
+    PooledFrameFactory(size_t max_free_frames = 16);
+    virtual ~PooledFrameFactory();
+
+    virtual Frame* CreateFrame();
+
+    uint64_t GetNumFrameAllocs() const { return mPool->GetNumFrameAllocs(); }
+
+private:
+    PooledFramePool *mPool;
+};
+
+
+};
+
+
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_SLICE_FRAME_H_
+#define BMX_SLICE_FRAME_H_
+
+
+#include <vector>
+#include <mutex>
+
+#include <bmx/frame/Frame.h>
+
+
+
+namespace bmx
+{
+
+
+// A pool of data slabs shared by a SliceFrameFactory and the frames it created. Slabs are returned to the
+// pool when a frame is deleted and the pool is deleted once the factory and all its frames are gone
+
+class SliceFramePool
+{
+public:
+    SliceFramePool(size_t max_free_slabs);
+
+    void Retain();
+    void Release();
+
+    unsigned char* AcquireSlab(uint32_t min_size, uint32_t *capacity);
+    void ReleaseSlab(unsigned char *slab, uint32_t capacity);
+
+    uint64_t GetNumSlabAllocs() const { return mNumSlabAllocs; }
+
+private:
+    ~SliceFramePool();
+
+private:
+    typedef struct
+    {
+        unsigned char *data;
+        uint32_t capacity;
+    } Slab;
+
+    std::mutex mMutex;
+    int mRefCount;
+    size_t mMaxFreeSlabs;
+    std::vector<Slab> mFreeSlabs;
+    uint64_t mNumSlabAllocs;
+};
+
+
+// A frame that references a slice of file data (see mxf_file_read_ref) or otherwise holds its data in a
+// slab taken from the pool. Referenced data is copied into a slab if the frame is grown
+
+class SliceFrame : public Frame
+{
+public:
+    static void* operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
+public:
+    SliceFrame(SliceFramePool *pool);
+    virtual ~SliceFrame();
+
+    virtual uint32_t GetSize() const;
+    virtual const unsigned char* GetBytes() const;
+
+    virtual void Grow(uint32_t min_size);
+    virtual uint32_t GetSizeAvailable() const;
+    virtual unsigned char* GetBytesAvailable() const;
+    virtual void SetSize(uint32_t size);
+    virtual void IncrementSize(uint32_t inc);
+
+    virtual bool CanReferenceData() const;
+    virtual void ReferenceData(const unsigned char *data, uint32_t size, MXFFileDataRef *ref);
+
+    virtual Frame* Clone();
+
+private:
+    SliceFrame(const SliceFrame &from);
+
+    void ReleaseData();
+
+private:
+    SliceFramePool *mPool;
+
+    const unsigned char *mRefData;
+    MXFFileDataRef *mRef;
+
+    unsigned char *mSlab;
+    uint32_t mSlabCapacity;
+
+    uint32_t mSize;
+};
+
+
+class SliceFrameFactory : public FrameFactory
+{
+public:
+    SliceFrameFactory(size_t max_free_slabs = 16);
+    virtual ~SliceFrameFactory();
+
+    virtual Frame* CreateFrame();
+
+    uint64_t GetNumSlabAllocs() const { return mPool->GetNumSlabAllocs(); }
+
+private:
+    SliceFramePool *mPool;
+};
+
+
+};
+
+
+
+#endif
+
@@ -33,7 +33,7 @@
 #define BMX_OP1A_INDEX_TABLE_H_
 
 #include <vector>
-#include <set>
+#include <map>
 
 #include <bmx/ByteArray.h>
 
@@ -98,6 +98,7 @@ public:
 
     bool RequireUpdatesAtEnd(int64_t end_offset) const;
     bool RequireUpdatesAtPos(int64_t position) const;
+    void ClearRequiredUpdate(int64_t position);
     void IgnoreRequiredUpdates();
 
 public:
@@ -110,11 +111,27 @@ public:
 
     uint32_t element_size;
 
-    std::set<int64_t> require_updates;
     int64_t last_add_index_entry_pos;
 
 private:
-    std::map<int64_t, OP1AIndexEntry> mIndexEntryCache;
+    typedef struct
+    {
+        int64_t position;
+        OP1AIndexEntry entry;
+        bool have_entry;
+        bool require_update;
+    } CacheSlot;
+
+    CacheSlot* GetCacheSlot(int64_t position);
+    CacheSlot* AllocCacheSlot(int64_t position);
+    void ReleaseCacheSlot(CacheSlot *slot);
+    void GrowCache();
+
+private:
+    std::vector<CacheSlot> mIndexEntryCache;
+    size_t mNumCacheEntries;
+    size_t mNumRequireUpdates;
+    int64_t mFirstRequireUpdate;
 };
 
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_ESSENCE_READ_AHEAD_H_
+#define BMX_ESSENCE_READ_AHEAD_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include <libMXF++/MXF.h>
+
+#include <bmx/ByteArray.h>
+
+
+
+namespace bmx
+{
+
+
+class EssenceReadAheadPool;
+
+// Reads the content packages of upcoming edit units ahead of the essence reader, with up to a queue depth
+// of reads queued. The reads are performed by a pool of threads that is shared by all read-aheads in the process.
+// Each read-ahead has a small number of file handles, opened using the default file factory, which limits the
+// reads it has in flight.
+class EssenceReadAhead
+{
+public:
+    friend class EssenceReadAheadPool;
+
+public:
+    EssenceReadAhead(const std::string &filename, mxfpp::File *file, uint32_t queue_depth);
+    ~EssenceReadAhead();
+
+    bool Start();
+
+    uint32_t GetQueueDepth() const { return mQueueDepth; }
+    size_t GetNumQueued() const    { return mRequests.size(); }
+    int64_t GetEndPosition() const;
+
+    void Queue(int64_t position, int64_t file_position, uint32_t size);
+    bool Take(int64_t position, const unsigned char **data, uint32_t *size, int64_t *file_position);
+    void Clear();
+
+private:
+    typedef struct
+    {
+        int64_t position;
+        int64_t file_position;
+        uint32_t size;
+        ByteArray data;
+        bool done;
+        bool failed;
+    } Request;
+
+private:
+    bool ReadNext();
+
+private:
+    std::string mFilename;
+    mxfpp::File *mFile;
+    uint32_t mQueueDepth;
+    std::vector<mxfpp::File*> mFiles;
+    std::vector<mxfpp::File*> mFreeFiles;
+    EssenceReadAheadPool *mPool;
+
+    std::mutex mMutex;
+    std::condition_variable mDoneCond;
+    std::deque<std::shared_ptr<Request> > mRequests;
+    std::deque<std::shared_ptr<Request> > mPending;
+    std::shared_ptr<Request> mCurrent;
+    uint32_t mNumJobs;
+};
+
+
+};
+
+
+
+#endif
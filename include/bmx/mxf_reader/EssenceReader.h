@@ -34,12 +34,15 @@
 
 
 #include <vector>
+#include <utility>
 #include <deque>
 
 #include <bmx/frame/Frame.h>
+#include <bmx/ByteArray.h>
 #include <bmx/mxf_reader/FrameMetadataReader.h>
 #include <bmx/mxf_reader/EssenceChunkHelper.h>
 #include <bmx/mxf_reader/IndexTableHelper.h>
+#include <bmx/mxf_reader/EssenceReadAhead.h>
 
 
 
@@ -48,6 +51,7 @@ namespace bmx
 
 
 class MXFFileReader;
+class MXFTrackReader;
 
 
 class EssenceReaderBuffer
@@ -62,6 +66,7 @@ public:
 
     Frame* GetFrame(uint32_t track_index);
     void PushFrames(uint32_t actual_read_num_samples);
+    void AbortRead();
 
     size_t GetBufferSize() const { return mRequestSampleCounts.size(); }
 
@@ -94,6 +99,7 @@ public:
 
     void SetReadLimits(int64_t start_position, int64_t duration);
     void SetBufferFrames(bool enable);
+    void SetReadAhead(const std::string &filename, uint32_t queue_depth);
 
     uint32_t Read(uint32_t num_samples);
     void Seek(int64_t position);
@@ -108,6 +114,8 @@ public:
 
     bool IsComplete() const;
 
+    IndexTableHelper* GetIndexTableHelper() { return &mIndexTableHelper; }
+
 private:
     uint32_t ReadClipWrappedSamples(uint32_t num_samples);
     uint32_t ReadFrameWrappedSamples(uint32_t num_samples);
@@ -118,6 +126,11 @@ private:
 
     uint32_t GetConstantEditUnitSize();
 
+private:
+    void StartCoalescedRead(int64_t position, uint32_t max_samples);
+    bool StartReadAheadRead(int64_t position);
+    void EndCoalescedRead();
+
 private:
     bool SeekEssence(int64_t base_position);
     bool ReadEssenceKL(bool first_element, mxfKey *key, uint8_t *llen, uint64_t *len);
@@ -131,7 +144,7 @@ private:
     bool ReadNonfirstEssenceKL(mxfKey *key, uint8_t *llen, uint64_t *len);
     bool SeekContentPackageStart();
 
-    void ReadNextPartition(const mxfKey *key, uint8_t llen, uint64_t len);
+    size_t ReadNextPartition(const mxfKey *key, uint8_t llen, uint64_t len);
 
     void SetHaveFooter();
     void SetFileIsComplete();
@@ -158,6 +171,7 @@ private:
     uint32_t mImageEndOffset;
 
     EssenceReaderBuffer mReadFrameBuffer;
+    std::vector<std::pair<uint32_t, MXFTrackReader*> > mEnabledTrackReaders;
 
     int64_t mBasePosition;
     int64_t mFilePosition;
@@ -170,6 +184,11 @@ private:
     int64_t mLastKnownBasePosition;
     bool mHaveFooter;
     bool mBaseReadError;
+
+    ByteArray mCoalescedData;
+    ::MXFFile *mCoalescedFileSave;
+    int64_t mCoalescedEndPosition;
+    EssenceReadAhead *mReadAhead;
 };
 
 
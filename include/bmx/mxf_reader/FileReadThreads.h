@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef BMX_FILE_READ_THREADS_H_
+#define BMX_FILE_READ_THREADS_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <libMXF++/MXF.h>
+
+
+
+namespace bmx
+{
+
+
+// Runs independent read tasks, eg. reading partition packs or index table segments at open, concurrently.
+// Each thread reads using its own file handle, which is opened using the default file factory.
+class FileReadThreads : public mxfpp::PartitionPackReader
+{
+public:
+    typedef std::function<void(mxfpp::File *file, size_t task_index)> Task;
+
+public:
+    FileReadThreads(const std::string &filename, mxfpp::File *file, uint32_t num_threads);
+    virtual ~FileReadThreads();
+
+    void Run(size_t num_tasks, const Task &task);
+
+public:
+    // from mxfpp::PartitionPackReader
+    virtual std::vector<mxfpp::Partition*> readPartitionPacks(mxfpp::File *file, const std::vector<uint64_t> &offsets);
+
+private:
+    bool OpenFiles();
+
+private:
+    std::string mFilename;
+    mxfpp::File *mFile;
+    uint32_t mNumThreads;
+    std::vector<mxfpp::File*> mFiles;
+    bool mOpenFailed;
+};
+
+
+};
+
+
+
+#endif
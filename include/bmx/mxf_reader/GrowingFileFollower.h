@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BMX_GROWING_FILE_FOLLOWER_H_
+#define BMX_GROWING_FILE_FOLLOWER_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <bmx/mxf_reader/MXFReader.h>
+
+
+
+namespace bmx
+{
+
+
+// Reads from input files that are still being written. A read that fails because the data has not yet been
+// written is retried as soon as one of the files grows. File changes are signalled using inotify where it is
+// available and otherwise detected by polling the file sizes. The essence reader retries from the last known
+// content package and skips the partition packs that were already read before the failure.
+class GrowingFileFollower
+{
+public:
+    typedef std::function<void(int64_t position, uint32_t num_samples)> FramesAvailableCallback;
+
+public:
+    GrowingFileFollower(MXFReader *reader, const std::vector<std::string> &filenames);
+    ~GrowingFileFollower();
+
+    void SetMaxWaits(uint32_t max_waits, uint32_t wait_msec);  // default: 10 waits of 1000 msec without file growth
+    void SetPollInterval(uint32_t msec);                       // default: 10 msec
+    void SetFramesAvailableCallback(const FramesAvailableCallback &callback);
+
+    uint32_t Read(uint32_t num_samples);
+
+    bool WaitForGrowth(uint32_t timeout_msec);
+
+    bool HaveWaited() const         { return mHaveWaited; }
+    bool ReachedMaxWaits() const    { return mNumWaits >= mMaxWaits; }
+    bool IsNotifyEnabled() const    { return mNotifyFd >= 0; }
+
+private:
+    bool CheckGrowth();
+    bool WaitForNotify(uint32_t timeout_msec);
+
+private:
+    MXFReader *mReader;
+    std::vector<std::string> mFilenames;
+    std::vector<int64_t> mFileSizes;
+    uint32_t mMaxWaits;
+    uint32_t mWaitMSec;
+    uint32_t mPollInterval;
+    FramesAvailableCallback mFramesAvailableCallback;
+    int mNotifyFd;
+    uint32_t mNumWaits;
+    bool mHaveWaited;
+    bool mIsFollowing;
+};
+
+
+};
+
+
+
+#endif
@@ -55,6 +55,7 @@ public:
     virtual ~IndexTableHelperSegment();
 
     void ReadIndexTableSegment(mxfpp::File *file, uint64_t segment_len);
+    void ReadIndexTableSegmentHeader(mxfpp::File *file, uint64_t segment_len);
     void ProcessIndexTableSegment(Rational expected_edit_rate);
 
     bool HaveExtraIndexEntries() const { return mHaveExtraIndexEntries; }
@@ -84,6 +85,20 @@ public:
 
     void CopyIndexEntries(const IndexTableHelperSegment *segment, uint32_t duration);
 
+    bool IsLazy() const            { return mIsLazy; }
+    bool HaveIndexEntries() const  { return mIndexEntries != 0; }
+    bool ContainsPosition(int64_t position) const;
+    void LoadIndexEntries(mxfpp::File *file);
+    void UnloadIndexEntries();
+    void ClearLazy()               { mIsLazy = false; }
+    int64_t GetIndexEntriesSize() const;
+
+    void SetLastAccess(uint64_t count) { mLastAccess = count; }
+    uint64_t GetLastAccess() const     { return mLastAccess; }
+
+    void WriteCache(mxfpp::File *file);
+    void ReadCache(mxfpp::File *file);
+
 private:
     unsigned char *mIndexEntries;
     uint32_t mAllocIndexEntries;
@@ -97,6 +112,12 @@ private:
     int64_t mEssenceStartOffset;
 
     bool mIsFileIndexSegment;
+
+    bool mIsLazy;
+    int64_t mFilePosition;
+    uint64_t mSegmentLen;
+    uint32_t mFileNumIndexEntries;
+    uint64_t mLastAccess;
 };
 
 
@@ -138,7 +159,18 @@ public:
 
     bool GetIndexEntry(MXFIndexEntryExt *entry, int64_t position);
 
+public:
+    bool CanWriteCache() const;
+    void WriteCache(mxfpp::File *file);
+    void ReadCache(mxfpp::File *file);
+
 private:
+    int64_t AddIndexTableSegment(std::unique_ptr<IndexTableHelperSegment> &new_segment);
+    int GetSegmentEditUnit(size_t index, int64_t position, int8_t *temporal_offset, int8_t *key_frame_offset,
+                           uint8_t *flags, int64_t *offset);
+    void LoadLazySegment(IndexTableHelperSegment *segment);
+    void ReleaseLazySegment(IndexTableHelperSegment *segment);
+    void PinSegment(IndexTableHelperSegment *segment);
     void InsertCBEIndexSegment(std::unique_ptr<IndexTableHelperSegment> &new_segment_up);
     void InsertVBEIndexSegment(std::unique_ptr<IndexTableHelperSegment> &new_segment_up);
 
@@ -159,6 +191,10 @@ private:
 
     Rational mEditRate;
     int64_t mDuration;
+
+    std::vector<IndexTableHelperSegment*> mLoadedLazySegments;
+    int64_t mLazyIndexMemory;
+    uint64_t mAccessCount;
 };
 
 
@@ -43,6 +43,8 @@
 #include <bmx/mxf_reader/MXFReader.h>
 #include <bmx/mxf_reader/MXFFileTrackReader.h>
 #include <bmx/mxf_reader/EssenceReader.h>
+#include <bmx/mxf_reader/FileReadThreads.h>
+#include <bmx/mxf_reader/MXFOpenCache.h>
 #include <bmx/mxf_reader/MXFPackageResolver.h>
 #include <bmx/mxf_helper/MXFFileFactory.h>
 #include <bmx/URI.h>
@@ -97,6 +99,10 @@ public:
     void SetFileFactory(MXFFileFactory *factory, bool take_ownership);
     virtual void SetEmptyFrames(bool enable);
     void SetST436ManifestFrameCount(uint32_t count);     // default: 2 frames used to extract manifest
+    void SetOpenThreads(uint32_t num_threads);           // default: 1, partitions and index tables read serially
+    void SetLazyIndex(bool enable, uint64_t memory_limit = 0);  // default: false, index entries are read at open
+    void SetOpenCacheDir(const std::string &dir);        // default: no sidecar open cache files are used
+    void SetReadAhead(uint32_t queue_depth);             // default: 0, essence is read when requested
     virtual void SetFileIndex(MXFFileIndex *file_index, bool take_ownership);
     virtual void SetMCALabelIndex(MXFMCALabelIndex *label_index, bool take_ownership);
 
@@ -264,6 +270,16 @@ private:
     uint32_t mRequireFrameInfoCount;
     uint32_t mST436ManifestCount;
 
+    uint32_t mOpenThreads;
+    FileReadThreads *mFileReadThreads;
+    std::string mOpenCacheDir;
+    MXFOpenCache *mOpenCache;
+
+    bool mLazyIndex;
+    uint64_t mLazyIndexMemoryLimit;
+
+    uint32_t mReadAheadDepth;
+
     std::set<mxfpp::SourcePackage*> mMCALabelIndexedPackages;
 };
 
@@ -33,6 +33,10 @@
 #define BMX_MXF_GROUP_READER_H_
 
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 #include <bmx/mxf_reader/MXFReader.h>
 
@@ -54,6 +58,9 @@ public:
     void AddReader(MXFReader *reader);
     bool Finalize();
 
+    // read the members concurrently using up to num_threads threads, including the calling thread
+    void SetReadThreads(uint32_t num_threads);
+
 public:
     virtual MXFFileReader* GetFileReader(size_t file_id);
     virtual std::vector<size_t> GetFileIds(bool internal_ess_only) const;
@@ -102,6 +109,13 @@ private:
     void CompleteRead();
     void AbortRead();
 
+    uint32_t ReadMember(size_t i, int64_t current_position, uint32_t num_samples);
+    uint32_t ReadMembersParallel(int64_t current_position, uint32_t num_samples);
+    void ReadMembersTasks(std::unique_lock<std::mutex> &lock);
+    void StartReadThreads();
+    void StopReadThreads();
+    void ReadThread();
+
 private:
     bool mEmptyFrames;
     bool mEmptyFramesSet;
@@ -116,6 +130,20 @@ private:
 
     std::vector<std::vector<uint32_t> > mSampleSequences;
     std::vector<int64_t> mSampleSequenceSizes;
+
+    uint32_t mNumReadThreads;
+    std::vector<std::thread> mReadThreads;
+    std::mutex mReadMutex;
+    std::condition_variable mReadTaskCond;
+    std::condition_variable mReadDoneCond;
+    bool mStopReadThreads;
+    std::vector<size_t> mReadTaskMembers;
+    size_t mNextReadTask;
+    size_t mNumPendingReadTasks;
+    int64_t mReadTaskPosition;
+    uint32_t mReadTaskNumSamples;
+    std::vector<uint32_t> mReadTaskNumRead;
+    std::vector<std::exception_ptr> mReadTaskErrors;
 };
 
 
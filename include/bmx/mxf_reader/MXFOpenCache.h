@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+
+#ifndef BMX_MXF_OPEN_CACHE_H_
+#define BMX_MXF_OPEN_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include <libMXF++/MXF.h>
+
+
+
+namespace bmx
+{
+
+
+class IndexTableHelper;
+
+
+// A sidecar file that caches the partition packs and the processed index table of an MXF file so that
+// re-opening the file doesn't require reading these from across the file again.
+// The cache is only used if the file size, modification time and header partition pack are unchanged and the
+// partition offsets in the file's Random Index Pack match.
+class MXFOpenCache : public mxfpp::PartitionPackReader
+{
+public:
+    static std::string GetCacheFilename(const std::string &cache_dir, const std::string &filename);
+
+public:
+    MXFOpenCache(const std::string &cache_dir, const std::string &filename);
+    virtual ~MXFOpenCache();
+
+    void SetFallbackReader(mxfpp::PartitionPackReader *reader);
+
+    bool Load(mxfpp::File *file);
+    bool IsLoaded() const { return mIsLoaded; }
+
+    bool ReadIndexTable(uint32_t index_sid, IndexTableHelper *index_table);
+
+    void Save(mxfpp::File *file, uint32_t index_sid, IndexTableHelper *index_table);
+
+public:
+    // from mxfpp::PartitionPackReader
+    virtual std::vector<mxfpp::Partition*> readPartitionPacks(mxfpp::File *file, const std::vector<uint64_t> &offsets);
+
+private:
+    void ReadFileIdentity(mxfpp::File *file);
+    void Clear();
+
+private:
+    std::string mCacheDir;
+    std::string mCacheFilename;
+    std::string mFilename;
+    mxfpp::PartitionPackReader *mFallbackReader;
+
+    int64_t mFileSize;
+    int64_t mFileModTime;
+    unsigned char mHeaderDigest[16];
+
+    bool mIsLoaded;
+    mxfpp::File *mCacheFile;
+    std::vector<mxfpp::Partition*> mPartitions;
+    uint32_t mIndexSID;
+    int64_t mIndexTableOffset;
+};
+
+
+};
+
+
+
+#endif
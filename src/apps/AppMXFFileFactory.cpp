@@ -54,9 +54,17 @@ AppMXFFileFactory::AppMXFFileFactory()
     mInputFlags = 0;
     mRWInterleaver = 0;
     mHTTPMinReadSize = 64 * 1024;
-#if defined(_WIN32) && !defined(__MINGW32__)
+    mHTTPReadAhead = 8;
+#if !defined(__MINGW32__)
     mUseMMapFile = false;
 #endif
+#if !defined(_WIN32)
+    mDirectIOOutput = false;
+    mOutputPreallocateSize = 0;
+    mInputCacheHints = MXF_POSIX_CACHE_HINT_DEFAULT;
+    mOutputCacheHints = MXF_POSIX_CACHE_HINT_DEFAULT;
+    mCacheHintWindow = 0;
+#endif
 }
 
 AppMXFFileFactory::~AppMXFFileFactory()
@@ -98,13 +106,33 @@ void AppMXFFileFactory::SetHTTPMinReadSize(uint32_t size)
     mHTTPMinReadSize = size;
 }
 
-#if defined(_WIN32) && !defined(__MINGW32__)
+void AppMXFFileFactory::SetHTTPReadAhead(uint32_t max_requests)
+{
+    mHTTPReadAhead = max_requests;
+}
+
+#if !defined(__MINGW32__)
 void AppMXFFileFactory::SetUseMMapFile(bool enable)
 {
     mUseMMapFile = enable;
 }
 #endif
 
+#if !defined(_WIN32)
+void AppMXFFileFactory::SetDirectIOOutput(bool enable, int64_t preallocate_size)
+{
+    mDirectIOOutput = enable;
+    mOutputPreallocateSize = preallocate_size;
+}
+
+void AppMXFFileFactory::SetCacheHints(int input_flags, int output_flags, int64_t window_size)
+{
+    mInputCacheHints = input_flags;
+    mOutputCacheHints = output_flags;
+    mCacheHintWindow = window_size;
+}
+#endif
+
 File* AppMXFFileFactory::OpenNew(string filename)
 {
     MXFFile *mxf_file = 0;
@@ -122,7 +150,14 @@ File* AppMXFFileFactory::OpenNew(string filename)
 #endif
             BMX_CHECK(mxf_win32_file_open_new(filename.c_str(), 0, &mxf_file));
 #else
-        BMX_CHECK(mxf_disk_file_open_new(filename.c_str(), &mxf_file));
+        if (mDirectIOOutput)
+            BMX_CHECK(mxf_posix_direct_open_new(filename.c_str(), mOutputPreallocateSize, &mxf_file));
+        else if (mUseMMapFile)
+            BMX_CHECK(mxf_posix_mmap_open_new(filename.c_str(), 0, &mxf_file));
+        else if (mOutputCacheHints != MXF_POSIX_CACHE_HINT_DEFAULT)
+            BMX_CHECK(mxf_posix_cache_hint_open_new(filename.c_str(), mOutputCacheHints, mCacheHintWindow, &mxf_file));
+        else
+            BMX_CHECK(mxf_disk_file_open_new(filename.c_str(), &mxf_file));
 #endif
 
         if (mRWInterleaver) {
@@ -152,7 +187,7 @@ File* AppMXFFileFactory::OpenRead(string filename)
             uri_str = "stdin:";
         } else {
             if (mxf_http_is_url(filename)) {
-                mxf_file = mxf_http_file_open_read(filename, mHTTPMinReadSize);
+                mxf_file = mxf_http_file_open_read(filename, mHTTPMinReadSize, mHTTPReadAhead);
                 uri_str = filename;
             } else {
 #if defined(_WIN32)
@@ -163,7 +198,16 @@ File* AppMXFFileFactory::OpenRead(string filename)
 #endif
                     BMX_CHECK(mxf_win32_file_open_read(filename.c_str(), mInputFlags, &mxf_file));
 #else
-                BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
+                // the sequential scan flag is passed on as a page cache hint for standard disk files
+                int cache_hints = mInputCacheHints;
+                if (mInputFlags & MXF_POSIX_MMAP_FLAG_SEQUENTIAL_SCAN)
+                    cache_hints |= MXF_POSIX_CACHE_HINT_SEQUENTIAL;
+                if (mUseMMapFile)
+                    BMX_CHECK(mxf_posix_mmap_open_read(filename.c_str(), mInputFlags, &mxf_file));
+                else if (cache_hints != MXF_POSIX_CACHE_HINT_DEFAULT)
+                    BMX_CHECK(mxf_posix_cache_hint_open_read(filename.c_str(), cache_hints, mCacheHintWindow, &mxf_file));
+                else
+                    BMX_CHECK(mxf_disk_file_open_read(filename.c_str(), &mxf_file));
 #endif
             }
         }
@@ -227,7 +271,12 @@ File* AppMXFFileFactory::OpenModify(string filename)
 #endif
             BMX_CHECK(mxf_win32_file_open_modify(filename.c_str(), 0, &mxf_file));
 #else
-        BMX_CHECK(mxf_disk_file_open_modify(filename.c_str(), &mxf_file));
+        if (mUseMMapFile)
+            BMX_CHECK(mxf_posix_mmap_open_modify(filename.c_str(), 0, &mxf_file));
+        else if (mOutputCacheHints != MXF_POSIX_CACHE_HINT_DEFAULT)
+            BMX_CHECK(mxf_posix_cache_hint_open_modify(filename.c_str(), mOutputCacheHints, mCacheHintWindow, &mxf_file));
+        else
+            BMX_CHECK(mxf_disk_file_open_modify(filename.c_str(), &mxf_file));
 #endif
 
         if (mRWInterleaver) {
@@ -52,6 +52,9 @@
 
 #include <mxf/mxf.h>
 #include <mxf/mxf_avid.h>
+#if !defined(_WIN32)
+#include <mxf/mxf_posix_cache_hint.h>
+#endif
 
 #include <bmx/apps/AppUtils.h>
 #include <bmx/clip_writer/ClipWriter.h>
@@ -1012,6 +1015,22 @@ bool bmx::parse_avid_umid_type(const char *str, AvidUMIDType *value)
     return false;
 }
 
+#if !defined(_WIN32)
+bool bmx::parse_cache_hint(const char *mode_str, int *cache_hint_flags)
+{
+    if (strcmp(mode_str, "none") == 0)
+        *cache_hint_flags = MXF_POSIX_CACHE_HINT_DEFAULT;
+    else if (strcmp(mode_str, "seq") == 0)
+        *cache_hint_flags = MXF_POSIX_CACHE_HINT_SEQUENTIAL;
+    else if (strcmp(mode_str, "stream") == 0)
+        *cache_hint_flags = MXF_POSIX_CACHE_HINT_STREAMING;
+    else
+        return false;
+
+    return true;
+}
+#endif
+
 int bmx::parse_three_color_primaries(const char *str, mxfThreeColorPrimaries *three_color_primaries)
 {
     unsigned int value[6];
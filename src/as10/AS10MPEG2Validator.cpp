@@ -60,6 +60,10 @@ AS10MPEG2Validator::AS10MPEG2Validator(AS10Shim as10_shim, const char *fname, in
     mSequenceHeaderChk = mSequenceExtensionChk = mDisplayExtensionChk =
     mPicCodingExtensionChk = mAllHeadersChecks = mPrintParsingReport = mLooseChecks = false;
     mHDRefaults = as10_high_hd_2014_mpeg_values;
+    mGOPSampleInterval = 1;
+    mGOPCount = 0;
+    mMaxQueued = 0;
+    mStop = false;
     AssignMapVals();
 
     for (int i = 0; (AS10_MXF_Descriptors_Arr[i]).name != ""; i++ )
@@ -80,6 +84,29 @@ AS10MPEG2Validator::AS10MPEG2Validator(AS10Shim as10_shim, const char *fname, in
 
 AS10MPEG2Validator::~AS10MPEG2Validator()
 {
+    StopValidationThread();
+
+    size_t i;
+    for (i = 0; i < mQueue.size(); i++)
+        delete mQueue[i].buffer;
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        delete mFreeBuffers[i];
+}
+
+void AS10MPEG2Validator::SetValidationThread(uint32_t max_queued)
+{
+    BMX_CHECK(max_queued > 0);
+    BMX_CHECK(!mThread.joinable());
+
+    mMaxQueued = max_queued;
+    mThread = thread(&AS10MPEG2Validator::ValidationThread, this);
+}
+
+void AS10MPEG2Validator::SetGOPSampleInterval(uint32_t interval)
+{
+    BMX_CHECK(interval > 0);
+
+    mGOPSampleInterval = interval;
 }
 
 void AS10MPEG2Validator::ProcessFrame(const unsigned char *data, uint32_t size)
@@ -101,16 +128,123 @@ void AS10MPEG2Validator::ProcessFrame(const unsigned char *data, uint32_t size)
     if (!mAllHeadersChecks)
         return;
 
-    mEssenceParser.ParseFrameAllInfo(data, size);
-    if (mEssenceParser.HaveSequenceHeader() || mEssenceParser.HaveExtension())
-        AllHeadersChecks();
+    // the frames before the first GOP header are part of the first GOP
+    if (mWriterHelper->HaveGOPHeader())
+        mGOPCount++;
+    if (mGOPCount > 0 && (mGOPCount - 1) % mGOPSampleInterval != 0)
+        return;
+
+    // the checks use the writer helper state after processing this frame and so it is copied
+    WriterHelperState state;
+    GetWriterHelperState(&state);
+
+    if (!mThread.joinable()) {
+        CheckFrame(data, size, state);
+        return;
+    }
+
+    ByteArray *buffer;
+    {
+        unique_lock<mutex> lock(mMutex);
+        mCheckedCond.wait(lock, [this] { return mError || mQueue.size() < mMaxQueued; });
+        if (mError)
+            rethrow_exception(mError);
+
+        if (mFreeBuffers.empty()) {
+            buffer = new ByteArray();
+        } else {
+            buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+        }
+    }
+
+    // the writer may re-use the data once this function returns and so it is copied
+    buffer->SetSize(0);
+    buffer->Append(data, size);
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        QueuedFrame frame;
+        frame.buffer = buffer;
+        frame.state = state;
+        mQueue.push_back(frame);
+    }
+    mQueuedCond.notify_one();
 }
 
 void AS10MPEG2Validator::CompleteWrite()
 {
+    StopValidationThread();
+    if (mError)
+        rethrow_exception(mError);
+
     ReportCheckedHeaders();
 }
 
+void AS10MPEG2Validator::GetWriterHelperState(WriterHelperState *state)
+{
+    state->single_sequence = mWriterHelper->GetSingleSequence();
+    state->bit_rate        = mWriterHelper->GetBitRate();
+    state->have_gop_header = mWriterHelper->HaveGOPHeader();
+    state->max_gop         = mWriterHelper->GetMaxGOP();
+    state->closed_gop      = mWriterHelper->GetClosedGOP();
+    state->identical_gop   = mWriterHelper->GetIdenticalGOP();
+}
+
+void AS10MPEG2Validator::CheckFrame(const unsigned char *data, uint32_t size, const WriterHelperState &state)
+{
+    mEssenceParser.ParseFrameAllInfo(data, size);
+    if (mEssenceParser.HaveSequenceHeader() || mEssenceParser.HaveExtension())
+        AllHeadersChecks(state);
+}
+
+void AS10MPEG2Validator::StopValidationThread()
+{
+    if (!mThread.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mQueuedCond.notify_one();
+
+    mThread.join();
+}
+
+void AS10MPEG2Validator::ValidationThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        mQueuedCond.wait(lock, [this] { return mStop || !mQueue.empty(); });
+        if (mQueue.empty())
+            break;
+
+        QueuedFrame frame = mQueue.front();
+        mQueue.pop_front();
+        lock.unlock();
+
+        exception_ptr error;
+        try {
+            CheckFrame(frame.buffer->GetBytes(), frame.buffer->GetSize(), frame.state);
+        } catch (...) {
+            error = current_exception();
+        }
+
+        lock.lock();
+        mFreeBuffers.push_back(frame.buffer);
+        if (error && !mError) {
+            // the remaining frames are dropped and the violation is reported to the writer
+            mError = error;
+            while (!mQueue.empty()) {
+                mFreeBuffers.push_back(mQueue.front().buffer);
+                mQueue.pop_front();
+            }
+        }
+        mCheckedCond.notify_all();
+    }
+}
+
 void AS10MPEG2Validator::shim(AS10Shim as10_shim)
 {
     switch (as10_shim)
@@ -405,7 +539,7 @@ void AS10MPEG2Validator::DoAllHeadersChecks(bool set_it_on, uint32_t maxLoggedVi
     }
 }
 
-void AS10MPEG2Validator::AllHeadersChecks()
+void AS10MPEG2Validator::AllHeadersChecks(const WriterHelperState &state)
 {
     //check MPEG2LGMXFDescriptorHelper.cpp for header settings
 
@@ -421,7 +555,7 @@ void AS10MPEG2Validator::AllHeadersChecks()
     {
         mSequenceHeaderChk = true;
 
-        if ((mHDRefaults.mSingleSequence.value != D_BOOL_IS_ANY) && ((uint32_t)mWriterHelper->GetSingleSequence() != mHDRefaults.mSingleSequence.value))
+        if ((mHDRefaults.mSingleSequence.value != D_BOOL_IS_ANY) && ((uint32_t)state.single_sequence != mHDRefaults.mSingleSequence.value))
         {
             if (mHDRefaults.mSingleSequence.nlogged++ <= mMaxLoggedViolations)
             {
@@ -452,11 +586,11 @@ void AS10MPEG2Validator::AllHeadersChecks()
             }
         }
 
-        if (std::abs( ((long)( mWriterHelper->GetBitRate() - mHDRefaults.mBitRate.value) ) ) > (long)mHDRefaults.mBitRateDelta.value)
+        if (std::abs( ((long)( state.bit_rate - mHDRefaults.mBitRate.value) ) ) > (long)mHDRefaults.mBitRateDelta.value)
         {
             if (mHDRefaults.mBitRate.nlogged++ <= mMaxLoggedViolations)
             {
-                log_warn("bitrate %u is not equal (whithin the margin of error) to AS10 shim requiret bitrate %u...\n", mWriterHelper->GetBitRate(), mHDRefaults.mBitRate.value);
+                log_warn("bitrate %u is not equal (whithin the margin of error) to AS10 shim requiret bitrate %u...\n", state.bit_rate, mHDRefaults.mBitRate.value);
             }
         }
 
@@ -692,21 +826,21 @@ void AS10MPEG2Validator::AllHeadersChecks()
         }
     }
 
-    if (mWriterHelper->HaveGOPHeader())
+    if (state.have_gop_header)
     {
-        if (mWriterHelper->GetMaxGOP() > mHDRefaults.mMaxGOP.value)
+        if (state.max_gop > mHDRefaults.mMaxGOP.value)
         {
-            log_error("max gop %u is more than max %u allowed\n", mWriterHelper->GetMaxGOP(), mHDRefaults.mMaxGOP.value);
+            log_error("max gop %u is more than max %u allowed\n", state.max_gop, mHDRefaults.mMaxGOP.value);
             fatalError = true;
         }
 
-        if ((mHDRefaults.mClosedGOP.value != D_BOOL_IS_ANY) && (mWriterHelper->GetClosedGOP() != (bool)mHDRefaults.mClosedGOP.value))
+        if ((mHDRefaults.mClosedGOP.value != D_BOOL_IS_ANY) && (state.closed_gop != (bool)mHDRefaults.mClosedGOP.value))
         {
             log_error("gop doesnt match reguiremet: %s\n", (mHDRefaults.mClosedGOP.value == 1) ? "closed" : "open");
             fatalError = true;
         }
 
-        if ((mHDRefaults.mIdenticalGOP.value != D_BOOL_IS_ANY) && (!mWriterHelper->GetIdenticalGOP() && (mWriterHelper->GetIdenticalGOP() != (bool)mHDRefaults.mIdenticalGOP.value)))
+        if ((mHDRefaults.mIdenticalGOP.value != D_BOOL_IS_ANY) && (!state.identical_gop && (state.identical_gop != (bool)mHDRefaults.mIdenticalGOP.value)))
         {
             log_error("gop is not constant\n");
             fatalError = true;
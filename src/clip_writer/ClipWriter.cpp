@@ -31,6 +31,7 @@
 
 #include <bmx/clip_writer/ClipWriter.h>
 #include <bmx/as02/AS02Version.h>
+#include <bmx/as02/AS02PictureTrack.h>
 #include <bmx/Utils.h>
 #include <bmx/MXFUtils.h>
 #include <bmx/BMXException.h>
@@ -85,6 +86,7 @@ ClipWriter::ClipWriter(AS02Bundle *bundle, AS02Clip *clip)
     mD10Clip = 0;
     mRDD9Clip = 0;
     mWaveClip = 0;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::ClipWriter(OP1AFile *clip)
@@ -97,6 +99,7 @@ ClipWriter::ClipWriter(OP1AFile *clip)
     mD10Clip = 0;
     mRDD9Clip = 0;
     mWaveClip = 0;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::ClipWriter(AvidClip *clip)
@@ -109,6 +112,7 @@ ClipWriter::ClipWriter(AvidClip *clip)
     mD10Clip = 0;
     mRDD9Clip = 0;
     mWaveClip = 0;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::ClipWriter(D10File *clip)
@@ -121,6 +125,7 @@ ClipWriter::ClipWriter(D10File *clip)
     mD10Clip = clip;
     mRDD9Clip = 0;
     mWaveClip = 0;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::ClipWriter(RDD9File *clip)
@@ -133,6 +138,7 @@ ClipWriter::ClipWriter(RDD9File *clip)
     mD10Clip = 0;
     mRDD9Clip = clip;
     mWaveClip = 0;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::ClipWriter(WaveWriter *clip)
@@ -145,10 +151,20 @@ ClipWriter::ClipWriter(WaveWriter *clip)
     mD10Clip = 0;
     mRDD9Clip = 0;
     mWaveClip = clip;
+    mTrackWriterQueueSize = 0;
 }
 
 ClipWriter::~ClipWriter()
 {
+    // stop the track writer threads before the tracks are deleted
+    size_t i;
+    for (i = 0; i < mTracks.size(); i++) {
+        try {
+            mTracks[i]->StopWriterThread();
+        } catch (...) {
+        }
+    }
+
     delete mAS02Bundle;
     delete mAS02Clip;
     delete mOP1AClip;
@@ -157,7 +173,6 @@ ClipWriter::~ClipWriter()
     delete mRDD9Clip;
     delete mWaveClip;
 
-    size_t i;
     for (i = 0; i < mTracks.size(); i++)
         delete mTracks[i];
 }
@@ -419,6 +434,14 @@ void ClipWriter::PrepareHeaderMetadata()
     }
 }
 
+void ClipWriter::SetTrackWriterThreads(uint32_t queue_size)
+{
+    BMX_CHECK_M(mType == CW_AS02_CLIP_TYPE || mType == CW_AVID_CLIP_TYPE,
+                ("Track writer threads are only supported for AS02 and Avid clips"));
+
+    mTrackWriterQueueSize = queue_size;
+}
+
 void ClipWriter::PrepareWrite()
 {
     switch (mType)
@@ -445,6 +468,19 @@ void ClipWriter::PrepareWrite()
             BMX_ASSERT(false);
             break;
     }
+
+    if (mTrackWriterQueueSize > 0) {
+        size_t i;
+        for (i = 0; i < mTracks.size(); i++) {
+            // AS02 picture tracks that start partitions generate index table segment ids whilst writing
+            // samples. These tracks are written on the caller's thread to keep the id order deterministic
+            AS02PictureTrack *as02_picture_track = dynamic_cast<AS02PictureTrack*>(mTracks[i]->GetAS02Track());
+            if (as02_picture_track && as02_picture_track->GetPartitionInterval() > 0)
+                continue;
+
+            mTracks[i]->StartWriterThread(mTrackWriterQueueSize);
+        }
+    }
 }
 
 void ClipWriter::WriteSamples(uint32_t track_index, const unsigned char *data, uint32_t size, uint32_t num_samples)
@@ -455,6 +491,11 @@ void ClipWriter::WriteSamples(uint32_t track_index, const unsigned char *data, u
 
 void ClipWriter::CompleteWrite()
 {
+    // write the queued samples before completing the files on this thread
+    size_t i;
+    for (i = 0; i < mTracks.size(); i++)
+        mTracks[i]->StopWriterThread();
+
     switch (mType)
     {
         case CW_AS02_CLIP_TYPE:
@@ -620,6 +661,12 @@ Timecode ClipWriter::GetStartTimecode() const
 
 int64_t ClipWriter::GetDuration() const
 {
+    size_t i;
+    for (i = 0; i < mTracks.size(); i++) {
+        if (mTracks[i]->HaveWriterThread())
+            mTracks[i]->GetContainerDuration(); // waits for the queued samples to be written
+    }
+
     switch (mType)
     {
         case CW_AS02_CLIP_TYPE:
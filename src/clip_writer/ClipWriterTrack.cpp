@@ -115,6 +115,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, AS02Track *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, OP1ATrack *track)
@@ -130,6 +131,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, OP1ATrack *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, AvidTrack *track)
@@ -145,6 +147,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, AvidTrack *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, D10Track *track)
@@ -160,6 +163,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, D10Track *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, RDD9Track *track)
@@ -175,6 +179,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, RDD9Track *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, WaveTrackWriter *track)
@@ -190,6 +195,7 @@ ClipWriterTrack::ClipWriterTrack(EssenceType essence_type, WaveTrackWriter *trac
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(OP1AXMLTrack *track)
@@ -205,6 +211,7 @@ ClipWriterTrack::ClipWriterTrack(OP1AXMLTrack *track)
     mOP1AXMLTrack = track;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(D10XMLTrack *track)
@@ -220,6 +227,7 @@ ClipWriterTrack::ClipWriterTrack(D10XMLTrack *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = track;
     mRDD9XMLTrack = 0;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::ClipWriterTrack(RDD9XMLTrack *track)
@@ -235,10 +243,12 @@ ClipWriterTrack::ClipWriterTrack(RDD9XMLTrack *track)
     mOP1AXMLTrack = 0;
     mD10XMLTrack = 0;
     mRDD9XMLTrack = track;
+    mWriterThread = 0;
 }
 
 ClipWriterTrack::~ClipWriterTrack()
 {
+    delete mWriterThread;
 }
 
 void ClipWriterTrack::SetOutputTrackNumber(uint32_t track_number)
@@ -1419,6 +1429,37 @@ void ClipWriterTrack::SetTimedTextResourceProvider(TimedTextMXFResourceProvider
 }
 
 void ClipWriterTrack::WriteSamples(const unsigned char *data, uint32_t size, uint32_t num_samples)
+{
+    if (mWriterThread)
+        mWriterThread->WriteSamples(data, size, num_samples);
+    else
+        WriteSamplesInt(data, size, num_samples);
+}
+
+void ClipWriterTrack::StartWriterThread(uint32_t max_queued)
+{
+    BMX_CHECK(!mWriterThread);
+
+    mWriterThread = new TrackWriterThread(this, max_queued);
+}
+
+void ClipWriterTrack::StopWriterThread()
+{
+    if (!mWriterThread)
+        return;
+
+    TrackWriterThread *writer_thread = mWriterThread;
+    mWriterThread = 0;
+    try {
+        writer_thread->Flush();
+    } catch (...) {
+        delete writer_thread;
+        throw;
+    }
+    delete writer_thread;
+}
+
+void ClipWriterTrack::WriteSamplesInt(const unsigned char *data, uint32_t size, uint32_t num_samples)
 {
     switch (mClipType)
     {
@@ -1675,6 +1716,9 @@ uint32_t ClipWriterTrack::GetChannelCount() const
 
 int64_t ClipWriterTrack::GetDuration() const
 {
+    if (mWriterThread)
+        mWriterThread->Flush();
+
     switch (mClipType)
     {
         case CW_AS02_CLIP_TYPE:
@@ -1699,6 +1743,9 @@ int64_t ClipWriterTrack::GetDuration() const
 
 int64_t ClipWriterTrack::GetContainerDuration() const
 {
+    if (mWriterThread)
+        mWriterThread->Flush();
+
     switch (mClipType)
     {
         case CW_AS02_CLIP_TYPE:
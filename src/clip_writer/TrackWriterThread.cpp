@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <bmx/clip_writer/TrackWriterThread.h>
+#include <bmx/clip_writer/ClipWriterTrack.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+
+TrackWriterThread::TrackWriterThread(ClipWriterTrack *track, uint32_t max_queued)
+{
+    BMX_CHECK(max_queued > 0);
+
+    mTrack = track;
+    mMaxQueued = max_queued;
+    mStop = false;
+
+    mThread = thread(&TrackWriterThread::WriteThread, this);
+}
+
+TrackWriterThread::~TrackWriterThread()
+{
+    Stop();
+
+    size_t i;
+    for (i = 0; i < mQueue.size(); i++)
+        delete mQueue[i].buffer;
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        delete mFreeBuffers[i];
+}
+
+void TrackWriterThread::WriteSamples(const unsigned char *data, uint32_t size, uint32_t num_samples)
+{
+    // wait for space in the queue and take a recycled buffer
+    ByteArray *buffer;
+    {
+        unique_lock<mutex> lock(mMutex);
+        mWrittenCond.wait(lock, [this] { return mError || mQueue.size() < mMaxQueued; });
+        if (mError)
+            rethrow_exception(mError);
+
+        if (mFreeBuffers.empty()) {
+            buffer = new ByteArray();
+        } else {
+            buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+        }
+    }
+
+    // the caller may re-use the data once this function returns and so it is copied
+    buffer->SetSize(0);
+    buffer->Append(data, size);
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        QueuedSamples samples;
+        samples.buffer = buffer;
+        samples.num_samples = num_samples;
+        mQueue.push_back(samples);
+    }
+    mQueuedCond.notify_one();
+}
+
+void TrackWriterThread::Flush()
+{
+    unique_lock<mutex> lock(mMutex);
+    mWrittenCond.wait(lock, [this] { return mError || mQueue.empty(); });
+    if (mError)
+        rethrow_exception(mError);
+}
+
+void TrackWriterThread::Stop()
+{
+    if (!mThread.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mQueuedCond.notify_one();
+
+    mThread.join();
+}
+
+void TrackWriterThread::WriteThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        mQueuedCond.wait(lock, [this] { return mStop || !mQueue.empty(); });
+        if (mQueue.empty())
+            break;
+
+        // the samples stay at the front of the queue whilst being written so that Flush waits for them
+        QueuedSamples samples = mQueue.front();
+        lock.unlock();
+
+        exception_ptr error;
+        try {
+            mTrack->WriteSamplesInt(samples.buffer->GetBytes(), samples.buffer->GetSize(), samples.num_samples);
+        } catch (...) {
+            error = current_exception();
+        }
+
+        lock.lock();
+        mQueue.pop_front();
+        mFreeBuffers.push_back(samples.buffer);
+        if (error && !mError) {
+            // the remaining samples are dropped and the error is reported to the caller
+            mError = error;
+            while (!mQueue.empty()) {
+                mFreeBuffers.push_back(mQueue.front().buffer);
+                mQueue.pop_front();
+            }
+        }
+        mWrittenCond.notify_all();
+    }
+}
@@ -50,7 +50,7 @@ ByteBuffer::ByteBuffer(const unsigned char *data, uint32_t size, bool big_endian
 uint8_t ByteBuffer::GetUInt8()
 {
     if (mPos + 1 > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + 1);
 
     uint8_t value = mData[mPos];
     mPos++;
@@ -61,7 +61,7 @@ uint8_t ByteBuffer::GetUInt8()
 uint16_t ByteBuffer::GetUInt16()
 {
     if (mPos + 2 > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + 2);
 
     uint16_t value;
     if (mBigEndian) {
@@ -79,7 +79,7 @@ uint16_t ByteBuffer::GetUInt16()
 uint32_t ByteBuffer::GetUInt32()
 {
     if (mPos + 4 > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + 4);
 
     uint32_t value;
     if (mBigEndian) {
@@ -101,7 +101,7 @@ uint32_t ByteBuffer::GetUInt32()
 uint64_t ByteBuffer::GetUInt64()
 {
     if (mPos + 8 > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + 8);
 
     uint64_t value;
     if (mBigEndian) {
@@ -131,7 +131,7 @@ uint64_t ByteBuffer::GetUInt64()
 vector<unsigned char> ByteBuffer::GetBytes(uint32_t size)
 {
     if (mPos + size > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + size);
 
     return vector<unsigned char>(&mData[mPos], &mData[mPos + size]);
 }
@@ -139,7 +139,7 @@ vector<unsigned char> ByteBuffer::GetBytes(uint32_t size)
 void ByteBuffer::Skip(uint32_t size)
 {
     if (mPos + size > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes((uint64_t)mPos + size);
 
     mPos += size;
 }
@@ -147,7 +147,7 @@ void ByteBuffer::Skip(uint32_t size)
 void ByteBuffer::SetPos(uint32_t pos)
 {
     if (pos > mSize)
-        throw InsufficientBytes();
+        throw InsufficientBytes(pos);
 
     mPos = pos;
 }
@@ -157,7 +157,7 @@ ByteBufferLengthContext::ByteBufferLengthContext(ByteBuffer &data, uint32_t leng
 : mData(data), mEndPos(data.GetPos() + length)
 {
     if (mEndPos > mData.GetSize())
-        throw InsufficientBytes();
+        throw InsufficientBytes(mEndPos);
 }
 
 ByteBufferLengthContext::~ByteBufferLengthContext()
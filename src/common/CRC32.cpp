@@ -37,12 +37,21 @@
 #include <cstring>
 #include <cerrno>
 
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BMX_CRC32_PCLMUL
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 #include <bmx/CRC32.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
 using namespace std;
+using namespace bmx;
 
 
 
@@ -118,11 +127,205 @@ void bmx::crc32_init(uint32_t *crc32)
     *crc32 = 0xffffffffL;
 }
 
-void bmx::crc32_update(uint32_t *crc32, const unsigned char *data, size_t size)
+// Slice-by-8 tables, where table[k][n] is the CRC of byte n followed by k zero bytes
+class CRC32SliceTables
+{
+public:
+    CRC32SliceTables()
+    {
+        int k, n;
+        for (n = 0; n < 256; n++)
+            table[0][n] = CRC32_TABLE[n];
+        for (k = 1; k < 8; k++) {
+            for (n = 0; n < 256; n++)
+                table[k][n] = (table[k - 1][n] >> 8) ^ CRC32_TABLE[table[k - 1][n] & 0xff];
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+
+static uint32_t crc32_update_slice8(uint32_t crc, const unsigned char *data, size_t size)
+{
+    static const CRC32SliceTables slice_tables;
+    const uint32_t (*table)[256] = slice_tables.table;
+
+    while (size >= 8) {
+        uint32_t one = crc ^ ( (uint32_t)data[0]        | ((uint32_t)data[1] << 8) |
+                              ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+        uint32_t two =         (uint32_t)data[4]        | ((uint32_t)data[5] << 8) |
+                              ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+        crc = table[7][ one        & 0xff] ^ table[6][(one >> 8)  & 0xff] ^
+              table[5][(one >> 16) & 0xff] ^ table[4][ one >> 24        ] ^
+              table[3][ two        & 0xff] ^ table[2][(two >> 8)  & 0xff] ^
+              table[1][(two >> 16) & 0xff] ^ table[0][ two >> 24        ];
+        data += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc = CRC32_TABLE[(crc ^ *data) & 0xff] ^ (crc >> 8);
+        data++;
+        size--;
+    }
+
+    return crc;
+}
+
+
+#if defined(BMX_CRC32_PCLMUL)
+
+// Folding using carry-less multiplication, see Intel's "Fast CRC Computation for Generic Polynomials
+// Using PCLMULQDQ Instruction" white paper. The constants are the bit-reflected domain constants for
+// the CRC-32 polynomial. size must be >= 64 and a multiple of 16.
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_update_pclmul(uint32_t crc, const unsigned char *data, size_t size)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    data += 64;
+    size -= 64;
+
+    // fold 4 x 128 bits in parallel
+    while (size >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 0x30)));
+        data += 64;
+        size -= 64;
+    }
+
+    // fold into 128 bits
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // fold remaining 128 bit blocks
+    while (size >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+        data += 16;
+        size -= 16;
+    }
+
+    // fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+static bool have_pclmul()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (ecx & bit_PCLMUL) && (ecx & bit_SSE4_1);
+}
+
+static uint32_t crc32_update_pclmul_slice8(uint32_t crc, const unsigned char *data, size_t size)
+{
+    if (size >= 64) {
+        size_t fold_size = size & ~(size_t)15;
+        crc = crc32_update_pclmul(crc, data, fold_size);
+        data += fold_size;
+        size -= fold_size;
+    }
+
+    return crc32_update_slice8(crc, data, size);
+}
+
+#endif
+
+
+static uint32_t crc32_update_table(uint32_t crc, const unsigned char *data, size_t size)
 {
     size_t i;
     for (i = 0; i < size; i++)
-        *crc32 = CRC32_TABLE[((*crc32) ^ data[i]) & 0xff] ^ ((*crc32) >> 8);
+        crc = CRC32_TABLE[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+
+    return crc;
+}
+
+
+typedef struct
+{
+    const char *name;
+    CRC32UpdateFunc func;
+} CRC32UpdateImpl;
+
+static vector<CRC32UpdateImpl> get_supported_crc32_update_impls()
+{
+    vector<CRC32UpdateImpl> impls;
+    CRC32UpdateImpl impl;
+
+    impl.name = "table";
+    impl.func = crc32_update_table;
+    impls.push_back(impl);
+
+    impl.name = "slice8";
+    impl.func = crc32_update_slice8;
+    impls.push_back(impl);
+
+#if defined(BMX_CRC32_PCLMUL)
+    if (have_pclmul()) {
+        impl.name = "pclmul";
+        impl.func = crc32_update_pclmul_slice8;
+        impls.push_back(impl);
+    }
+#endif
+
+    return impls;
+}
+
+static const vector<CRC32UpdateImpl>& get_crc32_update_impls()
+{
+    static const vector<CRC32UpdateImpl> impls = get_supported_crc32_update_impls();
+    return impls;
+}
+
+
+void bmx::crc32_update(uint32_t *crc32, const unsigned char *data, size_t size)
+{
+    static const CRC32UpdateFunc update_func = get_crc32_update_impls().back().func;
+    *crc32 = update_func(*crc32, data, size);
 }
 
 void bmx::crc32_final(uint32_t *crc32)
@@ -130,6 +333,20 @@ void bmx::crc32_final(uint32_t *crc32)
     *crc32 ^= 0xffffffffL;
 }
 
+size_t bmx::crc32_get_num_update_impls()
+{
+    return get_crc32_update_impls().size();
+}
+
+CRC32UpdateFunc bmx::crc32_get_update_impl(size_t index, const char **name)
+{
+    BMX_CHECK(index < get_crc32_update_impls().size());
+
+    if (name)
+        *name = get_crc32_update_impls()[index].name;
+    return get_crc32_update_impls()[index].func;
+}
+
 string bmx::crc32_digest_str(uint32_t crc32)
 {
     static const char hex_chars[] = "0123456789abcdef";
@@ -36,6 +36,10 @@
 #include <cstring>
 #include <cerrno>
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <bmx/Checksum.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
@@ -45,6 +49,138 @@ using namespace std;
 using namespace bmx;
 
 
+#define CHECKSUM_BUFFER_SIZE    (256 * 1024)
+#define CHECKSUM_NUM_BUFFERS    4
+
+
+typedef struct
+{
+    unsigned char *data;
+    size_t size;
+    size_t num_pending;
+} ChecksumBuffer;
+
+typedef struct
+{
+    mutex buffers_mutex;
+    condition_variable cond;
+    ChecksumBuffer buffers[CHECKSUM_NUM_BUFFERS];
+    uint64_t num_filled;
+    bool eof;
+    bool abort;
+} ChecksumBuffers;
+
+
+
+static bool calc_checksums(FILE *file, vector<Checksum> *checksums)
+{
+    unsigned char *buffer = new unsigned char[CHECKSUM_BUFFER_SIZE];
+    size_t num_read = CHECKSUM_BUFFER_SIZE;
+    while (num_read == CHECKSUM_BUFFER_SIZE) {
+        num_read = fread(buffer, 1, CHECKSUM_BUFFER_SIZE, file);
+        if (num_read != CHECKSUM_BUFFER_SIZE && ferror(file)) {
+            log_warn("Read failure when calculating checksum: %s\n", bmx_strerror(errno).c_str());
+            delete [] buffer;
+            return false;
+        }
+
+        if (num_read > 0) {
+            size_t i;
+            for (i = 0; i < checksums->size(); i++)
+                (*checksums)[i].Update(buffer, (uint32_t)num_read);
+        }
+    }
+    delete [] buffer;
+
+    return true;
+}
+
+static void checksum_thread(ChecksumBuffers *buffers, Checksum *checksum)
+{
+    unique_lock<mutex> lock(buffers->buffers_mutex);
+    uint64_t count = 0;
+    while (true) {
+        while (!buffers->abort && !buffers->eof && count >= buffers->num_filled)
+            buffers->cond.wait(lock);
+        if (buffers->abort || count >= buffers->num_filled)
+            break;
+
+        ChecksumBuffer *buffer = &buffers->buffers[count % CHECKSUM_NUM_BUFFERS];
+        lock.unlock();
+        checksum->Update(buffer->data, (uint32_t)buffer->size);
+        lock.lock();
+
+        buffer->num_pending--;
+        if (buffer->num_pending == 0)
+            buffers->cond.notify_all();
+        count++;
+    }
+}
+
+static bool calc_checksums_threaded(FILE *file, vector<Checksum> *checksums)
+{
+    // the file is read once into shared buffers and each checksum type is calculated in its own thread
+
+    ChecksumBuffers buffers;
+    buffers.num_filled = 0;
+    buffers.eof = false;
+    buffers.abort = false;
+    size_t i;
+    for (i = 0; i < CHECKSUM_NUM_BUFFERS; i++) {
+        buffers.buffers[i].data = new unsigned char[CHECKSUM_BUFFER_SIZE];
+        buffers.buffers[i].size = 0;
+        buffers.buffers[i].num_pending = 0;
+    }
+
+    vector<thread> threads;
+    for (i = 0; i < checksums->size(); i++)
+        threads.push_back(thread(checksum_thread, &buffers, &(*checksums)[i]));
+
+    bool result = true;
+    uint64_t count = 0;
+    while (true) {
+        ChecksumBuffer *buffer = &buffers.buffers[count % CHECKSUM_NUM_BUFFERS];
+        {
+            unique_lock<mutex> lock(buffers.buffers_mutex);
+            while (buffer->num_pending > 0)
+                buffers.cond.wait(lock);
+        }
+
+        size_t num_read = fread(buffer->data, 1, CHECKSUM_BUFFER_SIZE, file);
+        if (num_read != CHECKSUM_BUFFER_SIZE && ferror(file)) {
+            log_warn("Read failure when calculating checksum: %s\n", bmx_strerror(errno).c_str());
+            result = false;
+        }
+
+        lock_guard<mutex> lock(buffers.buffers_mutex);
+        if (!result) {
+            buffers.abort = true;
+            buffers.cond.notify_all();
+            break;
+        }
+        if (num_read > 0) {
+            buffer->size = num_read;
+            buffer->num_pending = checksums->size();
+            buffers.num_filled++;
+            count++;
+        }
+        if (num_read != CHECKSUM_BUFFER_SIZE)
+            buffers.eof = true;
+        buffers.cond.notify_all();
+        if (buffers.eof)
+            break;
+    }
+
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+    for (i = 0; i < CHECKSUM_NUM_BUFFERS; i++)
+        delete [] buffers.buffers[i].data;
+
+    return result;
+}
+
+
+
 
 string Checksum::CalcFileChecksum(const string &filename, ChecksumType type)
 {
@@ -94,23 +230,13 @@ vector<string> Checksum::CalcFileChecksums(FILE *file, const vector<ChecksumType
     for (i = 0; i < types.size(); i++)
         checksums.push_back(Checksum(types[i]));
 
-    const size_t buffer_size = 8192;
-    unsigned char *buffer = new unsigned char[buffer_size];
-    size_t num_read = buffer_size;
-    while (num_read == buffer_size) {
-        num_read = fread(buffer, 1, buffer_size, file);
-        if (num_read != buffer_size && ferror(file)) {
-            log_warn("Read failure when calculating checksum: %s\n", bmx_strerror(errno).c_str());
-            delete [] buffer;
-            return vector<string>();
-        }
-
-        if (num_read > 0) {
-            for (i = 0; i < checksums.size(); i++)
-                checksums[i].Update(buffer, (uint32_t)num_read);
-        }
-    }
-    delete [] buffer;
+    bool read_ok;
+    if (checksums.size() > 1)
+        read_ok = calc_checksums_threaded(file, &checksums);
+    else
+        read_ok = calc_checksums(file, &checksums);
+    if (!read_ok)
+        return vector<string>();
 
     vector<string> result;
     for (i = 0; i < checksums.size(); i++) {
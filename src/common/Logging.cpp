@@ -59,6 +59,8 @@ LogLevel bmx::LOG_LEVEL = INFO_LOG;
 
 static FILE *LOG_FILE = 0;
 
+static thread_local int THREAD_MIN_LOG_LEVEL = DEBUG_LOG;
+
 
 
 static void log_message(FILE *file, LogLevel level, const char *source, const char *format, va_list p_arg)
@@ -89,7 +91,7 @@ static void log_message(FILE *file, LogLevel level, const char *source, const ch
 
 static void stdio_vlog2(LogLevel level, const char *source, const char *format, va_list p_arg)
 {
-    if (level < LOG_LEVEL)
+    if (!is_log_level_enabled(level))
         return;
 
     if (level == ERROR_LOG)
@@ -118,7 +120,7 @@ static void file_vlog2(LogLevel level, const char *source, const char *format, v
     const time_t t = time(0);
     const struct tm *gmt = gmtime(&t);
 
-    if (level < LOG_LEVEL || !LOG_FILE)
+    if (!is_log_level_enabled(level) || !LOG_FILE)
         return;
 
     if (LOG_FILE != stderr && LOG_FILE != stdout) {
@@ -149,6 +151,25 @@ static void file_log(LogLevel level, const char* format, ...)
 
 
 
+ThreadLogLevel::ThreadLogLevel(LogLevel min_level)
+{
+    mPrevMinLevel = THREAD_MIN_LOG_LEVEL;
+    if (min_level > THREAD_MIN_LOG_LEVEL)
+        THREAD_MIN_LOG_LEVEL = min_level;
+}
+
+ThreadLogLevel::~ThreadLogLevel()
+{
+    THREAD_MIN_LOG_LEVEL = mPrevMinLevel;
+}
+
+bool bmx::is_log_level_enabled(LogLevel level)
+{
+    return level >= LOG_LEVEL && level >= THREAD_MIN_LOG_LEVEL;
+}
+
+
+
 bool bmx::open_log_file(string filename)
 {
     close_log_file();
@@ -251,6 +272,9 @@ void bmx::log_error(const char *format, ...)
 
 void bmx::log_error_nl(const char *format, ...)
 {
+    if (!is_log_level_enabled(ERROR_LOG))
+        return;
+
     va_list p_arg;
 
     va_start(p_arg, format);
@@ -37,9 +37,15 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 #include <mxf/mxf.h>
 
 #include <bmx/MXFChecksumFile.h>
+#include <bmx/ByteArray.h>
 #include <bmx/Logging.h>
 #include <bmx/BMXException.h>
 
@@ -48,6 +54,135 @@ using namespace std;
 using namespace bmx;
 
 
+#define ASYNC_BLOCK_SIZE        (1024 * 1024)
+#define ASYNC_MAX_QUEUED        8
+
+
+namespace bmx
+{
+
+// Updates a checksum in a separate thread. The data is copied and queued in blocks, with the block
+// buffers being reused once the checksum has been updated.
+class AsyncChecksumUpdate
+{
+public:
+    AsyncChecksumUpdate(Checksum *checksum);
+    ~AsyncChecksumUpdate();
+
+    void Update(const unsigned char *data, uint32_t size);
+    void Complete();
+
+private:
+    void QueueFillBuffer();
+    void UpdateThread();
+
+private:
+    Checksum *mChecksum;
+    ByteArray *mFillBuffer;
+    deque<ByteArray*> mQueue;
+    vector<ByteArray*> mFreeBuffers;
+    thread mThread;
+    mutex mMutex;
+    condition_variable mQueuedCond;
+    condition_variable mDoneCond;
+    bool mStop;
+};
+
+};
+
+
+AsyncChecksumUpdate::AsyncChecksumUpdate(Checksum *checksum)
+{
+    mChecksum = checksum;
+    mFillBuffer = new ByteArray(ASYNC_BLOCK_SIZE);
+    mStop = false;
+    mThread = thread(&AsyncChecksumUpdate::UpdateThread, this);
+}
+
+AsyncChecksumUpdate::~AsyncChecksumUpdate()
+{
+    Complete();
+
+    delete mFillBuffer;
+    size_t i;
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        delete mFreeBuffers[i];
+}
+
+void AsyncChecksumUpdate::Update(const unsigned char *data, uint32_t size)
+{
+    BMX_ASSERT(!mStop);
+
+    uint32_t offset = 0;
+    while (offset < size) {
+        uint32_t count = size - offset;
+        if (count > ASYNC_BLOCK_SIZE - mFillBuffer->GetSize())
+            count = ASYNC_BLOCK_SIZE - mFillBuffer->GetSize();
+        mFillBuffer->Append(&data[offset], count);
+        offset += count;
+
+        if (mFillBuffer->GetSize() >= ASYNC_BLOCK_SIZE)
+            QueueFillBuffer();
+    }
+}
+
+void AsyncChecksumUpdate::Complete()
+{
+    if (!mThread.joinable())
+        return;
+
+    if (mFillBuffer->GetSize() > 0)
+        QueueFillBuffer();
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+        mQueuedCond.notify_one();
+    }
+    mThread.join();
+}
+
+void AsyncChecksumUpdate::QueueFillBuffer()
+{
+    unique_lock<mutex> lock(mMutex);
+
+    while (mQueue.size() >= ASYNC_MAX_QUEUED)
+        mDoneCond.wait(lock);
+
+    mQueue.push_back(mFillBuffer);
+    mQueuedCond.notify_one();
+
+    if (mFreeBuffers.empty()) {
+        mFillBuffer = new ByteArray(ASYNC_BLOCK_SIZE);
+    } else {
+        mFillBuffer = mFreeBuffers.back();
+        mFreeBuffers.pop_back();
+    }
+}
+
+void AsyncChecksumUpdate::UpdateThread()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (true) {
+        while (!mStop && mQueue.empty())
+            mQueuedCond.wait(lock);
+        if (mQueue.empty())
+            break;
+
+        ByteArray *buffer = mQueue.front();
+        lock.unlock();
+        mChecksum->Update(buffer->GetBytes(), buffer->GetSize());
+        buffer->SetSize(0);
+        lock.lock();
+
+        mQueue.pop_front();
+        mFreeBuffers.push_back(buffer);
+        mDoneCond.notify_one();
+    }
+}
+
+
+
 struct bmx::MXFChecksumFile
 {
     MXFFile *mxf_file;
@@ -58,6 +193,7 @@ struct MXFFileSysData
     MXFChecksumFile checksum_file;
     MXFFile *target;
     Checksum *checksum;
+    AsyncChecksumUpdate *async_update;
     int64_t position;
     int64_t checksum_position;
     bool force_update;
@@ -65,6 +201,14 @@ struct MXFFileSysData
 };
 
 
+static void update_checksum(MXFFileSysData *sys_data, const unsigned char *data, uint32_t size)
+{
+    if (sys_data->async_update)
+        sys_data->async_update->Update(data, size);
+    else
+        sys_data->checksum->Update(data, size);
+}
+
 static bool update_checksum_to_position(MXFChecksumFile *checksum_file, int64_t position)
 {
     MXFFile *mxf_file = checksum_file->mxf_file;
@@ -155,8 +299,8 @@ static uint32_t checksum_file_read(MXFFileSysData *sys_data, uint8_t *data, uint
             sys_data->position + result >  sys_data->checksum_position)
         {
             uint32_t checksum_count = (uint32_t)(sys_data->position + result - sys_data->checksum_position);
-            sys_data->checksum->Update(&data[(uint32_t)(sys_data->checksum_position - sys_data->position)],
-                                       checksum_count);
+            update_checksum(sys_data, &data[(uint32_t)(sys_data->checksum_position - sys_data->position)],
+                            checksum_count);
             sys_data->checksum_position += checksum_count;
         }
         sys_data->position += result;
@@ -175,7 +319,7 @@ static uint32_t checksum_file_write(MXFFileSysData *sys_data, const uint8_t *dat
     if (result > 0) {
         // sys_data->position == sys_data->checksum_position
         if (!sys_data->checksum_final) {
-            sys_data->checksum->Update(data, result);
+            update_checksum(sys_data, data, result);
             sys_data->checksum_position += result;
         }
         sys_data->position += result;
@@ -197,7 +341,7 @@ static int checksum_file_getc(MXFFileSysData *sys_data)
     if (result != EOF) {
         if (!sys_data->checksum_final && sys_data->position == sys_data->checksum_position) {
             unsigned char byte = (unsigned char)result;
-            sys_data->checksum->Update(&byte, 1);
+            update_checksum(sys_data, &byte, 1);
             sys_data->checksum_position++;
         }
         sys_data->position++;
@@ -217,7 +361,7 @@ static int checksum_file_putc(MXFFileSysData *sys_data, int c)
         // sys_data->position == sys_data->checksum_position
         if (!sys_data->checksum_final) {
             unsigned char byte = (unsigned char)c;
-            sys_data->checksum->Update(&byte, 1);
+            update_checksum(sys_data, &byte, 1);
             sys_data->checksum_position++;
         }
         sys_data->position++;
@@ -294,6 +438,7 @@ static int64_t checksum_file_size(MXFFileSysData *sys_data)
 static void free_checksum_file(MXFFileSysData *sys_data)
 {
     if (sys_data) {
+        delete sys_data->async_update;
         delete sys_data->checksum;
         free(sys_data);
     }
@@ -313,6 +458,7 @@ MXFChecksumFile* bmx::mxf_checksum_file_open(MXFFile *target, ChecksumType type)
 
         checksum_file->sysData->target            = target;
         checksum_file->sysData->checksum          = new Checksum(type);
+        checksum_file->sysData->async_update      = 0;
         checksum_file->sysData->position          = mxf_file_tell(target);
         checksum_file->sysData->checksum_position = 0;
         checksum_file->sysData->force_update      = false;
@@ -358,6 +504,14 @@ void bmx::mxf_checksum_file_force_update(MXFChecksumFile *checksum_file)
     checksum_file->mxf_file->sysData->force_update = true;
 }
 
+void bmx::mxf_checksum_file_enable_async_update(MXFChecksumFile *checksum_file)
+{
+    MXFFileSysData *sys_data = checksum_file->mxf_file->sysData;
+
+    if (!sys_data->async_update && !sys_data->checksum_final)
+        sys_data->async_update = new AsyncChecksumUpdate(sys_data->checksum);
+}
+
 bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
 {
     MXFFile *mxf_file = checksum_file->mxf_file;
@@ -377,6 +531,12 @@ bool bmx::mxf_checksum_file_final(MXFChecksumFile *checksum_file)
         update_checksum_to_nonseekable_end(checksum_file);
     }
 
+    if (sys_data->async_update) {
+        sys_data->async_update->Complete();
+        delete sys_data->async_update;
+        sys_data->async_update = 0;
+    }
+
     sys_data->checksum->Final();
     sys_data->checksum_final = true;
 
@@ -41,6 +41,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <map>
+#include <list>
+#include <vector>
+
 #include <curl/curl.h>
 
 #include <mxf/mxf.h>
@@ -54,6 +58,29 @@ using namespace std;
 using namespace bmx;
 
 
+// The file is read in blocks of size min_read_size that are held in a cache. Sequential reads trigger
+// read-ahead range requests that are kept in flight using a curl multi handle. The transfers progress
+// whenever the file is accessed and so the request latencies overlap.
+
+#define DEFAULT_BLOCK_SIZE      (64 * 1024)
+#define MAX_REQUEST_SIZE        (2 * 1024 * 1024)
+#define NUM_PINNED_END_BLOCKS   2
+#define MAX_SEQ_COUNT           8
+#define MAX_FREE_BUFFERS        16
+
+
+struct HTTPRequest;
+
+typedef struct
+{
+    unsigned char *data;
+    uint32_t size;
+    bool complete;
+    bool failed;
+    HTTPRequest *request;   // set whilst the block is being received
+    list<int64_t>::iterator lru_iter;
+} HTTPBlock;
+
 typedef struct
 {
     MXFFile *mxf_file;
@@ -64,26 +91,45 @@ struct MXFFileSysData
     MXFHTTPFile http_file;
     string url_str;
     CURL *curl;
+    CURLM *multi;
     int64_t position;
     int eof;
-    unsigned char *buffer;
-    uint32_t buffer_pos;
-    uint32_t buffer_size;
-    uint32_t buffer_alloc_size;
+    int64_t file_size;
+    uint32_t block_size;
+    uint32_t max_requests;
+    uint32_t max_request_blocks;
+    uint32_t read_ahead_blocks;
+    size_t max_cache_blocks;
+    map<int64_t, HTTPBlock*> blocks;
+    list<int64_t> lru_blocks;   // block indexes ordered from least to most recently used
+    vector<HTTPRequest*> requests;
+    vector<CURL*> idle_curls;
+    vector<unsigned char*> free_buffers;
+    HTTPBlock *current_block;   // block containing the last byte read
+    int64_t current_block_index;
+    int64_t last_block_index;
+    uint32_t seq_count;
     bool disable_response_code_warn;
 };
 
-typedef struct
+struct HTTPRequest
 {
     MXFFileSysData *sys_data;
+    CURL *curl;
+    vector<HTTPBlock*> blocks;
+    int64_t first_block_index;
     int64_t range_first;
     int64_t range_last;
-    uint8_t *client_data;
-    uint32_t client_rem_count;
-    uint32_t read_count;
+    int64_t received;
+    long response_code;
     bool accept_range_recv;
     bool accept_bytes_range;
-} CURLReceiveInfo;
+    bool range_end_reached;
+    bool read_ahead;
+    bool retried;
+    char range_buf[64];
+    char error_buf[CURL_ERROR_SIZE];
+};
 
 
 static size_t get_http_field_value_pos(const string &header_str, const string &field_name)
@@ -115,26 +161,38 @@ static size_t curl_file_size_header_cb(char *buffer, size_t size, size_t nmemb,
 
 static size_t curl_header_cb(char *buffer, size_t size, size_t nmemb, void *priv)
 {
-  CURLReceiveInfo *info = (CURLReceiveInfo*)priv;
+  HTTPRequest *request = (HTTPRequest*)priv;
 
   string header_str = lowercase(string(buffer, size * nmemb));
 
+  // a new status line resets the state, e.g. after a redirect
+  if (header_str.compare(0, 5, "http/") == 0) {
+      size_t sidx = header_str.find(' ');
+      long code;
+      if (sidx != string::npos && sscanf(&header_str.c_str()[sidx], "%ld", &code) == 1)
+          request->response_code = code;
+      request->accept_range_recv  = false;
+      request->accept_bytes_range = false;
+  }
+
   size_t fidx = get_http_field_value_pos(header_str, "accept-ranges");
   if (fidx != string::npos) {
-      info->accept_range_recv = true;
-      if (header_str.compare(fidx, 5, "bytes"))
-          info->accept_bytes_range = true;
+      request->accept_range_recv = true;
+      if (header_str.compare(fidx, 5, "bytes") == 0)
+          request->accept_bytes_range = true;
   }
 
   fidx = get_http_field_value_pos(header_str, "content-range");
   if (fidx != string::npos) {
-      int64_t first;
-      if (sscanf(&header_str.c_str()[fidx], "%" PRId64, &first) == 1) {
-          if (first != info->range_first) {
-              log_warn("HTTP content range start byte at %" PRId64 " does not match requested start byte at %" PRId64 "\n",
-                       first, info->range_first);
-          }
+      int64_t first, last, total;
+      int num_values = sscanf(&header_str.c_str()[fidx], "bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+                              &first, &last, &total);
+      if (num_values >= 1 && first != request->range_first) {
+          log_warn("HTTP content range start byte at %" PRId64 " does not match requested start byte at %" PRId64 "\n",
+                   first, request->range_first);
       }
+      if (num_values == 3)
+          request->sys_data->file_size = total;
   }
 
   return size * nmemb;
@@ -152,164 +210,477 @@ static size_t curl_abort_write_cb(void* ptr, size_t size, size_t nmemb, void *pr
 
 static size_t curl_data_cb(void* ptr, size_t size, size_t nmemb, void *priv)
 {
-  CURLReceiveInfo *info = (CURLReceiveInfo*)priv;
+  HTTPRequest *request = (HTTPRequest*)priv;
+  uint32_t block_size = request->sys_data->block_size;
 
+  // a server that doesn't support byte ranges returns the file from the start
+  if (request->response_code != 206 && request->range_first != 0)
+      return 0;
+
+  const unsigned char *rec_data = (const unsigned char*)ptr;
   size_t rec_count = size * nmemb;
+  size_t rem_count = rec_count;
+  while (rem_count > 0) {
+      int64_t offset = request->range_first + request->received;
+      if (offset > request->range_last) {
+          // abort because the server returned more data than requested
+          request->range_end_reached = true;
+          return 0;
+      }
 
-  uint32_t client_copy_count = 0;
-  if (info->client_rem_count > 0) {
-      client_copy_count = info->client_rem_count;
-      if (client_copy_count > rec_count)
-          client_copy_count = (uint32_t)(rec_count);
-      memcpy(&info->client_data[info->read_count], ptr, client_copy_count);
-      info->client_rem_count   -= client_copy_count;
-      info->sys_data->position += client_copy_count;
-      info->read_count         += client_copy_count;
-  }
+      HTTPBlock *block = request->blocks[(size_t)(offset / block_size - request->first_block_index)];
+      uint32_t block_offset = (uint32_t)(offset % block_size);
+      uint32_t copy_count = block_size - block_offset;
+      if (copy_count > rem_count)
+          copy_count = (uint32_t)rem_count;
+      if (copy_count > request->range_last + 1 - offset)
+          copy_count = (uint32_t)(request->range_last + 1 - offset);
+
+      memcpy(&block->data[block_offset], rec_data, copy_count);
+      block->size = block_offset + copy_count;
 
-  uint32_t buf_copy_count = 0;
-  if (client_copy_count < rec_count) {
-      buf_copy_count = info->sys_data->buffer_alloc_size - info->sys_data->buffer_size;
-      if (buf_copy_count > rec_count - client_copy_count)
-          buf_copy_count = (uint32_t)(rec_count - client_copy_count);
-      memcpy(&info->sys_data->buffer[info->sys_data->buffer_size], &((unsigned char*)ptr)[client_copy_count], buf_copy_count);
-      info->sys_data->buffer_size += buf_copy_count;
-      info->read_count            += buf_copy_count;
+      request->received += copy_count;
+      rec_data          += copy_count;
+      rem_count         -= copy_count;
   }
 
-  return (size_t)client_copy_count + (size_t)buf_copy_count;
+  return rec_count;
 }
 
 
-static void http_file_close(MXFFileSysData *sys_data)
+static bool is_pinned_block(MXFFileSysData *sys_data, int64_t block_index)
 {
-    if (sys_data->curl)
-        curl_easy_cleanup(sys_data->curl);
-    delete [] sys_data->buffer;
+    // keep the blocks containing the header partition pack and the footer / RIP resident
+    if (block_index == 0)
+        return true;
+    if (sys_data->file_size > 0) {
+        int64_t last_block_index = (sys_data->file_size - 1) / sys_data->block_size;
+        return block_index > last_block_index - NUM_PINNED_END_BLOCKS;
+    }
+
+    return false;
 }
 
-static uint32_t _http_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count,
-                                bool close_connections, CURLcode *error_code)
+static int64_t get_eof_block_index(MXFFileSysData *sys_data)
 {
-    uint8_t *data_ptr  = data;
-    uint32_t rem_count = count;
+    if (sys_data->file_size < 0)
+        return INT64_MAX;
 
-    *error_code = CURLE_OK;
+    return (sys_data->file_size + sys_data->block_size - 1) / sys_data->block_size;
+}
 
-    sys_data->eof = 0;
+static void free_block(MXFFileSysData *sys_data, HTTPBlock *block)
+{
+    if (sys_data->current_block == block)
+        sys_data->current_block = 0;
+    if (sys_data->free_buffers.size() < MAX_FREE_BUFFERS)
+        sys_data->free_buffers.push_back(block->data);
+    else
+        delete [] block->data;
+    delete block;
+}
 
-    uint32_t buffer_copy_size = 0;
-    if (sys_data->buffer_pos < sys_data->buffer_size) {
-        buffer_copy_size = sys_data->buffer_size - sys_data->buffer_pos;
-        if (buffer_copy_size > rem_count)
-            buffer_copy_size = rem_count;
-        if (buffer_copy_size > 0) {
-            memcpy(data_ptr, &sys_data->buffer[sys_data->buffer_pos], buffer_copy_size);
-            sys_data->buffer_pos += buffer_copy_size;
-            sys_data->position   += buffer_copy_size;
-            data_ptr             += buffer_copy_size;
-            rem_count            -= buffer_copy_size;
-        }
+static void add_block(MXFFileSysData *sys_data, int64_t block_index, HTTPBlock *block)
+{
+    block->lru_iter = sys_data->lru_blocks.insert(sys_data->lru_blocks.end(), block_index);
+    sys_data->blocks[block_index] = block;
+}
+
+static void remove_block(MXFFileSysData *sys_data, map<int64_t, HTTPBlock*>::iterator iter)
+{
+    sys_data->lru_blocks.erase(iter->second->lru_iter);
+    free_block(sys_data, iter->second);
+    sys_data->blocks.erase(iter);
+}
+
+static void touch_block(MXFFileSysData *sys_data, HTTPBlock *block)
+{
+    sys_data->lru_blocks.splice(sys_data->lru_blocks.end(), sys_data->lru_blocks, block->lru_iter);
+}
+
+static void evict_blocks(MXFFileSysData *sys_data, size_t num_new_blocks)
+{
+    // the least recently used blocks are at the front of the list. Only the few pinned blocks and the
+    // blocks still being received are skipped over
+    list<int64_t>::iterator lru_iter = sys_data->lru_blocks.begin();
+    while (sys_data->blocks.size() + num_new_blocks > sys_data->max_cache_blocks &&
+           lru_iter != sys_data->lru_blocks.end())
+    {
+        map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.find(*lru_iter);
+        BMX_ASSERT(iter != sys_data->blocks.end());
+        lru_iter++;
+        if (!iter->second->request && !is_pinned_block(sys_data, iter->first))
+            remove_block(sys_data, iter);
     }
+}
 
-    if (rem_count > 0) {
-        char error_buf[CURL_ERROR_SIZE];
+static void start_request(MXFFileSysData *sys_data, HTTPRequest *request, bool close_connections)
+{
+    request->received           = 0;
+    request->response_code      = 0;
+    request->accept_range_recv  = false;
+    request->accept_bytes_range = false;
+    request->range_end_reached  = false;
+    request->error_buf[0]       = 0;
+
+    CURL *curl = request->curl;
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)request);
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, request->error_buf);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
+    curl_easy_setopt(curl, CURLOPT_URL, sys_data->url_str.c_str());
+    curl_easy_setopt(curl, CURLOPT_RANGE, request->range_buf);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_data_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)request);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_header_cb);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)request);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
+
+    if (close_connections) {
+        // This closes the connections and opens a new connection
+        curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, 1L);
+        curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L);
+    }
 
-        sys_data->buffer_pos  = 0;
-        sys_data->buffer_size = 0;
+    curl_multi_add_handle(sys_data->multi, curl);
+}
 
-        CURLReceiveInfo info;
-        memset(&info, 0, sizeof(info));
-        info.sys_data         = sys_data;
-        info.client_data      = data_ptr;
-        info.client_rem_count = rem_count;
-        info.range_first      = sys_data->position;
-        info.range_last       = sys_data->position;
-        if (rem_count > sys_data->buffer_alloc_size)
-            info.range_last += rem_count - 1;
-        else
-            info.range_last += sys_data->buffer_alloc_size - 1;
+static void issue_request(MXFFileSysData *sys_data, int64_t first_block_index, uint32_t num_blocks, bool read_ahead)
+{
+    evict_blocks(sys_data, num_blocks);
+
+    HTTPRequest *request = new HTTPRequest;
+    request->sys_data          = sys_data;
+    request->first_block_index = first_block_index;
+    request->range_first       = first_block_index * sys_data->block_size;
+    request->range_last        = request->range_first + (int64_t)num_blocks * sys_data->block_size - 1;
+    request->read_ahead        = read_ahead;
+    request->retried           = false;
+    bmx_snprintf(request->range_buf, sizeof(request->range_buf), "%" PRId64 "-%" PRId64,
+                 request->range_first, request->range_last);
+
+    uint32_t i;
+    for (i = 0; i < num_blocks; i++) {
+        HTTPBlock *block = new HTTPBlock;
+        if (sys_data->free_buffers.empty()) {
+            block->data = new unsigned char[sys_data->block_size];
+        } else {
+            block->data = sys_data->free_buffers.back();
+            sys_data->free_buffers.pop_back();
+        }
+        block->size        = 0;
+        block->complete    = false;
+        block->failed      = false;
+        block->request     = request;
+        add_block(sys_data, first_block_index + i, block);
+        request->blocks.push_back(block);
+    }
+
+    if (sys_data->idle_curls.empty()) {
+        request->curl = curl_easy_init();
+    } else {
+        request->curl = sys_data->idle_curls.back();
+        sys_data->idle_curls.pop_back();
+    }
+    if (!request->curl) {
+        for (i = 0; i < num_blocks; i++) {
+            request->blocks[i]->request = 0;
+            request->blocks[i]->failed  = true;
+        }
+        delete request;
+        log_error("Failed to initialise curl handle for HTTP request\n");
+        return;
+    }
 
-        char range_buf[64];
-        bmx_snprintf(range_buf, sizeof(range_buf), "%" PRId64 "-%" PRId64,
-                     info.range_first, info.range_last);
+    sys_data->requests.push_back(request);
+    start_request(sys_data, request, false);
+}
 
-        curl_easy_reset(sys_data->curl);
-        curl_easy_setopt(sys_data->curl, CURLOPT_ERRORBUFFER, error_buf);
-        curl_easy_setopt(sys_data->curl, CURLOPT_NOPROGRESS, 1);
-        curl_easy_setopt(sys_data->curl, CURLOPT_URL, sys_data->url_str.c_str());
-        curl_easy_setopt(sys_data->curl, CURLOPT_RANGE, range_buf);
-        curl_easy_setopt(sys_data->curl, CURLOPT_WRITEFUNCTION, curl_data_cb);
-        curl_easy_setopt(sys_data->curl, CURLOPT_WRITEDATA, (void*)&info);
-        curl_easy_setopt(sys_data->curl, CURLOPT_HEADERFUNCTION, curl_header_cb);
-        curl_easy_setopt(sys_data->curl, CURLOPT_HEADERDATA, (void*)&info);
-        curl_easy_setopt(sys_data->curl, CURLOPT_FAILONERROR, 1);
+static void remove_request(MXFFileSysData *sys_data, HTTPRequest *request)
+{
+    curl_multi_remove_handle(sys_data->multi, request->curl);
+    sys_data->idle_curls.push_back(request->curl);
+
+    size_t i;
+    for (i = 0; i < sys_data->requests.size(); i++) {
+        if (sys_data->requests[i] == request) {
+            sys_data->requests.erase(sys_data->requests.begin() + i);
+            break;
+        }
+    }
+    delete request;
+}
 
-        if (close_connections) {
-            // This closes the connections and opens a new connection
-            curl_easy_setopt(sys_data->curl, CURLOPT_MAXCONNECTS, 1L);
-            curl_easy_setopt(sys_data->curl, CURLOPT_FRESH_CONNECT, 1L);
+static void cancel_read_ahead(MXFFileSysData *sys_data, int64_t keep_block_index)
+{
+    size_t i = 0;
+    while (i < sys_data->requests.size()) {
+        HTTPRequest *request = sys_data->requests[i];
+        if (!request->read_ahead ||
+            (keep_block_index >= request->first_block_index &&
+                keep_block_index < request->first_block_index + (int64_t)request->blocks.size()))
+        {
+            i++;
+            continue;
         }
 
-        CURLcode result = curl_easy_perform(sys_data->curl);
-        rem_count = info.client_rem_count;
-
-        if (result != 0) {
-            if (result != CURLE_PARTIAL_FILE) {
-                if (result == CURLE_WRITE_ERROR) {
-                    if (!info.accept_range_recv || !info.accept_bytes_range) {
-                        if (info.range_first != 0)
-                            rem_count = count;
-                        bmx::log((info.range_first == 0 ? WARN_LOG: ERROR_LOG),
-                                 "HTTP server does not support byte range requests\n");
-                    } else {
-                        log_error("HTTP server returned more data than requested\n");
-                    }
-                } else {
-                    log_error("HTTP request failed: %s (curl result %d)\n", error_buf, result);
-                }
-            }
+        size_t b;
+        for (b = 0; b < request->blocks.size(); b++)
+            remove_block(sys_data, sys_data->blocks.find(request->first_block_index + b));
+        remove_request(sys_data, request);
+    }
+}
+
+static void complete_request(MXFFileSysData *sys_data, HTTPRequest *request, CURLcode result)
+{
+    long code = 0;
+    curl_easy_getinfo(request->curl, CURLINFO_RESPONSE_CODE, &code);
+
+    bool success = true;
+    if (result != CURLE_OK && result != CURLE_PARTIAL_FILE) {
+        if (code == 416) {
+            // range not satisfiable, i.e. the request starts beyond the end of the file
+            if (sys_data->file_size < 0 || sys_data->file_size > request->range_first)
+                sys_data->file_size = request->range_first;
+        } else if (result == CURLE_WRITE_ERROR && request->range_first == 0 && request->range_end_reached) {
+            log_warn("HTTP server does not support byte range requests\n");
+        } else if (result == CURLE_WRITE_ERROR) {
+            if (!request->accept_range_recv || !request->accept_bytes_range)
+                log_error("HTTP server does not support byte range requests\n");
+            else
+                log_error("HTTP server returned more data than requested\n");
+            success = false;
+        } else if (result == CURLE_HTTP2 && !request->retried) {
+            // It was found that the google storage api would cause curl to return a CURLE_HTTP2
+            // error after around an hour. The workaround implemented here is to close the connection
+            // and open a new one. The issue appears similar to https://github.com/curl/curl/issues/5389
+            // and https://github.com/curl/curl/pull/5643. The fix
+            // https://github.com/curl/curl/commit/ef86daf4d39e99b227d42bb712000c9adfdbdf76 didn't
+            // solve the issue (version 7.74.0).
+            log_warn("Closing curl connections and retrying a read after a CURLE_HTTP2 error\n");
+            curl_multi_remove_handle(sys_data->multi, request->curl);
+            request->retried = true;
+            start_request(sys_data, request, true);
+            return;
         } else {
-            long code;
-            curl_easy_getinfo(sys_data->curl, CURLINFO_RESPONSE_CODE, &code);
-            if (code != 206) { // 206 = partial content
-                if (!sys_data->disable_response_code_warn) {
-                    if (info.accept_range_recv && !info.accept_bytes_range)
-                        log_warn("HTTP server does not support byte range requests\n");
-                    else if (!info.accept_range_recv)
-                        log_warn("HTTP server does not indicate support for byte range requests\n");
-                    else
-                        log_warn("Unexpected HTTP response code %ld\n", code);
-                    sys_data->disable_response_code_warn = true;
-                }
-            } else {
-                sys_data->disable_response_code_warn = false;
-            }
+            log_error("HTTP request failed: %s (curl result %d)\n", request->error_buf, result);
+            success = false;
         }
+    } else if (code != 206) { // 206 = partial content
+        if (!sys_data->disable_response_code_warn) {
+            if (request->accept_range_recv && !request->accept_bytes_range)
+                log_warn("HTTP server does not support byte range requests\n");
+            else if (!request->accept_range_recv)
+                log_warn("HTTP server does not indicate support for byte range requests\n");
+            else
+                log_warn("Unexpected HTTP response code %ld\n", code);
+            sys_data->disable_response_code_warn = true;
+        }
+    } else {
+        sys_data->disable_response_code_warn = false;
+    }
+
+    // a short response indicates the end of the file
+    if (success && request->range_first + request->received <= request->range_last &&
+        (sys_data->file_size < 0 || sys_data->file_size > request->range_first + request->received))
+    {
+        sys_data->file_size = request->range_first + request->received;
+    }
+
+    size_t i;
+    for (i = 0; i < request->blocks.size(); i++) {
+        HTTPBlock *block = request->blocks[i];
+        block->request  = 0;
+        block->complete = success;
+        block->failed   = !success;
+        if (!success)
+            block->size = 0;
+    }
+
+    remove_request(sys_data, request);
+}
 
-        *error_code = result;
+static void process_transfers(MXFFileSysData *sys_data, bool wait)
+{
+    int running;
+    curl_multi_perform(sys_data->multi, &running);
+
+    CURLMsg *msg;
+    int num_msgs;
+    while ((msg = curl_multi_info_read(sys_data->multi, &num_msgs))) {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+
+        HTTPRequest *request = 0;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&request);
+        BMX_ASSERT(request);
+        complete_request(sys_data, request, msg->data.result);
+        wait = false;
+    }
+
+    if (wait && running > 0) {
+#if LIBCURL_VERSION_NUM >= 0x074200
+        curl_multi_poll(sys_data->multi, 0, 0, 1000, 0);
+#else
+        curl_multi_wait(sys_data->multi, 0, 0, 1000, 0);
+#endif
     }
+}
+
+static void request_missing_blocks(MXFFileSysData *sys_data, int64_t first_block_index, int64_t last_block_index,
+                                   bool read_ahead)
+{
+    int64_t eof_block_index = get_eof_block_index(sys_data);
+    if (last_block_index >= eof_block_index)
+        last_block_index = eof_block_index - 1;
+
+    int64_t block_index = first_block_index;
+    while (block_index <= last_block_index) {
+        if (read_ahead && sys_data->requests.size() >= sys_data->max_requests)
+            break;
+        if (sys_data->blocks.count(block_index)) {
+            block_index++;
+            continue;
+        }
+
+        uint32_t num_blocks = 1;
+        while (num_blocks < sys_data->max_request_blocks &&
+               block_index + num_blocks <= last_block_index &&
+               !sys_data->blocks.count(block_index + num_blocks))
+        {
+            num_blocks++;
+        }
+        // read-ahead is only issued in full size requests to avoid a small request for each block read
+        if (read_ahead && num_blocks < sys_data->max_request_blocks && block_index + num_blocks < eof_block_index)
+            break;
+
+        issue_request(sys_data, block_index, num_blocks, read_ahead);
+        block_index += num_blocks;
+    }
+}
+
+static HTTPBlock* get_block(MXFFileSysData *sys_data, int64_t block_index, int64_t last_needed_block_index)
+{
+    // forward skips within the read-ahead window, e.g. over essence that is not read, are also sequential
+    int64_t max_skip = (sys_data->read_ahead_blocks > 0 ? sys_data->read_ahead_blocks : 1);
+    if (block_index > sys_data->last_block_index && block_index <= sys_data->last_block_index + max_skip) {
+        if (sys_data->seq_count < MAX_SEQ_COUNT)
+            sys_data->seq_count++;
+    } else if (block_index != sys_data->last_block_index) {
+        sys_data->seq_count = 0;
+        cancel_read_ahead(sys_data, block_index);
+    }
+    sys_data->last_block_index = block_index;
+
+    map<int64_t, HTTPBlock*>::iterator iter = sys_data->blocks.find(block_index);
+    if (iter != sys_data->blocks.end() && iter->second->failed)
+        remove_block(sys_data, iter);
+
+    // limit the number of blocks requested in advance for large reads
+    int64_t max_window = sys_data->read_ahead_blocks;
+    if (max_window < sys_data->max_request_blocks)
+        max_window = sys_data->max_request_blocks;
+    if (last_needed_block_index > block_index + max_window - 1)
+        last_needed_block_index = block_index + max_window - 1;
+
+    for (iter = sys_data->blocks.lower_bound(block_index);
+         iter != sys_data->blocks.end() && iter->first <= last_needed_block_index;
+         iter++)
+    {
+        touch_block(sys_data, iter->second);
+    }
+
+    request_missing_blocks(sys_data, block_index, last_needed_block_index, false);
+    if (sys_data->seq_count > 0 && sys_data->read_ahead_blocks > 0) {
+        int64_t window = (int64_t)sys_data->max_request_blocks << sys_data->seq_count;
+        if (window > sys_data->read_ahead_blocks)
+            window = sys_data->read_ahead_blocks;
+        request_missing_blocks(sys_data, last_needed_block_index + 1, block_index + window, true);
+    }
+
+    iter = sys_data->blocks.find(block_index);
+    if (iter == sys_data->blocks.end())
+        return 0; // beyond the end of the file
+    HTTPBlock *block = iter->second;
+
+    while (block->request)
+        process_transfers(sys_data, true);
+
+    if (block->failed)
+        return 0;
 
-    return count - rem_count;
+    return block;
+}
+
+
+static void http_file_close(MXFFileSysData *sys_data)
+{
+    while (!sys_data->requests.empty())
+        remove_request(sys_data, sys_data->requests.back());
+
+    map<int64_t, HTTPBlock*>::iterator iter;
+    for (iter = sys_data->blocks.begin(); iter != sys_data->blocks.end(); iter++) {
+        delete [] iter->second->data;
+        delete iter->second;
+    }
+    sys_data->blocks.clear();
+    sys_data->lru_blocks.clear();
+    sys_data->current_block = 0;
+
+    size_t i;
+    for (i = 0; i < sys_data->free_buffers.size(); i++)
+        delete [] sys_data->free_buffers[i];
+    sys_data->free_buffers.clear();
+
+    for (i = 0; i < sys_data->idle_curls.size(); i++)
+        curl_easy_cleanup(sys_data->idle_curls[i]);
+    sys_data->idle_curls.clear();
+
+    if (sys_data->multi)
+        curl_multi_cleanup(sys_data->multi);
+    if (sys_data->curl)
+        curl_easy_cleanup(sys_data->curl);
 }
 
 static uint32_t http_file_read(MXFFileSysData *sys_data, uint8_t *data, uint32_t count)
 {
-    CURLcode error_code;
-    uint32_t result = _http_file_read(sys_data, data, count, false, &error_code);
-
-    // It was found that the google storage api would cause curl to return a CURLE_HTTP2
-    // error after around an hour. The workaround implemented here is to close the connection
-    // and open a new one. The issue appears similar to https://github.com/curl/curl/issues/5389
-    // and https://github.com/curl/curl/pull/5643. The fix
-    // https://github.com/curl/curl/commit/ef86daf4d39e99b227d42bb712000c9adfdbdf76 didn't
-    // solve the issue (version 7.74.0).
-    if (result < count && error_code == CURLE_HTTP2) {
-        log_warn("Closing curl connections and retrying a read after a CURLE_HTTP2 error\n");
-        result += _http_file_read(sys_data, data, count - result, true, &error_code);
+    uint32_t total_read = 0;
+
+    sys_data->eof = 0;
+
+    // progress the transfers that are in flight
+    if (!sys_data->requests.empty())
+        process_transfers(sys_data, false);
+
+    while (total_read < count) {
+        int64_t block_index = sys_data->position / sys_data->block_size;
+        int64_t last_needed_block_index = (sys_data->position + (count - total_read) - 1) / sys_data->block_size;
+
+        HTTPBlock *block = get_block(sys_data, block_index, last_needed_block_index);
+        if (!block) {
+            if (sys_data->file_size >= 0 && sys_data->position >= sys_data->file_size)
+                sys_data->eof = 1;
+            break;
+        }
+
+        uint32_t block_offset = (uint32_t)(sys_data->position % sys_data->block_size);
+        if (block_offset >= block->size) {
+            sys_data->eof = 1;
+            break;
+        }
+
+        sys_data->current_block       = block;
+        sys_data->current_block_index = block_index;
+
+        uint32_t copy_count = block->size - block_offset;
+        if (copy_count > count - total_read)
+            copy_count = count - total_read;
+        memcpy(&data[total_read], &block->data[block_offset], copy_count);
+        sys_data->position += copy_count;
+        total_read         += copy_count;
     }
 
-    return result;
+    return total_read;
 }
 
 static uint32_t http_file_write(MXFFileSysData *sys_data, const uint8_t *data, uint32_t count)
@@ -322,6 +693,18 @@ static uint32_t http_file_write(MXFFileSysData *sys_data, const uint8_t *data, u
 
 static int http_file_getc(MXFFileSysData *sys_data)
 {
+    // KLV keys and lengths are parsed a byte at a time and so a byte in the current block is returned directly,
+    // without progressing the transfers or looking up the block
+    HTTPBlock *block = sys_data->current_block;
+    if (block && sys_data->position / sys_data->block_size == sys_data->current_block_index) {
+        uint32_t block_offset = (uint32_t)(sys_data->position % sys_data->block_size);
+        if (block_offset < block->size) {
+            sys_data->eof = 0;
+            sys_data->position++;
+            return block->data[block_offset];
+        }
+    }
+
     uint8_t data;
     uint32_t num_read = http_file_read(sys_data, &data, 1);
     if (num_read == 0)
@@ -355,6 +738,10 @@ static int http_file_is_seekable(MXFFileSysData *sys_data)
 
 static int64_t http_file_size(MXFFileSysData *sys_data)
 {
+    // the size is known once a range response or the end of the file has been received
+    if (sys_data->file_size >= 0)
+        return sys_data->file_size;
+
     int64_t file_size = -1;
 
     // Not using CURLINFO_CONTENT_LENGTH_DOWNLOAD because it returns a double.
@@ -394,6 +781,9 @@ static int64_t http_file_size(MXFFileSysData *sys_data)
         log_error("Failed to get file size: %s (curl result = %d)\n", error_buf, result);
     }
 
+    if (file_size >= 0)
+        sys_data->file_size = file_size;
+
     return file_size;
 }
 
@@ -414,22 +804,8 @@ static int http_file_seek(MXFFileSysData *sys_data, int64_t offset, int whence)
         return 0;
     }
 
-    if (sys_data->position != new_position) {
-        int64_t pos_diff = new_position - sys_data->position;
-        if (sys_data->buffer_size > 0 &&
-            pos_diff >= - (int64_t)sys_data->buffer_pos &&
-            pos_diff < (int64_t)(sys_data->buffer_size - sys_data->buffer_pos))
-        {
-            sys_data->buffer_pos = (uint32_t)(sys_data->buffer_pos + pos_diff);
-        }
-        else
-        {
-            sys_data->buffer_size = 0;
-            sys_data->buffer_pos  = 0;
-        }
-        sys_data->position = new_position;
-    }
-
+    // cached blocks are kept and sequential access detection happens when reading
+    sys_data->position = new_position;
     sys_data->eof = false;
 
     return 1;
@@ -452,7 +828,7 @@ bool bmx::mxf_http_is_url(const string &url_str)
            url_str.compare(0, 8, "https://") == 0;
 }
 
-MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size)
+MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size, uint32_t max_read_ahead_requests)
 {
     MXFFile *http_file = 0;
     try
@@ -465,18 +841,26 @@ MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_s
         http_file->sysData->http_file.mxf_file = http_file;
         http_file->sysData->url_str = url_str;
         http_file->sysData->curl = 0;
+        http_file->sysData->multi = 0;
         http_file->sysData->position = 0;
         http_file->sysData->eof = false;
-        http_file->sysData->buffer = 0;
-        http_file->sysData->buffer_pos = 0;
-        http_file->sysData->buffer_size = 0;
-        http_file->sysData->buffer_alloc_size = 0;
+        http_file->sysData->file_size = -1;
+        http_file->sysData->block_size = (min_read_size > 0 ? min_read_size : DEFAULT_BLOCK_SIZE);
+        http_file->sysData->max_requests = max_read_ahead_requests;
+        http_file->sysData->max_request_blocks = MAX_REQUEST_SIZE / http_file->sysData->block_size;
+        if (http_file->sysData->max_request_blocks == 0)
+            http_file->sysData->max_request_blocks = 1;
+        http_file->sysData->read_ahead_blocks = max_read_ahead_requests * http_file->sysData->max_request_blocks;
+        http_file->sysData->max_cache_blocks = 2 * (http_file->sysData->read_ahead_blocks +
+                                                    http_file->sysData->max_request_blocks) + NUM_PINNED_END_BLOCKS + 1;
+        http_file->sysData->current_block = 0;
+        http_file->sysData->current_block_index = -1;
+        http_file->sysData->last_block_index = -1;
+        http_file->sysData->seq_count = 0;
+        http_file->sysData->disable_response_code_warn = false;
 
         BMX_CHECK((http_file->sysData->curl = curl_easy_init()) != 0);
-        if (min_read_size > 0) {
-            http_file->sysData->buffer            = new unsigned char[min_read_size];
-            http_file->sysData->buffer_alloc_size = min_read_size;
-        }
+        BMX_CHECK((http_file->sysData->multi = curl_multi_init()) != 0);
 
         http_file->close         = http_file_close;
         http_file->read          = http_file_read;
@@ -525,10 +909,11 @@ bool bmx::mxf_http_is_url(const string &url_str)
            url_str.compare(0, 8, "https://") == 0;
 }
 
-MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size)
+MXFFile* bmx::mxf_http_file_open_read(const string &url_str, uint32_t min_read_size, uint32_t max_read_ahead_requests)
 {
     (void)url_str;
     (void)min_read_size;
+    (void)max_read_ahead_requests;
     BMX_EXCEPTION(("HTTP file access is not supported in this build"));
 }
 
@@ -40,6 +40,10 @@
 // * Changed 'unsigned long' to 'uint32_t' (otherwise calculation is
 //   wrong)
 // * Changed sha1_update 'len' parameter type to 'uint32_t'
+// * Changed the sha1_transform workspace from static to local to allow
+//   contexts to be used in multiple threads
+// * Added a SHA extensions (SHA-NI) block transform that is selected at
+//   runtime
 
 
 #ifdef HAVE_CONFIG_H
@@ -50,12 +54,21 @@
 #include <cstring>
 #include <cerrno>
 
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BMX_SHA1_SHANI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 #include <bmx/SHA1.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
 using namespace std;
+using namespace bmx;
 
 
 #define SHA1HANDSOFF /* Copies data before messing with it. */
@@ -93,7 +106,7 @@ typedef union {
 } CHAR64LONG16;
 CHAR64LONG16* block;
 #ifdef SHA1HANDSOFF
-static unsigned char workspace[64];
+unsigned char workspace[64];
     block = (CHAR64LONG16*)workspace;
     memcpy(block, buffer, 64);
 #else
@@ -137,6 +150,122 @@ static unsigned char workspace[64];
 }
 
 
+#if defined(BMX_SHA1_SHANI)
+
+/* Hash 4 rounds using the SHA extensions. k is the (constant) index of the 4 rounds, 0..19 */
+#define SHANI_ROUNDS4(k) \
+    if ((k) > 0) \
+        e[(k) & 1] = _mm_sha1nexte_epu32(e[(k) & 1], msg[(k) & 3]); \
+    e[((k) + 1) & 1] = abcd; \
+    if ((k) >= 3 && (k) <= 18) \
+        msg[((k) + 1) & 3] = _mm_sha1msg2_epu32(msg[((k) + 1) & 3], msg[(k) & 3]); \
+    abcd = _mm_sha1rnds4_epu32(abcd, e[(k) & 1], (k) / 5); \
+    if ((k) >= 1 && (k) <= 16) \
+        msg[((k) + 3) & 3] = _mm_sha1msg1_epu32(msg[((k) + 3) & 3], msg[(k) & 3]); \
+    if ((k) >= 2 && (k) <= 17) \
+        msg[((k) + 2) & 3] = _mm_xor_si128(msg[((k) + 2) & 3], msg[(k) & 3]);
+
+__attribute__((target("sha,ssse3,sse4.1")))
+static void sha1_transform_shani(uint32_t state[5], const unsigned char *data, size_t num_blocks)
+{
+    const __m128i byte_swap_mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd, abcd_save, e_save;
+    __m128i e[2];
+    __m128i msg[4];
+    size_t i;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1b);
+    e[0] = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for (i = 0; i < num_blocks; i++) {
+        abcd_save = abcd;
+        e_save = e[0];
+
+        msg[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data +  0)), byte_swap_mask);
+        msg[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), byte_swap_mask);
+        msg[2] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), byte_swap_mask);
+        msg[3] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), byte_swap_mask);
+
+        e[0] = _mm_add_epi32(e[0], msg[0]);
+        SHANI_ROUNDS4( 0) SHANI_ROUNDS4( 1) SHANI_ROUNDS4( 2) SHANI_ROUNDS4( 3)
+        SHANI_ROUNDS4( 4) SHANI_ROUNDS4( 5) SHANI_ROUNDS4( 6) SHANI_ROUNDS4( 7)
+        SHANI_ROUNDS4( 8) SHANI_ROUNDS4( 9) SHANI_ROUNDS4(10) SHANI_ROUNDS4(11)
+        SHANI_ROUNDS4(12) SHANI_ROUNDS4(13) SHANI_ROUNDS4(14) SHANI_ROUNDS4(15)
+        SHANI_ROUNDS4(16) SHANI_ROUNDS4(17) SHANI_ROUNDS4(18) SHANI_ROUNDS4(19)
+
+        e[0] = _mm_sha1nexte_epu32(e[0], e_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+
+        data += 64;
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t)_mm_extract_epi32(e[0], 3);
+}
+
+static bool have_shani()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+        return false;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (ebx & (1 << 29)) != 0;
+}
+
+#endif
+
+
+/* Hash a sequence of 512-bit blocks */
+
+static void sha1_transform_portable(uint32_t state[5], const unsigned char *data, size_t num_blocks)
+{
+    size_t i;
+    for (i = 0; i < num_blocks; i++)
+        sha1_transform(state, &data[i * 64]);
+}
+
+
+typedef struct
+{
+    const char *name;
+    SHA1TransformFunc func;
+} SHA1TransformImpl;
+
+static vector<SHA1TransformImpl> get_supported_sha1_transform_impls()
+{
+    vector<SHA1TransformImpl> impls;
+    SHA1TransformImpl impl;
+
+    impl.name = "portable";
+    impl.func = sha1_transform_portable;
+    impls.push_back(impl);
+
+#if defined(BMX_SHA1_SHANI)
+    if (have_shani()) {
+        impl.name = "shani";
+        impl.func = sha1_transform_shani;
+        impls.push_back(impl);
+    }
+#endif
+
+    return impls;
+}
+
+static const vector<SHA1TransformImpl>& get_sha1_transform_impls()
+{
+    static const vector<SHA1TransformImpl> impls = get_supported_sha1_transform_impls();
+    return impls;
+}
+
+static void sha1_transform_blocks(uint32_t state[5], const unsigned char *data, size_t num_blocks)
+{
+    static const SHA1TransformFunc transform_func = get_sha1_transform_impls().back().func;
+    transform_func(state, data, num_blocks);
+}
+
+
 /* sha1_init - Initialize new context */
 
 void bmx::sha1_init(SHA1Context *context)
@@ -162,10 +291,9 @@ size_t i, j;
     context->count[1] += (len >> 29);
     if ((j + len) > 63) {
         memcpy(&context->buffer[j], data, (i = 64-j));
-        sha1_transform(context->state, context->buffer);
-        for ( ; i + 63 < len; i += 64) {
-            sha1_transform(context->state, &data[i]);
-        }
+        sha1_transform_blocks(context->state, context->buffer, 1);
+        sha1_transform_blocks(context->state, &data[i], (len - i) / 64);
+        i += (len - i) & ~(size_t)63;
         j = 0;
     }
     else i = 0;
@@ -199,9 +327,6 @@ unsigned char finalcount[8];
     memset(context->state, 0, 20);
     memset(context->count, 0, 8);
     memset(&finalcount, 0, 8);
-#ifdef SHA1HANDSOFF  /* make sha1_transform overwrite it's own static vars */
-    sha1_transform(context->state, context->buffer);
-#endif
 }
 
 string bmx::sha1_digest_str(const unsigned char digest[20])
@@ -219,6 +344,20 @@ string bmx::sha1_digest_str(const unsigned char digest[20])
     return digest_str;
 }
 
+size_t bmx::sha1_get_num_transform_impls()
+{
+    return get_sha1_transform_impls().size();
+}
+
+SHA1TransformFunc bmx::sha1_get_transform_impl(size_t index, const char **name)
+{
+    BMX_CHECK(index < get_sha1_transform_impls().size());
+
+    if (name)
+        *name = get_sha1_transform_impls()[index].name;
+    return get_sha1_transform_impls()[index].func;
+}
+
 string bmx::sha1_calc_file(string filename)
 {
     FILE *file = fopen(filename.c_str(), "rb");
@@ -254,7 +393,7 @@ string bmx::sha1_calc_file(FILE *file)
             sha1_update(&context, buffer, (uint32_t)num_read);
     }
 
-    unsigned char digest[16];
+    unsigned char digest[20];
     sha1_final(digest, &context);
 
     return sha1_digest_str(digest);
@@ -743,6 +743,26 @@ int64_t bmx::get_file_size(FILE *file)
     return (int64_t)stat_buf.st_size;
 }
 
+int64_t bmx::get_file_mod_time(const string &filename)
+{
+#if defined(_WIN32)
+    struct _stati64 stat_buf;
+    if (_stati64(filename.c_str(), &stat_buf) != 0)
+#else
+    struct stat stat_buf;
+    if (stat(filename.c_str(), &stat_buf) != 0)
+#endif
+        throw BMXIOException("Failed to get file modification time: %s", bmx_strerror(errno).c_str());
+
+#if defined(_WIN32)
+    return (int64_t)stat_buf.st_mtime * 1000000000;
+#elif defined(__APPLE__)
+    return (int64_t)stat_buf.st_mtimespec.tv_sec * 1000000000 + stat_buf.st_mtimespec.tv_nsec;
+#else
+    return (int64_t)stat_buf.st_mtim.tv_sec * 1000000000 + stat_buf.st_mtim.tv_nsec;
+#endif
+}
+
 string bmx::trim_string(string value)
 {
     size_t start;
@@ -146,6 +146,7 @@ D10File::D10File(int flavour, mxfpp::File *mxf_file, mxfRational frame_rate)
 
     if ((flavour & D10_SINGLE_PASS_MD5_WRITE_FLAVOUR)) {
         mMXFChecksumFile = mxf_checksum_file_open(mMXFFile->getCFile(), MD5_CHECKSUM);
+        mxf_checksum_file_enable_async_update(mMXFChecksumFile);
         mMXFFile->swapCFile(mxf_checksum_file_get_file(mMXFChecksumFile));
     }
     if ((flavour & D10_AS11_FLAVOUR))
@@ -77,6 +77,7 @@ uint32_t DVEssenceParser::ParseFrameStart(const unsigned char *data, uint32_t da
 uint32_t DVEssenceParser::ParseFrameSize(const unsigned char *data, uint32_t data_size)
 {
     BMX_ASSERT(DV_PARSER_MIN_DATA_SIZE >= DV_DIF_SEQUENCE_SIZE);
+    mRequiredFrameDataSize = 0;
     if (data_size < DV_PARSER_MIN_DATA_SIZE)
         return ESSENCE_PARSER_NULL_OFFSET; // insufficient data
 
@@ -101,8 +102,10 @@ uint32_t DVEssenceParser::ParseFrameSize(const unsigned char *data, uint32_t dat
     }
 
     uint32_t frame_size = ParseFrameSizeInt(data, data_size);
-    if (data_size < frame_size)
+    if (data_size < frame_size) {
+        mRequiredFrameDataSize = frame_size;
         return ESSENCE_PARSER_NULL_OFFSET;
+    }
 
     return frame_size;
 }
@@ -35,13 +35,164 @@
 
 #define __STDC_LIMIT_MACROS
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BMX_HAVE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BMX_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#include <vector>
+
 #include "EssenceParserUtils.h"
+#include <bmx/essence_parser/EssenceParser.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+using namespace std;
 using namespace bmx;
 
 
+struct StartCodePrefixImpl
+{
+    FindStartCodePrefixFunc func;
+    const char *name;
+};
+
+
+#if defined(BMX_HAVE_SSE2)
+
+static inline uint32_t count_trailing_zeros(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(mask);
+#endif
+}
+
+static uint32_t find_start_code_prefix_sse2(const unsigned char *data, uint32_t size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi8(1);
+
+    // compare 16 candidate prefix positions per iteration using loads offset by 0, 1 and 2 bytes
+    uint32_t offset = 0;
+    while (size >= 18 && offset <= size - 18) {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(data + offset));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(data + offset + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(data + offset + 2));
+        __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                      _mm_cmpeq_epi8(b2, one));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(match);
+        if (mask)
+            return offset + count_trailing_zeros(mask);
+        offset += 16;
+    }
+
+    uint32_t rem_offset = find_start_code_prefix_scalar(data + offset, size - offset);
+    if (rem_offset == ESSENCE_PARSER_NULL_OFFSET)
+        return ESSENCE_PARSER_NULL_OFFSET;
+    return offset + rem_offset;
+}
+
+#endif
+
+#if defined(BMX_HAVE_AVX2)
+
+__attribute__((target("avx2")))
+static uint32_t find_start_code_prefix_avx2(const unsigned char *data, uint32_t size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one  = _mm256_set1_epi8(1);
+
+    uint32_t offset = 0;
+    while (size >= 34 && offset <= size - 34) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(data + offset));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(data + offset + 1));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(data + offset + 2));
+        __m256i match = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero), _mm256_cmpeq_epi8(b1, zero)),
+                                         _mm256_cmpeq_epi8(b2, one));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(match);
+        if (mask)
+            return offset + count_trailing_zeros(mask);
+        offset += 32;
+    }
+
+    uint32_t rem_offset = find_start_code_prefix_sse2(data + offset, size - offset);
+    if (rem_offset == ESSENCE_PARSER_NULL_OFFSET)
+        return ESSENCE_PARSER_NULL_OFFSET;
+    return offset + rem_offset;
+}
+
+#endif
+
+static StartCodePrefixImpl select_start_code_prefix_impl()
+{
+    StartCodePrefixImpl impl;
+#if defined(BMX_HAVE_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        impl.func = find_start_code_prefix_avx2;
+        impl.name = "avx2";
+        return impl;
+    }
+#endif
+#if defined(BMX_HAVE_SSE2)
+    impl.func = find_start_code_prefix_sse2;
+    impl.name = "sse2";
+#else
+    impl.func = find_start_code_prefix_scalar;
+    impl.name = "scalar";
+#endif
+    return impl;
+}
+
+static const StartCodePrefixImpl& get_selected_start_code_prefix_impl()
+{
+    static const StartCodePrefixImpl impl = select_start_code_prefix_impl();
+    return impl;
+}
+
+static vector<StartCodePrefixImpl> get_supported_start_code_prefix_impls()
+{
+    vector<StartCodePrefixImpl> impls;
+    StartCodePrefixImpl impl;
+
+    impl.func = find_start_code_prefix_scalar;
+    impl.name = "scalar";
+    impls.push_back(impl);
+#if defined(BMX_HAVE_SSE2)
+    impl.func = find_start_code_prefix_sse2;
+    impl.name = "sse2";
+    impls.push_back(impl);
+#endif
+#if defined(BMX_HAVE_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        impl.func = find_start_code_prefix_avx2;
+        impl.name = "avx2";
+        impls.push_back(impl);
+    }
+#endif
+
+    return impls;
+}
+
+static const vector<StartCodePrefixImpl>& get_start_code_prefix_impls()
+{
+    static const vector<StartCodePrefixImpl> impls = get_supported_start_code_prefix_impls();
+    return impls;
+}
+
+
 uint32_t BitstreamParser::read(uint8_t num_bits)
 {
     uint32_t d = get_bits(mDataPtr, mDataSize, mBitOffset, num_bits);
@@ -89,3 +240,49 @@ uint32_t bmx::get_bits(const unsigned char *data, uint32_t data_size, uint32_t b
     return (uint32_t)buffer;
 }
 
+
+uint32_t bmx::find_start_code_prefix(const unsigned char *data, uint32_t size)
+{
+    return get_selected_start_code_prefix_impl().func(data, size);
+}
+
+uint32_t bmx::find_start_code_prefix_scalar(const unsigned char *data, uint32_t size)
+{
+    const unsigned char *datap3 = data + 3;
+    const unsigned char *end    = data + size;
+
+    // loop logic is based on FFmpeg's avpriv_find_start_code in libavcodec/utils.c
+    while (datap3 <= end) {
+        if (datap3[-1] > 1)
+            datap3 += 3;
+        else if (datap3[-2])
+            datap3 += 2;
+        else if (datap3[-3] | (datap3[-1] - 1))
+            datap3++;
+        else
+            break;
+    }
+    if (datap3 <= end)
+        return (uint32_t)(datap3 - data) - 3;
+    else
+        return ESSENCE_PARSER_NULL_OFFSET;
+}
+
+const char* bmx::get_start_code_prefix_impl_name()
+{
+    return get_selected_start_code_prefix_impl().name;
+}
+
+size_t bmx::get_num_start_code_prefix_impls()
+{
+    return get_start_code_prefix_impls().size();
+}
+
+FindStartCodePrefixFunc bmx::get_start_code_prefix_impl(size_t index, const char **name)
+{
+    BMX_CHECK(index < get_start_code_prefix_impls().size());
+
+    if (name)
+        *name = get_start_code_prefix_impls()[index].name;
+    return get_start_code_prefix_impls()[index].func;
+}
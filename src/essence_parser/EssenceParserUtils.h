@@ -63,6 +63,18 @@ private:
 
 uint32_t get_bits(const unsigned char *data, uint32_t data_size, uint32_t bit_offset, uint8_t num_bits);
 
+// Returns the offset of the first 0x000001 start code prefix that lies entirely within data[0..size),
+// or ESSENCE_PARSER_NULL_OFFSET if there is none. The SSE2 or AVX2 implementation is selected at runtime
+// when available, otherwise the scalar implementation is used
+uint32_t find_start_code_prefix(const unsigned char *data, uint32_t size);
+uint32_t find_start_code_prefix_scalar(const unsigned char *data, uint32_t size);
+const char* get_start_code_prefix_impl_name();
+
+// The implementations supported by this CPU, including the scalar implementation, for testing
+typedef uint32_t (*FindStartCodePrefixFunc)(const unsigned char *data, uint32_t size);
+size_t get_num_start_code_prefix_impls();
+FindStartCodePrefixFunc get_start_code_prefix_impl(size_t index, const char **name);
+
 
 
 };
@@ -47,6 +47,53 @@ using namespace std;
 using namespace bmx;
 
 
+static int read_file(const string &filepath, ByteArray *buffer)
+{
+    buffer->SetSize(0);
+
+    FILE *file = fopen(filepath.c_str(), "rb");
+    if (!file)
+        return errno;
+
+    int64_t file_size;
+    try {
+        file_size = get_file_size(file);
+    } catch (const BMXIOException &ex) {
+        fclose(file);
+        return ex.GetErrno();
+    }
+    if (file_size > UINT32_MAX) {
+        fclose(file);
+        return EFBIG;
+    }
+
+    buffer->Allocate((uint32_t)file_size);
+
+    int err = 0;
+    int64_t rem_read = file_size;
+    while (rem_read > 0) {
+        size_t next_read = 8192;
+        if ((int64_t)next_read > rem_read)
+            next_read = (size_t)rem_read;
+
+        size_t num_read = fread(buffer->GetBytesAvailable(), 1, next_read, file);
+        if (num_read != next_read && ferror(file) != 0)
+            err = errno;
+
+        buffer->IncrementSize((uint32_t)num_read);
+        rem_read -= num_read;
+
+        if (num_read != next_read)
+            break;
+    }
+
+    fclose(file);
+
+    return err;
+}
+
+
+
 FilePatternEssenceSource::FilePatternEssenceSource(bool fill_gaps)
 : EssenceSource()
 {
@@ -55,11 +102,25 @@ FilePatternEssenceSource::FilePatternEssenceSource(bool fill_gaps)
     mCurrentOffset = 0;
     mErrno = 0;
     mCurrentNumber = 0;
+    mCurrentFileNumber = 0;
+    mFileBuffer = new ByteArray();
     mFileBufferOffset = 0;
+    mPrefetchCount = 0;
+    mStopPrefetch = false;
 }
 
 FilePatternEssenceSource::~FilePatternEssenceSource()
 {
+    StopPrefetch();
+
+    delete mFileBuffer;
+}
+
+void FilePatternEssenceSource::SetPrefetch(uint32_t num_files)
+{
+    BMX_CHECK(mPrefetchThreads.empty());
+
+    mPrefetchCount = num_files;
 }
 
 bool FilePatternEssenceSource::Open(const string &pattern, int64_t start_offset)
@@ -99,6 +160,9 @@ bool FilePatternEssenceSource::Open(const string &pattern, int64_t start_offset)
         throw BMXException("No files found for patterns");
     }
 
+    if (mPrefetchCount > 0)
+        StartPrefetch();
+
     return SeekStart();
 }
 
@@ -114,12 +178,13 @@ bool FilePatternEssenceSource::SeekStart()
 
     mNextFilenamesIter = mFilenames.begin();
     mCurrentNumber = mNextFilenamesIter->first;
+    mCurrentFileNumber = mNextFilenamesIter->first;
     mCurrentFilename = mNextFilenamesIter->second;
 
     mNextFilenamesIter++;
 
     mCurrentOffset = 0;
-    mFileBuffer.Clear();
+    mFileBuffer->SetSize(0);
     mFileBufferOffset = 0;
 
     return Skip(mStartOffset - mCurrentOffset);
@@ -130,6 +195,20 @@ bool FilePatternEssenceSource::Skip(int64_t offset)
     return ReadOrSkip(0, 0, offset) == offset;
 }
 
+uint32_t FilePatternEssenceSource::GetNextUnitSize()
+{
+    // Each file is a unit. Return the remaining size of the current file or the size of the next file
+    if (mFilenames.empty())
+        return 0;
+
+    if (mFileBuffer->GetSize() > 0 && mFileBufferOffset >= mFileBuffer->GetSize() && !NextFile())
+        return 0;
+    if (mFileBuffer->GetSize() == 0 && !BufferFile())
+        return 0;
+
+    return mFileBuffer->GetSize() - mFileBufferOffset;
+}
+
 int64_t FilePatternEssenceSource::ReadOrSkip(unsigned char *data, uint32_t size, int64_t skip_offset)
 {
     if (mFilenames.empty() || (data == 0 && skip_offset <= 0))
@@ -138,7 +217,7 @@ int64_t FilePatternEssenceSource::ReadOrSkip(unsigned char *data, uint32_t size,
     bool do_read = (data != 0);
     int64_t rem_size = do_read ? size : skip_offset;
     while (rem_size > 0) {
-        if (mFileBuffer.GetSize() == 0) {
+        if (mFileBuffer->GetSize() == 0) {
             // Buffer or skip the current file
             bool buffer_file = true;
             if (!do_read) {
@@ -164,21 +243,21 @@ int64_t FilePatternEssenceSource::ReadOrSkip(unsigned char *data, uint32_t size,
                 }
             }
 
-            if (buffer_file && (!BufferFile() || mFileBuffer.GetSize() == 0))
+            if (buffer_file && (!BufferFile() || mFileBuffer->GetSize() == 0))
                 break;
-        } else if (mFileBufferOffset < mFileBuffer.GetSize()) {
+        } else if (mFileBufferOffset < mFileBuffer->GetSize()) {
             // Copy or skip from the file buffer
-            uint32_t copy_size = mFileBuffer.GetSize() - mFileBufferOffset;
+            uint32_t copy_size = mFileBuffer->GetSize() - mFileBufferOffset;
             if (copy_size > rem_size)
                 copy_size = (uint32_t)rem_size;
 
             if (do_read)
-                memcpy(&data[size - rem_size], &mFileBuffer.GetBytes()[mFileBufferOffset], copy_size);
+                memcpy(&data[size - rem_size], &mFileBuffer->GetBytes()[mFileBufferOffset], copy_size);
 
             mFileBufferOffset += copy_size;
             mCurrentOffset += copy_size;
             rem_size -= copy_size;
-        } else {  // mFileBufferOffset >= mFileBuffer.GetSize()
+        } else {  // mFileBufferOffset >= mFileBuffer->GetSize()
             // At the end of the current file; move to the start of the next file
             if (!NextFile())
                 break;
@@ -207,8 +286,9 @@ bool FilePatternEssenceSource::NextFile()
         mCurrentNumber = mNextFilenamesIter->first;
 
     if (mCurrentNumber >= mNextFilenamesIter->first) {
+        mCurrentFileNumber = mNextFilenamesIter->first;
         mCurrentFilename = mNextFilenamesIter->second;
-        mFileBuffer.Clear();
+        mFileBuffer->SetSize(0);
 
         mNextFilenamesIter++;
     }
@@ -219,45 +299,158 @@ bool FilePatternEssenceSource::NextFile()
 
 bool FilePatternEssenceSource::BufferFile()
 {
-    mFileBuffer.Clear();
+    mFileBuffer->SetSize(0);
     mFileBufferOffset = 0;
 
-    string filepath = GetCurrentFilePath();
-    FILE *file = fopen(filepath.c_str(), "rb");
-    if (!file) {
-        mErrno = errno;
-        return false;
+    if (mPrefetchCount > 0)
+        return TakePrefetchedFile();
+
+    int err = read_file(GetCurrentFilePath(), mFileBuffer);
+    if (err)
+        mErrno = err;
+
+    return mErrno == 0;
+}
+
+bool FilePatternEssenceSource::TakePrefetchedFile()
+{
+    unique_lock<mutex> lock(mPrefetchMutex);
+
+    // Drop files that were skipped over
+    while (!mPrefetchFiles.empty() && mPrefetchFiles.front()->number < mCurrentFileNumber)
+        RecyclePrefetchFile(lock);
+
+    // Restart prefetching from the current file if it is not next in the queue, e.g. after a seek to the start
+    if (mPrefetchFiles.empty() || mPrefetchFiles.front()->number != mCurrentFileNumber) {
+        while (!mPrefetchFiles.empty())
+            RecyclePrefetchFile(lock);
+        mPrefetchFilenamesIter = mFilenames.find(mCurrentFileNumber);
+        BMX_ASSERT(mPrefetchFilenamesIter != mFilenames.end());
+        QueuePrefetch();
     }
 
-    int64_t file_size;
-    try {
-        file_size = get_file_size(file);
-    } catch (const BMXIOException &ex) {
-        mErrno = ex.GetErrno();
-        return false;
+    PrefetchFile *file = mPrefetchFiles.front();
+    mPrefetchDoneCond.wait(lock, [file] { return file->done; });
+    mPrefetchFiles.pop_front();
+
+    // Swap the prefetched buffer with the current file buffer, which is recycled
+    mFreeBuffers.push_back(mFileBuffer);
+    mFileBuffer = file->buffer;
+    int err = file->err;
+    delete file;
+
+    QueuePrefetch();
+
+    if (err)
+        mErrno = err;
+
+    return mErrno == 0;
+}
+
+void FilePatternEssenceSource::StartPrefetch()
+{
+    mStopPrefetch = false;
+    mPrefetchFilenamesIter = mFilenames.end();
+
+    uint32_t i;
+    for (i = 0; i < mPrefetchCount; i++)
+        mPrefetchThreads.push_back(thread(&FilePatternEssenceSource::PrefetchWorker, this));
+}
+
+void FilePatternEssenceSource::StopPrefetch()
+{
+    {
+        lock_guard<mutex> guard(mPrefetchMutex);
+        mStopPrefetch = true;
     }
+    mPrefetchQueuedCond.notify_all();
 
-    BMX_CHECK(file_size <= UINT32_MAX);
-    mFileBuffer.Allocate((uint32_t)file_size);
+    size_t i;
+    for (i = 0; i < mPrefetchThreads.size(); i++)
+        mPrefetchThreads[i].join();
+    mPrefetchThreads.clear();
 
-    int64_t rem_read = file_size;
-    while (rem_read > 0) {
-        size_t next_read = 8192;
-        if ((int64_t)next_read > rem_read)
-            next_read = (size_t)rem_read;
+    for (i = 0; i < mPrefetchFiles.size(); i++) {
+        delete mPrefetchFiles[i]->buffer;
+        delete mPrefetchFiles[i];
+    }
+    mPrefetchFiles.clear();
 
-        size_t num_read = fread(mFileBuffer.GetBytesAvailable(), 1, next_read, file);
-        if (num_read != next_read && ferror(file) != 0)
-            mErrno = errno;
+    for (i = 0; i < mFreeBuffers.size(); i++)
+        delete mFreeBuffers[i];
+    mFreeBuffers.clear();
+}
 
-        mFileBuffer.IncrementSize((uint32_t)num_read);
-        rem_read -= num_read;
+void FilePatternEssenceSource::QueuePrefetch()
+{
+    // Called with mPrefetchMutex locked
+    bool queued = false;
+    while (mPrefetchFiles.size() < mPrefetchCount && mPrefetchFilenamesIter != mFilenames.end()) {
+        PrefetchFile *file = new PrefetchFile;
+        file->number = mPrefetchFilenamesIter->first;
+        file->filepath = mDirname + "/" + mPrefetchFilenamesIter->second;
+        if (mFreeBuffers.empty()) {
+            file->buffer = new ByteArray();
+        } else {
+            file->buffer = mFreeBuffers.back();
+            mFreeBuffers.pop_back();
+        }
+        file->claimed = false;
+        file->done = false;
+        file->err = 0;
+        mPrefetchFiles.push_back(file);
 
-        if (num_read != next_read)
-            break;
+        mPrefetchFilenamesIter++;
+        queued = true;
     }
 
-    fclose(file);
+    if (queued)
+        mPrefetchQueuedCond.notify_all();
+}
 
-    return mErrno == 0;
+void FilePatternEssenceSource::RecyclePrefetchFile(unique_lock<mutex> &lock)
+{
+    // Remove the file at the front of the queue, waiting for a worker that is reading it
+    PrefetchFile *file = mPrefetchFiles.front();
+    if (file->claimed)
+        mPrefetchDoneCond.wait(lock, [file] { return file->done; });
+    mPrefetchFiles.pop_front();
+
+    mFreeBuffers.push_back(file->buffer);
+    delete file;
+}
+
+void FilePatternEssenceSource::PrefetchWorker()
+{
+    unique_lock<mutex> lock(mPrefetchMutex);
+    while (true) {
+        PrefetchFile *file = 0;
+        mPrefetchQueuedCond.wait(lock, [this, &file] {
+            size_t i;
+            for (i = 0; i < mPrefetchFiles.size(); i++) {
+                if (!mPrefetchFiles[i]->claimed) {
+                    file = mPrefetchFiles[i];
+                    break;
+                }
+            }
+            return mStopPrefetch || file;
+        });
+        if (mStopPrefetch)
+            break;
+
+        file->claimed = true;
+        lock.unlock();
+
+        int err;
+        try {
+            err = read_file(file->filepath, file->buffer);
+        } catch (...) {
+            err = ENOMEM;
+        }
+
+        lock.lock();
+        file->err = err;
+        file->done = true;
+        mPrefetchDoneCond.notify_all();
+    }
 }
@@ -43,6 +43,7 @@
 
 #include <bmx/essence_parser/AVCEssenceParser.h> // for AVCGetBitBuffer
 #include <bmx/essence_parser/HEVCEssenceParser.h>
+#include "EssenceParserUtils.h"
 #include <bmx/mxf_helper/AVCIMXFDescriptorHelper.h>
 #include <bmx/BitBuffer.h>
 #include <bmx/Utils.h>
@@ -148,35 +149,38 @@ uint32_t HEVCEssenceParser::ParseFrameSize(const unsigned char *data, uint32_t d
     }
 
     // we want at least 5 bytes of space
-    while (!have_frame_end && mOffset < data_size - 5) {
-        if (data[mOffset] == 0x00 && data[mOffset+1] == 0x00 && data[mOffset+2] == 0x01) {
+    while (!have_frame_end && mOffset + 5 < data_size) {
+        // skip to the next start code prefix that is followed by the 2 byte nal header and 1 more byte
+        uint32_t prefix_offset = find_start_code_prefix(&data[mOffset], data_size - mOffset - 3);
+        if (prefix_offset == ESSENCE_PARSER_NULL_OFFSET) {
+            mOffset = data_size - 5;
+            break;
+        }
+        mOffset += prefix_offset;
 
-            // advance start code
-            mOffset += 3;
+        // advance start code
+        mOffset += 3;
 
-            uint8_t b1 = data[mOffset];
+        uint8_t b1 = data[mOffset];
 
-            // advance nal header
-            mOffset += 2;
+        // advance nal header
+        mOffset += 2;
 
-            uint32_t nal_unit_type = (b1 & 0x7e) >> 1;
-            mLastNalUnitType = mNalUnitType;
-            mNalUnitType = nal_unit_type;
+        uint32_t nal_unit_type = (b1 & 0x7e) >> 1;
+        mLastNalUnitType = mNalUnitType;
+        mNalUnitType = nal_unit_type;
 
-            if (mLastNalUnitType == NAL_TYPE::IDR_W_RADL
-                || mLastNalUnitType == NAL_TYPE::IDR_N_LP)
-            {
-                end_pos = mOffset - 5; // back to before start code and header
+        if (mLastNalUnitType == NAL_TYPE::IDR_W_RADL
+            || mLastNalUnitType == NAL_TYPE::IDR_N_LP)
+        {
+            end_pos = mOffset - 5; // back to before start code and header
 
-                assert(data[end_pos] == 0x00 && data[end_pos+1] == 0x00 && data[end_pos+2] == 0x01);
+            assert(data[end_pos] == 0x00 && data[end_pos+1] == 0x00 && data[end_pos+2] == 0x01);
 
-                // check if we have 00.00.00.01 or 00.00.01
+            // check if we have 00.00.00.01 or 00.00.01
 
-                have_frame_end = true;
-                break;
-            }
-        } else {
-            mOffset++;
+            have_frame_end = true;
+            break;
         }
     }
 
@@ -893,24 +897,11 @@ void HEVCEssenceParser::CheckConformance()
 
 uint32_t HEVCEssenceParser::NextStartCodePrefix(const unsigned char *data, uint32_t size)
 {
-    const unsigned char *datap3 = data + 3;
-    const unsigned char *end    = data + size;
-
-    // loop logic is based on FFmpeg's avpriv_find_start_code in libavcodec/utils.c
-    while (datap3 < end) {
-        if (datap3[-1] > 1)
-            datap3 += 3;
-        else if (datap3[-2])
-            datap3 += 2;
-        else if (datap3[-3] | (datap3[-1] - 1))
-            datap3++;
-        else
-            break;
-    }
-    if (datap3 < end)
-        return (uint32_t)(datap3 - data) - 3;
-    else
+    // the byte following the start code prefix must also be available
+    if (size == 0)
         return ESSENCE_PARSER_NULL_OFFSET;
+
+    return find_start_code_prefix(data, size - 1);
 }
 
 void HEVCEssenceParser::ResetFrameInfo()
@@ -123,7 +123,7 @@ bool HEVCRawEssenceReader::ReadAndParseHEVC()
         BMX_CHECK_M(mMaxSampleSize == 0 || mSampleBuffer.GetSize() - sample_start_offset <= mMaxSampleSize,
                    ("Max raw sample size (%u) exceeded", mMaxSampleSize));
 
-        num_read = ReadBytes(READ_BLOCK_SIZE);
+        num_read = ReadBytes(GetParseReadSize(sample_num_read));
         if (num_read == 0) {
             // read last frame
             sample_size = mEssenceParser->ParseFrameSize(mSampleBuffer.GetBytes() + sample_start_offset, ESSENCE_PARSER_NULL_OFFSET);
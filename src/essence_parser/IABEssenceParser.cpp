@@ -241,9 +241,11 @@ uint32_t IABEssenceParser::ParseFrameSize(const unsigned char *data, uint32_t da
         if (data_size >= mFrameLength) {
             // reset for next frame
             mFrameHeaderParsed = false;
+            mRequiredFrameDataSize = 0;
             return mFrameLength;
         }
 
+        mRequiredFrameDataSize = mFrameLength;
         return ESSENCE_PARSER_NULL_OFFSET;
     }
     catch (const InvalidData& ex)
@@ -105,13 +105,19 @@ uint32_t J2CEssenceParser::ParseFrameSize(const unsigned char *data, uint32_t da
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
+    mRequiredFrameDataSize = 0;
+
     try
     {
         ParseFrameInfo(data, data_size);
         return mFrameSize;
     }
-    catch (const InsufficientBytes&)
+    catch (const InsufficientBytes &ex)
     {
+        // the codestream is parsed from the start in each call. The Psot or TLM tile part lengths
+        // allow skipping to the next marker, so the caller can read up to there before calling again
+        if (ex.required_size < ESSENCE_PARSER_NULL_OFFSET)
+            mRequiredFrameDataSize = (uint32_t)ex.required_size;
         return ESSENCE_PARSER_NULL_OFFSET;
     }
     catch (const InvalidData&)
@@ -146,7 +146,18 @@ uint32_t MPEG2EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t
         return ESSENCE_PARSER_NULL_OFFSET;
 
     while (mOffset < data_size) {
-        mState = (mState << 8) | data[mOffset];
+        if (mOffset > 3) {
+            // skip to the byte following the next start code prefix
+            uint32_t prefix_offset = find_start_code_prefix(&data[mOffset - 3], data_size - mOffset + 2);
+            if (prefix_offset == ESSENCE_PARSER_NULL_OFFSET) {
+                mOffset = data_size;
+                break;
+            }
+            mOffset += prefix_offset;
+            mState = 0x00000100 | data[mOffset];
+        } else {
+            mState = (mState << 8) | data[mOffset];
+        }
         if (mState == SEQUENCE_HEADER_CODE ||
             mState == GROUP_HEADER_CODE ||
             mState == PICTURE_START_CODE)
@@ -142,18 +142,22 @@ uint32_t RDD36EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
+    mRequiredFrameDataSize = 0;
+
     if (data_size < 8)
         return ESSENCE_PARSER_NULL_OFFSET;
 
     RDD36GetBitBuffer buffer(data, data_size);
     uint32_t frame_size = buffer.GetU32(32);
     uint32_t frame_identifier = buffer.GetF32(32);
-    if (frame_identifier != RDD36_FRAME_ID)
+    if (frame_identifier != RDD36_FRAME_ID) {
         return ESSENCE_PARSER_NULL_FRAME_SIZE;
-    else if (data_size < frame_size)
+    } else if (data_size < frame_size) {
+        mRequiredFrameDataSize = frame_size;
         return ESSENCE_PARSER_NULL_OFFSET;
-    else
+    } else {
         return frame_size;
+    }
 }
 
 void RDD36EssenceParser::ParseFrameInfo(const unsigned char *data, uint32_t data_size)
@@ -54,6 +54,7 @@ using namespace bmx;
 
 
 #define READ_BLOCK_SIZE         8192
+#define MAX_READ_BLOCK_SIZE     (4 * 1024 * 1024)
 #define PARSE_FRAME_START_SIZE  8192
 
 RawEssenceReader::RawEssenceReader(EssenceSource *essence_source)
@@ -63,6 +64,7 @@ RawEssenceReader::RawEssenceReader(EssenceSource *essence_source)
     mTotalReadLength = 0;
     mMaxSampleSize = 0;
     mFixedSampleSize = 0;
+    mSampleSizeFromSource = false;
     mEssenceParser = 0;
     mSampleDataSize = 0;
     mNumSamples = 0;
@@ -88,6 +90,11 @@ void RawEssenceReader::SetFixedSampleSize(uint32_t size)
     mFixedSampleSize = size;
 }
 
+void RawEssenceReader::SetSampleSizeFromSource(bool enable)
+{
+    mSampleSizeFromSource = enable;
+}
+
 void RawEssenceReader::SetEssenceParser(EssenceParser *essence_parser)
 {
     delete mEssenceParser;
@@ -112,7 +119,13 @@ uint32_t RawEssenceReader::ReadSamples(uint32_t num_samples)
     mSampleDataSize = 0;
     mNumSamples = 0;
 
-    if (mFixedSampleSize == 0) {
+    if (mFixedSampleSize == 0 && mSampleSizeFromSource) {
+        uint32_t i;
+        for (i = 0; i < num_samples; i++) {
+            if (!ReadSourceSample())
+                break;
+        }
+    } else if (mFixedSampleSize == 0) {
         uint32_t i;
         for (i = 0; i < num_samples; i++) {
             if (!ReadAndParseSample())
@@ -193,7 +206,7 @@ bool RawEssenceReader::ReadAndParseSample()
         BMX_CHECK_M(mMaxSampleSize == 0 || mSampleBuffer.GetSize() - sample_start_offset <= mMaxSampleSize,
                    ("Max raw sample size (%u) exceeded", mMaxSampleSize));
 
-        num_read = ReadBytes(READ_BLOCK_SIZE);
+        num_read = ReadBytes(GetParseReadSize(sample_num_read));
         if (num_read == 0)
             break;
 
@@ -221,6 +234,63 @@ bool RawEssenceReader::ReadAndParseSample()
     return true;
 }
 
+bool RawEssenceReader::ReadSourceSample()
+{
+    // The essence source unit is a sample, e.g. a file in a sequence containing a single frame
+    BMX_ASSERT(mSampleBuffer.GetSize() == mSampleDataSize);
+
+    uint32_t sample_size = mEssenceSource->GetNextUnitSize();
+    if (sample_size == 0) {
+        if (mEssenceSource->HaveError())
+            log_error("Failed to read from raw essence source: %s\n", mEssenceSource->GetStrError().c_str());
+        mLastSampleRead = true;
+        return false;
+    }
+
+    BMX_CHECK_M(mMaxSampleSize == 0 || sample_size <= mMaxSampleSize,
+               ("Max raw sample size (%u) exceeded", mMaxSampleSize));
+
+    uint32_t num_read = ReadBytes(sample_size);
+    if (num_read < sample_size) {
+        // assume the remaining data is a valid sample if the max read length was reached
+        mLastSampleRead = true;
+        if (num_read == 0)
+            return false;
+    }
+
+    mSampleDataSize += num_read;
+    mNumSamples++;
+    return !mLastSampleRead;
+}
+
+uint32_t RawEssenceReader::GetParseReadSize(uint32_t sample_num_read) const
+{
+    // Read up to the size the parser requires if known. Otherwise double the read size as the
+    // sample grows so that large frames only result in a few ParseFrameSize calls. The overshoot
+    // into the next sample is limited to the sample data read so far
+    uint32_t required_size = mEssenceParser->GetRequiredFrameDataSize();
+    if (required_size > sample_num_read)
+        return required_size - sample_num_read;
+    else if (sample_num_read <= READ_BLOCK_SIZE)
+        return READ_BLOCK_SIZE;
+    else if (sample_num_read >= MAX_READ_BLOCK_SIZE)
+        return MAX_READ_BLOCK_SIZE;
+    else
+        return sample_num_read;
+}
+
+void RawEssenceReader::GrowSampleBuffer(uint32_t size)
+{
+    // Grow the buffer exponentially rather than by the alloc block size to avoid repeatedly
+    // reallocating and copying large frames. The buffer is kept and reused for the next samples
+    if (mSampleBuffer.GetSizeAvailable() < size) {
+        uint32_t min_size = mSampleBuffer.GetAllocatedSize();
+        if (min_size < size || min_size > UINT32_MAX - mSampleBuffer.GetSize())
+            min_size = size;
+        mSampleBuffer.Grow(min_size);
+    }
+}
+
 uint32_t RawEssenceReader::ReadBytes(uint32_t size)
 {
     BMX_ASSERT(mMaxReadLength == 0 || mTotalReadLength <= mMaxReadLength);
@@ -231,7 +301,7 @@ uint32_t RawEssenceReader::ReadBytes(uint32_t size)
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    GrowSampleBuffer(actual_size);
     uint32_t num_read = mEssenceSource->Read(mSampleBuffer.GetBytesAvailable(), actual_size);
     if (num_read < actual_size && mEssenceSource->HaveError())
         log_error("Failed to read from raw essence source: %s\n", mEssenceSource->GetStrError().c_str());
@@ -265,7 +335,7 @@ uint32_t RawEssenceReader::AppendBytes(const unsigned char *bytes, uint32_t size
     if (actual_size == 0)
         return 0;
 
-    mSampleBuffer.Grow(actual_size);
+    GrowSampleBuffer(actual_size);
     memcpy(mSampleBuffer.GetBytesAvailable(), bytes, actual_size);
 
     mTotalReadLength += actual_size;
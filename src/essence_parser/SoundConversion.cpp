@@ -33,12 +33,891 @@
 #include "config.h"
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BMX_HAVE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BMX_HAVE_SSSE3
+#define BMX_HAVE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
 #include <cstring>
 
 #include <bmx/essence_parser/SoundConversion.h>
+#include "SoundConversionImpl.h"
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
+using namespace bmx;
+
+
+// The D-10 AES3 data has 8 channels of 4 byte words per sample, preceded by a 4 byte header
+#define AES3_HEADER_SIZE        4
+#define AES3_BLOCK_ALIGN        (8 * 4)
+
+
+typedef enum
+{
+    SCALAR_IMPL,
+    SSE2_IMPL,
+    SSSE3_IMPL,
+    AVX2_IMPL,
+} SoundConversionImplType;
+
+
+static SoundConversionImplType select_impl_type()
+{
+#if defined(BMX_HAVE_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return AVX2_IMPL;
+    if (__builtin_cpu_supports("ssse3"))
+        return SSSE3_IMPL;
+#endif
+#if defined(BMX_HAVE_SSE2)
+    return SSE2_IMPL;
+#else
+    return SCALAR_IMPL;
+#endif
+}
+
+static SoundConversionImplType get_impl_type()
+{
+    static const SoundConversionImplType impl_type = select_impl_type();
+    return impl_type;
+}
+
+
+static void copy_samples(const unsigned char *input_data, uint32_t input_stride,
+                         unsigned char *output_data, uint32_t output_stride,
+                         uint32_t bytes_per_sample, uint32_t sample_count)
+{
+    uint32_t i;
+
+    // constant size copies compile to single loads and stores
+    switch (bytes_per_sample)
+    {
+        case 1:
+            for (i = 0; i < sample_count; i++)
+                output_data[i * output_stride] = input_data[i * input_stride];
+            break;
+        case 2:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_stride], &input_data[i * input_stride], 2);
+            break;
+        case 3:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_stride], &input_data[i * input_stride], 3);
+            break;
+        case 4:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_stride], &input_data[i * input_stride], 4);
+            break;
+        default:
+            for (i = 0; i < sample_count; i++)
+                memcpy(&output_data[i * output_stride], &input_data[i * input_stride], bytes_per_sample);
+            break;
+    }
+}
+
+static void zero_samples(unsigned char *output_data, uint32_t output_stride,
+                         uint32_t bytes_per_sample, uint32_t sample_count)
+{
+    uint32_t i;
+    for (i = 0; i < sample_count; i++)
+        memset(&output_data[i * output_stride], 0, bytes_per_sample);
+}
+
+static void convert_aes3_samples(const unsigned char *aes_data_ptr, uint32_t bytes_per_sample,
+                                 unsigned char *pcm_data_ptr, uint32_t pcm_stride, uint32_t sample_count)
+{
+    uint32_t i;
+
+    if (bytes_per_sample == 2) {
+        for (i = 0; i < sample_count; i++) {
+            pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
+                              (aes_data_ptr[2] << 4);
+            pcm_data_ptr[1] = (aes_data_ptr[2] >> 4) |
+                              (aes_data_ptr[3] << 4);
+            pcm_data_ptr += pcm_stride;
+            aes_data_ptr += AES3_BLOCK_ALIGN;
+        }
+    } else {
+        for (i = 0; i < sample_count; i++) {
+            pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
+                              (aes_data_ptr[1] << 4);
+            pcm_data_ptr[1] = (aes_data_ptr[1] >> 4) |
+                              (aes_data_ptr[2] << 4);
+            pcm_data_ptr[2] = (aes_data_ptr[2] >> 4) |
+                              (aes_data_ptr[3] << 4);
+            pcm_data_ptr += pcm_stride;
+            aes_data_ptr += AES3_BLOCK_ALIGN;
+        }
+    }
+}
+
+static void deinterleave_region(const unsigned char *input_data, uint32_t block_align, uint32_t bytes_per_sample,
+                                uint32_t start_sample, uint32_t end_sample,
+                                uint16_t start_channel, uint16_t end_channel,
+                                unsigned char * const *output_data)
+{
+    uint16_t c;
+    for (c = start_channel; c < end_channel; c++) {
+        if (output_data[c]) {
+            copy_samples(&input_data[start_sample * block_align + c * bytes_per_sample], block_align,
+                         &output_data[c][start_sample * bytes_per_sample], bytes_per_sample,
+                         bytes_per_sample, end_sample - start_sample);
+        }
+    }
+}
+
+static void interleave_region(const unsigned char * const *input_data, uint32_t block_align, uint32_t bytes_per_sample,
+                              uint32_t start_sample, uint32_t end_sample,
+                              uint16_t start_channel, uint16_t end_channel,
+                              unsigned char *output_data)
+{
+    uint16_t c;
+    for (c = start_channel; c < end_channel; c++) {
+        unsigned char *output_ptr = &output_data[start_sample * block_align + c * bytes_per_sample];
+        if (input_data[c]) {
+            copy_samples(&input_data[c][start_sample * bytes_per_sample], bytes_per_sample,
+                         output_ptr, block_align,
+                         bytes_per_sample, end_sample - start_sample);
+        } else {
+            zero_samples(output_ptr, block_align, bytes_per_sample, end_sample - start_sample);
+        }
+    }
+}
+
+
+#if defined(BMX_HAVE_SSE2)
+
+static inline void transpose_16bit_8x8(__m128i *r)
+{
+    __m128i t0 = _mm_unpacklo_epi16(r[0], r[1]);
+    __m128i t1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi16(r[2], r[3]);
+    __m128i t3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i t4 = _mm_unpacklo_epi16(r[4], r[5]);
+    __m128i t5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i t6 = _mm_unpacklo_epi16(r[6], r[7]);
+    __m128i t7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+    __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+    __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+    __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+    __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+    __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+    r[0] = _mm_unpacklo_epi64(u0, u4);
+    r[1] = _mm_unpackhi_epi64(u0, u4);
+    r[2] = _mm_unpacklo_epi64(u1, u5);
+    r[3] = _mm_unpackhi_epi64(u1, u5);
+    r[4] = _mm_unpacklo_epi64(u2, u6);
+    r[5] = _mm_unpackhi_epi64(u2, u6);
+    r[6] = _mm_unpacklo_epi64(u3, u7);
+    r[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+static inline void transpose_32bit_4x4(__m128i *r)
+{
+    __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+    __m128i t1 = _mm_unpackhi_epi32(r[0], r[1]);
+    __m128i t2 = _mm_unpacklo_epi32(r[2], r[3]);
+    __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm_unpacklo_epi64(t0, t2);
+    r[1] = _mm_unpackhi_epi64(t0, t2);
+    r[2] = _mm_unpacklo_epi64(t1, t3);
+    r[3] = _mm_unpackhi_epi64(t1, t3);
+}
+
+static inline void store_12_bytes(unsigned char *data, __m128i value)
+{
+    _mm_storel_epi64((__m128i*)data, value);
+    uint32_t last = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+    memcpy(data + 8, &last, 4);
+}
+
+// The channel group kernels process the samples in [0, sample_count) and channels in
+// [0, channel_count) where the counts are multiples of the kernel's block and group size
+
+static void deinterleave_16bit_sse2(const unsigned char *input_data, uint32_t block_align,
+                                    uint32_t sample_count, uint16_t channel_count,
+                                    unsigned char * const *output_data)
+{
+    __m128i r[8];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 8) {
+        const unsigned char *row = &input_data[i * block_align];
+        for (c = 0; c < channel_count; c += 8) {
+            for (k = 0; k < 8; k++)
+                r[k] = _mm_loadu_si128((const __m128i*)&row[k * block_align + c * 2]);
+            transpose_16bit_8x8(r);
+            for (k = 0; k < 8; k++) {
+                if (output_data[c + k])
+                    _mm_storeu_si128((__m128i*)&output_data[c + k][i * 2], r[k]);
+            }
+        }
+    }
+}
+
+static void deinterleave_16bit_stereo_sse2(const unsigned char *input_data, uint32_t sample_count,
+                                           unsigned char * const *output_data)
+{
+    uint32_t i;
+
+    for (i = 0; i < sample_count; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&input_data[i * 4]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&input_data[i * 4 + 16]);
+        // sign extend so that the saturating pack is exact
+        if (output_data[0]) {
+            __m128i left = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                           _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+            _mm_storeu_si128((__m128i*)&output_data[0][i * 2], left);
+        }
+        if (output_data[1]) {
+            __m128i right = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+            _mm_storeu_si128((__m128i*)&output_data[1][i * 2], right);
+        }
+    }
+}
+
+static void deinterleave_16bit_4ch_sse2(const unsigned char *input_data, uint32_t sample_count,
+                                        unsigned char * const *output_data)
+{
+    __m128i r[8];
+    uint32_t i;
+    int k;
+
+    // each register holds a pair of samples and the transpose results in the even samples
+    // of the channels followed by the odd samples
+    for (i = 0; i < sample_count; i += 16) {
+        for (k = 0; k < 8; k++)
+            r[k] = _mm_loadu_si128((const __m128i*)&input_data[(i + 2 * k) * 8]);
+        transpose_16bit_8x8(r);
+        for (k = 0; k < 4; k++) {
+            if (output_data[k]) {
+                _mm_storeu_si128((__m128i*)&output_data[k][i * 2],      _mm_unpacklo_epi16(r[k], r[k + 4]));
+                _mm_storeu_si128((__m128i*)&output_data[k][i * 2 + 16], _mm_unpackhi_epi16(r[k], r[k + 4]));
+            }
+        }
+    }
+}
+
+static void deinterleave_32bit_sse2(const unsigned char *input_data, uint32_t block_align,
+                                    uint32_t sample_count, uint16_t channel_count,
+                                    unsigned char * const *output_data)
+{
+    __m128i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 4) {
+        const unsigned char *row = &input_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++)
+                r[k] = _mm_loadu_si128((const __m128i*)&row[k * block_align + c * 4]);
+            transpose_32bit_4x4(r);
+            for (k = 0; k < 4; k++) {
+                if (output_data[c + k])
+                    _mm_storeu_si128((__m128i*)&output_data[c + k][i * 4], r[k]);
+            }
+        }
+    }
+}
+
+static void interleave_16bit_sse2(const unsigned char * const *input_data, uint32_t block_align,
+                                  uint32_t sample_count, uint16_t channel_count,
+                                  unsigned char *output_data)
+{
+    __m128i r[8];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 8) {
+        unsigned char *row = &output_data[i * block_align];
+        for (c = 0; c < channel_count; c += 8) {
+            for (k = 0; k < 8; k++) {
+                if (input_data[c + k])
+                    r[k] = _mm_loadu_si128((const __m128i*)&input_data[c + k][i * 2]);
+                else
+                    r[k] = _mm_setzero_si128();
+            }
+            transpose_16bit_8x8(r);
+            for (k = 0; k < 8; k++)
+                _mm_storeu_si128((__m128i*)&row[k * block_align + c * 2], r[k]);
+        }
+    }
+}
+
+static void interleave_16bit_stereo_sse2(const unsigned char * const *input_data, uint32_t sample_count,
+                                         unsigned char *output_data)
+{
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t i;
+
+    for (i = 0; i < sample_count; i += 8) {
+        __m128i left  = (input_data[0] ? _mm_loadu_si128((const __m128i*)&input_data[0][i * 2]) : zero);
+        __m128i right = (input_data[1] ? _mm_loadu_si128((const __m128i*)&input_data[1][i * 2]) : zero);
+        _mm_storeu_si128((__m128i*)&output_data[i * 4],      _mm_unpacklo_epi16(left, right));
+        _mm_storeu_si128((__m128i*)&output_data[i * 4 + 16], _mm_unpackhi_epi16(left, right));
+    }
+}
+
+static void interleave_32bit_sse2(const unsigned char * const *input_data, uint32_t block_align,
+                                  uint32_t sample_count, uint16_t channel_count,
+                                  unsigned char *output_data)
+{
+    __m128i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 4) {
+        unsigned char *row = &output_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++) {
+                if (input_data[c + k])
+                    r[k] = _mm_loadu_si128((const __m128i*)&input_data[c + k][i * 4]);
+                else
+                    r[k] = _mm_setzero_si128();
+            }
+            transpose_32bit_4x4(r);
+            for (k = 0; k < 4; k++)
+                _mm_storeu_si128((__m128i*)&row[k * block_align + c * 4], r[k]);
+        }
+    }
+}
+
+#endif
+
+#if defined(BMX_HAVE_SSSE3)
+
+// 24-bit samples are expanded to 32-bit lanes, transposed and packed again. The 16 byte
+// loads read 4 bytes beyond the samples and so the caller limits the sample count
+
+__attribute__((target("ssse3")))
+static void deinterleave_24bit_ssse3(const unsigned char *input_data, uint32_t block_align,
+                                     uint32_t sample_count, uint16_t channel_count,
+                                     unsigned char * const *output_data)
+{
+    const __m128i expand   = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i compress = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 4) {
+        const unsigned char *row = &input_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++)
+                r[k] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&row[k * block_align + c * 3]), expand);
+            transpose_32bit_4x4(r);
+            for (k = 0; k < 4; k++) {
+                if (output_data[c + k])
+                    store_12_bytes(&output_data[c + k][i * 3], _mm_shuffle_epi8(r[k], compress));
+            }
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+static void interleave_24bit_ssse3(const unsigned char * const *input_data, uint32_t block_align,
+                                   uint32_t sample_count, uint16_t channel_count,
+                                   unsigned char *output_data)
+{
+    const __m128i expand   = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i compress = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 4) {
+        unsigned char *row = &output_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++) {
+                if (input_data[c + k])
+                    r[k] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&input_data[c + k][i * 3]), expand);
+                else
+                    r[k] = _mm_setzero_si128();
+            }
+            transpose_32bit_4x4(r);
+            for (k = 0; k < 4; k++)
+                store_12_bytes(&row[k * block_align + c * 3], _mm_shuffle_epi8(r[k], compress));
+        }
+    }
+}
+
+// The AES3 words hold the sample in bits 4 to 27. Each group of 4 channel words is transposed
+// and the samples are shifted down and packed
+
+__attribute__((target("ssse3")))
+static void convert_aes3_to_pcm_ssse3(const unsigned char *aes_data, uint32_t bytes_per_sample,
+                                      uint32_t sample_count, uint8_t channel_count, uint8_t valid_flags,
+                                      unsigned char * const *pcm_data)
+{
+    const __m128i compress_16 = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i compress_24 = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i r[4];
+    uint32_t i;
+    uint8_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 4) {
+        const unsigned char *row = &aes_data[i * AES3_BLOCK_ALIGN];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++)
+                r[k] = _mm_loadu_si128((const __m128i*)&row[k * AES3_BLOCK_ALIGN + c * 4]);
+            transpose_32bit_4x4(r);
+            for (k = 0; k < 4 && c + k < channel_count; k++) {
+                if (!pcm_data[c + k] || !(valid_flags & (1 << (c + k))))
+                    continue;
+                if (bytes_per_sample == 2) {
+                    _mm_storel_epi64((__m128i*)&pcm_data[c + k][i * 2],
+                                     _mm_shuffle_epi8(_mm_srli_epi32(r[k], 12), compress_16));
+                } else {
+                    store_12_bytes(&pcm_data[c + k][i * 3],
+                                   _mm_shuffle_epi8(_mm_srli_epi32(r[k], 4), compress_24));
+                }
+            }
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+static void convert_aes3_to_8ch_pcm_ssse3(const unsigned char *aes_data, uint32_t bytes_per_sample,
+                                          uint32_t sample_count, uint8_t valid_flags,
+                                          unsigned char *pcm_data)
+{
+    const __m128i compress_16 = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i compress_24 = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i valid_low  = _mm_setr_epi32((valid_flags & 0x01) ? -1 : 0, (valid_flags & 0x02) ? -1 : 0,
+                                              (valid_flags & 0x04) ? -1 : 0, (valid_flags & 0x08) ? -1 : 0);
+    const __m128i valid_high = _mm_setr_epi32((valid_flags & 0x10) ? -1 : 0, (valid_flags & 0x20) ? -1 : 0,
+                                              (valid_flags & 0x40) ? -1 : 0, (valid_flags & 0x80) ? -1 : 0);
+    uint32_t i;
+
+    for (i = 0; i < sample_count; i++) {
+        const unsigned char *row = &aes_data[i * AES3_BLOCK_ALIGN];
+        __m128i low  = _mm_and_si128(_mm_loadu_si128((const __m128i*)row), valid_low);
+        __m128i high = _mm_and_si128(_mm_loadu_si128((const __m128i*)&row[16]), valid_high);
+        if (bytes_per_sample == 2) {
+            low  = _mm_shuffle_epi8(_mm_srli_epi32(low, 12), compress_16);
+            high = _mm_shuffle_epi8(_mm_srli_epi32(high, 12), compress_16);
+            _mm_storeu_si128((__m128i*)&pcm_data[i * 16], _mm_unpacklo_epi64(low, high));
+        } else {
+            store_12_bytes(&pcm_data[i * 24],      _mm_shuffle_epi8(_mm_srli_epi32(low, 4), compress_24));
+            store_12_bytes(&pcm_data[i * 24 + 12], _mm_shuffle_epi8(_mm_srli_epi32(high, 4), compress_24));
+        }
+    }
+}
+
+#endif
+
+#if defined(BMX_HAVE_AVX2)
+
+// The AVX2 kernels use the SSE2 transposes within each 128-bit lane, with the low lane holding
+// the first half of the samples and the high lane the second half
+
+__attribute__((target("avx2")))
+static inline __m256i load_2x128(const unsigned char *low, const unsigned char *high)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)low)),
+                                   _mm_loadu_si128((const __m128i*)high), 1);
+}
+
+__attribute__((target("avx2")))
+static inline void transpose_16bit_8x8_avx2(__m256i *r)
+{
+    __m256i t0 = _mm256_unpacklo_epi16(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi16(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi16(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi16(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi16(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi16(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi16(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi16(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi32(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi32(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi32(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi32(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi32(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi32(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi32(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi32(t5, t7);
+    r[0] = _mm256_unpacklo_epi64(u0, u4);
+    r[1] = _mm256_unpackhi_epi64(u0, u4);
+    r[2] = _mm256_unpacklo_epi64(u1, u5);
+    r[3] = _mm256_unpackhi_epi64(u1, u5);
+    r[4] = _mm256_unpacklo_epi64(u2, u6);
+    r[5] = _mm256_unpackhi_epi64(u2, u6);
+    r[6] = _mm256_unpacklo_epi64(u3, u7);
+    r[7] = _mm256_unpackhi_epi64(u3, u7);
+}
+
+__attribute__((target("avx2")))
+static inline void transpose_32bit_4x4_avx2(__m256i *r)
+{
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    r[0] = _mm256_unpacklo_epi64(t0, t2);
+    r[1] = _mm256_unpackhi_epi64(t0, t2);
+    r[2] = _mm256_unpacklo_epi64(t1, t3);
+    r[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+__attribute__((target("avx2")))
+static void deinterleave_16bit_avx2(const unsigned char *input_data, uint32_t block_align,
+                                    uint32_t sample_count, uint16_t channel_count,
+                                    unsigned char * const *output_data)
+{
+    __m256i r[8];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 16) {
+        const unsigned char *row = &input_data[i * block_align];
+        for (c = 0; c < channel_count; c += 8) {
+            for (k = 0; k < 8; k++)
+                r[k] = load_2x128(&row[k * block_align + c * 2], &row[(k + 8) * block_align + c * 2]);
+            transpose_16bit_8x8_avx2(r);
+            for (k = 0; k < 8; k++) {
+                if (output_data[c + k])
+                    _mm256_storeu_si256((__m256i*)&output_data[c + k][i * 2], r[k]);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void deinterleave_32bit_avx2(const unsigned char *input_data, uint32_t block_align,
+                                    uint32_t sample_count, uint16_t channel_count,
+                                    unsigned char * const *output_data)
+{
+    __m256i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 8) {
+        const unsigned char *row = &input_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++)
+                r[k] = load_2x128(&row[k * block_align + c * 4], &row[(k + 4) * block_align + c * 4]);
+            transpose_32bit_4x4_avx2(r);
+            for (k = 0; k < 4; k++) {
+                if (output_data[c + k])
+                    _mm256_storeu_si256((__m256i*)&output_data[c + k][i * 4], r[k]);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void interleave_16bit_avx2(const unsigned char * const *input_data, uint32_t block_align,
+                                  uint32_t sample_count, uint16_t channel_count,
+                                  unsigned char *output_data)
+{
+    __m256i r[8];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 16) {
+        unsigned char *row = &output_data[i * block_align];
+        for (c = 0; c < channel_count; c += 8) {
+            for (k = 0; k < 8; k++) {
+                if (input_data[c + k])
+                    r[k] = _mm256_loadu_si256((const __m256i*)&input_data[c + k][i * 2]);
+                else
+                    r[k] = _mm256_setzero_si256();
+            }
+            transpose_16bit_8x8_avx2(r);
+            for (k = 0; k < 8; k++) {
+                _mm_storeu_si128((__m128i*)&row[k * block_align + c * 2], _mm256_castsi256_si128(r[k]));
+                _mm_storeu_si128((__m128i*)&row[(k + 8) * block_align + c * 2], _mm256_extracti128_si256(r[k], 1));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void interleave_32bit_avx2(const unsigned char * const *input_data, uint32_t block_align,
+                                  uint32_t sample_count, uint16_t channel_count,
+                                  unsigned char *output_data)
+{
+    __m256i r[4];
+    uint32_t i;
+    uint16_t c;
+    int k;
+
+    for (i = 0; i < sample_count; i += 8) {
+        unsigned char *row = &output_data[i * block_align];
+        for (c = 0; c < channel_count; c += 4) {
+            for (k = 0; k < 4; k++) {
+                if (input_data[c + k])
+                    r[k] = _mm256_loadu_si256((const __m256i*)&input_data[c + k][i * 4]);
+                else
+                    r[k] = _mm256_setzero_si256();
+            }
+            transpose_32bit_4x4_avx2(r);
+            for (k = 0; k < 4; k++) {
+                _mm_storeu_si128((__m128i*)&row[k * block_align + c * 4], _mm256_castsi256_si128(r[k]));
+                _mm_storeu_si128((__m128i*)&row[(k + 4) * block_align + c * 4], _mm256_extracti128_si256(r[k], 1));
+            }
+        }
+    }
+}
+
+#endif
+
+
+// Runs the vector kernel that applies and sets the number of samples and channels it has processed
+
+static void deinterleave_vector(SoundConversionImplType impl_type,
+                                const unsigned char *input_data, uint32_t input_data_size,
+                                uint32_t bytes_per_sample, uint16_t channel_count, uint32_t sample_count,
+                                unsigned char * const *output_data,
+                                uint32_t *vector_sample_count, uint16_t *vector_channel_count)
+{
+    uint32_t block_align = channel_count * bytes_per_sample;
+    uint32_t num_samples = 0;
+    uint16_t num_channels = 0;
+
+#if defined(BMX_HAVE_SSE2)
+    if (impl_type == SCALAR_IMPL) {
+        // no vector kernel
+    } else if (bytes_per_sample == 2 && channel_count == 2) {
+        num_channels = 2;
+        num_samples  = sample_count - sample_count % 8;
+        deinterleave_16bit_stereo_sse2(input_data, num_samples, output_data);
+    } else if (bytes_per_sample == 2 && channel_count == 4) {
+        num_channels = 4;
+        num_samples  = sample_count - sample_count % 16;
+        deinterleave_16bit_4ch_sse2(input_data, num_samples, output_data);
+    } else if (bytes_per_sample == 2 && channel_count >= 8) {
+        num_channels = channel_count - channel_count % 8;
+#if defined(BMX_HAVE_AVX2)
+        if (impl_type == AVX2_IMPL) {
+            num_samples = sample_count - sample_count % 16;
+            deinterleave_16bit_avx2(input_data, block_align, num_samples, num_channels, output_data);
+        } else
+#endif
+        {
+            num_samples = sample_count - sample_count % 8;
+            deinterleave_16bit_sse2(input_data, block_align, num_samples, num_channels, output_data);
+        }
+    } else if (bytes_per_sample == 4 && channel_count >= 4) {
+        num_channels = channel_count - channel_count % 4;
+#if defined(BMX_HAVE_AVX2)
+        if (impl_type == AVX2_IMPL) {
+            num_samples = sample_count - sample_count % 8;
+            deinterleave_32bit_avx2(input_data, block_align, num_samples, num_channels, output_data);
+        } else
+#endif
+        {
+            num_samples = sample_count - sample_count % 4;
+            deinterleave_32bit_sse2(input_data, block_align, num_samples, num_channels, output_data);
+        }
+    }
+#if defined(BMX_HAVE_SSSE3)
+    else if (bytes_per_sample == 3 && channel_count >= 4 && impl_type >= SSSE3_IMPL) {
+        num_channels = channel_count - channel_count % 4;
+        num_samples  = (input_data_size >= 4 ? (input_data_size - 4) / block_align : 0);
+        if (num_samples > sample_count)
+            num_samples = sample_count;
+        num_samples -= num_samples % 4;
+        deinterleave_24bit_ssse3(input_data, block_align, num_samples, num_channels, output_data);
+    }
+#endif
+#else
+    (void)impl_type;
+    (void)input_data;
+    (void)input_data_size;
+    (void)sample_count;
+    (void)output_data;
+    (void)block_align;
+#endif
+
+    if (num_samples == 0)
+        num_channels = 0;
+    *vector_sample_count  = num_samples;
+    *vector_channel_count = num_channels;
+}
+
+static void interleave_vector(SoundConversionImplType impl_type,
+                              const unsigned char * const *input_data, uint32_t input_data_size,
+                              uint32_t bytes_per_sample, uint16_t channel_count, uint32_t sample_count,
+                              unsigned char *output_data,
+                              uint32_t *vector_sample_count, uint16_t *vector_channel_count)
+{
+    uint32_t block_align = channel_count * bytes_per_sample;
+    uint32_t num_samples = 0;
+    uint16_t num_channels = 0;
+
+#if defined(BMX_HAVE_SSE2)
+    if (impl_type == SCALAR_IMPL) {
+        // no vector kernel
+    } else if (bytes_per_sample == 2 && channel_count == 2) {
+        num_channels = 2;
+        num_samples  = sample_count - sample_count % 8;
+        interleave_16bit_stereo_sse2(input_data, num_samples, output_data);
+    } else if (bytes_per_sample == 2 && channel_count >= 8) {
+        num_channels = channel_count - channel_count % 8;
+#if defined(BMX_HAVE_AVX2)
+        if (impl_type == AVX2_IMPL) {
+            num_samples = sample_count - sample_count % 16;
+            interleave_16bit_avx2(input_data, block_align, num_samples, num_channels, output_data);
+        } else
+#endif
+        {
+            num_samples = sample_count - sample_count % 8;
+            interleave_16bit_sse2(input_data, block_align, num_samples, num_channels, output_data);
+        }
+    } else if (bytes_per_sample == 4 && channel_count >= 4) {
+        num_channels = channel_count - channel_count % 4;
+#if defined(BMX_HAVE_AVX2)
+        if (impl_type == AVX2_IMPL) {
+            num_samples = sample_count - sample_count % 8;
+            interleave_32bit_avx2(input_data, block_align, num_samples, num_channels, output_data);
+        } else
+#endif
+        {
+            num_samples = sample_count - sample_count % 4;
+            interleave_32bit_sse2(input_data, block_align, num_samples, num_channels, output_data);
+        }
+    }
+#if defined(BMX_HAVE_SSSE3)
+    else if (bytes_per_sample == 3 && channel_count >= 4 && impl_type >= SSSE3_IMPL) {
+        num_channels = channel_count - channel_count % 4;
+        num_samples  = (input_data_size >= 4 ? (input_data_size - 4) / 3 : 0);
+        if (num_samples > sample_count)
+            num_samples = sample_count;
+        num_samples -= num_samples % 4;
+        interleave_24bit_ssse3(input_data, block_align, num_samples, num_channels, output_data);
+    }
+#endif
+#else
+    (void)impl_type;
+    (void)input_data;
+    (void)input_data_size;
+    (void)sample_count;
+    (void)output_data;
+    (void)block_align;
+#endif
+
+    if (num_samples == 0)
+        num_channels = 0;
+    *vector_sample_count  = num_samples;
+    *vector_channel_count = num_channels;
+}
+
+static void deinterleave_channels(SoundConversionImplType impl_type,
+                                  const unsigned char *input_data, uint32_t input_data_size,
+                                  uint32_t bits_per_sample, uint16_t channel_count,
+                                  unsigned char * const *output_data, uint32_t output_data_size)
+{
+    uint32_t bytes_per_sample = (bits_per_sample + 7) / 8;
+    uint32_t block_align = channel_count * bytes_per_sample;
+    BMX_CHECK(block_align > 0);
+    uint32_t sample_count = input_data_size / block_align;
+
+    BMX_CHECK(output_data_size >= sample_count * bytes_per_sample);
+
+    uint32_t vector_sample_count;
+    uint16_t vector_channel_count;
+    deinterleave_vector(impl_type, input_data, input_data_size, bytes_per_sample, channel_count, sample_count,
+                        output_data, &vector_sample_count, &vector_channel_count);
+
+    deinterleave_region(input_data, block_align, bytes_per_sample,
+                        vector_sample_count, sample_count, 0, vector_channel_count,
+                        output_data);
+    deinterleave_region(input_data, block_align, bytes_per_sample,
+                        0, sample_count, vector_channel_count, channel_count,
+                        output_data);
+}
+
+static void interleave_channels(SoundConversionImplType impl_type,
+                                const unsigned char * const *input_data, uint32_t input_data_size,
+                                uint32_t bits_per_sample, uint16_t channel_count,
+                                unsigned char *output_data, uint32_t output_data_size)
+{
+    uint32_t bytes_per_sample = (bits_per_sample + 7) / 8;
+    uint32_t block_align = channel_count * bytes_per_sample;
+    BMX_CHECK(block_align > 0);
+    uint32_t sample_count = input_data_size / bytes_per_sample;
+
+    BMX_CHECK(output_data_size >= sample_count * block_align);
+
+    uint32_t vector_sample_count;
+    uint16_t vector_channel_count;
+    interleave_vector(impl_type, input_data, input_data_size, bytes_per_sample, channel_count, sample_count,
+                      output_data, &vector_sample_count, &vector_channel_count);
+
+    interleave_region(input_data, block_align, bytes_per_sample,
+                      vector_sample_count, sample_count, 0, vector_channel_count,
+                      output_data);
+    interleave_region(input_data, block_align, bytes_per_sample,
+                      0, sample_count, vector_channel_count, channel_count,
+                      output_data);
+}
+
+static uint32_t convert_aes3_channels(SoundConversionImplType impl_type,
+                                      const unsigned char *aes3_data, uint32_t aes3_data_size,
+                                      bool ignore_valid_flags, uint32_t bits_per_sample, uint8_t channel_count,
+                                      unsigned char * const *pcm_data, uint32_t pcm_data_size)
+{
+    uint16_t sample_count       = get_aes3_sample_count(aes3_data, aes3_data_size);
+    uint8_t valid_flags         = (ignore_valid_flags ? 0xff : get_aes3_channel_valid_flags(aes3_data, aes3_data_size));
+    uint32_t bytes_per_sample   = (bits_per_sample + 7) / 8;
+
+    BMX_CHECK(sample_count <= (aes3_data_size - AES3_HEADER_SIZE) / AES3_BLOCK_ALIGN);
+    BMX_CHECK(bytes_per_sample == 2 || bytes_per_sample == 3); // only 16-bit to 24-bit sample size allowed
+    BMX_CHECK(channel_count <= 8);
+    BMX_CHECK(pcm_data_size >= bytes_per_sample * sample_count);
+
+    const unsigned char *aes_data = &aes3_data[AES3_HEADER_SIZE];
+    uint32_t vector_sample_count = 0;
+#if defined(BMX_HAVE_SSSE3)
+    if (impl_type >= SSSE3_IMPL) {
+        vector_sample_count = sample_count - sample_count % 4;
+        convert_aes3_to_pcm_ssse3(aes_data, bytes_per_sample, vector_sample_count, channel_count, valid_flags,
+                                  pcm_data);
+    }
+#else
+    (void)impl_type;
+#endif
+
+    uint8_t c;
+    for (c = 0; c < channel_count; c++) {
+        if (!pcm_data[c])
+            continue;
+
+        if (!(valid_flags & (1 << c))) {
+            memset(pcm_data[c], 0, sample_count * bytes_per_sample);
+        } else {
+            convert_aes3_samples(&aes_data[vector_sample_count * AES3_BLOCK_ALIGN + c * 4], bytes_per_sample,
+                                 &pcm_data[c][vector_sample_count * bytes_per_sample], bytes_per_sample,
+                                 sample_count - vector_sample_count);
+        }
+    }
+
+    return AES3_HEADER_SIZE + sample_count * AES3_BLOCK_ALIGN;
+}
+
 
 
 uint8_t bmx::get_aes3_channel_valid_flags(const unsigned char *aes3_data, uint32_t aes3_data_size)
@@ -71,37 +950,19 @@ uint32_t bmx::convert_aes3_to_pcm(const unsigned char *aes3_data, uint32_t aes3_
         return 4 + sample_count * 4 * 8;
     }
 
-    const unsigned char *aes_data_ptr = &aes3_data[4];
-    unsigned char *pcm_data_ptr = &pcm_data[0];
-    uint16_t sample_num;
-
-    if (block_align == 2) {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            aes_data_ptr += channel_num * 4;
-            pcm_data_ptr[0] = (aes_data_ptr[1] >> 4) |
-                              (aes_data_ptr[2] << 4);
-            pcm_data_ptr[1] = (aes_data_ptr[2] >> 4) |
-                              (aes_data_ptr[3] << 4);
-            pcm_data_ptr += 2;
-            aes_data_ptr += (8 - channel_num) * 4;
-        }
-    } else {
-        for (sample_num = 0; sample_num < sample_count; sample_num++) {
-            aes_data_ptr += channel_num * 4;
-            pcm_data_ptr[0] = (aes_data_ptr[0] >> 4) |
-                              (aes_data_ptr[1] << 4);
-            pcm_data_ptr[1] = (aes_data_ptr[1] >> 4) |
-                              (aes_data_ptr[2] << 4);
-            pcm_data_ptr[2] = (aes_data_ptr[2] >> 4) |
-                              (aes_data_ptr[3] << 4);
-            pcm_data_ptr += 3;
-            aes_data_ptr += (8 - channel_num) * 4;
-        }
-    }
+    convert_aes3_samples(&aes3_data[4 + channel_num * 4], block_align, pcm_data, block_align, sample_count);
 
     return 4 + sample_count * 4 * 8;
 }
 
+uint32_t bmx::convert_aes3_to_pcm_channels(const unsigned char *aes3_data, uint32_t aes3_data_size,
+                                          bool ignore_valid_flags, uint32_t bits_per_sample, uint8_t channel_count,
+                                          unsigned char * const *pcm_data, uint32_t pcm_data_size)
+{
+    return convert_aes3_channels(get_impl_type(), aes3_data, aes3_data_size, ignore_valid_flags,
+                                 bits_per_sample, channel_count, pcm_data, pcm_data_size);
+}
+
 uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t aes3_data_size, bool ignore_valid_flags,
                                     uint32_t bits_per_sample, uint8_t channel_count,
                                     unsigned char *pcm_data, uint32_t pcm_data_size)
@@ -115,6 +976,14 @@ uint32_t bmx::convert_aes3_to_mc_pcm(const unsigned char *aes3_data, uint32_t ae
     BMX_CHECK(channel_count <= 8);
     BMX_CHECK(pcm_data_size >= channel_count * bytes_per_sample * sample_count);
 
+#if defined(BMX_HAVE_SSSE3)
+    // all 8 channels map directly to the interleaved output
+    if (channel_count == 8 && get_impl_type() >= SSSE3_IMPL) {
+        convert_aes3_to_8ch_pcm_ssse3(&aes3_data[4], bytes_per_sample, sample_count, valid_flags, pcm_data);
+        return 4 + sample_count * 4 * 8;
+    }
+#endif
+
     const unsigned char *aes_data_ptr = &aes3_data[4];
     unsigned char *pcm_data_ptr = &pcm_data[0];
     uint16_t sample_num, channel_num;
@@ -169,14 +1038,20 @@ void bmx::deinterleave_audio(const unsigned char *input_data, uint32_t input_dat
     uint32_t output_block_align = (bits_per_sample + 7) / 8;
     uint32_t channel_offset = channel_num * output_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
-        for (j = 0; j < output_block_align; j++)
-            output_data[i * output_block_align + j] = input_data[i * input_block_align + channel_offset + j];
-    }
+    copy_samples(&input_data[channel_offset], input_block_align,
+                 output_data, output_block_align,
+                 output_block_align, sample_count);
+}
+
+void bmx::deinterleave_audio_channels(const unsigned char *input_data, uint32_t input_data_size,
+                                     uint32_t bits_per_sample, uint16_t channel_count,
+                                     unsigned char * const *output_data, uint32_t output_data_size)
+{
+    deinterleave_channels(get_impl_type(), input_data, input_data_size, bits_per_sample, channel_count,
+                          output_data, output_data_size);
 }
 
 void bmx::interleave_audio(const unsigned char *input_data, uint32_t input_data_size,
@@ -187,12 +1062,61 @@ void bmx::interleave_audio(const unsigned char *input_data, uint32_t input_data_
     uint32_t output_block_align = channel_count * input_block_align;
     uint32_t channel_offset = channel_num * input_block_align;
     uint32_t sample_count = input_data_size / input_block_align;
-    uint32_t i, j;
 
     BMX_CHECK(output_data_size >= sample_count * output_block_align);
 
-    for (i = 0; i < sample_count; i++) {
-        for (j = 0; j < input_block_align; j++)
-            output_data[i * output_block_align + channel_offset + j] = input_data[i * input_block_align + j];
+    copy_samples(input_data, input_block_align,
+                 &output_data[channel_offset], output_block_align,
+                 input_block_align, sample_count);
+}
+
+void bmx::interleave_audio_channels(const unsigned char * const *input_data, uint32_t input_data_size,
+                                   uint32_t bits_per_sample, uint16_t channel_count,
+                                   unsigned char *output_data, uint32_t output_data_size)
+{
+    interleave_channels(get_impl_type(), input_data, input_data_size, bits_per_sample, channel_count,
+                        output_data, output_data_size);
+}
+
+
+void bmx::deinterleave_audio_channels_scalar(const unsigned char *input_data, uint32_t input_data_size,
+                                            uint32_t bits_per_sample, uint16_t channel_count,
+                                            unsigned char * const *output_data, uint32_t output_data_size)
+{
+    deinterleave_channels(SCALAR_IMPL, input_data, input_data_size, bits_per_sample, channel_count,
+                          output_data, output_data_size);
+}
+
+void bmx::interleave_audio_channels_scalar(const unsigned char * const *input_data, uint32_t input_data_size,
+                                          uint32_t bits_per_sample, uint16_t channel_count,
+                                          unsigned char *output_data, uint32_t output_data_size)
+{
+    interleave_channels(SCALAR_IMPL, input_data, input_data_size, bits_per_sample, channel_count,
+                        output_data, output_data_size);
+}
+
+uint32_t bmx::convert_aes3_to_pcm_channels_scalar(const unsigned char *aes3_data, uint32_t aes3_data_size,
+                                                 bool ignore_valid_flags, uint32_t bits_per_sample,
+                                                 uint8_t channel_count,
+                                                 unsigned char * const *pcm_data, uint32_t pcm_data_size)
+{
+    return convert_aes3_channels(SCALAR_IMPL, aes3_data, aes3_data_size, ignore_valid_flags,
+                                 bits_per_sample, channel_count, pcm_data, pcm_data_size);
+}
+
+const char* bmx::get_sound_conversion_impl_name()
+{
+    switch (get_impl_type())
+    {
+        case AVX2_IMPL:
+            return "avx2";
+        case SSSE3_IMPL:
+            return "ssse3";
+        case SSE2_IMPL:
+            return "sse2";
+        case SCALAR_IMPL:
+            break;
     }
+
+    return "scalar";
 }
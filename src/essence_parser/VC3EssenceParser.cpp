@@ -141,6 +141,8 @@ uint32_t VC3EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t da
 {
     BMX_CHECK(data_size != ESSENCE_PARSER_NULL_OFFSET);
 
+    mRequiredFrameDataSize = 0;
+
     if (data_size < VC3_PARSER_MIN_DATA_SIZE)
         return ESSENCE_PARSER_NULL_OFFSET;
 
@@ -155,10 +157,12 @@ uint32_t VC3EssenceParser::ParseFrameSize(const unsigned char *data, uint32_t da
     for (i = 0; i < BMX_ARRAY_SIZE(COMPRESSION_PARAMETERS); i++)
     {
         if (compression_id == COMPRESSION_PARAMETERS[i].compression_id) {
-            if (data_size >= COMPRESSION_PARAMETERS[i].frame_size)
+            if (data_size >= COMPRESSION_PARAMETERS[i].frame_size) {
                 return COMPRESSION_PARAMETERS[i].frame_size;
-            else
+            } else {
+                mRequiredFrameDataSize = COMPRESSION_PARAMETERS[i].frame_size;
                 return ESSENCE_PARSER_NULL_OFFSET;
+            }
         }
     }
 
@@ -33,6 +33,8 @@
 #include "config.h"
 #endif
 
+#include <cstring>
+
 #include <bmx/frame/Frame.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -76,30 +78,13 @@ Frame::Frame()
 
 Frame::Frame(const Frame &from)
 {
-    edit_rate           = from.edit_rate;
-    position            = from.position;
-    track_edit_rate     = from.track_edit_rate;
-    track_position      = from.track_position;
-    ec_position         = from.ec_position;
-    request_num_samples = from.request_num_samples;
-    first_sample_offset = from.first_sample_offset;
-    num_samples         = from.num_samples;
-    temporal_reordering = from.temporal_reordering;
-    temporal_offset     = from.temporal_offset;
-    key_frame_offset    = from.key_frame_offset;
-    flags               = from.flags;
-    cp_file_position    = from.cp_file_position;
-    file_position       = from.file_position;
-    kl_size             = from.kl_size;
-    file_id             = from.file_id;
-    element_key         = from.element_key;
+    CopyProperties(from);
 
     map<string, vector<FrameMetadata*> >::const_iterator iter;
     for (iter = from.mMetadata.begin(); iter != from.mMetadata.end(); iter++) {
-        mMetadata[iter->first] = vector<FrameMetadata*>();
         size_t i;
         for (i = 0; i < iter->second.size(); i++)
-            mMetadata[iter->first].push_back(iter->second[i]->Clone());
+            InsertMetadata(iter->second[i]->Clone());
     }
 }
 
@@ -116,7 +101,7 @@ Frame::~Frame()
 const vector<FrameMetadata*>* Frame::GetMetadata(std::string id) const
 {
     map<string, vector<FrameMetadata*> >::const_iterator result = mMetadata.find(id);
-    if (result == mMetadata.end())
+    if (result == mMetadata.end() || result->second.empty())
         return 0;
 
     return &result->second;
@@ -127,6 +112,36 @@ void Frame::InsertMetadata(FrameMetadata *metadata)
     mMetadata[metadata->GetId()].push_back(metadata);
 }
 
+void Frame::CopyProperties(const Frame &from)
+{
+    edit_rate           = from.edit_rate;
+    position            = from.position;
+    track_edit_rate     = from.track_edit_rate;
+    track_position      = from.track_position;
+    ec_position         = from.ec_position;
+    request_num_samples = from.request_num_samples;
+    first_sample_offset = from.first_sample_offset;
+    num_samples         = from.num_samples;
+    temporal_reordering = from.temporal_reordering;
+    temporal_offset     = from.temporal_offset;
+    key_frame_offset    = from.key_frame_offset;
+    flags               = from.flags;
+    cp_file_position    = from.cp_file_position;
+    file_position       = from.file_position;
+    kl_size             = from.kl_size;
+    file_id             = from.file_id;
+    element_key         = from.element_key;
+}
+
+void Frame::ReferenceData(const unsigned char *data, uint32_t size, MXFFileDataRef *ref)
+{
+    Grow(size);
+    memcpy(GetBytesAvailable(), data, size);
+    IncrementSize(size);
+
+    mxf_file_release_ref(&ref);
+}
+
 
 
 DefaultFrame::DefaultFrame()
@@ -34,6 +34,7 @@
 #endif
 
 #include <bmx/frame/FrameBuffer.h>
+#include <bmx/frame/PooledFrame.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
 
@@ -46,7 +47,8 @@ using namespace bmx;
 
 DefaultFrameBuffer::DefaultFrameBuffer()
 {
-    mFrameFactory = new DefaultFrameFactory();
+    // frames are recycled so that reading a frame per edit unit does not allocate in the steady state
+    mFrameFactory = new PooledFrameFactory();
     mOwnFrameFactory = true;
     mStartReadIndex = NULL_READ_START_INDEX;
 }
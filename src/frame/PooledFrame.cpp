@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <new>
+
+#include <bmx/frame/PooledFrame.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+// the PooledFrame follows the storage in a block and is aligned for any type
+#define FRAME_OFFSET    ((sizeof(PooledFrameStorage) + 15) / 16 * 16)
+
+
+
+PooledFrameStorage::PooledFrameStorage(PooledFramePool *pool_)
+{
+    pool = pool_;
+}
+
+
+
+PooledFramePool::PooledFramePool(size_t max_free_frames)
+{
+    mRefCount = 1;
+    mMaxFreeFrames = max_free_frames;
+    mFreeBlocks.reserve(max_free_frames);
+    mNumFrameAllocs = 0;
+}
+
+PooledFramePool::~PooledFramePool()
+{
+    size_t i;
+    for (i = 0; i < mFreeBlocks.size(); i++) {
+        ((PooledFrameStorage*)mFreeBlocks[i])->~PooledFrameStorage();
+        delete [] mFreeBlocks[i];
+    }
+}
+
+void PooledFramePool::Retain()
+{
+    lock_guard<mutex> lock(mMutex);
+    mRefCount++;
+}
+
+void PooledFramePool::Release()
+{
+    bool last_ref;
+    {
+        lock_guard<mutex> lock(mMutex);
+        BMX_ASSERT(mRefCount > 0);
+        mRefCount--;
+        last_ref = (mRefCount == 0);
+    }
+
+    if (last_ref)
+        delete this;
+}
+
+void* PooledFramePool::AllocateFrame(size_t size)
+{
+    BMX_ASSERT(size == sizeof(PooledFrame));
+
+    unsigned char *block = 0;
+    {
+        lock_guard<mutex> lock(mMutex);
+        mRefCount++;
+        if (!mFreeBlocks.empty()) {
+            block = mFreeBlocks.back();
+            mFreeBlocks.pop_back();
+        } else {
+            mNumFrameAllocs++;
+        }
+    }
+
+    if (!block) {
+        try
+        {
+            block = new unsigned char[FRAME_OFFSET + size];
+            new (block) PooledFrameStorage(this);
+        }
+        catch (...)
+        {
+            delete [] block;
+            Release();
+            throw;
+        }
+    }
+
+    return block + FRAME_OFFSET;
+}
+
+void PooledFramePool::FreeFrame(void *ptr)
+{
+    unsigned char *block = (unsigned char*)ptr - FRAME_OFFSET;
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mFreeBlocks.size() < mMaxFreeFrames) {
+            mFreeBlocks.push_back(block);
+            block = 0;
+        }
+    }
+
+    if (block) {
+        ((PooledFrameStorage*)block)->~PooledFrameStorage();
+        delete [] block;
+    }
+
+    Release();
+}
+
+
+
+void* PooledFrame::operator new(size_t size, PooledFramePool *pool)
+{
+    return pool->AllocateFrame(size);
+}
+
+void PooledFrame::operator delete(void *ptr, PooledFramePool *pool)
+{
+    pool->FreeFrame(ptr);
+}
+
+void PooledFrame::operator delete(void *ptr)
+{
+    if (ptr)
+        GetStorage(ptr)->pool->FreeFrame(ptr);
+}
+
+PooledFrame::PooledFrame()
+: Frame()
+{
+    mStorage = GetStorage(this);
+    mMetadata.swap(mStorage->metadata);
+}
+
+PooledFrame::PooledFrame(const PooledFrame &from)
+: Frame()
+{
+    mStorage = GetStorage(this);
+    mMetadata.swap(mStorage->metadata);
+
+    CopyProperties(from);
+
+    map<string, vector<FrameMetadata*> >::const_iterator iter;
+    for (iter = from.mMetadata.begin(); iter != from.mMetadata.end(); iter++) {
+        size_t i;
+        for (i = 0; i < iter->second.size(); i++)
+            InsertMetadata(iter->second[i]->Clone());
+    }
+
+    if (from.GetSize() > 0)
+        mStorage->data.CopyBytes(from.GetBytes(), from.GetSize());
+}
+
+PooledFrame::~PooledFrame()
+{
+    // delete the metadata but keep the map entries and vector capacity for the next frame
+    map<string, vector<FrameMetadata*> >::iterator iter;
+    for (iter = mMetadata.begin(); iter != mMetadata.end(); iter++) {
+        size_t i;
+        for (i = 0; i < iter->second.size(); i++)
+            delete iter->second[i];
+        iter->second.clear();
+    }
+    mMetadata.swap(mStorage->metadata);
+
+    mStorage->data.SetSize(0);
+}
+
+uint32_t PooledFrame::GetSize() const
+{
+    return mStorage->data.GetSize();
+}
+
+const unsigned char* PooledFrame::GetBytes() const
+{
+    return mStorage->data.GetBytes();
+}
+
+void PooledFrame::Grow(uint32_t min_size)
+{
+    mStorage->data.Grow(min_size);
+}
+
+uint32_t PooledFrame::GetSizeAvailable() const
+{
+    return mStorage->data.GetSizeAvailable();
+}
+
+unsigned char* PooledFrame::GetBytesAvailable() const
+{
+    return mStorage->data.GetBytesAvailable();
+}
+
+void PooledFrame::SetSize(uint32_t size)
+{
+    mStorage->data.SetSize(size);
+}
+
+void PooledFrame::IncrementSize(uint32_t inc)
+{
+    mStorage->data.IncrementSize(inc);
+}
+
+Frame* PooledFrame::Clone()
+{
+    return new (mStorage->pool) PooledFrame(*this);
+}
+
+PooledFrameStorage* PooledFrame::GetStorage(void *ptr)
+{
+    return (PooledFrameStorage*)((unsigned char*)ptr - FRAME_OFFSET);
+}
+
+
+
+PooledFrameFactory::PooledFrameFactory(size_t max_free_frames)
+{
+    mPool = new PooledFramePool(max_free_frames);
+}
+
+PooledFrameFactory::~PooledFrameFactory()
+{
+    mPool->Release();
+}
+
+Frame* PooledFrameFactory::CreateFrame()
+{
+    return new (mPool) PooledFrame();
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstring>
+
+#include <bmx/frame/SliceFrame.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define SLAB_SIZE_ALIGNMENT         4096
+#define MAX_FREE_FRAME_BLOCKS       64
+
+
+// frame objects are recycled so that creating and deleting a frame per edit unit does not hit the heap
+static mutex g_free_frame_blocks_mutex;
+static void *g_free_frame_blocks[MAX_FREE_FRAME_BLOCKS];
+static size_t g_num_free_frame_blocks = 0;
+
+
+
+SliceFramePool::SliceFramePool(size_t max_free_slabs)
+{
+    mRefCount = 1;
+    mMaxFreeSlabs = max_free_slabs;
+    mFreeSlabs.reserve(max_free_slabs);
+    mNumSlabAllocs = 0;
+}
+
+SliceFramePool::~SliceFramePool()
+{
+    size_t i;
+    for (i = 0; i < mFreeSlabs.size(); i++)
+        delete [] mFreeSlabs[i].data;
+}
+
+void SliceFramePool::Retain()
+{
+    lock_guard<mutex> lock(mMutex);
+    mRefCount++;
+}
+
+void SliceFramePool::Release()
+{
+    bool last_ref;
+    {
+        lock_guard<mutex> lock(mMutex);
+        BMX_ASSERT(mRefCount > 0);
+        mRefCount--;
+        last_ref = (mRefCount == 0);
+    }
+
+    if (last_ref)
+        delete this;
+}
+
+unsigned char* SliceFramePool::AcquireSlab(uint32_t min_size, uint32_t *capacity)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+
+        // use the smallest free slab that is large enough
+        size_t best_index = (size_t)(-1);
+        size_t i;
+        for (i = 0; i < mFreeSlabs.size(); i++) {
+            if (mFreeSlabs[i].capacity >= min_size &&
+                (best_index == (size_t)(-1) || mFreeSlabs[i].capacity < mFreeSlabs[best_index].capacity))
+            {
+                best_index = i;
+            }
+        }
+        if (best_index != (size_t)(-1)) {
+            Slab slab = mFreeSlabs[best_index];
+            mFreeSlabs[best_index] = mFreeSlabs.back();
+            mFreeSlabs.pop_back();
+
+            *capacity = slab.capacity;
+            return slab.data;
+        }
+
+        mNumSlabAllocs++;
+    }
+
+    BMX_CHECK(min_size <= UINT32_MAX - SLAB_SIZE_ALIGNMENT);
+    uint32_t alloc_size = (min_size + SLAB_SIZE_ALIGNMENT - 1) / SLAB_SIZE_ALIGNMENT * SLAB_SIZE_ALIGNMENT;
+    if (alloc_size == 0)
+        alloc_size = SLAB_SIZE_ALIGNMENT;
+
+    *capacity = alloc_size;
+    return new unsigned char[alloc_size];
+}
+
+void SliceFramePool::ReleaseSlab(unsigned char *slab, uint32_t capacity)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mFreeSlabs.size() < mMaxFreeSlabs) {
+            Slab free_slab;
+            free_slab.data     = slab;
+            free_slab.capacity = capacity;
+            mFreeSlabs.push_back(free_slab);
+            return;
+        }
+    }
+
+    delete [] slab;
+}
+
+
+
+void* SliceFrame::operator new(size_t size)
+{
+    if (size == sizeof(SliceFrame)) {
+        lock_guard<mutex> lock(g_free_frame_blocks_mutex);
+        if (g_num_free_frame_blocks > 0)
+            return g_free_frame_blocks[--g_num_free_frame_blocks];
+    }
+
+    return ::operator new(size);
+}
+
+void SliceFrame::operator delete(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size == sizeof(SliceFrame)) {
+        lock_guard<mutex> lock(g_free_frame_blocks_mutex);
+        if (g_num_free_frame_blocks < MAX_FREE_FRAME_BLOCKS) {
+            g_free_frame_blocks[g_num_free_frame_blocks++] = ptr;
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
+
+SliceFrame::SliceFrame(SliceFramePool *pool)
+: Frame()
+{
+    mPool = pool;
+    mPool->Retain();
+    mRefData = 0;
+    mRef = 0;
+    mSlab = 0;
+    mSlabCapacity = 0;
+    mSize = 0;
+}
+
+SliceFrame::SliceFrame(const SliceFrame &from)
+: Frame(from)
+{
+    mPool = from.mPool;
+    mPool->Retain();
+    mRefData = 0;
+    mRef = 0;
+    mSlab = 0;
+    mSlabCapacity = 0;
+    mSize = 0;
+
+    if (from.mSize > 0) {
+        Grow(from.mSize);
+        memcpy(mSlab, from.GetBytes(), from.mSize);
+        mSize = from.mSize;
+    }
+}
+
+SliceFrame::~SliceFrame()
+{
+    ReleaseData();
+    mPool->Release();
+}
+
+uint32_t SliceFrame::GetSize() const
+{
+    return mSize;
+}
+
+const unsigned char* SliceFrame::GetBytes() const
+{
+    if (mRef)
+        return mRefData;
+    else
+        return mSlab;
+}
+
+void SliceFrame::Grow(uint32_t min_size)
+{
+    if (!mRef && mSize + min_size <= mSlabCapacity)
+        return;
+
+    // referenced data is copied into a slab once the frame needs to be modified
+    uint32_t new_capacity;
+    unsigned char *new_slab = mPool->AcquireSlab(mSize + min_size, &new_capacity);
+    if (mSize > 0)
+        memcpy(new_slab, GetBytes(), mSize);
+
+    uint32_t size = mSize;
+    ReleaseData();
+    mSlab = new_slab;
+    mSlabCapacity = new_capacity;
+    mSize = size;
+}
+
+uint32_t SliceFrame::GetSizeAvailable() const
+{
+    if (mRef)
+        return 0;
+    else
+        return mSlabCapacity - mSize;
+}
+
+unsigned char* SliceFrame::GetBytesAvailable() const
+{
+    if (mRef || mSize == mSlabCapacity)
+        return 0;
+
+    return mSlab + mSize;
+}
+
+void SliceFrame::SetSize(uint32_t size)
+{
+    if (size > (mRef ? mSize : mSlabCapacity))
+        BMX_EXCEPTION(("Cannot set frame size > allocated size"));
+
+    mSize = size;
+}
+
+void SliceFrame::IncrementSize(uint32_t inc)
+{
+    if (mRef || mSize + inc > mSlabCapacity)
+        BMX_EXCEPTION(("Cannot set frame size > allocated size"));
+
+    mSize += inc;
+}
+
+bool SliceFrame::CanReferenceData() const
+{
+    // only a single contiguous slice can be referenced
+    return mSize == 0;
+}
+
+void SliceFrame::ReferenceData(const unsigned char *data, uint32_t size, MXFFileDataRef *ref)
+{
+    if (mSize > 0) {
+        Frame::ReferenceData(data, size, ref);
+        return;
+    }
+
+    ReleaseData();
+    mRefData = data;
+    mRef = ref;
+    mSize = size;
+}
+
+Frame* SliceFrame::Clone()
+{
+    return new SliceFrame(*this);
+}
+
+void SliceFrame::ReleaseData()
+{
+    if (mRef) {
+        mxf_file_release_ref(&mRef);
+        mRefData = 0;
+    }
+    if (mSlab) {
+        mPool->ReleaseSlab(mSlab, mSlabCapacity);
+        mSlab = 0;
+        mSlabCapacity = 0;
+    }
+    mSize = 0;
+}
+
+
+
+SliceFrameFactory::SliceFrameFactory(size_t max_free_slabs)
+{
+    mPool = new SliceFramePool(max_free_slabs);
+}
+
+SliceFrameFactory::~SliceFrameFactory()
+{
+    mPool->Release();
+}
+
+Frame* SliceFrameFactory::CreateFrame()
+{
+    return new SliceFrame(mPool);
+}
+
@@ -144,6 +144,7 @@ OP1AFile::OP1AFile(int flavour, mxfpp::File *mxf_file, mxfRational frame_rate)
 
     if (flavour & OP1A_SINGLE_PASS_MD5_WRITE_FLAVOUR) {
         mMXFChecksumFile = mxf_checksum_file_open(mMXFFile->getCFile(), MD5_CHECKSUM);
+        mxf_checksum_file_enable_async_update(mMXFChecksumFile);
         mMXFFile->swapCFile(mxf_checksum_file_get_file(mMXFChecksumFile));
     }
 
@@ -55,6 +55,8 @@ using namespace mxfpp;
 #define MAX_GOP_SIZE_GUESS          30
 
 #define MAX_CACHE_ENTRIES           250
+// power of 2 that covers the cached entries and the int8 temporal offset range
+#define INDEX_CACHE_INIT_SIZE       256
 
 
 
@@ -117,46 +119,63 @@ OP1AIndexTableElement::OP1AIndexTableElement(uint32_t track_index_, ElementType
     slice_offset = 0;
     element_size = 0;
     last_add_index_entry_pos = -1;
+    mNumCacheEntries = 0;
+    mNumRequireUpdates = 0;
+    mFirstRequireUpdate = -1;
 }
 
 void OP1AIndexTableElement::CacheIndexEntry(int64_t position, int8_t temporal_offset, int8_t key_frame_offset,
                                             uint8_t flags, bool can_start_partition, bool require_update)
 {
-    BMX_CHECK(mIndexEntryCache.size() <= MAX_CACHE_ENTRIES);
+    BMX_CHECK(mNumCacheEntries <= MAX_CACHE_ENTRIES);
 
-    mIndexEntryCache[position] = OP1AIndexEntry(temporal_offset, key_frame_offset, flags, can_start_partition);
+    CacheSlot *slot = AllocCacheSlot(position);
+    if (!slot->have_entry) {
+        slot->have_entry = true;
+        mNumCacheEntries++;
+    }
+    slot->entry = OP1AIndexEntry(temporal_offset, key_frame_offset, flags, can_start_partition);
 
-    if (require_update)
-        require_updates.insert(position);
+    if (require_update && !slot->require_update) {
+        slot->require_update = true;
+        if (mNumRequireUpdates == 0 || position < mFirstRequireUpdate)
+            mFirstRequireUpdate = position;
+        mNumRequireUpdates++;
+    }
     if (position > last_add_index_entry_pos)
         last_add_index_entry_pos = position;
 }
 
 void OP1AIndexTableElement::UpdateIndexEntry(int64_t position, int8_t temporal_offset)
 {
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    CacheSlot *slot = GetCacheSlot(position);
+    BMX_ASSERT(slot && slot->have_entry);
 
-    mIndexEntryCache[position].temporal_offset = temporal_offset;
+    slot->entry.temporal_offset = temporal_offset;
 }
 
 void OP1AIndexTableElement::UpdateIndexEntry(int64_t position, int8_t temporal_offset, int8_t key_frame_offset,
                                              uint8_t flags)
 {
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    CacheSlot *slot = GetCacheSlot(position);
+    BMX_ASSERT(slot && slot->have_entry);
 
-    mIndexEntryCache[position].temporal_offset  = temporal_offset;
-    mIndexEntryCache[position].key_frame_offset = key_frame_offset;
-    mIndexEntryCache[position].flags            = flags;
+    slot->entry.temporal_offset  = temporal_offset;
+    slot->entry.key_frame_offset = key_frame_offset;
+    slot->entry.flags            = flags;
 }
 
 bool OP1AIndexTableElement::TakeIndexEntry(int64_t position, OP1AIndexEntry *entry)
 {
-    map<int64_t, OP1AIndexEntry>::iterator result = mIndexEntryCache.find(position);
-    if (result == mIndexEntryCache.end())
+    CacheSlot *slot = GetCacheSlot(position);
+    if (!slot || !slot->have_entry)
         return false;
 
-    *entry = result->second;
-    mIndexEntryCache.erase(result);
+    *entry = slot->entry;
+    slot->have_entry = false;
+    mNumCacheEntries--;
+    if (!slot->require_update)
+        ReleaseCacheSlot(slot);
 
     return true;
 }
@@ -166,24 +185,117 @@ bool OP1AIndexTableElement::CanStartPartition(int64_t position)
     if (is_cbe)
         return true;
 
-    BMX_ASSERT(mIndexEntryCache.find(position) != mIndexEntryCache.end());
+    CacheSlot *slot = GetCacheSlot(position);
+    BMX_ASSERT(slot && slot->have_entry);
 
-    return (mIndexEntryCache[position].can_start_partition);
+    return slot->entry.can_start_partition;
 }
 
 bool OP1AIndexTableElement::RequireUpdatesAtEnd(int64_t end_offset) const
 {
-    return !require_updates.empty() && (*require_updates.begin()) <= last_add_index_entry_pos + end_offset;
+    return mNumRequireUpdates > 0 && mFirstRequireUpdate <= last_add_index_entry_pos + end_offset;
 }
 
 bool OP1AIndexTableElement::RequireUpdatesAtPos(int64_t position) const
 {
-    return !require_updates.empty() && (*require_updates.begin()) <= position;
+    return mNumRequireUpdates > 0 && mFirstRequireUpdate <= position;
+}
+
+void OP1AIndexTableElement::ClearRequiredUpdate(int64_t position)
+{
+    CacheSlot *slot = GetCacheSlot(position);
+    if (!slot || !slot->require_update)
+        return;
+
+    slot->require_update = false;
+    if (!slot->have_entry)
+        ReleaseCacheSlot(slot);
+    mNumRequireUpdates--;
+
+    // move on to the next position requiring an update. The positions are cleared in roughly increasing
+    // order and so the search cost is constant per position
+    if (mNumRequireUpdates > 0 && position == mFirstRequireUpdate) {
+        do {
+            mFirstRequireUpdate++;
+            BMX_ASSERT(mFirstRequireUpdate <= last_add_index_entry_pos);
+            slot = GetCacheSlot(mFirstRequireUpdate);
+        } while (!slot || !slot->require_update);
+    }
 }
 
 void OP1AIndexTableElement::IgnoreRequiredUpdates()
 {
-    require_updates.clear();
+    int64_t position;
+    for (position = mFirstRequireUpdate; mNumRequireUpdates > 0 && position <= last_add_index_entry_pos; position++) {
+        CacheSlot *slot = GetCacheSlot(position);
+        if (slot && slot->require_update) {
+            slot->require_update = false;
+            if (!slot->have_entry)
+                ReleaseCacheSlot(slot);
+            mNumRequireUpdates--;
+        }
+    }
+    BMX_ASSERT(mNumRequireUpdates == 0);
+}
+
+OP1AIndexTableElement::CacheSlot* OP1AIndexTableElement::GetCacheSlot(int64_t position)
+{
+    if (mIndexEntryCache.empty() || position < 0)
+        return 0;
+
+    CacheSlot *slot = &mIndexEntryCache[(size_t)position & (mIndexEntryCache.size() - 1)];
+    if (slot->position != position)
+        return 0;
+
+    return slot;
+}
+
+OP1AIndexTableElement::CacheSlot* OP1AIndexTableElement::AllocCacheSlot(int64_t position)
+{
+    BMX_ASSERT(position >= 0);
+
+    if (mIndexEntryCache.empty())
+        GrowCache();
+
+    while (true) {
+        CacheSlot *slot = &mIndexEntryCache[(size_t)position & (mIndexEntryCache.size() - 1)];
+        if (slot->position == position)
+            return slot;
+        if (slot->position < 0) {
+            slot->position = position;
+            return slot;
+        }
+
+        // the slot is still used by an older position, e.g. one waiting for an update in a long GOP
+        GrowCache();
+    }
+}
+
+void OP1AIndexTableElement::ReleaseCacheSlot(CacheSlot *slot)
+{
+    slot->position = -1;
+    slot->have_entry = false;
+    slot->require_update = false;
+}
+
+void OP1AIndexTableElement::GrowCache()
+{
+    CacheSlot empty_slot;
+    empty_slot.position = -1;
+    empty_slot.have_entry = false;
+    empty_slot.require_update = false;
+
+    // positions that differ modulo the old size also differ modulo the doubled size and so the
+    // used slots can be moved without collisions
+    vector<CacheSlot> old_cache;
+    old_cache.swap(mIndexEntryCache);
+    mIndexEntryCache.resize(old_cache.empty() ? INDEX_CACHE_INIT_SIZE : old_cache.size() * 2, empty_slot);
+
+    size_t i;
+    for (i = 0; i < old_cache.size(); i++) {
+        if (old_cache[i].position >= 0)
+            mIndexEntryCache[(size_t)old_cache[i].position & (mIndexEntryCache.size() - 1)] = old_cache[i];
+    }
 }
 
 
@@ -486,7 +598,7 @@ void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, in
         mIndexSegments[i]->UpdateIndexEntry(mIndexSegments[i]->GetDuration() - end_offset, temporal_offset);
     }
 
-    mIndexElementsMap[track_index]->require_updates.erase(position);
+    mIndexElementsMap[track_index]->ClearRequiredUpdate(position);
 }
 
 void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, int8_t temporal_offset,
@@ -509,7 +621,7 @@ void OP1AIndexTable::UpdateIndexEntry(uint32_t track_index, int64_t position, in
                                             key_frame_offset, flags);
     }
 
-    mIndexElementsMap[track_index]->require_updates.erase(position);
+    mIndexElementsMap[track_index]->ClearRequiredUpdate(position);
 }
 
 bool OP1AIndexTable::CanStartPartition()
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <thread>
+
+#include <bmx/mxf_reader/EssenceReadAhead.h>
+#include <bmx/mxf_helper/MXFFileFactory.h>
+#include <bmx/MXFHTTPFile.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+#define MAX_POOL_THREADS    8
+#define MAX_READ_FILES      4
+#define HTTP_MIN_READ_SIZE  (64 * 1024)
+
+
+
+namespace bmx
+{
+
+
+// The pool threads are shared so that readers of group and sequence members don't each start threads
+class EssenceReadAheadPool
+{
+public:
+    static EssenceReadAheadPool* Register(uint32_t num_files);
+    static void Unregister(EssenceReadAheadPool *pool);
+
+public:
+    void Submit(EssenceReadAhead *read_ahead);
+    void Cancel(EssenceReadAhead *read_ahead);
+
+private:
+    EssenceReadAheadPool();
+
+    void AddThreads(uint32_t num_files);
+    void Stop();
+    void PoolThread();
+
+private:
+    static mutex sRegisterMutex;
+    static EssenceReadAheadPool *sInstance;
+    static uint32_t sNumRegistered;
+
+    vector<thread> mThreads;
+    uint32_t mNumFiles;
+
+    mutex mMutex;
+    condition_variable mJobCond;
+    condition_variable mIdleCond;
+    deque<EssenceReadAhead*> mJobs;
+    vector<EssenceReadAhead*> mActive;
+    bool mStop;
+};
+
+
+};
+
+
+
+mutex EssenceReadAheadPool::sRegisterMutex;
+EssenceReadAheadPool* EssenceReadAheadPool::sInstance = 0;
+uint32_t EssenceReadAheadPool::sNumRegistered = 0;
+
+
+EssenceReadAheadPool* EssenceReadAheadPool::Register(uint32_t num_files)
+{
+    lock_guard<mutex> lock(sRegisterMutex);
+
+    if (!sInstance)
+        sInstance = new EssenceReadAheadPool();
+    sInstance->AddThreads(num_files);
+    sNumRegistered++;
+
+    return sInstance;
+}
+
+void EssenceReadAheadPool::Unregister(EssenceReadAheadPool *pool)
+{
+    lock_guard<mutex> lock(sRegisterMutex);
+
+    BMX_ASSERT(pool == sInstance && sNumRegistered > 0);
+    sNumRegistered--;
+    if (sNumRegistered == 0) {
+        sInstance->Stop();
+        delete sInstance;
+        sInstance = 0;
+    }
+}
+
+EssenceReadAheadPool::EssenceReadAheadPool()
+{
+    mNumFiles = 0;
+    mStop = false;
+}
+
+void EssenceReadAheadPool::AddThreads(uint32_t num_files)
+{
+    // a thread per file handle, up to the maximum, allows a blocking read per file handle to be in flight
+    mNumFiles += num_files;
+    while (mThreads.size() < mNumFiles && mThreads.size() < MAX_POOL_THREADS)
+        mThreads.push_back(thread(&EssenceReadAheadPool::PoolThread, this));
+}
+
+void EssenceReadAheadPool::Stop()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStop = true;
+    }
+    mJobCond.notify_all();
+
+    size_t i;
+    for (i = 0; i < mThreads.size(); i++)
+        mThreads[i].join();
+    mThreads.clear();
+}
+
+void EssenceReadAheadPool::Submit(EssenceReadAhead *read_ahead)
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mJobs.push_back(read_ahead);
+    }
+    mJobCond.notify_one();
+}
+
+void EssenceReadAheadPool::Cancel(EssenceReadAhead *read_ahead)
+{
+    // an active job can be queued again when it completes and so the queued jobs are removed each time
+    unique_lock<mutex> lock(mMutex);
+    mIdleCond.wait(lock, [&]() {
+        mJobs.erase(remove(mJobs.begin(), mJobs.end(), read_ahead), mJobs.end());
+        return find(mActive.begin(), mActive.end(), read_ahead) == mActive.end();
+    });
+}
+
+void EssenceReadAheadPool::PoolThread()
+{
+    while (true) {
+        EssenceReadAhead *read_ahead;
+        {
+            unique_lock<mutex> lock(mMutex);
+            mJobCond.wait(lock, [&]() { return mStop || !mJobs.empty(); });
+            if (mStop)
+                break;
+            read_ahead = mJobs.front();
+            mJobs.pop_front();
+            mActive.push_back(read_ahead);
+        }
+
+        // a job reads a single request and is then queued again if there are more requests, which shares the
+        // threads between the read-aheads
+        bool more = read_ahead->ReadNext();
+
+        {
+            lock_guard<mutex> lock(mMutex);
+            mActive.erase(find(mActive.begin(), mActive.end(), read_ahead));
+            if (more)
+                mJobs.push_back(read_ahead);
+        }
+        if (more)
+            mJobCond.notify_one();
+        mIdleCond.notify_all();
+    }
+}
+
+
+
+EssenceReadAhead::EssenceReadAhead(const string &filename, File *file, uint32_t queue_depth)
+{
+    mFilename = filename;
+    mFile = file;
+    mQueueDepth = queue_depth;
+    mPool = 0;
+    mNumJobs = 0;
+}
+
+EssenceReadAhead::~EssenceReadAhead()
+{
+    if (mPool) {
+        mPool->Cancel(this);
+        EssenceReadAheadPool::Unregister(mPool);
+    }
+
+    size_t i;
+    for (i = 0; i < mFiles.size(); i++)
+        delete mFiles[i];
+}
+
+bool EssenceReadAhead::Start()
+{
+    try
+    {
+        uint32_t num_files = mQueueDepth;
+        if (num_files > MAX_READ_FILES)
+            num_files = MAX_READ_FILES;
+
+        // HTTP read-ahead is disabled because each file handle reads a subset of the content packages
+        DefaultMXFFileFactory file_factory;
+        uint32_t i;
+        for (i = 0; i < num_files; i++) {
+            if (mxf_http_is_url(mFilename))
+                mFiles.push_back(new File(mxf_http_file_open_read(mFilename, HTTP_MIN_READ_SIZE, 0)));
+            else
+                mFiles.push_back(file_factory.OpenRead(mFilename));
+            mxf_set_runin_len(mFiles.back()->getCFile(), mxf_get_runin_len(mFile->getCFile()));
+        }
+    }
+    catch (...)
+    {
+        log_warn("Failed to open file '%s' for essence read-ahead\n", mFilename.c_str());
+        size_t i;
+        for (i = 0; i < mFiles.size(); i++)
+            delete mFiles[i];
+        mFiles.clear();
+        return false;
+    }
+
+    mFreeFiles = mFiles;
+    mPool = EssenceReadAheadPool::Register((uint32_t)mFiles.size());
+
+    return true;
+}
+
+int64_t EssenceReadAhead::GetEndPosition() const
+{
+    if (mRequests.empty())
+        return -1;
+    else
+        return mRequests.back()->position + 1;
+}
+
+void EssenceReadAhead::Queue(int64_t position, int64_t file_position, uint32_t size)
+{
+    BMX_ASSERT(mRequests.empty() || position == mRequests.back()->position + 1);
+
+    shared_ptr<Request> request(new Request);
+    request->position      = position;
+    request->file_position = file_position;
+    request->size          = size;
+    request->done          = false;
+    request->failed        = false;
+
+    bool submit = false;
+    {
+        lock_guard<mutex> lock(mMutex);
+        mRequests.push_back(request);
+        mPending.push_back(request);
+        if (mNumJobs < mFiles.size()) {
+            mNumJobs++;
+            submit = true;
+        }
+    }
+    if (submit)
+        mPool->Submit(this);
+}
+
+bool EssenceReadAhead::Take(int64_t position, const unsigned char **data, uint32_t *size, int64_t *file_position)
+{
+    mCurrent.reset();
+
+    unique_lock<mutex> lock(mMutex);
+
+    if (mRequests.empty() || mRequests.front()->position != position)
+        return false;
+
+    shared_ptr<Request> request = mRequests.front();
+    mRequests.pop_front();
+    mDoneCond.wait(lock, [&]() { return request->done; });
+    if (request->failed)
+        return false;
+
+    // the data remains valid until the next call to Take
+    mCurrent = request;
+    *data          = request->data.GetBytes();
+    *size          = request->data.GetSize();
+    *file_position = request->file_position;
+
+    return true;
+}
+
+void EssenceReadAhead::Clear()
+{
+    // reads that are in flight complete in the pool threads and are then discarded
+    lock_guard<mutex> lock(mMutex);
+    mRequests.clear();
+    mPending.clear();
+}
+
+bool EssenceReadAhead::ReadNext()
+{
+    // each job holds a file handle while reading because there are at most as many jobs as file handles
+    shared_ptr<Request> request;
+    File *file;
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mPending.empty()) {
+            mNumJobs--;
+            return false;
+        }
+        request = mPending.front();
+        mPending.pop_front();
+        file = mFreeFiles.back();
+        mFreeFiles.pop_back();
+    }
+
+    bool failed = false;
+    try
+    {
+        request->data.Allocate(request->size);
+        file->seek(request->file_position, SEEK_SET);
+        if (file->read(request->data.GetBytes(), request->size) == request->size)
+            request->data.SetSize(request->size);
+        else
+            failed = true;
+    }
+    catch (...)
+    {
+        failed = true;
+    }
+
+    bool more;
+    {
+        lock_guard<mutex> lock(mMutex);
+        request->done   = true;
+        request->failed = failed;
+        mFreeFiles.push_back(file);
+        more = !mPending.empty();
+        if (!more)
+            mNumJobs--;
+    }
+    mDoneCond.notify_all();
+
+    return more;
+}
@@ -57,6 +57,9 @@ using namespace bmx;
 using namespace mxfpp;
 
 
+#define MAX_COALESCED_READ_SIZE     (8 * 1024 * 1024)
+
+
 EssenceReaderBuffer::EssenceReaderBuffer(MXFFileReader *file_reader)
 {
     mFileReader = file_reader;
@@ -105,6 +108,9 @@ bool EssenceReaderBuffer::PopOrPrepareRead(int64_t position, uint32_t num_sample
     }
     // else mBufferFrames && offset == GetBufferSize()
 
+    // appending with push_back rather than inserting at the front of an empty deque avoids a
+    // deque node allocation for each read
+    BMX_ASSERT(offset == GetBufferSize());
     size_t t;
     for (t = 0; t < mFileReader->GetNumInternalTrackReaders(); t++) {
         Frame *frame = 0;
@@ -112,10 +118,10 @@ bool EssenceReaderBuffer::PopOrPrepareRead(int64_t position, uint32_t num_sample
             frame = mFileReader->GetInternalTrackReader(t)->GetFrameBuffer()->CreateFrame();
             frame->request_num_samples = num_samples;
         }
-        mTrackFrames[t].insert(mTrackFrames[t].begin() + offset, frame);
+        mTrackFrames[t].push_back(frame);
     }
-    mRequestSampleCounts.insert(mRequestSampleCounts.begin() + offset, num_samples);
-    mReadSampleCounts.insert(mReadSampleCounts.begin() + offset, 0); // filled-in when PushFrames is called
+    mRequestSampleCounts.push_back(num_samples);
+    mReadSampleCounts.push_back(0); // filled-in when PushFrames is called
     mCurrentFrame = offset;
 
     if (mCurrentFrame == 0)
@@ -152,6 +158,14 @@ void EssenceReaderBuffer::PushFrames(uint32_t actual_read_num_samples)
     mCurrentFrame = GetBufferSize(); // i.e. not set
 }
 
+void EssenceReaderBuffer::AbortRead()
+{
+    if (mCurrentFrame < GetBufferSize())
+        ClearFromFrame(mCurrentFrame);
+
+    mCurrentFrame = GetBufferSize(); // i.e. not set
+}
+
 Frame* EssenceReaderBuffer::TakeFrame(uint32_t track_index)
 {
     BMX_ASSERT(track_index < mTrackFrames.size() && mCurrentFrame < mTrackFrames[track_index].size());
@@ -256,6 +270,9 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
     mLastKnownBasePosition = -1;
     mHaveFooter = file_is_complete;
     mBaseReadError = false;
+    mCoalescedFileSave = 0;
+    mCoalescedEndPosition = 0;
+    mReadAhead = 0;
 
 
     // get ImageStartOffset and ImageEndOffset properties which are used in Avid uncompressed files
@@ -361,6 +378,8 @@ EssenceReader::EssenceReader(MXFFileReader *file_reader, bool file_is_complete,
 
 EssenceReader::~EssenceReader()
 {
+    EndCoalescedRead();
+    delete mReadAhead;
     delete mFrameMetadataReader;
 }
 
@@ -389,6 +408,25 @@ void EssenceReader::SetBufferFrames(bool enable)
     mReadFrameBuffer.SetBufferFrames(enable);
 }
 
+void EssenceReader::SetReadAhead(const string &filename, uint32_t queue_depth)
+{
+    delete mReadAhead;
+    mReadAhead = 0;
+
+    // the content packages are located using the index table, as is the case for coalesced reads
+    if (queue_depth == 0 || mParseOnly || mFileReader->IsClipWrapped() || mFileReader->mLazyIndex ||
+        mFile->getCFile()->read_ref)
+    {
+        return;
+    }
+
+    mReadAhead = new EssenceReadAhead(filename, mFile, queue_depth);
+    if (!mReadAhead->Start()) {
+        delete mReadAhead;
+        mReadAhead = 0;
+    }
+}
+
 uint32_t EssenceReader::Read(uint32_t num_samples)
 {
     uint32_t actual_read_num_samples = 0;
@@ -426,10 +464,19 @@ uint32_t EssenceReader::Read(uint32_t num_samples)
 
         // read the samples
         int64_t start_position = mPosition;
-        if (mFileReader->IsClipWrapped())
-            actual_read_num_samples = ReadClipWrappedSamples(read_num_samples);
-        else
-            actual_read_num_samples = ReadFrameWrappedSamples(read_num_samples);
+        try
+        {
+            if (mFileReader->IsClipWrapped())
+                actual_read_num_samples = ReadClipWrappedSamples(read_num_samples);
+            else
+                actual_read_num_samples = ReadFrameWrappedSamples(read_num_samples);
+        }
+        catch (...)
+        {
+            // the partially read frames are removed so that a retry, eg. for a growing file, reads them again
+            mReadFrameBuffer.AbortRead();
+            throw;
+        }
 
         // add frame metadata and information associated with first sample in frame
         int64_t essence_offset = 0;
@@ -466,6 +513,9 @@ uint32_t EssenceReader::Read(uint32_t num_samples)
 
 void EssenceReader::Seek(int64_t position)
 {
+    if (mReadAhead && position != mPosition)
+        mReadAhead->Clear();
+
     mPosition = position;
 }
 
@@ -526,17 +576,26 @@ uint32_t EssenceReader::ReadClipWrappedSamples(uint32_t num_samples)
             current_file_position = file_position;
 
             BMX_CHECK(size <= UINT32_MAX);
-            frame->Grow((uint32_t)size);
-            uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)size);
-            current_file_position += num_read;
-            BMX_CHECK(num_read == size);
-
-            size -= mImageEndOffset;
-            if (mImageStartOffset > 0) {
-                memmove(frame->GetBytesAvailable(),
-                        frame->GetBytesAvailable() + mImageStartOffset,
-                        (uint32_t)(size - mImageStartOffset));
-                size -= mImageStartOffset;
+            const unsigned char *ref_data;
+            MXFFileDataRef *ref;
+            if (frame->CanReferenceData() && mFile->readRef((uint32_t)size, &ref_data, &ref)) {
+                current_file_position += size;
+                size -= mImageStartOffset + mImageEndOffset;
+                frame->ReferenceData(ref_data + mImageStartOffset, (uint32_t)size, ref);
+            } else {
+                frame->Grow((uint32_t)size);
+                uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)size);
+                current_file_position += num_read;
+                BMX_CHECK(num_read == size);
+
+                size -= mImageEndOffset;
+                if (mImageStartOffset > 0) {
+                    memmove(frame->GetBytesAvailable(),
+                            frame->GetBytesAvailable() + mImageStartOffset,
+                            (uint32_t)(size - mImageStartOffset));
+                    size -= mImageStartOffset;
+                }
+                frame->IncrementSize((uint32_t)size);
             }
 
             if (frame->IsEmpty()) {
@@ -548,7 +607,6 @@ uint32_t EssenceReader::ReadClipWrappedSamples(uint32_t num_samples)
                 frame->element_key         = element_key;
             }
 
-            frame->IncrementSize((uint32_t)size);
             frame->num_samples += num_cont_samples;
         } else {
             mFile->seek(file_position + size, SEEK_SET);
@@ -567,110 +625,241 @@ uint32_t EssenceReader::ReadFrameWrappedSamples(uint32_t num_samples)
 {
     int64_t start_position = mPosition;
 
-    map<uint32_t, MXFTrackReader*> enabled_track_readers;
+    // a vector member is used rather than a map to avoid allocations for each edit unit
+    mEnabledTrackReaders.clear();
     uint32_t i;
-    for (i = 0; i < num_samples; i++) {
-        int64_t cp_file_position;
-        int64_t size;
-        if (!SeekEssence(mPosition))
-            return i;
-        if (mIndexTableHelper.HaveEditUnitSize(mPosition)) {
-            mxfKey dummy_key = g_Null_Key;
-            GetEditUnit(mPosition, &dummy_key, &cp_file_position, &size);
-            BMX_ASSERT(cp_file_position == mFilePosition);
-        } else if (mIndexTableHelper.HaveEditUnitOffset(mPosition)) {
-            size = 0;
-            cp_file_position = mEssenceChunkHelper.GetFilePosition(mIndexTableHelper.GetEditUnitOffset(mPosition));
-            BMX_ASSERT(cp_file_position == mFilePosition);
-        } else {
-            size = 0;
-            cp_file_position = mFilePosition;
-        }
+    try
+    {
+        for (i = 0; i < num_samples; i++) {
+            // content packages with an indexed size are read from memory after a single read from the file
+            if (mCoalescedFileSave && mPosition >= mCoalescedEndPosition)
+                EndCoalescedRead();
+            if (!mCoalescedFileSave)
+                StartCoalescedRead(mPosition, num_samples - i);
+
+            int64_t cp_file_position;
+            int64_t size;
+            if (!SeekEssence(mPosition)) {
+                EndCoalescedRead();
+                return i;
+            }
+            if (mIndexTableHelper.HaveEditUnitSize(mPosition)) {
+                mxfKey dummy_key = g_Null_Key;
+                GetEditUnit(mPosition, &dummy_key, &cp_file_position, &size);
+                BMX_ASSERT(cp_file_position == mFilePosition);
+            } else if (mIndexTableHelper.HaveEditUnitOffset(mPosition)) {
+                size = 0;
+                cp_file_position = mEssenceChunkHelper.GetFilePosition(mIndexTableHelper.GetEditUnitOffset(mPosition));
+                BMX_ASSERT(cp_file_position == mFilePosition);
+            } else {
+                size = 0;
+                cp_file_position = mFilePosition;
+            }
 
-        mxfKey key;
-        uint8_t llen;
-        uint64_t len;
-        int64_t cp_num_read = 0;
-        while ((size == 0 || cp_num_read < size) &&
-               ReadEssenceKL(cp_num_read == 0, &key, &llen, &len))
-        {
-            cp_num_read += mxfKey_extlen + llen;
-
-            bool processed_metadata = mFrameMetadataReader->ProcessFrameMetadata(&key, len);
-
-            // Markus!
-            if (!processed_metadata && (mxf_is_gc_essence_element(&key) || mxf_avid_is_essence_element(&key))) {
-                uint32_t track_number = mxf_get_track_number(&key);
-                MXFTrackReader *track_reader = 0;
-                Frame *frame = 0;
-                if (enabled_track_readers.find(track_number) == enabled_track_readers.end()) {
-                    // frame does not yet exist - create it if track is enabled
-                    track_reader = mFileReader->GetInternalTrackReaderByNumber(track_number);
-                    if (start_position == mPosition && track_reader && track_reader->IsEnabled()) {
-                        frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
-
-                        BMX_CHECK(cp_num_read <= UINT32_MAX);
-
-                        frame->ec_position         = start_position;
-                        frame->cp_file_position    = cp_file_position;
-                        frame->file_position       = cp_file_position + cp_num_read - (mxfKey_extlen + llen);
-                        frame->kl_size             = mxfKey_extlen + llen;
-                        frame->file_id             = mFileReader->GetFileId();
-                        frame->element_key         = key;
-                        if (mIndexTableHelper.HaveEditUnit(start_position)) {
-                            frame->temporal_reordering =
-                                mIndexTableHelper.GetTemporalReordering((uint32_t)(cp_num_read - (mxfKey_extlen + llen)));
+            mxfKey key;
+            uint8_t llen;
+            uint64_t len;
+            int64_t cp_num_read = 0;
+            while ((size == 0 || cp_num_read < size) &&
+                   ReadEssenceKL(cp_num_read == 0, &key, &llen, &len))
+            {
+                cp_num_read += mxfKey_extlen + llen;
+
+                bool processed_metadata = mFrameMetadataReader->ProcessFrameMetadata(&key, len);
+
+                // Markus!
+                if (!processed_metadata && (mxf_is_gc_essence_element(&key) || mxf_avid_is_essence_element(&key))) {
+                    uint32_t track_number = mxf_get_track_number(&key);
+                    MXFTrackReader *track_reader = 0;
+                    Frame *frame = 0;
+                    size_t enabled_index;
+                    for (enabled_index = 0; enabled_index < mEnabledTrackReaders.size(); enabled_index++) {
+                        if (mEnabledTrackReaders[enabled_index].first == track_number)
+                            break;
+                    }
+                    if (enabled_index == mEnabledTrackReaders.size()) {
+                        // frame does not yet exist - create it if track is enabled
+                        track_reader = mFileReader->GetInternalTrackReaderByNumber(track_number);
+                        if (start_position == mPosition && track_reader && track_reader->IsEnabled()) {
+                            frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
+
+                            BMX_CHECK(cp_num_read <= UINT32_MAX);
+
+                            frame->ec_position         = start_position;
+                            frame->cp_file_position    = cp_file_position;
+                            frame->file_position       = cp_file_position + cp_num_read - (mxfKey_extlen + llen);
+                            frame->kl_size             = mxfKey_extlen + llen;
+                            frame->file_id             = mFileReader->GetFileId();
+                            frame->element_key         = key;
+                            if (mIndexTableHelper.HaveEditUnit(start_position)) {
+                                frame->temporal_reordering =
+                                    mIndexTableHelper.GetTemporalReordering((uint32_t)(cp_num_read - (mxfKey_extlen + llen)));
+                            }
+
+                            mEnabledTrackReaders.push_back(make_pair(track_number, track_reader));
+                        } else {
+                            mEnabledTrackReaders.push_back(make_pair(track_number, (MXFTrackReader*)0));
                         }
-
-                        enabled_track_readers[track_number] = track_reader;
                     } else {
-                        enabled_track_readers[track_number] = 0;
+                        // frame exists if track is enabled - get it
+                        track_reader = mEnabledTrackReaders[enabled_index].second;
+                        if (track_reader)
+                            frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
                     }
-                } else {
-                    // frame exists if track is enabled - get it
-                    track_reader = enabled_track_readers[track_number];
-                    if (track_reader)
-                        frame = mReadFrameBuffer.GetFrame((uint32_t)track_reader->GetTrackIndex());
-                }
 
-                if (frame) {
-                    BMX_CHECK(len <= UINT32_MAX);
-                    frame->Grow((uint32_t)len);
-                    if (!mParseOnly)
-                    {
-                        uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)len);
-                        BMX_CHECK(num_read == len);
+                    if (frame) {
+                        BMX_CHECK(len <= UINT32_MAX);
+                        const unsigned char *ref_data;
+                        MXFFileDataRef *ref;
+                        if (!mParseOnly && frame->CanReferenceData() &&
+                            mFile->readRef((uint32_t)len, &ref_data, &ref))
+                        {
+                            frame->ReferenceData(ref_data, (uint32_t)len, ref);
+                        } else {
+                            frame->Grow((uint32_t)len);
+                            if (!mParseOnly)
+                            {
+                                uint32_t num_read = mFile->read(frame->GetBytesAvailable(), (uint32_t)len);
+                                BMX_CHECK(num_read == len);
+                            } else {
+                                mFile->skip(len);
+                            }
+                            frame->IncrementSize((uint32_t)len);
+                        }
+                        frame->num_samples++;
                     } else {
                         mFile->skip(len);
                     }
-                    frame->IncrementSize((uint32_t)len);
-                    frame->num_samples++;
-                } else {
+                } else if (!processed_metadata) {
                     mFile->skip(len);
                 }
-            } else if (!processed_metadata) {
-                mFile->skip(len);
+
+                cp_num_read += len;
+            }
+            if (size != 0 && cp_num_read != size) {
+               BMX_EXCEPTION(("Read content package size (0x%" PRIx64 ") does not match size in index (0x%" PRIx64 ") "
+                              "at file position 0x%" PRIx64,
+                              cp_num_read, size, mFileReader->mFile->tell()));
             }
 
-            cp_num_read += len;
-        }
-        if (size != 0 && cp_num_read != size) {
-           BMX_EXCEPTION(("Read content package size (0x%" PRIx64 ") does not match size in index (0x%" PRIx64 ") "
-                          "at file position 0x%" PRIx64,
-                          cp_num_read, size, mFileReader->mFile->tell()));
-        }
+            if (size == 0) {
+                mIndexTableHelper.UpdateIndex(mPosition, mEssenceChunkHelper.GetEssenceOffset(cp_file_position),
+                                              cp_num_read);
+            }
 
-        if (size == 0) {
-            mIndexTableHelper.UpdateIndex(mPosition, mEssenceChunkHelper.GetEssenceOffset(cp_file_position),
-                                          cp_num_read);
+            mPosition++;
         }
-
-        mPosition++;
     }
+    catch (...)
+    {
+        EndCoalescedRead();
+        throw;
+    }
+    EndCoalescedRead();
 
     return num_samples;
 }
 
+void EssenceReader::StartCoalescedRead(int64_t position, uint32_t max_samples)
+{
+    // the data is copied from memory and so there is no benefit if the file data can be referenced,
+    // and lazy index table segments would be loaded from memory rather than from the file
+    if (mParseOnly || mFileReader->mLazyIndex || mFile->getCFile()->read_ref ||
+        !mIndexTableHelper.HaveEditUnitSize(position) || GetIndexedFilePosition(position) < 0)
+    {
+        return;
+    }
+
+    if (mReadAhead && StartReadAheadRead(position))
+        return;
+
+    mxfKey dummy_key = g_Null_Key;
+    int64_t start_file_position, size;
+    GetEditUnit(position, &dummy_key, &start_file_position, &size);
+    if (size <= 0 || size > MAX_COALESCED_READ_SIZE)
+        return;
+
+    // add following content packages that are contiguous in the file
+    int64_t total_size = size;
+    uint32_t num_samples = 1;
+    while (num_samples < max_samples &&
+           mIndexTableHelper.HaveEditUnitSize(position + num_samples) &&
+           GetIndexedFilePosition(position + num_samples) == start_file_position + total_size)
+    {
+        int64_t file_position;
+        GetEditUnit(position + num_samples, &dummy_key, &file_position, &size);
+        if (size <= 0 || total_size + size > MAX_COALESCED_READ_SIZE)
+            break;
+        total_size += size;
+        num_samples++;
+    }
+
+    mFile->seek(start_file_position, SEEK_SET);
+    mCoalescedData.Allocate((uint32_t)total_size);
+    BMX_CHECK(mFile->read(mCoalescedData.GetBytes(), (uint32_t)total_size) == total_size);
+    mCoalescedData.SetSize((uint32_t)total_size);
+
+    MXFMemoryFile *mem_file;
+    BMX_CHECK(mxf_mem_file_open_read(mCoalescedData.GetBytes(), total_size, start_file_position, &mem_file));
+    mCoalescedFileSave = mFile->swapCFile(mxf_mem_file_get_file(mem_file));
+    mCoalescedEndPosition = position + num_samples;
+
+    // SeekEssence will position the memory file at the content package start
+    ResetState();
+}
+
+bool EssenceReader::StartReadAheadRead(int64_t position)
+{
+    // top up the queue of reads for the edit units following those already queued
+    int64_t end_position = mReadStartPosition + mReadDuration;
+    int64_t next_position = (mReadAhead->GetNumQueued() > 0 ? mReadAhead->GetEndPosition() : position);
+    mxfKey dummy_key = g_Null_Key;
+    while (mReadAhead->GetNumQueued() < mReadAhead->GetQueueDepth() &&
+           next_position < end_position &&
+           mIndexTableHelper.HaveEditUnitSize(next_position) &&
+           GetIndexedFilePosition(next_position) >= 0)
+    {
+        int64_t file_position, size;
+        GetEditUnit(next_position, &dummy_key, &file_position, &size);
+        if (size <= 0 || size > MAX_COALESCED_READ_SIZE)
+            break;
+        mReadAhead->Queue(next_position, file_position, (uint32_t)size);
+        next_position++;
+    }
+
+    // the queue is restarted at the next read if the data is not available, e.g. the read failed
+    const unsigned char *data;
+    uint32_t size;
+    int64_t file_position;
+    if (!mReadAhead->Take(position, &data, &size, &file_position)) {
+        mReadAhead->Clear();
+        return false;
+    }
+
+    MXFMemoryFile *mem_file;
+    BMX_CHECK(mxf_mem_file_open_read(data, size, file_position, &mem_file));
+    mCoalescedFileSave = mFile->swapCFile(mxf_mem_file_get_file(mem_file));
+    mCoalescedEndPosition = position + 1;
+
+    // SeekEssence will position the memory file at the content package start
+    ResetState();
+
+    return true;
+}
+
+void EssenceReader::EndCoalescedRead()
+{
+    if (!mCoalescedFileSave)
+        return;
+
+    // continue from the same position in the file
+    int64_t file_position = mFile->tell();
+    MXFFile *mem_file = mFile->swapCFile(mCoalescedFileSave);
+    mCoalescedFileSave = 0;
+    mxf_file_close(&mem_file);
+    mFile->seek(file_position, SEEK_SET);
+}
+
 void EssenceReader::GetEditUnit(int64_t position, mxfKey *element_key, int64_t *file_position, int64_t *size)
 {
     int64_t essence_offset, essence_size;
@@ -989,10 +1178,11 @@ bool EssenceReader::SeekContentPackageStart()
     bool have_start_key = (mEssenceStartKey != g_Null_Key);
 
     if (mxf_is_partition_pack(&mNextKey))
-        ReadNextPartition(&mNextKey, mNextLLen, mNextLen);
+        partition_id = ReadNextPartition(&mNextKey, mNextLLen, mNextLen);
+    else
+        partition_id = mFile->getPartitions().size() - 1;
     ResetNextKL();
 
-    partition_id = mFile->getPartitions().size() - 1;
     partition = mFile->getPartitions()[partition_id];
 
     bool at_cp_start = false;
@@ -1004,8 +1194,7 @@ bool EssenceReader::SeekContentPackageStart()
         {
             if (partition->getBodySID() == mFileReader->mBodySID)
                 mEssenceChunkHelper.UpdateLastChunk(mFile->tell() - mxfKey_extlen - llen, true);
-            ReadNextPartition(&key, llen, len);
-            partition_id++;
+            partition_id = ReadNextPartition(&key, llen, len);
             partition = mFile->getPartitions()[partition_id];
         }
         else if (mxf_equals_key(&key, &g_RandomIndexPack_key))
@@ -1069,11 +1258,24 @@ bool EssenceReader::SeekContentPackageStart()
     return at_cp_start;
 }
 
-void EssenceReader::ReadNextPartition(const mxfKey *key, uint8_t llen, uint64_t len)
+size_t EssenceReader::ReadNextPartition(const mxfKey *key, uint8_t llen, uint64_t len)
 {
     int64_t partition_pos = mFile->tell() - mxfKey_extlen - llen;
-    BMX_ASSERT(partition_pos >= 0 &&
-               mFile->getPartitions().back()->getThisPartition() < (uint64_t)partition_pos);
+    BMX_ASSERT(partition_pos >= 0);
+
+    // a growing file read is retried from the last known content package and so the partition pack may
+    // already have been read before the read failure
+    const vector<Partition*> &partitions = mFile->getPartitions();
+    size_t i;
+    for (i = partitions.size(); i > 0; i--) {
+        if (partitions[i - 1]->getThisPartition() == (uint64_t)partition_pos) {
+            mFile->skip(len);
+            return i - 1;
+        } else if (partitions[i - 1]->getThisPartition() < (uint64_t)partition_pos) {
+            break;
+        }
+    }
+    BMX_ASSERT(i == partitions.size());
 
     mFile->readNextPartition(key, len);
 
@@ -1089,6 +1291,8 @@ void EssenceReader::ReadNextPartition(const mxfKey *key, uint8_t llen, uint64_t
         if (partition->getIndexByteCount() == 0)
             SetFileIsComplete();
     }
+
+    return partitions.size() - 1;
 }
 
 void EssenceReader::SetHaveFooter()
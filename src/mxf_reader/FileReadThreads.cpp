@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <thread>
+#include <mutex>
+#include <exception>
+
+#include <bmx/mxf_reader/FileReadThreads.h>
+#include <bmx/mxf_helper/MXFFileFactory.h>
+#include <bmx/MXFHTTPFile.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+#define HTTP_MIN_READ_SIZE  (64 * 1024)
+
+
+
+FileReadThreads::FileReadThreads(const string &filename, File *file, uint32_t num_threads)
+{
+    mFilename = filename;
+    mFile = file;
+    mNumThreads = num_threads;
+    mOpenFailed = false;
+}
+
+FileReadThreads::~FileReadThreads()
+{
+    size_t i;
+    for (i = 0; i < mFiles.size(); i++)
+        delete mFiles[i];
+}
+
+void FileReadThreads::Run(size_t num_tasks, const Task &task)
+{
+    // run in the calling thread using the original file if there is nothing to gain
+    if (num_tasks < 2 || mNumThreads < 2 || !OpenFiles()) {
+        size_t i;
+        for (i = 0; i < num_tasks; i++)
+            task(mFile, i);
+        return;
+    }
+
+    mutex task_mutex;
+    size_t next_task = 0;
+    vector<exception_ptr> errors(num_tasks);
+
+    vector<thread> threads;
+    size_t i;
+    for (i = 0; i < mFiles.size() && i < num_tasks; i++) {
+        File *thread_file = mFiles[i];
+        threads.push_back(thread([&, thread_file]() {
+            while (true) {
+                size_t task_index;
+                {
+                    lock_guard<mutex> lock(task_mutex);
+                    if (next_task >= num_tasks)
+                        break;
+                    task_index = next_task++;
+                }
+
+                try
+                {
+                    task(thread_file, task_index);
+                }
+                catch (...)
+                {
+                    errors[task_index] = current_exception();
+                    lock_guard<mutex> lock(task_mutex);
+                    next_task = num_tasks;
+                }
+            }
+        }));
+    }
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    // rethrow the error for the first failed task, as would be the case when run serially
+    for (i = 0; i < errors.size(); i++) {
+        if (errors[i])
+            rethrow_exception(errors[i]);
+    }
+}
+
+vector<Partition*> FileReadThreads::readPartitionPacks(File *file, const vector<uint64_t> &offsets)
+{
+    BMX_ASSERT(file == mFile);
+
+    vector<Partition*> partitions(offsets.size(), 0);
+    try
+    {
+        Run(offsets.size(), [&](File *task_file, size_t task_index) {
+            mxfKey key;
+            uint8_t llen;
+            uint64_t len;
+            task_file->seek(mxf_get_runin_len(task_file->getCFile()) + offsets[task_index], SEEK_SET);
+            task_file->readKL(&key, &llen, &len);
+            partitions[task_index] = Partition::read(task_file, &key, len);
+        });
+    }
+    catch (...)
+    {
+        size_t i;
+        for (i = 0; i < partitions.size(); i++)
+            delete partitions[i];
+        throw;
+    }
+
+    return partitions;
+}
+
+bool FileReadThreads::OpenFiles()
+{
+    if (!mFiles.empty())
+        return true;
+    if (mOpenFailed)
+        return false;
+
+    try
+    {
+        // HTTP read-ahead is disabled because each thread reads small items at scattered positions
+        DefaultMXFFileFactory file_factory;
+        uint32_t i;
+        for (i = 0; i < mNumThreads; i++) {
+            if (mxf_http_is_url(mFilename))
+                mFiles.push_back(new File(mxf_http_file_open_read(mFilename, HTTP_MIN_READ_SIZE, 0)));
+            else
+                mFiles.push_back(file_factory.OpenRead(mFilename));
+            mxf_set_runin_len(mFiles.back()->getCFile(), mxf_get_runin_len(mFile->getCFile()));
+        }
+    }
+    catch (...)
+    {
+        log_warn("Failed to open file '%s' for concurrent reads\n", mFilename.c_str());
+        size_t i;
+        for (i = 0; i < mFiles.size(); i++)
+            delete mFiles[i];
+        mFiles.clear();
+        mOpenFailed = true;
+    }
+
+    return !mFiles.empty();
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <chrono>
+#include <thread>
+#include <memory>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/inotify.h>
+#endif
+
+#include <bmx/mxf_reader/GrowingFileFollower.h>
+#include <bmx/Utils.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+#define DEFAULT_MAX_WAITS       10
+#define DEFAULT_WAIT_MSEC       1000
+#define DEFAULT_POLL_INTERVAL   10
+
+// changes made on another host are not notified for network file systems and so the file sizes are still
+// checked at this interval when notifications are enabled
+#define NOTIFY_POLL_INTERVAL    250
+
+#define QUIET_LOG_LEVEL         ((LogLevel)(ERROR_LOG + 1))
+
+
+
+static int64_t get_current_file_size(const string &filename)
+{
+    try
+    {
+        return get_file_size(filename);
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+
+
+GrowingFileFollower::GrowingFileFollower(MXFReader *reader, const vector<string> &filenames)
+{
+    mReader = reader;
+    mFilenames = filenames;
+    mMaxWaits = DEFAULT_MAX_WAITS;
+    mWaitMSec = DEFAULT_WAIT_MSEC;
+    mPollInterval = DEFAULT_POLL_INTERVAL;
+    mNotifyFd = -1;
+    mNumWaits = 0;
+    mHaveWaited = false;
+    mIsFollowing = false;
+
+    size_t i;
+    for (i = 0; i < mFilenames.size(); i++)
+        mFileSizes.push_back(get_current_file_size(mFilenames[i]));
+
+#if defined(__linux__)
+    mNotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mNotifyFd >= 0) {
+        for (i = 0; i < mFilenames.size(); i++) {
+            if (inotify_add_watch(mNotifyFd, mFilenames[i].c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+                log_debug("Failed to add inotify watch for file '%s': %s\n",
+                          mFilenames[i].c_str(), bmx_strerror(errno).c_str());
+                close(mNotifyFd);
+                mNotifyFd = -1;
+                break;
+            }
+        }
+    }
+    if (mNotifyFd < 0)
+        log_debug("Polling file sizes to follow growing files\n");
+#endif
+}
+
+GrowingFileFollower::~GrowingFileFollower()
+{
+#if defined(__linux__)
+    if (mNotifyFd >= 0)
+        close(mNotifyFd);
+#endif
+}
+
+void GrowingFileFollower::SetMaxWaits(uint32_t max_waits, uint32_t wait_msec)
+{
+    mMaxWaits = max_waits;
+    mWaitMSec = wait_msec;
+}
+
+void GrowingFileFollower::SetPollInterval(uint32_t msec)
+{
+    mPollInterval = msec;
+}
+
+void GrowingFileFollower::SetFramesAvailableCallback(const FramesAvailableCallback &callback)
+{
+    mFramesAvailableCallback = callback;
+}
+
+uint32_t GrowingFileFollower::Read(uint32_t num_samples)
+{
+    mHaveWaited = false;
+
+    // once a read has waited the reader is following the end of the file, where reads are expected to fail
+    // until the frame has been completely written. Only the errors for the first failure are logged.
+    // Logging is disabled for this thread only and is restored if the read throws an exception
+    unique_ptr<ThreadLogLevel> quiet_logging;
+    if (mIsFollowing)
+        quiet_logging.reset(new ThreadLogLevel(QUIET_LOG_LEVEL));
+
+    int64_t position;
+    uint32_t num_read;
+    while (true) {
+        position = mReader->GetPosition();
+        num_read = mReader->Read(num_samples);
+
+        // a failure to read when the files are not growing is reported to the caller
+        if (num_read > 0 || !mReader->ReadError() || ReachedMaxWaits())
+            break;
+
+        // only waits that time out count towards the maximum. A wait that ends because the files have grown is
+        // followed by a retry, which may fail again if the next frame has only been partially written
+        mHaveWaited = true;
+        mIsFollowing = true;
+        if (!WaitForGrowth(mWaitMSec))
+            mNumWaits++;
+
+        if (!quiet_logging)
+            quiet_logging.reset(new ThreadLogLevel(QUIET_LOG_LEVEL));
+    }
+    quiet_logging.reset();
+
+    if (num_read > 0) {
+        mNumWaits = 0;
+        if (mFramesAvailableCallback)
+            mFramesAvailableCallback(position, num_read);
+    }
+
+    return num_read;
+}
+
+bool GrowingFileFollower::WaitForGrowth(uint32_t timeout_msec)
+{
+    // the sizes are compared with those from the previous check so that growth between the failed read and
+    // this call is not missed
+    if (CheckGrowth())
+        return true;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (true) {
+        int64_t elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+        if (elapsed >= timeout_msec)
+            return false;
+
+        uint32_t interval = (mNotifyFd >= 0 ? NOTIFY_POLL_INTERVAL : mPollInterval);
+        if (interval > timeout_msec - elapsed)
+            interval = (uint32_t)(timeout_msec - elapsed);
+
+        if (mNotifyFd >= 0) {
+            if (WaitForNotify(interval)) {
+                CheckGrowth();
+                return true;
+            }
+        } else {
+            this_thread::sleep_for(chrono::milliseconds(interval));
+        }
+
+        if (CheckGrowth())
+            return true;
+    }
+}
+
+bool GrowingFileFollower::CheckGrowth()
+{
+    bool grown = false;
+    size_t i;
+    for (i = 0; i < mFilenames.size(); i++) {
+        int64_t file_size = get_current_file_size(mFilenames[i]);
+        if (file_size != mFileSizes[i]) {
+            mFileSizes[i] = file_size;
+            grown = true;
+        }
+    }
+
+    return grown;
+}
+
+bool GrowingFileFollower::WaitForNotify(uint32_t timeout_msec)
+{
+#if defined(__linux__)
+    struct pollfd poll_fd;
+    poll_fd.fd = mNotifyFd;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+    int result = poll(&poll_fd, 1, (int)timeout_msec);
+    if (result <= 0)
+        return false;
+
+    // the events are drained; any change is a reason to retry the read
+    char buffer[4096];
+    while (read(mNotifyFd, buffer, sizeof(buffer)) > 0)
+    {}
+
+    return true;
+#else
+    (void)timeout_msec;
+    return false;
+#endif
+}
@@ -45,6 +45,7 @@
 
 #include <bmx/mxf_reader/IndexTableHelper.h>
 #include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/mxf_reader/MXFOpenCache.h>
 #include <bmx/Utils.h>
 #include <bmx/BMXException.h>
 #include <bmx/Logging.h>
@@ -88,6 +89,73 @@ static int add_frame_offset_index_entry(void *data, uint32_t num_entries, MXFInd
     return 1;
 }
 
+typedef struct
+{
+    vector<unique_ptr<IndexTableHelperSegment> > segments;
+    bool found;
+    uint64_t num_read;
+    uint64_t index_byte_count;
+} PartitionIndexSegments;
+
+static void read_partition_index_segments(File *file, const Partition *partition, bool is_last_partition,
+                                          bool lazy_index, PartitionIndexSegments *segments)
+{
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+
+    segments->found = false;
+    segments->num_read = 0;
+    segments->index_byte_count = partition->getIndexByteCount();
+
+    // find the start of the first index table segment
+    file->seek(partition->getThisPartition(), SEEK_SET);
+    file->readKL(&key, &llen, &len);
+    file->skip(len);
+    while (true)
+    {
+        file->readNextNonFillerKL(&key, &llen, &len);
+
+        if (mxf_is_partition_pack(&key) || mxf_is_index_table_segment(&key))
+            break;
+        else if (mxf_is_header_metadata(&key) && partition->getHeaderByteCount() > mxfKey_extlen + llen + len)
+            file->skip(partition->getHeaderByteCount() - (mxfKey_extlen + llen));
+        else
+            file->skip(len);
+    }
+    if (!mxf_is_index_table_segment(&key))
+        return;
+
+    // read the index table segments
+    segments->found = true;
+    uint64_t num_read = mxfKey_extlen + llen;
+    while (true)
+    {
+        if (mxf_is_index_table_segment(&key)) {
+            segments->segments.push_back(unique_ptr<IndexTableHelperSegment>(new IndexTableHelperSegment()));
+            if (lazy_index)
+                segments->segments.back()->ReadIndexTableSegmentHeader(file, len);
+            else
+                segments->segments.back()->ReadIndexTableSegment(file, len);
+        } else if (mxf_is_filler(&key)) {
+            file->skip(len);
+        } else {
+            num_read -= mxfKey_extlen + llen;
+            break;
+        }
+        num_read += len;
+
+        if (segments->index_byte_count > 0 && num_read >= segments->index_byte_count)
+            break;
+        if (segments->index_byte_count == 0 && is_last_partition && file->tell() >= file->size())
+            break;
+
+        file->readKL(&key, &llen, &len);
+        num_read += mxfKey_extlen + llen;
+    }
+    segments->num_read = num_read;
+}
+
 
 
 IndexTableHelperSegment::IndexTableHelperSegment()
@@ -102,6 +170,11 @@ IndexTableHelperSegment::IndexTableHelperSegment()
     mIndexEndOffset = 0;
     mEssenceStartOffset = 0;
     mIsFileIndexSegment = false;
+    mIsLazy = false;
+    mFilePosition = 0;
+    mSegmentLen = 0;
+    mFileNumIndexEntries = 0;
+    mLastAccess = 0;
 }
 
 IndexTableHelperSegment::~IndexTableHelperSegment()
@@ -112,6 +185,7 @@ IndexTableHelperSegment::~IndexTableHelperSegment()
 void IndexTableHelperSegment::ReadIndexTableSegment(File *file, uint64_t segment_len)
 {
     mIsFileIndexSegment = true;
+    mIsLazy = false;
 
     // free existing segment which will be replaced
     mxf_free_index_table_segment(&_cSegment);
@@ -123,6 +197,27 @@ void IndexTableHelperSegment::ReadIndexTableSegment(File *file, uint64_t segment
                                                   &_cSegment));
 }
 
+void IndexTableHelperSegment::ReadIndexTableSegmentHeader(File *file, uint64_t segment_len)
+{
+    mIsFileIndexSegment = true;
+    mIsLazy = true;
+    mFilePosition = file->tell();
+    mSegmentLen = segment_len;
+
+    // free existing segment which will be replaced
+    mxf_free_index_table_segment(&_cSegment);
+
+    BMX_CHECK(mxf_avid_read_index_table_segment_header(file->getCFile(), segment_len,
+                                                       mxf_default_add_delta_entry, 0,
+                                                       &mFileNumIndexEntries, &_cSegment));
+
+    // only VBE segments with an index entry for each edit unit have their index entries loaded on demand
+    if (getEditUnitByteCount() != 0 || getIndexDuration() <= 0 || mFileNumIndexEntries != getIndexDuration()) {
+        file->seek(mFilePosition, SEEK_SET);
+        ReadIndexTableSegment(file, segment_len);
+    }
+}
+
 void IndexTableHelperSegment::ProcessIndexTableSegment(Rational expected_edit_rate)
 {
     setIndexEditRate(normalize_rate(getIndexEditRate()));
@@ -139,19 +234,20 @@ void IndexTableHelperSegment::ProcessIndexTableSegment(Rational expected_edit_ra
         setIndexDuration(0);
     }
 
+    uint32_t num_index_entries = (mIsLazy ? mFileNumIndexEntries : mNumIndexEntries);
     if (getEditUnitByteCount() == 0) {
         if (getIndexDuration() == 0) {
-            if (mNumIndexEntries > 0)
+            if (num_index_entries > 0)
                 BMX_EXCEPTION(("VBE index table segment with index entries but unknown duration is invalid"));
-        } else if ((int64_t)mNumIndexEntries < getIndexDuration()) {
-            if ((int64_t)mNumIndexEntries > 0) {
+        } else if ((int64_t)num_index_entries < getIndexDuration()) {
+            if ((int64_t)num_index_entries > 0) {
                 BMX_EXCEPTION(("VBE index table is missing index entries"));
             } else {
                 BMX_EXCEPTION(("CBE index table edit unit byte count is invalid or "
                                "VBE index table is missing index entries"));
             }
         }
-    } else if (mNumIndexEntries > 0) {
+    } else if (num_index_entries > 0) {
         BMX_EXCEPTION(("VBE index table with non-zero edit unit byte count or "
                        "CBE index table with index entries is invalid"));
     }
@@ -197,6 +293,8 @@ int IndexTableHelperSegment::GetEditUnit(int64_t position, int8_t *temporal_offs
         return position < getIndexStartPosition() ? -2 : -1;
     }
 
+    BMX_ASSERT(!mIsLazy || mIndexEntries);
+
     int64_t rel_position = position - getIndexStartPosition();
     if (mNumIndexEntries == 0) {
         *temporal_offset  = 0;
@@ -315,6 +413,107 @@ void IndexTableHelperSegment::CopyIndexEntries(const IndexTableHelperSegment *fr
     mHavePairedIndexEntries = from_segment->mHavePairedIndexEntries;
 }
 
+bool IndexTableHelperSegment::ContainsPosition(int64_t position) const
+{
+    return position >= getIndexStartPosition() &&
+           (getIndexDuration() == 0 || position < getIndexStartPosition() + getIndexDuration());
+}
+
+void IndexTableHelperSegment::LoadIndexEntries(File *file)
+{
+    BMX_ASSERT(mIsLazy && !mIndexEntries);
+
+    file->seek(mFilePosition, SEEK_SET);
+
+    MXFIndexTableSegment *file_segment = 0;
+    bool result = mxf_avid_read_index_table_segment_2(file->getCFile(), mSegmentLen,
+                                                      0, 0,
+                                                      add_frame_offset_index_entry, this,
+                                                      &file_segment);
+    mxf_free_index_table_segment(&file_segment);
+    if (!result || mNumIndexEntries != mFileNumIndexEntries) {
+        UnloadIndexEntries();
+        BMX_EXCEPTION(("Failed to load index entries for index table segment at file position 0x%" PRIx64,
+                       mFilePosition));
+    }
+}
+
+void IndexTableHelperSegment::UnloadIndexEntries()
+{
+    BMX_ASSERT(mIsLazy);
+
+    delete [] mIndexEntries;
+    mIndexEntries = 0;
+    mAllocIndexEntries = 0;
+    mNumIndexEntries = 0;
+    mEntriesStart = 0;
+}
+
+int64_t IndexTableHelperSegment::GetIndexEntriesSize() const
+{
+    return (int64_t)mAllocIndexEntries * INTERNAL_INDEX_ENTRY_SIZE;
+}
+
+void IndexTableHelperSegment::WriteCache(File *file)
+{
+    BMX_ASSERT(!mIsLazy);
+
+    BMX_CHECK(mxf_write_index_table_segment(file->getCFile(), _cSegment));
+    file->writeUInt8(mIsFileIndexSegment);
+    file->writeUInt8(mHaveExtraIndexEntries);
+    file->writeUInt8(mHavePairedIndexEntries);
+    file->writeInt64(mIndexEndOffset);
+    file->writeInt64(mEssenceStartOffset);
+
+    // the processed index entries are written as-is, i.e. in host byte order
+    uint32_t num_entries = (mIndexEntries ? mAllocIndexEntries : 0);
+    uint64_t size = (uint64_t)num_entries * INTERNAL_INDEX_ENTRY_SIZE;
+    BMX_CHECK(size <= UINT32_MAX);
+    file->writeUInt32(mEntriesStart);
+    file->writeUInt32(mNumIndexEntries);
+    file->writeUInt32(num_entries);
+    if (size > 0)
+        BMX_CHECK(file->write(mIndexEntries, (uint32_t)size) == size);
+}
+
+void IndexTableHelperSegment::ReadCache(File *file)
+{
+    BMX_ASSERT(!mIndexEntries);
+
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+    file->readKL(&key, &llen, &len);
+    BMX_CHECK(mxf_is_index_table_segment(&key));
+
+    // free existing segment which will be replaced
+    mxf_free_index_table_segment(&_cSegment);
+
+    BMX_CHECK(mxf_avid_read_index_table_segment_2(file->getCFile(), len,
+                                                  mxf_default_add_delta_entry, 0,
+                                                  0, 0,
+                                                  &_cSegment));
+    mIsFileIndexSegment     = (file->readUInt8() != 0);
+    mHaveExtraIndexEntries  = (file->readUInt8() != 0);
+    mHavePairedIndexEntries = (file->readUInt8() != 0);
+    mIndexEndOffset         = file->readInt64();
+    mEssenceStartOffset     = file->readInt64();
+
+    uint32_t entries_start = file->readUInt32();
+    uint32_t num_index_entries = file->readUInt32();
+    uint32_t num_entries = file->readUInt32();
+    uint64_t size = (uint64_t)num_entries * INTERNAL_INDEX_ENTRY_SIZE;
+    BMX_CHECK(size <= UINT32_MAX);
+    BMX_CHECK(num_index_entries == 0 || num_entries > 0);
+    if (size > 0) {
+        mIndexEntries = new unsigned char[(size_t)size];
+        mAllocIndexEntries = num_entries;
+        BMX_CHECK(file->read(mIndexEntries, (uint32_t)size) == size);
+    }
+    mEntriesStart = entries_start;
+    mNumIndexEntries = num_index_entries;
+}
+
 
 
 
@@ -328,6 +527,8 @@ IndexTableHelper::IndexTableHelper(MXFFileReader *file_reader)
     mEssenceDataSize = 0;
     mEditRate = ZERO_RATIONAL;
     mDuration = 0;
+    mLazyIndexMemory = 0;
+    mAccessCount = 0;
 }
 
 IndexTableHelper::~IndexTableHelper()
@@ -339,61 +540,40 @@ IndexTableHelper::~IndexTableHelper()
 
 void IndexTableHelper::ExtractIndexTable()
 {
-    mxfKey key;
-    uint8_t llen;
-    uint64_t len;
+    if (mFileReader->mOpenCache && mFileReader->mOpenCache->ReadIndexTable(mFileReader->mIndexSID, this))
+        return;
 
     const vector<Partition*> &partitions = mFileReader->mFile->getPartitions();
+    vector<size_t> partition_ids;
     size_t i;
     for (i = 0; i < partitions.size(); i++) {
-        const Partition *partition = partitions[i];
-
-        if (partition->getIndexSID() != mFileReader->mIndexSID)
-            continue;
-
-        // find the start of the first index table segment
-        mFile->seek(partition->getThisPartition(), SEEK_SET);
-        mFile->readKL(&key, &llen, &len);
-        mFile->skip(len);
-        while (true)
-        {
-            mFile->readNextNonFillerKL(&key, &llen, &len);
-
-            if (mxf_is_partition_pack(&key) || mxf_is_index_table_segment(&key))
-                break;
-            else if (mxf_is_header_metadata(&key) && partition->getHeaderByteCount() > mxfKey_extlen + llen + len)
-                mFile->skip(partition->getHeaderByteCount() - (mxfKey_extlen + llen));
-            else
-                mFile->skip(len);
-        }
-
-        // parse the index table segments
-        if (mxf_is_index_table_segment(&key)) {
-            uint64_t num_read = mxfKey_extlen + llen;
-            uint64_t index_byte_count = partition->getIndexByteCount();
-            while (true)
-            {
-                if (mxf_is_index_table_segment(&key)) {
-                    ReadIndexTableSegment(len);
-                } else if (mxf_is_filler(&key)) {
-                    mFile->skip(len);
-                } else {
-                    num_read -= mxfKey_extlen + llen;
-                    break;
-                }
-                num_read += len;
+        if (partitions[i]->getIndexSID() == mFileReader->mIndexSID)
+            partition_ids.push_back(i);
+    }
 
-                if (index_byte_count > 0 && num_read >= index_byte_count)
-                    break;
-                if (index_byte_count == 0 && i == partitions.size() - 1 && mFile->tell() >= mFile->size())
-                    break;
+    // read the index table segments, possibly concurrently, and then process them in partition order
+    vector<PartitionIndexSegments> partition_segments(partition_ids.size());
+    FileReadThreads::Task read_task = [&](File *file, size_t task_index) {
+        size_t partition_id = partition_ids[task_index];
+        read_partition_index_segments(file, partitions[partition_id], partition_id == partitions.size() - 1,
+                                      mFileReader->mLazyIndex, &partition_segments[task_index]);
+    };
+    if (mFileReader->mFileReadThreads) {
+        mFileReader->mFileReadThreads->Run(partition_ids.size(), read_task);
+    } else {
+        for (i = 0; i < partition_ids.size(); i++)
+            read_task(mFile, i);
+    }
 
-                mFile->readKL(&key, &llen, &len);
-                num_read += mxfKey_extlen + llen;
-            }
-            if (index_byte_count > 0 && num_read != index_byte_count) {
+    for (i = 0; i < partition_segments.size(); i++) {
+        PartitionIndexSegments &segments = partition_segments[i];
+        if (segments.found) {
+            size_t k;
+            for (k = 0; k < segments.segments.size(); k++)
+                AddIndexTableSegment(segments.segments[k]);
+            if (segments.index_byte_count > 0 && segments.num_read != segments.index_byte_count) {
                 log_warn("Index byte count %" PRIu64 " does not equal value in partition pack %" PRIu64 "\n",
-                         num_read, index_byte_count);
+                         segments.num_read, segments.index_byte_count);
             }
         } else {
             log_warn("Failed to find an index table segment in partition with IndexSID = %u\n", mFileReader->mIndexSID);
@@ -437,6 +617,12 @@ int64_t IndexTableHelper::ReadIndexTableSegment(uint64_t len)
 {
     unique_ptr<IndexTableHelperSegment> new_segment(new IndexTableHelperSegment());
     new_segment->ReadIndexTableSegment(mFileReader->mFile, len);
+
+    return AddIndexTableSegment(new_segment);
+}
+
+int64_t IndexTableHelper::AddIndexTableSegment(unique_ptr<IndexTableHelperSegment> &new_segment)
+{
     try
     {
         new_segment->ProcessIndexTableSegment(mEditRate);
@@ -511,6 +697,64 @@ void IndexTableHelper::SetIsComplete()
     SetEssenceDataSize(mEssenceDataSize);
 }
 
+bool IndexTableHelper::CanWriteCache() const
+{
+    if (!mIsComplete || mSegments.empty())
+        return false;
+
+    // the index entries of lazy segments are not all available in memory
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++) {
+        if (mSegments[i]->IsLazy())
+            return false;
+    }
+
+    return true;
+}
+
+void IndexTableHelper::WriteCache(File *file)
+{
+    BMX_ASSERT(CanWriteCache());
+
+    file->writeUInt32(mEditUnitSize);
+    file->writeInt32(mEditRate.numerator);
+    file->writeInt32(mEditRate.denominator);
+    file->writeInt64(mDuration);
+    file->writeUInt32((uint32_t)mSegments.size());
+
+    size_t i;
+    for (i = 0; i < mSegments.size(); i++)
+        mSegments[i]->WriteCache(file);
+}
+
+void IndexTableHelper::ReadCache(File *file)
+{
+    BMX_ASSERT(mSegments.empty());
+
+    uint32_t edit_unit_size = file->readUInt32();
+    Rational edit_rate;
+    edit_rate.numerator   = file->readInt32();
+    edit_rate.denominator = file->readInt32();
+    int64_t duration = file->readInt64();
+    uint32_t num_segments = file->readUInt32();
+
+    // the index table is left unchanged if reading fails
+    vector<unique_ptr<IndexTableHelperSegment> > segments;
+    uint32_t i;
+    for (i = 0; i < num_segments; i++) {
+        segments.push_back(unique_ptr<IndexTableHelperSegment>(new IndexTableHelperSegment()));
+        segments.back()->ReadCache(file);
+    }
+    BMX_CHECK(!segments.empty());
+
+    for (i = 0; i < num_segments; i++)
+        mSegments.push_back(segments[i].release());
+    mEditUnitSize = edit_unit_size;
+    mEditRate = edit_rate;
+    mDuration = duration;
+    mIsComplete = true;
+}
+
 bool IndexTableHelper::HaveEditUnit(int64_t position) const
 {
     return !mSegments.empty() && position >= 0 && position < mDuration;
@@ -522,16 +766,14 @@ void IndexTableHelper::GetEditUnit(int64_t position, int8_t *temporal_offset, in
     BMX_ASSERT(!mSegments.empty());
     BMX_CHECK(mDuration == 0 || position < mDuration);
 
-    int result = mSegments[mLastEditUnitSegment]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                              offset);
+    int result = GetSegmentEditUnit(mLastEditUnitSegment, position, temporal_offset, key_frame_offset, flags, offset);
     if (result < 0) {
         // TODO: binary search
         if (result == -2) {
             // segment is before mLastEditUnitSegment
             size_t i;
             for (i = mLastEditUnitSegment; i > 0; i--) {
-                result = mSegments[i - 1]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                       offset);
+                result = GetSegmentEditUnit(i - 1, position, temporal_offset, key_frame_offset, flags, offset);
                 if (result >= 0) {
                     mLastEditUnitSegment = i - 1;
                     break;
@@ -543,8 +785,7 @@ void IndexTableHelper::GetEditUnit(int64_t position, int8_t *temporal_offset, in
             // segment is after mLastEditUnitSegment
             size_t i;
             for (i = mLastEditUnitSegment + 1; i < mSegments.size(); i++) {
-                result = mSegments[i]->GetEditUnit(position, temporal_offset, key_frame_offset, flags,
-                                                   offset);
+                result = GetSegmentEditUnit(i, position, temporal_offset, key_frame_offset, flags, offset);
                 if (result >= 0) {
                     mLastEditUnitSegment = i;
                     break;
@@ -638,6 +879,72 @@ bool IndexTableHelper::GetIndexEntry(MXFIndexEntryExt *entry, int64_t position)
     return true;
 }
 
+int IndexTableHelper::GetSegmentEditUnit(size_t index, int64_t position, int8_t *temporal_offset,
+                                         int8_t *key_frame_offset, uint8_t *flags, int64_t *offset)
+{
+    IndexTableHelperSegment *segment = mSegments[index];
+    if (segment->IsLazy() && segment->ContainsPosition(position)) {
+        if (!segment->HaveIndexEntries())
+            LoadLazySegment(segment);
+        segment->SetLastAccess(++mAccessCount);
+    }
+
+    return segment->GetEditUnit(position, temporal_offset, key_frame_offset, flags, offset);
+}
+
+void IndexTableHelper::LoadLazySegment(IndexTableHelperSegment *segment)
+{
+    // restore the file position because the essence reader may depend on it
+    int64_t file_position = mFile->tell();
+    segment->LoadIndexEntries(mFile);
+    mFile->seek(file_position, SEEK_SET);
+
+    segment->SetLastAccess(++mAccessCount);
+    mLoadedLazySegments.push_back(segment);
+    mLazyIndexMemory += segment->GetIndexEntriesSize();
+
+    // unload the least recently accessed segments, excluding the one just loaded, until within the memory limit
+    uint64_t memory_limit = mFileReader->mLazyIndexMemoryLimit;
+    while (memory_limit > 0 && (uint64_t)mLazyIndexMemory > memory_limit && mLoadedLazySegments.size() > 1) {
+        size_t lru_index = 0;
+        size_t i;
+        for (i = 1; i < mLoadedLazySegments.size() - 1; i++) {
+            if (mLoadedLazySegments[i]->GetLastAccess() < mLoadedLazySegments[lru_index]->GetLastAccess())
+                lru_index = i;
+        }
+        mLazyIndexMemory -= mLoadedLazySegments[lru_index]->GetIndexEntriesSize();
+        mLoadedLazySegments[lru_index]->UnloadIndexEntries();
+        mLoadedLazySegments.erase(mLoadedLazySegments.begin() + lru_index);
+    }
+}
+
+void IndexTableHelper::ReleaseLazySegment(IndexTableHelperSegment *segment)
+{
+    size_t i;
+    for (i = 0; i < mLoadedLazySegments.size(); i++) {
+        if (mLoadedLazySegments[i] == segment) {
+            mLazyIndexMemory -= segment->GetIndexEntriesSize();
+            mLoadedLazySegments.erase(mLoadedLazySegments.begin() + i);
+            break;
+        }
+    }
+}
+
+void IndexTableHelper::PinSegment(IndexTableHelperSegment *segment)
+{
+    // the index entries of a segment that is modified can't be re-loaded from the file
+    if (!segment->IsLazy())
+        return;
+
+    ReleaseLazySegment(segment);
+    if (!segment->HaveIndexEntries()) {
+        int64_t file_position = mFile->tell();
+        segment->LoadIndexEntries(mFile);
+        mFile->seek(file_position, SEEK_SET);
+    }
+    segment->ClearLazy();
+}
+
 void IndexTableHelper::InsertCBEIndexSegment(unique_ptr<IndexTableHelperSegment> &new_segment_up)
 {
     IndexTableHelperSegment *new_segment = new_segment_up.get();
@@ -656,6 +963,7 @@ void IndexTableHelper::InsertCBEIndexSegment(unique_ptr<IndexTableHelperSegment>
             }
 
             // replace runtime generated index segment
+            ReleaseLazySegment(mSegments.front());
             delete mSegments.front();
             mSegments.clear();
         } else {
@@ -710,20 +1018,24 @@ void IndexTableHelper::InsertVBEIndexSegment(unique_ptr<IndexTableHelperSegment>
             // existing and new segment overlap
             if (SEG_START(segment) >= SEG_START(new_segment) && SEG_END(segment) <= SEG_END(new_segment)) {
                 // existing segment if completely covered by new segment
+                ReleaseLazySegment(segment);
                 delete segment;
                 iter = mSegments.erase(iter);
                 deleted_segment = true;
             } else if (SEG_START(segment) < SEG_START(new_segment) && SEG_END(segment) > SEG_END(new_segment)) {
                 // existing segment covers and is larger than new segment
+                PinSegment(segment);
                 iter = mSegments.insert(iter, CreateStartSegment(segment,
                                                                  (uint32_t)(SEG_START(new_segment) -
                                                                             SEG_START(segment))));
                 segment->UpdateStartPosition(SEG_START(new_segment));
             } else if (SEG_START(segment) < SEG_START(new_segment)) {
                 // existing segment starts before new segment
+                PinSegment(segment);
                 segment->UpdateDuration(SEG_START(new_segment) - SEG_START(segment));
             } else {
                 // existing segment ends after new segment
+                PinSegment(segment);
                 segment->UpdateStartPosition(SEG_END(new_segment));
                 iter = mSegments.insert(iter, new_segment);
                 new_segment_up.release();
@@ -165,6 +165,12 @@ MXFFileReader::MXFFileReader()
     mEssenceReader = 0;
     mRequireFrameInfoCount = 0;
     mST436ManifestCount = 2;
+    mOpenThreads = 1;
+    mFileReadThreads = 0;
+    mOpenCache = 0;
+    mLazyIndex = false;
+    mLazyIndexMemoryLimit = 0;
+    mReadAheadDepth = 0;
 
     mDataModel = new DataModel();
     mHeaderMetadata = new AvidHeaderMetadata(mDataModel);
@@ -183,6 +189,8 @@ MXFFileReader::~MXFFileReader()
     if (mOwnFilefactory)
         delete mFileFactory;
     delete mEssenceReader;
+    delete mFileReadThreads;
+    delete mOpenCache;
     delete mFile;
     delete mHeaderMetadata;
     delete mDataModel;
@@ -229,6 +237,27 @@ void MXFFileReader::SetST436ManifestFrameCount(uint32_t count)
     mST436ManifestCount = count;
 }
 
+void MXFFileReader::SetOpenThreads(uint32_t num_threads)
+{
+    mOpenThreads = num_threads;
+}
+
+void MXFFileReader::SetLazyIndex(bool enable, uint64_t memory_limit)
+{
+    mLazyIndex = enable;
+    mLazyIndexMemoryLimit = memory_limit;
+}
+
+void MXFFileReader::SetOpenCacheDir(const string &dir)
+{
+    mOpenCacheDir = dir;
+}
+
+void MXFFileReader::SetReadAhead(uint32_t queue_depth)
+{
+    mReadAheadDepth = queue_depth;
+}
+
 void MXFFileReader::SetFileIndex(MXFFileIndex *file_index, bool take_ownership)
 {
     if (mFileId != (size_t)(-1))
@@ -341,7 +370,21 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
 
         bool file_is_complete;
         if (mFile->isSeekable()) {
-            file_is_complete = mFile->readPartitions();
+            // the partition packs and index table segments are read concurrently using separate file handles,
+            // which are separate connections for HTTP files
+            if (mOpenThreads > 1 && !filename.empty())
+                mFileReadThreads = new FileReadThreads(filename, mFile, mOpenThreads);
+            // the partition packs and index table are taken from the open cache file if it is up to date. The
+            // cache is not used for HTTP files because the file modification time is not available to check
+            // whether the cache is up to date
+            PartitionPackReader *pack_reader = mFileReadThreads;
+            if (!mOpenCacheDir.empty() && !filename.empty() && !mxf_http_is_url(filename)) {
+                mOpenCache = new MXFOpenCache(mOpenCacheDir, filename);
+                mOpenCache->Load(mFile);
+                mOpenCache->SetFallbackReader(mFileReadThreads);
+                pack_reader = mOpenCache;
+            }
+            file_is_complete = mFile->readPartitions(pack_reader);
             if (!file_is_complete) {
                 BMX_ASSERT(mFile->getPartitions().size() == 1);
                 if (mFile->getPartition(0).isClosed() || mFile->getPartition(0).getFooterPartition() != 0)
@@ -383,6 +426,8 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
         // create internal essence reader
         if (!mInternalTrackReaders.empty() && mBodySID != 0) {
             mEssenceReader = new EssenceReader(this, file_is_complete, mOpenModeFlags & MXF_MODE_PARSE_ONLY);
+            if (mReadAheadDepth > 0 && !filename.empty())
+                mEssenceReader->SetReadAhead(filename, mReadAheadDepth);
 
             CheckRequireFrameInfo();
             if (mRequireFrameInfoCount > 0)
@@ -417,6 +462,18 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
         }
 
 
+        if (mOpenCache) {
+            if (!mOpenCache->IsLoaded() && file_is_complete) {
+                mOpenCache->Save(mFile, mIndexSID,
+                                 mEssenceReader ? mEssenceReader->GetIndexTableHelper() : 0);
+            }
+            delete mOpenCache;
+            mOpenCache = 0;
+        }
+
+        delete mFileReadThreads;
+        mFileReadThreads = 0;
+
         result = MXF_RESULT_SUCCESS;
     }
     catch (const OpenResult &ex)
@@ -445,6 +502,10 @@ MXFFileReader::OpenResult MXFFileReader::Open(File *file, const URI &abs_uri, co
     // clean up
     if (result != MXF_RESULT_SUCCESS) {
         mFile = 0;
+        delete mFileReadThreads;
+        mFileReadThreads = 0;
+        delete mOpenCache;
+        mOpenCache = 0;
         delete mEssenceReader;
         mEssenceReader = 0;
         delete mHeaderMetadata;
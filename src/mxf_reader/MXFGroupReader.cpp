@@ -102,10 +102,18 @@ MXFGroupReader::MXFGroupReader()
     mEmptyFramesSet = false;
     mReadStartPosition = 0;
     mReadDuration = -1;
+    mNumReadThreads = 1;
+    mStopReadThreads = false;
+    mNextReadTask = 0;
+    mNumPendingReadTasks = 0;
+    mReadTaskPosition = 0;
+    mReadTaskNumSamples = 0;
 }
 
 MXFGroupReader::~MXFGroupReader()
 {
+    StopReadThreads();
+
     size_t i;
     for (i = 0; i < mReaders.size(); i++)
         delete mReaders[i];
@@ -137,6 +145,13 @@ void MXFGroupReader::AddReader(MXFReader *reader)
     mReaders.push_back(reader);
 }
 
+void MXFGroupReader::SetReadThreads(uint32_t num_threads)
+{
+    StopReadThreads();
+
+    mNumReadThreads = (num_threads > 1 ? num_threads : 1);
+}
+
 bool MXFGroupReader::Finalize()
 {
     try
@@ -402,35 +417,20 @@ uint32_t MXFGroupReader::Read(uint32_t num_samples, bool is_top)
             SetNextFrameTrackPositions();
         }
 
-        uint32_t max_read_num_samples = 0;
-        size_t i;
-        for (i = 0; i < mReaders.size(); i++) {
-            if (!mReaders[i]->IsEnabled())
-                continue;
-
-            int64_t member_current_position = CONVERT_GROUP_POS(current_position);
-
-            // ensure external reader is in sync
-            if (mReaders[i]->GetPosition() != member_current_position)
-                mReaders[i]->Seek(member_current_position);
-
-
-            uint32_t member_num_samples = (uint32_t)convert_duration_higher(num_samples,
-                                                                            current_position,
-                                                                            mSampleSequences[i],
-                                                                            mSampleSequenceSizes[i]);
-
-            uint32_t member_num_read = mReaders[i]->Read(member_num_samples, false);
-            if (member_num_read < member_num_samples && mReaders[i]->ReadError())
-                throw BMXException(mReaders[i]->ReadErrorMessage());
-
-            uint32_t group_num_read = (uint32_t)convert_duration_lower(member_num_read,
-                                                                       member_current_position,
-                                                                       mSampleSequences[i],
-                                                                       mSampleSequenceSizes[i]);
-
-            if (group_num_read > max_read_num_samples)
-                max_read_num_samples = group_num_read;
+        uint32_t max_read_num_samples;
+        if (mNumReadThreads > 1) {
+            max_read_num_samples = ReadMembersParallel(current_position, num_samples);
+        } else {
+            max_read_num_samples = 0;
+            size_t i;
+            for (i = 0; i < mReaders.size(); i++) {
+                if (!mReaders[i]->IsEnabled())
+                    continue;
+
+                uint32_t group_num_read = ReadMember(i, current_position, num_samples);
+                if (group_num_read > max_read_num_samples)
+                    max_read_num_samples = group_num_read;
+            }
         }
 
         CompleteRead();
@@ -644,6 +644,150 @@ void MXFGroupReader::SetTemporaryFrameBuffer(bool enable)
         mReaders[i]->SetTemporaryFrameBuffer(enable);
 }
 
+uint32_t MXFGroupReader::ReadMember(size_t i, int64_t current_position, uint32_t num_samples)
+{
+    int64_t member_current_position = CONVERT_GROUP_POS(current_position);
+
+    // ensure external reader is in sync
+    if (mReaders[i]->GetPosition() != member_current_position)
+        mReaders[i]->Seek(member_current_position);
+
+
+    uint32_t member_num_samples = (uint32_t)convert_duration_higher(num_samples,
+                                                                    current_position,
+                                                                    mSampleSequences[i],
+                                                                    mSampleSequenceSizes[i]);
+
+    uint32_t member_num_read = mReaders[i]->Read(member_num_samples, false);
+    if (member_num_read < member_num_samples && mReaders[i]->ReadError())
+        throw BMXException(mReaders[i]->ReadErrorMessage());
+
+    return (uint32_t)convert_duration_lower(member_num_read,
+                                            member_current_position,
+                                            mSampleSequences[i],
+                                            mSampleSequenceSizes[i]);
+}
+
+uint32_t MXFGroupReader::ReadMembersParallel(int64_t current_position, uint32_t num_samples)
+{
+    vector<size_t> members;
+    size_t i;
+    for (i = 0; i < mReaders.size(); i++) {
+        if (mReaders[i]->IsEnabled())
+            members.push_back(i);
+    }
+    if (members.empty())
+        return 0;
+
+    if (mReadThreads.empty())
+        StartReadThreads();
+
+    {
+        unique_lock<mutex> lock(mReadMutex);
+
+        mReadTaskMembers = members;
+        mNextReadTask = 0;
+        mNumPendingReadTasks = members.size();
+        mReadTaskPosition = current_position;
+        mReadTaskNumSamples = num_samples;
+        mReadTaskNumRead.assign(mReaders.size(), 0);
+        mReadTaskErrors.assign(mReaders.size(), exception_ptr());
+        mReadTaskCond.notify_all();
+
+        // the calling thread takes tasks as well and then waits for the edit unit boundary join
+        ReadMembersTasks(lock);
+        while (mNumPendingReadTasks > 0)
+            mReadDoneCond.wait(lock);
+    }
+
+    // results and errors are processed in member order to match the serial read
+    uint32_t max_read_num_samples = 0;
+    for (i = 0; i < members.size(); i++) {
+        if (mReadTaskErrors[members[i]])
+            rethrow_exception(mReadTaskErrors[members[i]]);
+        if (mReadTaskNumRead[members[i]] > max_read_num_samples)
+            max_read_num_samples = mReadTaskNumRead[members[i]];
+    }
+
+    return max_read_num_samples;
+}
+
+void MXFGroupReader::ReadMembersTasks(unique_lock<mutex> &lock)
+{
+    while (mNextReadTask < mReadTaskMembers.size()) {
+        size_t member_index = mReadTaskMembers[mNextReadTask];
+        mNextReadTask++;
+
+        lock.unlock();
+        uint32_t num_read = 0;
+        exception_ptr error;
+        try
+        {
+            num_read = ReadMember(member_index, mReadTaskPosition, mReadTaskNumSamples);
+        }
+        catch (...)
+        {
+            error = current_exception();
+        }
+        lock.lock();
+
+        mReadTaskNumRead[member_index] = num_read;
+        mReadTaskErrors[member_index] = error;
+        mNumPendingReadTasks--;
+        if (mNumPendingReadTasks == 0)
+            mReadDoneCond.notify_one();
+    }
+}
+
+void MXFGroupReader::StartReadThreads()
+{
+    size_t num_members = 0;
+    size_t i;
+    for (i = 0; i < mReaders.size(); i++) {
+        if (mReaders[i]->IsEnabled())
+            num_members++;
+    }
+
+    // the calling thread is one of the read threads
+    size_t num_threads = mNumReadThreads - 1;
+    if (num_threads > num_members - 1)
+        num_threads = num_members - 1;
+
+    mStopReadThreads = false;
+    for (i = 0; i < num_threads; i++)
+        mReadThreads.push_back(thread(&MXFGroupReader::ReadThread, this));
+}
+
+void MXFGroupReader::StopReadThreads()
+{
+    if (mReadThreads.empty())
+        return;
+
+    {
+        lock_guard<mutex> lock(mReadMutex);
+        mStopReadThreads = true;
+        mReadTaskCond.notify_all();
+    }
+
+    size_t i;
+    for (i = 0; i < mReadThreads.size(); i++)
+        mReadThreads[i].join();
+    mReadThreads.clear();
+}
+
+void MXFGroupReader::ReadThread()
+{
+    unique_lock<mutex> lock(mReadMutex);
+    while (true) {
+        while (!mStopReadThreads && mNextReadTask >= mReadTaskMembers.size())
+            mReadTaskCond.wait(lock);
+        if (mStopReadThreads)
+            break;
+
+        ReadMembersTasks(lock);
+    }
+}
+
 void MXFGroupReader::StartRead()
 {
     size_t i;
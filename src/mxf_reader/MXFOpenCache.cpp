@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
+#include <sys/types.h>
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h> // _mkdir
+#include <process.h> // _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+
+#include <libMXF++/MXF.h>
+
+#if defined(_WIN32)
+#include <mxf/mxf_win32_file.h>
+#if !defined(__MINGW32__)
+#include <mxf/mxf_win32_mmap.h>
+#endif
+#else
+#include <mxf/mxf_posix_mmap.h>
+#endif
+
+#include <bmx/mxf_reader/MXFOpenCache.h>
+#include <bmx/mxf_reader/IndexTableHelper.h>
+#include <bmx/MD5.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+using namespace mxfpp;
+
+
+#define CACHE_VERSION           2
+#define CACHE_BYTE_ORDER        0x01020304
+
+#define MAX_PARTITION_PACK_LEN  (64 * 1024)
+
+static const unsigned char CACHE_MAGIC[16] =
+    {'b', 'm', 'x', ' ', 'o', 'p', 'e', 'n', ' ', 'c', 'a', 'c', 'h', 'e', 0x0d, 0x0a};
+
+
+
+static void write_partition_pack(File *file, const Partition *partition)
+{
+    // mxf_write_partition is not used because it sets ThisPartition to the position in the cache file
+    MXFPartition *c_partition = partition->getCPartition();
+    uint32_t num_labels = (uint32_t)mxf_get_list_length(&c_partition->essenceContainers);
+
+    file->writeKL(&c_partition->key, 88 + mxfUL_extlen * num_labels);
+    file->writeUInt16(c_partition->majorVersion);
+    file->writeUInt16(c_partition->minorVersion);
+    file->writeUInt32(c_partition->kagSize);
+    file->writeUInt64(c_partition->thisPartition);
+    file->writeUInt64(c_partition->previousPartition);
+    file->writeUInt64(c_partition->footerPartition);
+    file->writeUInt64(c_partition->headerByteCount);
+    file->writeUInt64(c_partition->indexByteCount);
+    file->writeUInt32(c_partition->indexSID);
+    file->writeUInt64(c_partition->bodyOffset);
+    file->writeUInt32(c_partition->bodySID);
+    file->writeUL(&c_partition->operationalPattern);
+    file->writeBatchHeader(num_labels, mxfUL_extlen);
+
+    MXFListIterator iter;
+    mxf_initialise_list_iter(&iter, &c_partition->essenceContainers);
+    while (mxf_next_list_iter_element(&iter))
+        file->writeUL((mxfUL*)mxf_get_iter_element(&iter));
+}
+
+
+
+string MXFOpenCache::GetCacheFilename(const string &cache_dir, const string &filename)
+{
+    // the cache filename includes a digest of the absolute filename to distinguish files with the same name
+    string abs_filename = get_abs_filename(get_cwd(), filename);
+    MD5Context md5_context;
+    unsigned char digest[16];
+    md5_init(&md5_context);
+    md5_update(&md5_context, (const unsigned char*)abs_filename.c_str(), (uint32_t)abs_filename.size());
+    md5_final(digest, &md5_context);
+
+    string cache_filename = cache_dir;
+    if (!cache_filename.empty() && !check_ends_with_dir_separator(cache_filename))
+        cache_filename.append("/");
+    cache_filename.append(strip_path(filename)).append(".").append(md5_digest_str(digest).substr(0, 16));
+    cache_filename.append(".bmxcache");
+
+    return cache_filename;
+}
+
+MXFOpenCache::MXFOpenCache(const string &cache_dir, const string &filename)
+{
+    mCacheDir = cache_dir;
+    mCacheFilename = GetCacheFilename(cache_dir, filename);
+    mFilename = filename;
+    mFallbackReader = 0;
+    mFileSize = 0;
+    mFileModTime = 0;
+    memset(mHeaderDigest, 0, sizeof(mHeaderDigest));
+    mIsLoaded = false;
+    mCacheFile = 0;
+    mIndexSID = 0;
+    mIndexTableOffset = 0;
+}
+
+MXFOpenCache::~MXFOpenCache()
+{
+    Clear();
+}
+
+void MXFOpenCache::SetFallbackReader(PartitionPackReader *reader)
+{
+    mFallbackReader = reader;
+}
+
+bool MXFOpenCache::Load(File *file)
+{
+    Clear();
+
+    if (!check_file_exists(mCacheFilename))
+        return false;
+
+    try
+    {
+        ReadFileIdentity(file);
+
+        MXFFile *mxf_file = 0;
+#if defined(_WIN32)
+#if !defined(__MINGW32__)
+        BMX_CHECK(mxf_win32_mmap_open_read(mCacheFilename.c_str(), 0, &mxf_file));
+#else
+        BMX_CHECK(mxf_win32_file_open_read(mCacheFilename.c_str(), 0, &mxf_file));
+#endif
+#else
+        BMX_CHECK(mxf_posix_mmap_open_read(mCacheFilename.c_str(), MXF_POSIX_MMAP_FLAG_DEFAULT, &mxf_file));
+#endif
+        mCacheFile = new File(mxf_file);
+
+        unsigned char magic[sizeof(CACHE_MAGIC)];
+        BMX_CHECK(mCacheFile->read(magic, sizeof(magic)) == sizeof(magic));
+        BMX_CHECK(memcmp(magic, CACHE_MAGIC, sizeof(magic)) == 0);
+        if (mCacheFile->readUInt32() != CACHE_VERSION) {
+            Clear();
+            return false;
+        }
+
+        // index entries are stored in host byte order
+        uint32_t byte_order;
+        BMX_CHECK(mCacheFile->read((unsigned char*)&byte_order, sizeof(byte_order)) == sizeof(byte_order));
+
+        // the cache is out of date if the file has changed
+        unsigned char header_digest[sizeof(mHeaderDigest)];
+        int64_t file_size = mCacheFile->readInt64();
+        int64_t file_mod_time = mCacheFile->readInt64();
+        BMX_CHECK(mCacheFile->read(header_digest, sizeof(header_digest)) == sizeof(header_digest));
+        if (byte_order != CACHE_BYTE_ORDER ||
+            file_size != mFileSize ||
+            file_mod_time != mFileModTime ||
+            memcmp(header_digest, mHeaderDigest, sizeof(header_digest)) != 0)
+        {
+            Clear();
+            return false;
+        }
+
+        mxfKey key;
+        uint8_t llen;
+        uint64_t len;
+        uint32_t num_partitions = mCacheFile->readUInt32();
+        uint32_t i;
+        for (i = 0; i < num_partitions; i++) {
+            mCacheFile->readKL(&key, &llen, &len);
+            BMX_CHECK(mxf_is_partition_pack(&key));
+            mPartitions.push_back(Partition::read(mCacheFile, &key, len));
+        }
+
+        mIndexSID = mCacheFile->readUInt32();
+        mIndexTableOffset = mCacheFile->tell();
+
+        mIsLoaded = true;
+    }
+    catch (...)
+    {
+        log_warn("Failed to load open cache file '%s'\n", mCacheFilename.c_str());
+        Clear();
+    }
+
+    return mIsLoaded;
+}
+
+bool MXFOpenCache::ReadIndexTable(uint32_t index_sid, IndexTableHelper *index_table)
+{
+    if (!mIsLoaded || mIndexSID == 0 || mIndexSID != index_sid)
+        return false;
+
+    try
+    {
+        mCacheFile->seek(mIndexTableOffset, SEEK_SET);
+        index_table->ReadCache(mCacheFile);
+    }
+    catch (...)
+    {
+        log_warn("Failed to read index table from open cache file '%s'\n", mCacheFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void MXFOpenCache::Save(File *file, uint32_t index_sid, IndexTableHelper *index_table)
+{
+    // write to a temporary file first so that a partially written cache file is never loaded. The temporary
+    // filename is unique to the process and the save so that concurrent saves of the same cache file don't clash
+    static std::atomic<uint32_t> save_count(0);
+    char temp_suffix[64];
+#if defined(_WIN32)
+    bmx_snprintf(temp_suffix, sizeof(temp_suffix), ".%d.%u.tmp", _getpid(), save_count++);
+#else
+    bmx_snprintf(temp_suffix, sizeof(temp_suffix), ".%d.%u.tmp", (int)getpid(), save_count++);
+#endif
+    string temp_filename = mCacheFilename + temp_suffix;
+    File *cache_file = 0;
+    try
+    {
+        ReadFileIdentity(file);
+
+        if (!mCacheDir.empty() && !check_is_dir(mCacheDir)) {
+#if defined(_WIN32)
+            if (_mkdir(mCacheDir.c_str()) != 0 && errno != EEXIST) {
+#else
+            if (mkdir(mCacheDir.c_str(), 0777) != 0 && errno != EEXIST) {
+#endif
+                throw BMXIOException("Failed to create open cache directory '%s': %s",
+                                     mCacheDir.c_str(), bmx_strerror(errno).c_str());
+            }
+        }
+
+        MXFFile *mxf_file = 0;
+        BMX_CHECK(mxf_disk_file_open_new(temp_filename.c_str(), &mxf_file));
+        cache_file = new File(mxf_file);
+
+        uint32_t byte_order = CACHE_BYTE_ORDER;
+        BMX_CHECK(cache_file->write(CACHE_MAGIC, sizeof(CACHE_MAGIC)) == sizeof(CACHE_MAGIC));
+        cache_file->writeUInt32(CACHE_VERSION);
+        BMX_CHECK(cache_file->write((const unsigned char*)&byte_order, sizeof(byte_order)) == sizeof(byte_order));
+        cache_file->writeInt64(mFileSize);
+        cache_file->writeInt64(mFileModTime);
+        BMX_CHECK(cache_file->write(mHeaderDigest, sizeof(mHeaderDigest)) == sizeof(mHeaderDigest));
+
+        // the header partition pack is not stored because it is always read from the file
+        const vector<Partition*> &partitions = file->getPartitions();
+        BMX_CHECK(!partitions.empty() && partitions[0]->isHeader());
+        cache_file->writeUInt32((uint32_t)(partitions.size() - 1));
+        size_t i;
+        for (i = 1; i < partitions.size(); i++)
+            write_partition_pack(cache_file, partitions[i]);
+
+        if (index_sid && index_table && index_table->CanWriteCache()) {
+            cache_file->writeUInt32(index_sid);
+            index_table->WriteCache(cache_file);
+        } else {
+            cache_file->writeUInt32(0);
+        }
+
+        delete cache_file;
+        cache_file = 0;
+
+        // the existing cache file is replaced atomically so that it is always available to other readers
+#if defined(_WIN32)
+        if (!MoveFileExA(temp_filename.c_str(), mCacheFilename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            throw BMXIOException("Failed to rename '%s' to '%s': error %lu",
+                                 temp_filename.c_str(), mCacheFilename.c_str(), GetLastError());
+        }
+#else
+        if (rename(temp_filename.c_str(), mCacheFilename.c_str()) != 0) {
+            throw BMXIOException("Failed to rename '%s' to '%s': %s",
+                                 temp_filename.c_str(), mCacheFilename.c_str(), bmx_strerror(errno).c_str());
+        }
+#endif
+    }
+    catch (...)
+    {
+        log_warn("Failed to write open cache file '%s'\n", mCacheFilename.c_str());
+        delete cache_file;
+        remove(temp_filename.c_str());
+    }
+}
+
+vector<Partition*> MXFOpenCache::readPartitionPacks(File *file, const vector<uint64_t> &offsets)
+{
+    if (mIsLoaded) {
+        bool match = (mPartitions.size() == offsets.size());
+        size_t i;
+        for (i = 0; match && i < offsets.size(); i++)
+            match = (mPartitions[i]->getThisPartition() == offsets[i]);
+        if (match) {
+            // transfer ownership of the cached partition packs to the file
+            vector<Partition*> partitions;
+            partitions.swap(mPartitions);
+            return partitions;
+        }
+
+        // the partitions listed in the RIP have changed and so the cache can't be used for the index table either
+        log_warn("Ignoring out of date open cache file '%s'\n", mCacheFilename.c_str());
+        Clear();
+    }
+
+    if (mFallbackReader)
+        return mFallbackReader->readPartitionPacks(file, offsets);
+
+    vector<Partition*> partitions;
+    try
+    {
+        mxfKey key;
+        uint8_t llen;
+        uint64_t len;
+        size_t i;
+        for (i = 0; i < offsets.size(); i++) {
+            file->seek(mxf_get_runin_len(file->getCFile()) + offsets[i], SEEK_SET);
+            file->readKL(&key, &llen, &len);
+            partitions.push_back(Partition::read(file, &key, len));
+        }
+    }
+    catch (...)
+    {
+        size_t i;
+        for (i = 0; i < partitions.size(); i++)
+            delete partitions[i];
+        throw;
+    }
+
+    return partitions;
+}
+
+void MXFOpenCache::ReadFileIdentity(File *file)
+{
+    mFileSize = file->size();
+    mFileModTime = get_file_mod_time(mFilename);
+
+    int64_t position = file->tell();
+
+    mxfKey key;
+    uint8_t llen;
+    uint64_t len;
+    file->seek(mxf_get_runin_len(file->getCFile()), SEEK_SET);
+    file->readKL(&key, &llen, &len);
+    BMX_CHECK(mxf_is_header_partition_pack(&key) && len >= 88 && len <= MAX_PARTITION_PACK_LEN);
+
+    vector<unsigned char> pack((size_t)len);
+    BMX_CHECK(file->read(&pack[0], (uint32_t)len) == len);
+
+    MD5Context md5_context;
+    md5_init(&md5_context);
+    md5_update(&md5_context, (const unsigned char*)&key, mxfKey_extlen);
+    md5_update(&md5_context, &pack[0], (uint32_t)len);
+    md5_final(mHeaderDigest, &md5_context);
+
+    file->seek(position, SEEK_SET);
+}
+
+void MXFOpenCache::Clear()
+{
+    size_t i;
+    for (i = 0; i < mPartitions.size(); i++)
+        delete mPartitions[i];
+    mPartitions.clear();
+
+    delete mCacheFile;
+    mCacheFile = 0;
+
+    mIndexSID = 0;
+    mIndexTableOffset = 0;
+    mIsLoaded = false;
+}
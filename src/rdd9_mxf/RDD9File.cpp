@@ -142,6 +142,7 @@ RDD9File::RDD9File(int flavour, File *mxf_file, Rational frame_rate)
 
     if (flavour & RDD9_SINGLE_PASS_MD5_WRITE_FLAVOUR) {
         mMXFChecksumFile = mxf_checksum_file_open(mMXFFile->getCFile(), MD5_CHECKSUM);
+        mxf_checksum_file_enable_async_update(mMXFChecksumFile);
         mMXFFile->swapCFile(mxf_checksum_file_get_file(mMXFChecksumFile));
     }
 
@@ -0,0 +1,79 @@
+# Test that writing an AS02 clip containing D10 video and 2 PCM tracks with each track file written on its own
+# thread (--track-threads) gives the same files as writing the tracks serially, with and without body partitions.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 30
+    audio_track_threads
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio essence: ${ret}")
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 11
+    -d 30
+    video_track_threads
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test video essence: ${ret}")
+endif()
+
+
+# Creates the clip in directory 'output_dir' and sets 'checksums_var' to the MD5 checksums of the clip files
+function(create_clip checksums_var output_dir options)
+    file(REMOVE_RECURSE ${output_dir})
+    file(MAKE_DIRECTORY ${output_dir})
+
+    execute_process(COMMAND ${RAW2BMX}
+        --regtest
+        -t as02
+        ${options}
+        --clip test
+        -o ${output_dir}/as02test
+        -a 16:9 --d10_50 video_track_threads
+        -q 16 --locked true --pcm audio_track_threads
+        -q 16 --locked true --pcm audio_track_threads
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create AS02 MXF file with options '${options}': ${ret}")
+    endif()
+
+    file(GLOB_RECURSE clip_files RELATIVE ${CMAKE_CURRENT_BINARY_DIR}/${output_dir} ${output_dir}/*)
+    list(SORT clip_files)
+    set(checksums)
+    foreach(clip_file ${clip_files})
+        file(MD5 ${output_dir}/${clip_file} checksum)
+        list(APPEND checksums "${clip_file}=${checksum}")
+    endforeach()
+
+    set(${checksums_var} "${checksums}" PARENT_SCOPE)
+endfunction()
+
+function(check_track_threads part_options)
+    create_clip(expected_checksums test_track_threads_serial "${part_options}")
+    create_clip(checksums test_track_threads "${part_options};--track-threads;2")
+
+    if(NOT expected_checksums)
+        message(FATAL_ERROR "No clip files were found")
+    endif()
+    if(NOT checksums STREQUAL expected_checksums)
+        message(FATAL_ERROR "Track threads checksums '${checksums}' != serial '${expected_checksums}'")
+    endif()
+endfunction()
+
+check_track_threads("")
+check_track_threads("--part;10")
@@ -0,0 +1,121 @@
+# Test the AS-10 MPEG-2 compliancy checks run on a separate thread (--mpeg-checks-thread) and on a sample of the GOPs
+# (--mpeg-checks-gop). The expected values in mpeg_checks_violations.txt result in a max GOP error for each complete
+# GOP and a bitrate warning for each sequence header. The video has 3 GOPs of 12 frames.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 42
+    -d 36
+    audio_checks
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio essence: ${ret}")
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 53
+    -d 36
+    video_checks
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test video essence: ${ret}")
+endif()
+
+
+# Creates the AS-10 file and sets 'checksum_var' to the file MD5 checksum, 'errors_var' and 'warnings_var' to the
+# logged violations and 'report_var' to the checked headers report
+function(create_file checksum_var errors_var warnings_var report_var output_file options)
+    set(audio_options)
+    foreach(i RANGE 1 8)
+        list(APPEND audio_options -q 24 --locked true --pcm audio_checks)
+    endforeach()
+
+    execute_process(COMMAND ${RAW2BMX}
+        --regtest
+        -t as10
+        -f 25
+        -y 22:22:22:22
+        --single-pass
+        --part 25
+        -o ${output_file}
+        --dm-file as10 ${TEST_SOURCE_DIR}/as10_core_framework.txt
+        --shim-name high_hd_2014
+        --mpeg-checks ${TEST_SOURCE_DIR}/mpeg_checks_violations.txt
+        --loose-checks
+        --max-same-warnings 100
+        --print-checks
+        ${options}
+        --mpeg2lg_422p_hl_1080i video_checks
+        ${audio_options}
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE error_output
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create AS-10 MXF file with options '${options}': ${ret}")
+    endif()
+
+    file(MD5 ${output_file} checksum)
+    string(REGEX MATCHALL "ERROR: [^\n]*" errors "${error_output}")
+    string(REGEX MATCHALL "Warning: [^\n]*" warnings "${output}")
+    string(FIND "${output}" "picture header" report_start)
+    if(report_start LESS 0)
+        message(FATAL_ERROR "Missing checked headers report with options '${options}'")
+    endif()
+    string(SUBSTRING "${output}" ${report_start} -1 report)
+
+    set(${checksum_var} ${checksum} PARENT_SCOPE)
+    set(${errors_var} "${errors}" PARENT_SCOPE)
+    set(${warnings_var} "${warnings}" PARENT_SCOPE)
+    set(${report_var} "${report}" PARENT_SCOPE)
+endfunction()
+
+function(check_count name list expected_count)
+    list(LENGTH list count)
+    if(NOT count EQUAL expected_count)
+        message(FATAL_ERROR "Found ${count} ${name} '${list}', expected ${expected_count}")
+    endif()
+endfunction()
+
+
+create_file(expected_checksum expected_errors expected_warnings expected_report test_checks_sync.mxf "")
+check_count("synchronous errors" "${expected_errors}" 2)
+check_count("synchronous warnings" "${expected_warnings}" 3)
+
+# the threaded checks report the same violations in the same order
+create_file(checksum errors warnings report test_checks_thread.mxf "--mpeg-checks-thread;4")
+if(NOT checksum STREQUAL expected_checksum)
+    message(FATAL_ERROR "Threaded checks file checksum ${checksum} != expected ${expected_checksum}")
+endif()
+if(NOT errors STREQUAL expected_errors OR NOT warnings STREQUAL expected_warnings)
+    message(FATAL_ERROR "Threaded checks violations '${errors};${warnings}' != expected '${expected_errors};${expected_warnings}'")
+endif()
+if(NOT report STREQUAL expected_report)
+    message(FATAL_ERROR "Threaded checks report '${report}' != expected '${expected_report}'")
+endif()
+
+# checking every 2nd GOP checks GOPs 1 and 3. The max GOP is only known after the first GOP and so only the GOP 3
+# error is reported
+create_file(checksum errors warnings report test_checks_gop.mxf "--mpeg-checks-gop;2")
+if(NOT checksum STREQUAL expected_checksum)
+    message(FATAL_ERROR "GOP sampled checks file checksum ${checksum} != expected ${expected_checksum}")
+endif()
+check_count("GOP sampled errors" "${errors}" 1)
+check_count("GOP sampled warnings" "${warnings}" 2)
+foreach(violation ${errors} ${warnings})
+    list(FIND expected_errors "${violation}" error_index)
+    list(FIND expected_warnings "${violation}" warning_index)
+    if(error_index LESS 0 AND warning_index LESS 0)
+        message(FATAL_ERROR "GOP sampled checks violation '${violation}' not reported by synchronous checks")
+    endif()
+endforeach()
@@ -4,7 +4,7 @@
 include("${TEST_SOURCE_DIR}/../testing.cmake")
 
 
-function(run_test test raw2bmx_type bmxtranswrap_type video_ess_type)
+function(run_test test raw2bmx_type bmxtranswrap_type video_ess_type transwrap_opts)
     if(TEST_MODE STREQUAL "check")
         set(output_file test.mxf)
     elseif(TEST_MODE STREQUAL "samples")
@@ -41,6 +41,7 @@ function(run_test test raw2bmx_type bmxtranswrap_type video_ess_type)
     set(create_command_2 ${BMXTRANSWRAP}
         --regtest
         -t ${bmxtranswrap_type}
+        ${transwrap_opts}
         -o ${output_file}
         input.mxf
     )
@@ -90,5 +91,10 @@ foreach(index RANGE ${max_index})
     math(EXPR test_ess_type_index "${index} * 4 + 3")
     list(GET tests ${test_ess_type_index} test_ess_type)
 
-    run_test(${test} ${test_raw2bmx_type} ${test_bmxtranswrap_type} ${test_ess_type})
+    run_test(${test} ${test_raw2bmx_type} ${test_bmxtranswrap_type} ${test_ess_type} "")
+
+    # the pipelined transfer must produce the same output as the serial transfer
+    if(TEST_MODE STREQUAL "check")
+        run_test(${test} ${test_raw2bmx_type} ${test_bmxtranswrap_type} ${test_ess_type} "--pipeline")
+    endif()
 endforeach()
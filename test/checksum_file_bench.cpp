@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <mxf/mxf.h>
+
+#include <bmx/MXFChecksumFile.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+static const unsigned char FRAME_KEY[16] =
+    {0x06, 0x0e, 0x2b, 0x34, 0x01, 0x02, 0x01, 0x01, 0x0d, 0x01, 0x03, 0x01, 0x15, 0x01, 0x05, 0x01};
+
+
+typedef struct
+{
+    double rate;
+    string digest;
+} Result;
+
+
+static bool run(const char *filename, bool async_update, const vector<unsigned char> &frame, uint32_t num_frames,
+                Result *result)
+{
+    MXFFile *target;
+    if (!mxf_disk_file_open_new(filename, &target)) {
+        fprintf(stderr, "Failed to open '%s'\n", filename);
+        return false;
+    }
+
+    MXFChecksumFile *checksum_file = mxf_checksum_file_open(target, MD5_CHECKSUM);
+    MXFFile *mxf_file = mxf_checksum_file_get_file(checksum_file);
+    if (async_update)
+        mxf_checksum_file_enable_async_update(checksum_file);
+
+    // write KLV triplets using separate key, length and value writes, similar to the MXF writers
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool write_ok = true;
+    uint32_t i;
+    for (i = 0; i < num_frames && write_ok; i++) {
+        write_ok = mxf_file_write(mxf_file, FRAME_KEY, sizeof(FRAME_KEY)) == sizeof(FRAME_KEY) &&
+                   mxf_write_fixed_l(mxf_file, 4, frame.size()) &&
+                   mxf_file_write(mxf_file, &frame[0], (uint32_t)frame.size()) == frame.size();
+    }
+    if (write_ok)
+        write_ok = mxf_checksum_file_final(checksum_file);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    if (write_ok)
+        result->digest = mxf_checksum_file_digest_str(checksum_file);
+    mxf_file_close(&mxf_file);
+    if (!write_ok) {
+        fprintf(stderr, "Failed to write to '%s'\n", filename);
+        return false;
+    }
+
+    double secs = chrono::duration<double>(end - start).count();
+    result->rate = 0.0;
+    if (secs > 0.0)
+        result->rate = (double)(frame.size() + 20) * num_frames / secs / (1024.0 * 1024.0);
+
+    return true;
+}
+
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Measures the single-pass MD5 write rate with inline and async checksum updates\n");
+    fprintf(stderr, "Usage: %s [-n <frames>] [-s <size>] [-o <filename>]\n", cmd);
+    fprintf(stderr, "  -n <frames>    Number of frames. Default 500\n");
+    fprintf(stderr, "  -s <size>      Frame size in bytes. Default 1000000\n");
+    fprintf(stderr, "  -o <filename>  Output filename. Default '/dev/null'\n");
+}
+
+int main(int argc, const char **argv)
+{
+    const char *filename = "/dev/null";
+    uint32_t num_frames = 500;
+    uint32_t frame_size = 1000000;
+    int cmdln_index;
+    size_t i;
+
+    for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+        if (strcmp(argv[cmdln_index], "-n") == 0 ||
+            strcmp(argv[cmdln_index], "-s") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            uint32_t value;
+            if (sscanf(argv[cmdln_index + 1], "%u", &value) != 1 || value == 0) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Invalid argument '%s' for '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            if (argv[cmdln_index][1] == 'n')
+                num_frames = value;
+            else
+                frame_size = value;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "-o") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            filename = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            fprintf(stderr, "Unknown argument '%s'\n", argv[cmdln_index]);
+            return 1;
+        }
+    }
+
+    vector<unsigned char> frame(frame_size);
+    srand(1);
+    for (i = 0; i < frame.size(); i++)
+        frame[i] = (unsigned char)(rand() >> 4);
+
+    Result inline_result, async_result;
+    try
+    {
+        if (!run(filename, false, frame, num_frames, &inline_result) ||
+            !run(filename, true, frame, num_frames, &async_result))
+        {
+            return 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        return 1;
+    }
+
+    printf("%u frames of %u bytes:\n", num_frames, frame_size);
+    printf("  %-8s %12.1f MiB/s  %s\n", "inline", inline_result.rate, inline_result.digest.c_str());
+    printf("  %-8s %12.1f MiB/s  %s\n", "async", async_result.rate, async_result.digest.c_str());
+
+    if (async_result.digest != inline_result.digest) {
+        fprintf(stderr, "MD5 digests differ\n");
+        return 1;
+    }
+
+    return 0;
+}
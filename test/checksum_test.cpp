@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <bmx/Checksum.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+// larger than a few of the 256 KiB CalcFileChecksums read buffers and not a multiple of the block sizes
+#define FILE_SIZE   (3 * 256 * 1024 + 4099)
+
+
+typedef struct
+{
+    const char *data;
+    uint32_t repeat;
+    uint32_t crc32;
+    const char *sha1;
+} TestVector;
+
+static const TestVector TEST_VECTORS[] =
+{
+    {"",                                                            1,          0x00000000,
+        "da39a3ee5e6b4b0d3255bfef95601890afd80709"},
+    {"abc",                                                         1,          0x352441c2,
+        "a9993e364706816aba3e25717850c26c9cd0d89d"},
+    {"123456789",                                                   1,          0xcbf43926,
+        "f7c3bc1d808e04732adf679965ccc34ca7ae3441"},
+    {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",    1,          0x171a3f5f,
+        "84983e441c3bd26ebaae4aa1f95129e5e54670f1"},
+    {"a",                                                           1000000,    0xdc25bfbc,
+        "34aa973cd4c4daa4f61eeb2bdbad27316534016f"},
+};
+
+
+static uint32_t next_random(uint32_t *state)
+{
+    *state = *state * 1103515245 + 12345;
+    return (*state >> 16) & 0x7fff;
+}
+
+static void create_random_data(vector<unsigned char> *data, size_t size, uint32_t seed)
+{
+    uint32_t state = seed;
+    data->resize(size);
+    size_t i;
+    for (i = 0; i < size; i++)
+        (*data)[i] = (unsigned char)next_random(&state);
+}
+
+// splits the data into random sizes, including sizes below and above the 64 byte blocks and some empty updates
+static void create_random_splits(vector<uint32_t> *sizes, size_t total_size, uint32_t seed)
+{
+    uint32_t state = seed;
+    size_t remaining = total_size;
+    sizes->clear();
+    while (remaining > 0) {
+        uint32_t size;
+        switch (next_random(&state) % 4)
+        {
+            case 0:  size = 0;                                      break;
+            case 1:  size = next_random(&state) % 64;               break;
+            case 2:  size = next_random(&state) % 300;              break;
+            default: size = next_random(&state) * 4 % 70000;        break;
+        }
+        if (size > remaining)
+            size = (uint32_t)remaining;
+        sizes->push_back(size);
+        remaining -= size;
+    }
+}
+
+static bool check_crc32_vectors()
+{
+    bool passed = true;
+    size_t i, k;
+    for (k = 0; k < crc32_get_num_update_impls(); k++) {
+        const char *name;
+        CRC32UpdateFunc update_func = crc32_get_update_impl(k, &name);
+        for (i = 0; i < sizeof(TEST_VECTORS) / sizeof(TEST_VECTORS[0]); i++) {
+            const TestVector &vector = TEST_VECTORS[i];
+            string data;
+            uint32_t r;
+            for (r = 0; r < vector.repeat; r++)
+                data += vector.data;
+
+            uint32_t crc32;
+            crc32_init(&crc32);
+            crc32 = update_func(crc32, (const unsigned char*)data.c_str(), data.size());
+            crc32_final(&crc32);
+            if (crc32 != vector.crc32) {
+                fprintf(stderr, "CRC-32 '%s' of vector %u is %08x rather than %08x\n",
+                        name, (unsigned int)i, crc32, vector.crc32);
+                passed = false;
+            }
+        }
+    }
+
+    return passed;
+}
+
+static bool check_crc32_impls(const vector<unsigned char> &data)
+{
+    // check all sizes either side of the 64 byte folding threshold and 16 byte remainders at different alignments
+    bool passed = true;
+    CRC32UpdateFunc portable_func = crc32_get_update_impl(0, 0);
+    size_t k, offset, size;
+    for (k = 1; k < crc32_get_num_update_impls(); k++) {
+        const char *name;
+        CRC32UpdateFunc update_func = crc32_get_update_impl(k, &name);
+        for (offset = 0; offset < 16 && passed; offset++) {
+            for (size = 0; size <= 300 && passed; size++) {
+                uint32_t expected = portable_func(0xffffffff, &data[offset], size);
+                uint32_t crc32 = update_func(0xffffffff, &data[offset], size);
+                if (crc32 != expected) {
+                    fprintf(stderr, "CRC-32 '%s' of %u bytes at offset %u differs\n",
+                            name, (unsigned int)size, (unsigned int)offset);
+                    passed = false;
+                }
+            }
+        }
+        if (update_func(0xffffffff, &data[1], data.size() - 1) != portable_func(0xffffffff, &data[1], data.size() - 1)) {
+            fprintf(stderr, "CRC-32 '%s' of the data differs\n", name);
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+static bool check_sha1_vectors()
+{
+    bool passed = true;
+    size_t i;
+    for (i = 0; i < sizeof(TEST_VECTORS) / sizeof(TEST_VECTORS[0]); i++) {
+        const TestVector &vector = TEST_VECTORS[i];
+        string data;
+        uint32_t r;
+        for (r = 0; r < vector.repeat; r++)
+            data += vector.data;
+
+        SHA1Context context;
+        unsigned char digest[20];
+        sha1_init(&context);
+        sha1_update(&context, (const unsigned char*)data.c_str(), (uint32_t)data.size());
+        sha1_final(digest, &context);
+        if (sha1_digest_str(digest) != vector.sha1) {
+            fprintf(stderr, "SHA-1 of vector %u is %s rather than %s\n",
+                    (unsigned int)i, sha1_digest_str(digest).c_str(), vector.sha1);
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+static bool check_sha1_impls(const vector<unsigned char> &data)
+{
+    // transform 1 to 16 blocks from a random state at different alignments
+    bool passed = true;
+    SHA1TransformFunc portable_func = sha1_get_transform_impl(0, 0);
+    uint32_t random_state = 7;
+    size_t k, offset, num_blocks;
+    for (k = 1; k < sha1_get_num_transform_impls(); k++) {
+        const char *name;
+        SHA1TransformFunc transform_func = sha1_get_transform_impl(k, &name);
+        for (offset = 0; offset < 16 && passed; offset++) {
+            for (num_blocks = 1; num_blocks <= 16 && passed; num_blocks++) {
+                uint32_t expected[5];
+                uint32_t state[5];
+                int i;
+                for (i = 0; i < 5; i++) {
+                    expected[i] = (next_random(&random_state) << 17) ^ next_random(&random_state);
+                    state[i] = expected[i];
+                }
+                portable_func(expected, &data[offset], num_blocks);
+                transform_func(state, &data[offset], num_blocks);
+                if (memcmp(state, expected, sizeof(state)) != 0) {
+                    fprintf(stderr, "SHA-1 transform '%s' of %u blocks at offset %u differs\n",
+                            name, (unsigned int)num_blocks, (unsigned int)offset);
+                    passed = false;
+                }
+            }
+        }
+    }
+
+    return passed;
+}
+
+static bool check_split_updates(const vector<unsigned char> &data)
+{
+    // the digest of random size updates must equal the digest of a single update
+    static const ChecksumType types[] = {CRC32_CHECKSUM, MD5_CHECKSUM, SHA1_CHECKSUM};
+    static const char *type_names[] = {"CRC-32", "MD5", "SHA-1"};
+
+    bool passed = true;
+    uint32_t seed;
+    size_t i;
+    for (seed = 1; seed <= 20; seed++) {
+        vector<uint32_t> sizes;
+        create_random_splits(&sizes, data.size(), seed);
+        for (i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+            Checksum expected(types[i]);
+            expected.Update(&data[0], (uint32_t)data.size());
+            expected.Final();
+
+            Checksum checksum(types[i]);
+            size_t offset = 0;
+            size_t s;
+            for (s = 0; s < sizes.size(); s++) {
+                checksum.Update(&data[offset], sizes[s]);
+                offset += sizes[s];
+            }
+            checksum.Final();
+
+            if (checksum.GetDigestString() != expected.GetDigestString()) {
+                fprintf(stderr, "%s of %u random size updates (seed %u) differs\n",
+                        type_names[i], (unsigned int)sizes.size(), seed);
+                passed = false;
+            }
+        }
+    }
+
+    return passed;
+}
+
+static bool check_file_checksums(const vector<unsigned char> &data, const char *filename)
+{
+    // CalcFileChecksums calculates multiple types in parallel threads and a single type in the calling thread
+    static const ChecksumType types[] = {CRC32_CHECKSUM, MD5_CHECKSUM, SHA1_CHECKSUM};
+
+    FILE *file = fopen(filename, "wb");
+    if (!file || fwrite(&data[0], 1, data.size(), file) != data.size()) {
+        fprintf(stderr, "Failed to write test file '%s'\n", filename);
+        if (file)
+            fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    vector<ChecksumType> all_types(types, types + sizeof(types) / sizeof(types[0]));
+    vector<string> expected;
+    size_t i;
+    for (i = 0; i < all_types.size(); i++) {
+        Checksum checksum(all_types[i]);
+        checksum.Update(&data[0], (uint32_t)data.size());
+        checksum.Final();
+        expected.push_back(checksum.GetDigestString());
+    }
+
+    bool passed = true;
+    vector<string> digests = Checksum::CalcFileChecksums(filename, all_types);
+    if (digests != expected) {
+        fprintf(stderr, "Threaded file checksums differ from the serial updates\n");
+        passed = false;
+    }
+    for (i = 0; i < all_types.size(); i++) {
+        if (Checksum::CalcFileChecksum(filename, all_types[i]) != expected[i]) {
+            fprintf(stderr, "File checksum type %u differs from the serial update\n", (unsigned int)i);
+            passed = false;
+        }
+    }
+
+    remove(filename);
+
+    return passed;
+}
+
+
+int main(int argc, const char **argv)
+{
+    const char *filename = "checksum_test.bin";
+    if (argc == 2) {
+        filename = argv[1];
+    } else if (argc > 2) {
+        fprintf(stderr, "Usage: %s [<test filename>]\n", argv[0]);
+        return 1;
+    }
+
+    vector<unsigned char> data;
+    create_random_data(&data, FILE_SIZE, 1);
+
+    size_t i;
+    printf("CRC-32 implementations:");
+    for (i = 0; i < crc32_get_num_update_impls(); i++) {
+        const char *name;
+        crc32_get_update_impl(i, &name);
+        printf(" %s", name);
+    }
+    printf("\nSHA-1 implementations:");
+    for (i = 0; i < sha1_get_num_transform_impls(); i++) {
+        const char *name;
+        sha1_get_transform_impl(i, &name);
+        printf(" %s", name);
+    }
+    printf("\n");
+
+    bool passed = true;
+    try
+    {
+        passed &= check_crc32_vectors();
+        passed &= check_crc32_impls(data);
+        passed &= check_sha1_vectors();
+        passed &= check_sha1_impls(data);
+        passed &= check_split_updates(data);
+        passed &= check_file_checksums(data, filename);
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception caught: %s\n", ex.what());
+        return 1;
+    }
+
+    if (!passed)
+        return 1;
+
+    printf("Passed\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define __STDC_FORMAT_MACROS
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <inttypes.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_INTERVAL    200
+
+
+// Grows <dest> by appending bytes from <source> that follow its current size. The file is grown to each <length>
+// in turn and then to the size of <source>, with a pause after each step. It is used to write a file while it is
+// being read with the --gf option.
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Usage: %s [-i <msec>] <source> <dest> [<length> ...]\n", cmd);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, " -i <msec>    Pause after each step in milliseconds. The default is %u\n", DEFAULT_INTERVAL);
+}
+
+static bool append(FILE *source, FILE *dest, int64_t length)
+{
+    unsigned char buffer[65536];
+    int64_t remainder = length - ftell(dest);
+    while (length < 0 || remainder > 0) {
+        size_t num_read = sizeof(buffer);
+        if (length >= 0 && remainder < (int64_t)num_read)
+            num_read = (size_t)remainder;
+        num_read = fread(buffer, 1, num_read, source);
+        if (num_read == 0)
+            break;
+
+        if (fwrite(buffer, 1, num_read, dest) != num_read)
+            return false;
+        remainder -= num_read;
+    }
+
+    return !ferror(source) && fflush(dest) == 0;
+}
+
+int main(int argc, const char **argv)
+{
+    const char *source_filename;
+    const char *dest_filename;
+    unsigned int interval = DEFAULT_INTERVAL;
+    std::vector<int64_t> lengths;
+    int cmdln_index;
+
+    cmdln_index = 1;
+    if (cmdln_index + 1 < argc && strcmp(argv[cmdln_index], "-i") == 0) {
+        if (sscanf(argv[cmdln_index + 1], "%u", &interval) != 1) {
+            print_usage(argv[0]);
+            fprintf(stderr, "Invalid interval %s\n", argv[cmdln_index + 1]);
+            return 1;
+        }
+        cmdln_index += 2;
+    }
+    if (cmdln_index + 2 > argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    source_filename = argv[cmdln_index];
+    dest_filename = argv[cmdln_index + 1];
+    for (cmdln_index += 2; cmdln_index < argc; cmdln_index++) {
+        int64_t length;
+        if (sscanf(argv[cmdln_index], "%" PRId64, &length) != 1 || length < 0 ||
+            (!lengths.empty() && length < lengths.back()))
+        {
+            print_usage(argv[0]);
+            fprintf(stderr, "Invalid <length> %s\n", argv[cmdln_index]);
+            return 1;
+        }
+        lengths.push_back(length);
+    }
+    lengths.push_back(-1);
+
+    FILE *source = fopen(source_filename, "rb");
+    if (!source) {
+        fprintf(stderr, "%s: failed to open file: %s\n", source_filename, strerror(errno));
+        return 1;
+    }
+    FILE *dest = fopen(dest_filename, "ab");
+    if (!dest) {
+        fprintf(stderr, "%s: failed to open file: %s\n", dest_filename, strerror(errno));
+        fclose(source);
+        return 1;
+    }
+
+    int res = 0;
+    if (fseek(dest, 0, SEEK_END) != 0 || fseek(source, ftell(dest), SEEK_SET) != 0) {
+        fprintf(stderr, "%s: failed to seek: %s\n", source_filename, strerror(errno));
+        res = 1;
+    }
+
+    size_t i;
+    for (i = 0; res == 0 && i < lengths.size(); i++) {
+        if (!append(source, dest, lengths[i])) {
+            fprintf(stderr, "%s: failed to append file: %s\n", dest_filename, strerror(errno));
+            res = 1;
+            break;
+        }
+
+        if (i + 1 < lengths.size())
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+    }
+
+    fclose(dest);
+    fclose(source);
+
+    return res;
+}
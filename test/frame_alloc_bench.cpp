@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <atomic>
+#include <new>
+
+#include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/frame/PooledFrame.h>
+#include <bmx/frame/SliceFrame.h>
+#include <bmx/apps/AppMXFFileFactory.h>
+#include <bmx/BMXException.h>
+#include <bmx/Logging.h>
+
+using namespace std;
+using namespace bmx;
+
+
+typedef enum
+{
+    DEFAULT_FRAMES,
+    POOLED_FRAMES,
+    SLICE_FRAMES,
+} FrameType;
+
+
+static atomic<uint64_t> g_num_allocs(0);
+
+
+void* operator new(size_t size)
+{
+    g_num_allocs++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+
+static bool run(const char *name, const char *filename, bool use_mmap_file, FrameType frame_type)
+{
+    AppMXFFileFactory file_factory;
+#if !defined(__MINGW32__)
+    file_factory.SetUseMMapFile(use_mmap_file);
+#else
+    if (use_mmap_file)
+        return true;
+#endif
+
+    MXFFileReader reader;
+    reader.SetFileFactory(&file_factory, false);
+    MXFFileReader::OpenResult result = reader.Open(filename);
+    if (result != MXFFileReader::MXF_RESULT_SUCCESS) {
+        fprintf(stderr, "%s: failed to open file: %s\n", filename, MXFFileReader::ResultToString(result).c_str());
+        return false;
+    }
+
+    size_t i;
+    for (i = 0; i < reader.GetNumTrackReaders(); i++) {
+        FrameFactory *frame_factory;
+        if (frame_type == SLICE_FRAMES)
+            frame_factory = new SliceFrameFactory();
+        else if (frame_type == POOLED_FRAMES)
+            frame_factory = new PooledFrameFactory();
+        else
+            frame_factory = new DefaultFrameFactory();
+        reader.GetTrackReader(i)->GetFrameBuffer()->SetFrameFactory(frame_factory, true);
+    }
+    reader.SetReadLimits();
+
+    // the first read fills the frame and slab pools
+    uint64_t num_frames = 0;
+    uint64_t num_bytes = 0;
+    uint64_t start_num_allocs = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (reader.Read(1)) {
+        for (i = 0; i < reader.GetNumTrackReaders(); i++) {
+            Frame *frame = reader.GetTrackReader(i)->GetFrameBuffer()->GetLastFrame(true);
+            if (frame) {
+                num_bytes += frame->GetSize();
+                delete frame;
+            }
+        }
+        if (num_frames == 0) {
+            start_num_allocs = g_num_allocs;
+            num_bytes = 0;
+            start = chrono::steady_clock::now();
+        }
+        num_frames++;
+    }
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    uint64_t num_allocs = g_num_allocs - start_num_allocs;
+
+    if (num_frames <= 1) {
+        fprintf(stderr, "%s: file needs more than 1 edit unit\n", filename);
+        return false;
+    }
+    num_frames--;
+
+    double secs = chrono::duration<double>(end - start).count();
+    double mbps = 0.0;
+    if (secs > 0.0)
+        mbps = (double)num_bytes / secs / (1024.0 * 1024.0);
+    printf("  %-14s %8.2f allocs/edit unit %12.1f MiB/s\n", name, (double)num_allocs / num_frames, mbps);
+
+    return true;
+}
+
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Measures the heap allocations per edit unit when reading frames from an MXF file\n");
+    fprintf(stderr, "Usage: %s <filename>+\n", cmd);
+}
+
+int main(int argc, const char **argv)
+{
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    LOG_LEVEL = WARN_LOG;
+
+    try
+    {
+        int cmdln_index;
+        for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+            printf("%s:\n", argv[cmdln_index]);
+            if (!run("default", argv[cmdln_index], false, DEFAULT_FRAMES) ||
+                !run("pooled", argv[cmdln_index], false, POOLED_FRAMES) ||
+                !run("slice", argv[cmdln_index], false, SLICE_FRAMES) ||
+                !run("slice + mmap", argv[cmdln_index], true, SLICE_FRAMES))
+            {
+                return 1;
+            }
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        return 1;
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,128 @@
+# Test reading an MXF OP1a file with --gf while it is growing. A truncated copy is grown in steps and the track
+# checksums are compared with those read from the complete file.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+set(complete_file test_append_complete.mxf)
+set(growing_file test_append_growing.mxf)
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 24
+    audio_append
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 14
+    -d 24
+    video_append
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test video: ${ret}")
+endif()
+
+execute_process(COMMAND ${RAW2BMX}
+    --regtest
+    -t op1a
+    -o ${complete_file}
+    --single-pass
+    --part 10
+    --mpeg2lg_422p_hl_1080i video_append
+    -q 16 --pcm audio_append
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create MXF file: ${ret}")
+endif()
+
+execute_process(COMMAND ${MXF2RAW}
+    --regtest
+    --track-chksum md5
+    ${complete_file}
+    OUTPUT_VARIABLE expected_output
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to read complete MXF file: ${ret}")
+endif()
+
+
+# The copy starts with the header partition only and is grown to each length in turn before growing to the complete
+# file. The lengths are the same file positions as in test_growing_file.cmake.
+#
+# * partial content package: the partially read frame is removed from the buffer before the read is retried,
+# * inside the index body partition and the next essence body partition pack,
+# * partial index segment after the last content package,
+# * partial footer header metadata.
+# The partition packs that were read before a failure are skipped when the read is retried.
+set(grow_lengths
+    1000000
+    2970200 2970700
+    5927581
+    5937554
+)
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${complete_file} ${growing_file}
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to copy test file: ${ret}")
+endif()
+
+execute_process(COMMAND ${FILE_TRUNCATE}
+    13592
+    ${growing_file}
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to truncate test file: ${ret}")
+endif()
+
+# --gf-rate removes the realtime rate limit after a failure so that the reader is waiting at the end of the file
+# when it grows
+execute_process(
+    COMMAND ${FILE_APPEND}
+        -i 200
+        ${complete_file}
+        ${growing_file}
+        ${grow_lengths}
+    COMMAND ${MXF2RAW}
+        --regtest
+        --gf
+        --gf-delay 0.5
+        --gf-retries 2
+        --gf-rate 100
+        --track-chksum md5
+        ${growing_file}
+    OUTPUT_VARIABLE read_output
+    RESULTS_VARIABLE rets
+)
+if(NOT rets STREQUAL "0;0")
+    message(FATAL_ERROR "Failed to read growing MXF file: ${rets}")
+endif()
+
+string(REGEX MATCHALL "checksum[^\n]*" expected_checksums "${expected_output}")
+string(REGEX MATCHALL "checksum[^\n]*" checksums "${read_output}")
+if(NOT checksums STREQUAL expected_checksums)
+    message(FATAL_ERROR "Growing file checksums '${checksums}' != expected '${expected_checksums}'")
+endif()
+
+string(REGEX MATCH "Read [0-9]+ samples" expected_samples "${expected_output}")
+string(REGEX MATCH "Read [0-9]+ samples" samples "${read_output}")
+if(NOT samples STREQUAL expected_samples)
+    message(FATAL_ERROR "Growing file '${samples}' != expected '${expected_samples}'")
+endif()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+#
+# Serves an MXF file from a local HTTP server that supports byte range requests and checks that
+# mxf2raw gives the same output when reading the file over HTTP as when reading the local file.
+#
+# Usage: http_range_test.py <mxf2raw> <mxf file>
+
+import http.server
+import os
+import pathlib
+import re
+import subprocess
+import sys
+import threading
+
+
+MXF2RAW_TIMEOUT = 120
+
+
+class RangeRequestHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    served_filename = None
+
+    def log_message(self, format, *args):
+        pass
+
+    def send_file_headers(self):
+        file_size = os.path.getsize(self.served_filename)
+        first = 0
+        last = file_size - 1
+
+        range_header = self.headers.get('Range')
+        if range_header is not None:
+            match = re.match(r'bytes=(\d*)-(\d*)$', range_header.strip())
+            if not match or (not match.group(1) and not match.group(2)):
+                self.send_error(400, 'Invalid range')
+                return None
+            if match.group(1):
+                first = int(match.group(1))
+                if match.group(2):
+                    last = min(int(match.group(2)), file_size - 1)
+            else:
+                first = max(file_size - int(match.group(2)), 0)
+            if first >= file_size or first > last:
+                self.send_response(416)
+                self.send_header('Content-Range', 'bytes */%d' % file_size)
+                self.send_header('Content-Length', '0')
+                self.end_headers()
+                return None
+            self.send_response(206)
+            self.send_header('Content-Range', 'bytes %d-%d/%d' % (first, last, file_size))
+        else:
+            self.send_response(200)
+
+        self.send_header('Accept-Ranges', 'bytes')
+        self.send_header('Content-Type', 'application/mxf')
+        self.send_header('Content-Length', str(last - first + 1))
+        self.end_headers()
+
+        return (first, last)
+
+    def do_HEAD(self):
+        self.send_file_headers()
+
+    def do_GET(self):
+        file_range = self.send_file_headers()
+        if file_range is None:
+            return
+
+        first, last = file_range
+        with open(self.served_filename, 'rb') as served_file:
+            served_file.seek(first)
+            remaining = last - first + 1
+            while remaining > 0:
+                data = served_file.read(min(remaining, 65536))
+                if not data:
+                    # the client would otherwise wait for the rest of the content
+                    self.close_connection = True
+                    break
+                try:
+                    self.wfile.write(data)
+                except (BrokenPipeError, ConnectionResetError):
+                    # the client cancelled a read-ahead request
+                    return
+                remaining -= len(data)
+
+
+def run_mxf2raw(mxf2raw, options, input_name, input_uri):
+    command = [mxf2raw, '--regtest'] + options + [input_name]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=MXF2RAW_TIMEOUT)
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr.decode(errors='replace'))
+        raise RuntimeError('mxf2raw failed with %d: %s' % (result.returncode, ' '.join(command)))
+
+    # the input file URI is reported in the info output
+    return result.stdout.decode(errors='replace').replace(input_uri, '<input>')
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('Usage: %s <mxf2raw> <mxf file>\n' % sys.argv[0])
+        return 1
+
+    mxf2raw = sys.argv[1]
+    mxf_filename = os.path.abspath(sys.argv[2])
+
+    RangeRequestHandler.served_filename = mxf_filename
+    server = http.server.ThreadingHTTPServer(('127.0.0.1', 0), RangeRequestHandler)
+    server.daemon_threads = True
+    server_thread = threading.Thread(target=server.serve_forever)
+    server_thread.daemon = True
+    server_thread.start()
+
+    url = 'http://127.0.0.1:%d/%s' % (server.server_address[1], os.path.basename(mxf_filename))
+    file_uri = pathlib.Path(mxf_filename).as_uri()
+
+    # the read options cover a sequential read, reads that start part way through the file, a read
+    # with small blocks and a single read-ahead request so that cached blocks are evicted, and reads
+    # that open additional connections to read the partitions and essence concurrently
+    read_options = [
+        ['--info', '--track-chksum', 'md5'],
+        ['--track-chksum', 'md5', '--start', '37', '--dur', '20'],
+        ['--track-chksum', 'md5', '--start', '80'],
+    ]
+    http_options = [
+        [],
+        ['--http-read-ahead', '0'],
+        ['--http-min-read', '4096', '--http-read-ahead', '1'],
+        ['--open-threads', '4'],
+        ['--read-ahead', '8'],
+        ['--open-threads', '4', '--read-ahead', '8'],
+    ]
+
+    failed = False
+    try:
+        for options in read_options:
+            expected = run_mxf2raw(mxf2raw, options, mxf_filename, file_uri)
+            for extra_options in http_options:
+                output = run_mxf2raw(mxf2raw, extra_options + options, url, url)
+                if output != expected:
+                    sys.stderr.write('HTTP output differs for options: %s\n' % ' '.join(extra_options + options))
+                    failed = True
+    finally:
+        server.shutdown()
+        server.server_close()
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
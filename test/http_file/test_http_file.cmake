@@ -0,0 +1,64 @@
+# Test reading an MXF OP1a file over HTTP with range requests gives the same output as reading the
+# local file.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+if(TEST_MODE STREQUAL "samples")
+    file(MAKE_DIRECTORY ${BMX_TEST_SAMPLES_DIR})
+
+    set(output_file ${BMX_TEST_SAMPLES_DIR}/test_http_file.mxf)
+else()
+    set(output_file test.mxf)
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 1
+    -d 100
+    audio
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test audio: ${ret}")
+endif()
+
+execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+    -t 14
+    -d 100
+    video
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create test video: ${ret}")
+endif()
+
+execute_process(COMMAND ${RAW2BMX}
+    --regtest
+    -t op1a
+    -o ${output_file}
+    --single-pass
+    --part 25
+    --mpeg2lg_422p_hl_1080i video
+    -q 16 --pcm audio
+    -q 16 --pcm audio
+    OUTPUT_QUIET
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Failed to create MXF file: ${ret}")
+endif()
+
+# There is no test data to create as the HTTP output is compared with the local file output
+if(TEST_MODE STREQUAL "check")
+    execute_process(COMMAND ${PYTHON3}
+        ${TEST_SOURCE_DIR}/http_range_test.py
+        ${MXF2RAW}
+        ${output_file}
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "HTTP read output differs from the local file output: ${ret}")
+    endif()
+endif()
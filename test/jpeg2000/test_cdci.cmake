@@ -109,3 +109,59 @@ run_test_a(
     "${output_info_file_2};info_2.xml.bin"
     ""
 )
+
+
+# Check that prefetching the file pattern and using the file sizes as frame sizes creates the same file as test 1
+if(NOT TEST_MODE STREQUAL "samples")
+    set(output_file_3 test_3.mxf)
+    set(output_info_file_3 info_3.xml)
+
+    set(create_command ${RAW2BMX}
+        --regtest
+        -t imf
+        -o ${output_file_3}
+        --clip test
+        -f 25
+        -a 16:9
+        --frame-layout fullframe
+        --transfer-ch hlg
+        --coding-eq bt2020
+        --color-prim bt2020
+        --color-siting cositing
+        --black-level 64
+        --white-level 940
+        --color-range 897
+        --display-primaries 35400,14600,8500,39850,6550,2300
+        --display-white-point 15635,16450
+        --display-max-luma 10000000
+        --display-min-luma 50
+        --fill-pattern-gaps
+        --pattern-prefetch 2
+        --pattern-frame-files
+        --j2c_cdci "${TEST_SOURCE_DIR}/image_yuv_%d.j2c"
+    )
+
+    set(read_command ${MXF2RAW}
+        --regtest
+        --info
+        --info-format xml
+        --info-file ${output_info_file_3}
+        ${output_file_3}
+    )
+
+    run_test_a(
+        "check"
+        "${BMX_TEST_WITH_VALGRIND}"
+        ""
+        ""
+        ""
+        "${create_command}"
+        ""
+        ""
+        "${read_command}"
+        "${output_file_3}"
+        "test_1.md5"
+        "${output_info_file_3};info_1.xml.bin"
+        ""
+    )
+endif()
@@ -0,0 +1,92 @@
+# Functions for testing that mxf2raw read options give the same output as a plain read.
+# There is no test data to create because the outputs are compared with each other.
+
+include("${TEST_SOURCE_DIR}/../testing.cmake")
+
+
+function(run_command)
+    execute_process(COMMAND ${ARGN}
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Command failed with ${ret}: ${ARGN}")
+    endif()
+endfunction()
+
+# Create the test essence used by the create_*_file functions. The files are named using the test so that the tests
+# can run in parallel
+function(create_test_essence test duration)
+    run_command(${CREATE_TEST_ESSENCE} -t 1 -d ${duration} audio_${test})
+    run_command(${CREATE_TEST_ESSENCE} -t 54 -d ${duration} video_${test})
+endfunction()
+
+# Create a frame wrapped OP1a file with VC-2 video and 2 PCM tracks and a body partition and index table segment
+# every 25 frames
+function(create_op1a_file test output_file)
+    run_command(${RAW2BMX}
+        --regtest
+        -t op1a
+        -o ${output_file}
+        --part 25
+        --vc2 video_${test}
+        -q 16 --pcm audio_${test}
+        -q 16 --pcm audio_${test}
+    )
+endfunction()
+
+# Set the output variable to the mxf2raw info and track checksums for the file read using the options
+function(read_info_and_checksums output_var input_file options)
+    execute_process(COMMAND ${MXF2RAW}
+        --regtest
+        --info
+        --track-chksum md5
+        ${options}
+        ${input_file}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "mxf2raw failed with ${ret} reading '${input_file}' using '${options}'")
+    endif()
+    set(${output_var} "${output}" PARENT_SCOPE)
+endfunction()
+
+# Check that the info and track checksums read using the test options are the same as those read using the read
+# options only
+function(check_info_and_checksums input_file read_options test_options)
+    read_info_and_checksums(expected ${input_file} "${read_options}")
+    read_info_and_checksums(output ${input_file} "${read_options};${test_options}")
+    if(NOT output STREQUAL expected)
+        message(FATAL_ERROR "Reading '${input_file}' using '${read_options};${test_options}' gives different "
+                            "output to '${read_options}'")
+    endif()
+endfunction()
+
+# Check that the essence files extracted using the test options are the same as those extracted using the read
+# options only
+function(check_essence_files input_file read_options test_options)
+    get_filename_component(name ${input_file} NAME_WE)
+    set(expected_dir ess_expected_${name})
+    set(output_dir ess_output_${name})
+
+    file(REMOVE_RECURSE ${expected_dir} ${output_dir})
+    file(MAKE_DIRECTORY ${expected_dir} ${output_dir})
+    run_command(${MXF2RAW} --regtest ${read_options} --ess-out ${expected_dir}/output ${input_file})
+    run_command(${MXF2RAW} --regtest ${read_options} ${test_options} --ess-out ${output_dir}/output ${input_file})
+
+    file(GLOB expected_files RELATIVE ${CMAKE_CURRENT_BINARY_DIR}/${expected_dir} ${expected_dir}/*)
+    file(GLOB output_files RELATIVE ${CMAKE_CURRENT_BINARY_DIR}/${output_dir} ${output_dir}/*)
+    if(NOT output_files STREQUAL expected_files)
+        message(FATAL_ERROR "Extracting '${input_file}' using '${read_options};${test_options}' gives different "
+                            "files '${output_files}' to '${expected_files}'")
+    endif()
+    foreach(ess_file ${expected_files})
+        file(MD5 ${expected_dir}/${ess_file} expected)
+        file(MD5 ${output_dir}/${ess_file} output)
+        if(NOT output STREQUAL expected)
+            message(FATAL_ERROR "Extracting '${input_file}' using '${read_options};${test_options}' gives a "
+                                "different '${ess_file}'")
+        endif()
+    endforeach()
+endfunction()
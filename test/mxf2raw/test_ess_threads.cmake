@@ -0,0 +1,26 @@
+# Test that extracting essence using multiple threads gives the same essence files as a single thread.
+# The PCM and clip wrapped tracks are written directly to the track files and the frame wrapped VC-2 track uses
+# part files.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+create_test_essence(ess_threads 1000)
+create_op1a_file(ess_threads test_ess_threads.mxf)
+run_command(${RAW2BMX}
+    --regtest
+    -t op1a
+    --clip-wrap
+    -o test_ess_threads_clip.mxf
+    -q 16 --pcm audio_ess_threads
+)
+
+foreach(input_file test_ess_threads.mxf test_ess_threads_clip.mxf)
+    check_essence_files(${input_file} "" "--ess-threads;8")
+    check_essence_files(${input_file} "--deint;--wrap-klv;av" "--ess-threads;8")
+    check_essence_files(${input_file} "--start;17;--dur;633" "--ess-threads;3")
+endforeach()
@@ -0,0 +1,38 @@
+# Test that reading the files in a group on multiple threads gives the same info and track checksums as reading them
+# serially. The group has 3 files with different essence so that the files are not shared evenly between 2 threads
+# and a mix-up of the file reads changes the track checksums.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+create_test_essence(group_threads 1000)
+run_command(${CREATE_TEST_ESSENCE} -t 42 -d 1000 audio_24bit_group_threads)
+run_command(${CREATE_TEST_ESSENCE} -t 11 -d 1000 video_d10_group_threads)
+
+create_op1a_file(group_threads test_group_threads_1.mxf)
+run_command(${RAW2BMX}
+    --regtest
+    -t op1a
+    -o test_group_threads_2.mxf
+    --part 25
+    -q 24 --pcm audio_24bit_group_threads
+)
+run_command(${RAW2BMX}
+    --regtest
+    -t op1a
+    -o test_group_threads_3.mxf
+    --part 25
+    --d10_50 video_d10_group_threads
+)
+
+set(group_files test_group_threads_1.mxf test_group_threads_2.mxf test_group_threads_3.mxf)
+
+check_info_and_checksums("${group_files}" "--group" "--group-threads;2")
+check_info_and_checksums("${group_files}" "--group" "--group-threads;3")
+check_info_and_checksums("${group_files}" "--group" "--group-threads;8")
+check_info_and_checksums("${group_files}" "--group;--start;517;--dur;333" "--group-threads;2")
+check_info_and_checksums("${group_files}" "--group;--start;990" "--group-threads;3")
@@ -0,0 +1,20 @@
+# Test that reading the index table entries on demand gives the same info and track checksums as reading them when
+# opening the file. The file has 40 index table segments with 275 bytes of entries each and a 0.003 MiB limit
+# results in segments being unloaded and loaded again.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+create_test_essence(lazy_index 1000)
+create_op1a_file(lazy_index test_lazy_index.mxf)
+
+check_info_and_checksums(test_lazy_index.mxf "" "--lazy-index;0")
+check_info_and_checksums(test_lazy_index.mxf "" "--lazy-index;1")
+check_info_and_checksums(test_lazy_index.mxf "" "--lazy-index;0.003")
+check_info_and_checksums(test_lazy_index.mxf "--start;517;--dur;333" "--lazy-index;0.001")
+check_info_and_checksums(test_lazy_index.mxf "" "--lazy-index;0.003;--open-threads;4")
+check_essence_files(test_lazy_index.mxf "" "--lazy-index;0.003;--ess-threads;3")
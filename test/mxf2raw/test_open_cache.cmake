@@ -0,0 +1,49 @@
+# Test that opening a file using the open cache gives the same info and track checksums as a normal open, and that
+# the cache is updated rather than used when the file has been touched or rewritten.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+# Check the output using the cache and set the output variable to the cache file digest
+function(check_open_cache output_var)
+    check_info_and_checksums(test_open_cache.mxf "" "--open-cache;cache_open_cache")
+
+    file(GLOB cache_files cache_open_cache/*)
+    list(LENGTH cache_files num_cache_files)
+    if(NOT num_cache_files EQUAL 1)
+        message(FATAL_ERROR "Expected 1 cache file but found '${cache_files}'")
+    endif()
+    file(MD5 ${cache_files} digest)
+    set(${output_var} ${digest} PARENT_SCOPE)
+endfunction()
+
+file(REMOVE_RECURSE cache_open_cache)
+file(MAKE_DIRECTORY cache_open_cache)
+
+create_test_essence(open_cache 1000)
+create_op1a_file(open_cache test_open_cache.mxf)
+
+# the first open creates the cache file and the second open uses it
+check_open_cache(created_digest)
+check_open_cache(used_digest)
+if(NOT used_digest STREQUAL created_digest)
+    message(FATAL_ERROR "Cache file was changed when opening an unchanged file")
+endif()
+
+# the modification time has sub-second resolution and so touching the file straight away invalidates the cache
+file(TOUCH test_open_cache.mxf)
+check_open_cache(touched_digest)
+if(touched_digest STREQUAL used_digest)
+    message(FATAL_ERROR "Cache file was not updated when opening a touched file")
+endif()
+
+create_test_essence(open_cache 900)
+create_op1a_file(open_cache test_open_cache.mxf)
+check_open_cache(rewritten_digest)
+if(rewritten_digest STREQUAL touched_digest)
+    message(FATAL_ERROR "Cache file was not updated when opening a rewritten file")
+endif()
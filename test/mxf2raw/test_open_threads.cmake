@@ -0,0 +1,15 @@
+# Test that opening a file using multiple threads gives the same info and track checksums as a single thread.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+create_test_essence(open_threads 1000)
+create_op1a_file(open_threads test_open_threads.mxf)
+
+check_info_and_checksums(test_open_threads.mxf "" "--open-threads;4")
+check_info_and_checksums(test_open_threads.mxf "--start;17;--dur;633" "--open-threads;3")
+check_essence_files(test_open_threads.mxf "" "--open-threads;4;--ess-threads;3")
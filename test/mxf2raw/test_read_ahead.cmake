@@ -0,0 +1,21 @@
+# Test that reading the essence ahead of the current position gives the same info and track checksums as a normal
+# read. The group reader and essence extraction threads result in multiple read-aheads sharing the thread pool.
+
+include("${TEST_SOURCE_DIR}/test_common.cmake")
+
+
+if(NOT TEST_MODE STREQUAL "check")
+    return()
+endif()
+
+create_test_essence(read_ahead 1000)
+create_op1a_file(read_ahead test_read_ahead.mxf)
+file(COPY test_read_ahead.mxf DESTINATION group_read_ahead)
+
+check_info_and_checksums(test_read_ahead.mxf "" "--read-ahead;1")
+check_info_and_checksums(test_read_ahead.mxf "" "--read-ahead;16")
+check_info_and_checksums(test_read_ahead.mxf "--start;17;--dur;633" "--read-ahead;8")
+check_info_and_checksums(test_read_ahead.mxf "--start;990" "--read-ahead;32")
+check_info_and_checksums("test_read_ahead.mxf;group_read_ahead/test_read_ahead.mxf" "--group" "--read-ahead;8")
+check_info_and_checksums("test_read_ahead.mxf;group_read_ahead/test_read_ahead.mxf" "--group;--start;333;--dur;100" "--group-threads;2;--read-ahead;8")
+check_essence_files(test_read_ahead.mxf "--start;17;--dur;633" "--read-ahead;8;--ess-threads;4")
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+#include <bmx/mxf_reader/MXFFileReader.h>
+#include <bmx/Utils.h>
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+typedef struct
+{
+    double min_msec;
+    double avg_msec;
+    int64_t duration;
+    bool is_complete;
+} Result;
+
+
+static bool run(const char *filename, uint32_t num_threads, const char *cache_dir, bool cold_cache, uint32_t repeats,
+                Result *result)
+{
+    result->min_msec = 0.0;
+    result->avg_msec = 0.0;
+
+    uint32_t i;
+    for (i = 0; i < repeats; i++) {
+        MXFFileReader reader;
+        reader.SetOpenThreads(num_threads);
+        if (cache_dir) {
+            reader.SetOpenCacheDir(cache_dir);
+            if (cold_cache)
+                remove(MXFOpenCache::GetCacheFilename(cache_dir, filename).c_str());
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        MXFFileReader::OpenResult open_result = reader.Open(filename);
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        if (open_result != MXFFileReader::MXF_RESULT_SUCCESS) {
+            fprintf(stderr, "Failed to open '%s': %s\n", filename, MXFFileReader::ResultToString(open_result).c_str());
+            return false;
+        }
+        // the warm cache timings are only valid if the cache file was written
+        if (cache_dir && !check_file_exists(MXFOpenCache::GetCacheFilename(cache_dir, filename))) {
+            fprintf(stderr, "No open cache file was written in '%s'\n", cache_dir);
+            return false;
+        }
+
+        double msec = chrono::duration<double, milli>(end - start).count();
+        if (i == 0 || msec < result->min_msec)
+            result->min_msec = msec;
+        result->avg_msec += msec / repeats;
+        result->duration = reader.GetDuration();
+        result->is_complete = reader.IsComplete();
+    }
+
+    return true;
+}
+
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Measures the MXF file open latency with serial and concurrent partition and index table reads\n");
+    fprintf(stderr, "and with a cold and warm sidecar open cache\n");
+    fprintf(stderr, "Usage: %s [-r <repeats>] [-t <threads>] [-c <dir>] <filename>\n", cmd);
+    fprintf(stderr, "  -r <repeats>   Number of times the file is opened. Default 5\n");
+    fprintf(stderr, "  -t <threads>   Number of threads used for the concurrent reads. Default 4\n");
+    fprintf(stderr, "  -c <dir>       Also measure opens using an open cache file in <dir>\n");
+    fprintf(stderr, "A test file with many partitions can be created using raw2bmx, e.g. a 24 hour file with 10 second partitions:\n");
+    fprintf(stderr, "  create_test_essence -d 2160000 -t 43 anc.raw\n");
+    fprintf(stderr, "  raw2bmx -t op1a -f 25 --part 250 -o long.mxf --anc-const 24 --anc anc.raw\n");
+}
+
+int main(int argc, const char **argv)
+{
+    const char *filename = 0;
+    uint32_t repeats = 5;
+    uint32_t num_threads = 4;
+    const char *cache_dir = 0;
+    int cmdln_index;
+
+    for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+        if (strcmp(argv[cmdln_index], "-r") == 0 ||
+            strcmp(argv[cmdln_index], "-t") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            uint32_t value;
+            if (sscanf(argv[cmdln_index + 1], "%u", &value) != 1 || value == 0) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Invalid argument '%s' for '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            if (argv[cmdln_index][1] == 'r')
+                repeats = value;
+            else
+                num_threads = value;
+            cmdln_index++;
+        }
+        else if (strcmp(argv[cmdln_index], "-c") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            cache_dir = argv[cmdln_index + 1];
+            cmdln_index++;
+        }
+        else if (cmdln_index + 1 == argc)
+        {
+            filename = argv[cmdln_index];
+        }
+        else
+        {
+            print_usage(argv[0]);
+            fprintf(stderr, "Unknown argument '%s'\n", argv[cmdln_index]);
+            return 1;
+        }
+    }
+    if (!filename) {
+        print_usage(argv[0]);
+        fprintf(stderr, "Missing filename\n");
+        return 1;
+    }
+
+    Result serial_result, threads_result, cold_result, warm_result;
+    try
+    {
+        if (!run(filename, 1, 0, false, repeats, &serial_result) ||
+            !run(filename, num_threads, 0, false, repeats, &threads_result))
+        {
+            return 1;
+        }
+        if (cache_dir &&
+            (!run(filename, 1, cache_dir, true, repeats, &cold_result) ||
+             !run(filename, 1, cache_dir, false, repeats, &warm_result)))
+        {
+            return 1;
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        return 1;
+    }
+
+    printf("%u opens of '%s':\n", repeats, filename);
+    printf("  %-12s min %10.2f ms  avg %10.2f ms\n", "serial", serial_result.min_msec, serial_result.avg_msec);
+    printf("  %u %-10s min %10.2f ms  avg %10.2f ms\n", num_threads, num_threads == 1 ? "thread" : "threads",
+           threads_result.min_msec, threads_result.avg_msec);
+    if (cache_dir) {
+        printf("  %-12s min %10.2f ms  avg %10.2f ms\n", "cold cache", cold_result.min_msec, cold_result.avg_msec);
+        printf("  %-12s min %10.2f ms  avg %10.2f ms\n", "warm cache", warm_result.min_msec, warm_result.avg_msec);
+    }
+
+    if (serial_result.duration != threads_result.duration ||
+        serial_result.is_complete != threads_result.is_complete)
+    {
+        fprintf(stderr, "Serial and concurrent opens differ\n");
+        return 1;
+    }
+    if (cache_dir &&
+        (serial_result.duration != cold_result.duration ||
+         serial_result.is_complete != cold_result.is_complete ||
+         serial_result.duration != warm_result.duration ||
+         serial_result.is_complete != warm_result.is_complete))
+    {
+        fprintf(stderr, "Opens with and without an open cache differ\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include <bmx/essence_parser/SoundConversion.h>
+#include "SoundConversionImpl.h"
+#include <bmx/BMXException.h>
+
+using namespace std;
+using namespace bmx;
+
+
+// a 48kHz frame at 30000/1001Hz, which also exercises the samples left over by the vector kernels
+#define FRAME_SAMPLES   1602
+
+
+typedef struct
+{
+    const unsigned char *input;
+    uint32_t input_size;
+    uint32_t bits_per_sample;
+    uint16_t channel_count;
+    vector<unsigned char*> outputs;
+    uint32_t output_size;
+} Conversion;
+
+typedef void (*ConvertFunc)(Conversion *conv);
+
+
+static void deinterleave_per_channel(Conversion *conv)
+{
+    // the per channel calls that bmxtranswrap made for each frame
+    uint16_t c;
+    for (c = 0; c < conv->channel_count; c++) {
+        deinterleave_audio(conv->input, conv->input_size, conv->bits_per_sample, conv->channel_count, c,
+                           conv->outputs[c], conv->output_size);
+    }
+}
+
+static void deinterleave_scalar(Conversion *conv)
+{
+    deinterleave_audio_channels_scalar(conv->input, conv->input_size, conv->bits_per_sample, conv->channel_count,
+                                       &conv->outputs[0], conv->output_size);
+}
+
+static void deinterleave_default(Conversion *conv)
+{
+    deinterleave_audio_channels(conv->input, conv->input_size, conv->bits_per_sample, conv->channel_count,
+                                &conv->outputs[0], conv->output_size);
+}
+
+static void aes3_per_channel(Conversion *conv)
+{
+    uint16_t c;
+    for (c = 0; c < conv->channel_count; c++) {
+        convert_aes3_to_pcm(conv->input, conv->input_size, false, conv->bits_per_sample, (uint8_t)c,
+                            conv->outputs[c], conv->output_size);
+    }
+}
+
+static void aes3_scalar(Conversion *conv)
+{
+    convert_aes3_to_pcm_channels_scalar(conv->input, conv->input_size, false, conv->bits_per_sample,
+                                        (uint8_t)conv->channel_count, &conv->outputs[0], conv->output_size);
+}
+
+static void aes3_default(Conversion *conv)
+{
+    convert_aes3_to_pcm_channels(conv->input, conv->input_size, false, conv->bits_per_sample,
+                                 (uint8_t)conv->channel_count, &conv->outputs[0], conv->output_size);
+}
+
+static double run(ConvertFunc func, Conversion *conv, unsigned int repeat)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned int i;
+    for (i = 0; i < repeat; i++)
+        func(conv);
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    double secs = chrono::duration<double>(end - start).count();
+    if (secs <= 0.0)
+        return 0.0;
+    return (double)conv->input_size * repeat / secs / (1024.0 * 1024.0);
+}
+
+static bool run_all(const char *name, ConvertFunc per_channel_func, ConvertFunc scalar_func, ConvertFunc default_func,
+                    Conversion *conv, unsigned int repeat)
+{
+    vector<vector<unsigned char> > buffers[3];
+    ConvertFunc funcs[3] = {per_channel_func, scalar_func, default_func};
+    double rates[3];
+    size_t i;
+    uint16_t c;
+
+    for (i = 0; i < 3; i++) {
+        buffers[i].resize(conv->channel_count);
+        for (c = 0; c < conv->channel_count; c++) {
+            buffers[i][c].assign(conv->output_size, 0xaa);
+            conv->outputs[c] = &buffers[i][c][0];
+        }
+        rates[i] = run(funcs[i], conv, repeat);
+    }
+
+    printf("  %-6s %2u x %2u-bit %12.1f %12.1f %12.1f MiB/s\n", name, conv->channel_count, conv->bits_per_sample,
+           rates[0], rates[1], rates[2]);
+
+    if (buffers[1] != buffers[0] || buffers[2] != buffers[0]) {
+        fprintf(stderr, "%s %u x %u-bit: channel data differs\n", name, conv->channel_count, conv->bits_per_sample);
+        return false;
+    }
+
+    return true;
+}
+
+static bool check_interleave(const Conversion *conv)
+{
+    uint32_t bytes_per_sample = (conv->bits_per_sample + 7) / 8;
+    uint32_t sample_count = conv->input_size / (conv->channel_count * bytes_per_sample);
+    vector<vector<unsigned char> > channels(conv->channel_count);
+    vector<const unsigned char*> inputs(conv->channel_count);
+    vector<unsigned char*> outputs(conv->channel_count);
+    uint16_t c;
+
+    for (c = 0; c < conv->channel_count; c++) {
+        channels[c].resize(sample_count * bytes_per_sample);
+        outputs[c] = &channels[c][0];
+        inputs[c]  = &channels[c][0];
+    }
+    deinterleave_audio_channels(conv->input, conv->input_size, conv->bits_per_sample, conv->channel_count,
+                                &outputs[0], sample_count * bytes_per_sample);
+
+    // the last channel is left out to check it is set to silence
+    inputs[conv->channel_count - 1] = 0;
+    vector<unsigned char> expected(conv->input, conv->input + conv->input_size);
+    for (c = 0; c < conv->channel_count - 1; c++) {
+        interleave_audio(inputs[c], sample_count * bytes_per_sample, conv->bits_per_sample, conv->channel_count, c,
+                         &expected[0], conv->input_size);
+    }
+    vector<unsigned char> zeros(sample_count * bytes_per_sample, 0);
+    interleave_audio(&zeros[0], sample_count * bytes_per_sample, conv->bits_per_sample, conv->channel_count,
+                     conv->channel_count - 1, &expected[0], conv->input_size);
+
+    vector<unsigned char> scalar_output(conv->input_size, 0xaa);
+    vector<unsigned char> default_output(conv->input_size, 0xaa);
+    interleave_audio_channels_scalar(&inputs[0], sample_count * bytes_per_sample, conv->bits_per_sample,
+                                     conv->channel_count, &scalar_output[0], conv->input_size);
+    interleave_audio_channels(&inputs[0], sample_count * bytes_per_sample, conv->bits_per_sample,
+                              conv->channel_count, &default_output[0], conv->input_size);
+    if (scalar_output != expected || default_output != expected) {
+        fprintf(stderr, "pcm %u x %u-bit: interleaved data differs\n", conv->channel_count, conv->bits_per_sample);
+        return false;
+    }
+
+    return true;
+}
+
+static bool check_aes3_mc_pcm(const Conversion *conv)
+{
+    uint32_t bytes_per_sample = (conv->bits_per_sample + 7) / 8;
+    uint32_t size = FRAME_SAMPLES * bytes_per_sample;
+    vector<unsigned char> channel(size);
+    vector<unsigned char> expected(size * conv->channel_count);
+    vector<unsigned char> output(size * conv->channel_count);
+    uint16_t c;
+
+    for (c = 0; c < conv->channel_count; c++) {
+        convert_aes3_to_pcm(conv->input, conv->input_size, false, conv->bits_per_sample, (uint8_t)c, &channel[0], size);
+        interleave_audio(&channel[0], size, conv->bits_per_sample, conv->channel_count, c,
+                         &expected[0], (uint32_t)expected.size());
+    }
+    convert_aes3_to_mc_pcm(conv->input, conv->input_size, false, conv->bits_per_sample, (uint8_t)conv->channel_count,
+                           &output[0], (uint32_t)output.size());
+    if (output != expected) {
+        fprintf(stderr, "aes3 %u x %u-bit: multichannel data differs\n", conv->channel_count, conv->bits_per_sample);
+        return false;
+    }
+
+    return true;
+}
+
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Measures the multichannel PCM and D-10 AES3 conversion rates and checks the implementations match\n");
+    fprintf(stderr, "Usage: %s [-r <repeat>]\n", cmd);
+    fprintf(stderr, "  -r <repeat>    Number of conversions of each frame. Default 2000\n");
+}
+
+int main(int argc, const char **argv)
+{
+    static const uint16_t pcm_channel_counts[] = {2, 4, 8, 16, 32};
+    static const uint32_t pcm_bits[] = {16, 24, 32};
+    static const uint16_t aes3_channel_counts[] = {4, 8};
+    static const uint32_t aes3_bits[] = {16, 24};
+    unsigned int repeat = 2000;
+    int cmdln_index;
+    size_t i, j;
+
+    for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+        if (strcmp(argv[cmdln_index], "-r") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &repeat) != 1 || repeat == 0) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Invalid argument '%s' for '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            fprintf(stderr, "Unknown argument '%s'\n", argv[cmdln_index]);
+            return 1;
+        }
+    }
+
+    vector<unsigned char> data(FRAME_SAMPLES * 32 * 4 + 4);
+    srand(1);
+    for (i = 0; i < data.size(); i++)
+        data[i] = (unsigned char)(rand() >> 4);
+
+    bool mismatch = false;
+    try
+    {
+        printf("%u samples per frame, %u frames, implementation '%s':\n", FRAME_SAMPLES, repeat,
+               get_sound_conversion_impl_name());
+        printf("  %-6s %12s %12s %12s %12s\n", "", "", "per channel", "scalar", get_sound_conversion_impl_name());
+
+        for (i = 0; i < sizeof(pcm_bits) / sizeof(pcm_bits[0]); i++) {
+            for (j = 0; j < sizeof(pcm_channel_counts) / sizeof(pcm_channel_counts[0]); j++) {
+                Conversion conv;
+                conv.bits_per_sample = pcm_bits[i];
+                conv.channel_count   = pcm_channel_counts[j];
+                conv.input           = &data[0];
+                conv.input_size      = FRAME_SAMPLES * conv.channel_count * (conv.bits_per_sample / 8);
+                conv.output_size     = FRAME_SAMPLES * (conv.bits_per_sample / 8);
+                conv.outputs.resize(conv.channel_count);
+                if (!run_all("pcm", deinterleave_per_channel, deinterleave_scalar, deinterleave_default,
+                             &conv, repeat) ||
+                    !check_interleave(&conv))
+                {
+                    mismatch = true;
+                }
+            }
+        }
+
+        // set the AES3 header: sample count and channel valid flags, with channel 2 not valid
+        vector<unsigned char> aes3_data(data.begin(), data.begin() + 4 + FRAME_SAMPLES * 8 * 4);
+        aes3_data[0] = 0;
+        aes3_data[1] = (unsigned char)(FRAME_SAMPLES & 0xff);
+        aes3_data[2] = (unsigned char)(FRAME_SAMPLES >> 8);
+        aes3_data[3] = 0xfb;
+        for (i = 0; i < sizeof(aes3_bits) / sizeof(aes3_bits[0]); i++) {
+            for (j = 0; j < sizeof(aes3_channel_counts) / sizeof(aes3_channel_counts[0]); j++) {
+                Conversion conv;
+                conv.bits_per_sample = aes3_bits[i];
+                conv.channel_count   = aes3_channel_counts[j];
+                conv.input           = &aes3_data[0];
+                conv.input_size      = (uint32_t)aes3_data.size();
+                conv.output_size     = FRAME_SAMPLES * (conv.bits_per_sample / 8);
+                conv.outputs.resize(conv.channel_count);
+                if (!run_all("aes3", aes3_per_channel, aes3_scalar, aes3_default, &conv, repeat) ||
+                    !check_aes3_mc_pcm(&conv))
+                {
+                    mismatch = true;
+                }
+            }
+        }
+    }
+    catch (const BMXException &ex)
+    {
+        fprintf(stderr, "BMX exception: %s\n", ex.what());
+        return 1;
+    }
+
+    return mismatch ? 1 : 0;
+}
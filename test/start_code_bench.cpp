@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026, Dolby Laboratories
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice,
+ *       this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the British Broadcasting Corporation nor the names
+ *       of its contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <vector>
+
+#include <bmx/essence_parser/EssenceParser.h>
+#include "EssenceParserUtils.h"
+
+using namespace std;
+using namespace bmx;
+
+
+static void byte_loop_offsets(const unsigned char *data, uint32_t size, vector<uint32_t> *offsets)
+{
+    // the byte at a time state shift that MPEG2EssenceParser::ParseFrameSize used
+    uint32_t state = 0xffffffff;
+    uint32_t i;
+    offsets->clear();
+    for (i = 0; i < size; i++) {
+        state = (state << 8) | data[i];
+        if (i >= 2 && (state & 0x00ffffff) == 0x000001)
+            offsets->push_back(i - 2);
+    }
+}
+
+static void find_offsets(FindStartCodePrefixFunc find_func, const unsigned char *data, uint32_t size,
+                         vector<uint32_t> *offsets)
+{
+    uint32_t offset = 0;
+    uint32_t prefix_offset;
+    offsets->clear();
+    while ((prefix_offset = find_func(&data[offset], size - offset)) != ESSENCE_PARSER_NULL_OFFSET) {
+        offset += prefix_offset;
+        offsets->push_back(offset);
+        offset += 3;
+    }
+}
+
+static uint32_t count_byte_loop(FindStartCodePrefixFunc find_func, const unsigned char *data, uint32_t size)
+{
+    (void)find_func;
+
+    uint32_t state = 0xffffffff;
+    uint32_t count = 0;
+    uint32_t i;
+    for (i = 0; i < size; i++) {
+        state = (state << 8) | data[i];
+        if ((state & 0x00ffffff) == 0x000001)
+            count++;
+    }
+
+    return count;
+}
+
+static uint32_t count_find(FindStartCodePrefixFunc find_func, const unsigned char *data, uint32_t size)
+{
+    uint32_t count = 0;
+    uint32_t offset = 0;
+    uint32_t prefix_offset;
+    while ((prefix_offset = find_func(&data[offset], size - offset)) != ESSENCE_PARSER_NULL_OFFSET) {
+        count++;
+        offset += prefix_offset + 3;
+    }
+
+    return count;
+}
+
+static void run(const char *name, uint32_t (*count_func)(FindStartCodePrefixFunc, const unsigned char*, uint32_t),
+                FindStartCodePrefixFunc find_func, const vector<unsigned char> &data, unsigned int repeat)
+{
+    uint32_t count = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned int i;
+    for (i = 0; i < repeat; i++)
+        count = count_func(find_func, &data[0], (uint32_t)data.size());
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    double secs = chrono::duration<double>(end - start).count();
+    double mbps = 0.0;
+    if (secs > 0.0)
+        mbps = (double)data.size() * repeat / secs / (1024.0 * 1024.0);
+    printf("  %-10s %10u start codes %12.1f MiB/s\n", name, count, mbps);
+}
+
+static bool check_impl(const char *filename, const char *name, FindStartCodePrefixFunc find_func,
+                       const vector<unsigned char> &data)
+{
+    vector<uint32_t> expected;
+    vector<uint32_t> offsets;
+
+    byte_loop_offsets(&data[0], (uint32_t)data.size(), &expected);
+    find_offsets(find_func, &data[0], (uint32_t)data.size(), &offsets);
+    if (offsets != expected) {
+        fprintf(stderr, "%s: %s start code offsets differ\n", filename, name);
+        return false;
+    }
+
+    // shift the start and end of the data to cover all vector alignments and tail lengths
+    uint32_t shift;
+    for (shift = 1; shift <= 40 && 2 * shift < data.size(); shift++) {
+        uint32_t size = (uint32_t)data.size() - 2 * shift;
+        byte_loop_offsets(&data[shift], size, &expected);
+        find_offsets(find_func, &data[shift], size, &offsets);
+        if (offsets != expected) {
+            fprintf(stderr, "%s: %s start code offsets differ with data shifted by %u\n", filename, name, shift);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void create_dense_data(vector<unsigned char> *data)
+{
+    // mostly 0x00 and 0x01 bytes so that start code prefixes and near misses occur at all positions
+    uint32_t state = 1;
+    data->resize(65536);
+    size_t i;
+    for (i = 0; i < data->size(); i++) {
+        state = state * 1103515245 + 12345;
+        uint32_t value = (state >> 16) & 0x7fff;
+        if (value < 0x5000)
+            (*data)[i] = 0x00;
+        else if (value < 0x6800)
+            (*data)[i] = 0x01;
+        else
+            (*data)[i] = (unsigned char)(value & 0xff);
+    }
+}
+
+static bool read_file(const char *filename, vector<unsigned char> *data)
+{
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "%s: failed to open file: %s\n", filename, strerror(errno));
+        return false;
+    }
+
+    unsigned char buffer[65536];
+    size_t num_read;
+    while ((num_read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data->insert(data->end(), buffer, buffer + num_read);
+        if (data->size() > 0x7fffffff) {
+            fprintf(stderr, "%s: file is too large\n", filename);
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+
+    if (data->empty()) {
+        fprintf(stderr, "%s: file is empty\n", filename);
+        return false;
+    }
+
+    return true;
+}
+
+static void print_usage(const char *cmd)
+{
+    fprintf(stderr, "Measures the start code prefix search rate and checks the implementations supported by the CPU\n");
+    fprintf(stderr, "Usage: %s [-r <repeat>] <filename>+\n", cmd);
+    fprintf(stderr, "  -r <repeat>    Number of passes over each file. Default 100\n");
+    fprintf(stderr, "Test streams can be generated using create_test_essence, e.g. type 14 (MPEG-2 Long GOP)\n");
+}
+
+int main(int argc, const char **argv)
+{
+    unsigned int repeat = 100;
+    int cmdln_index;
+
+    for (cmdln_index = 1; cmdln_index < argc; cmdln_index++) {
+        if (strcmp(argv[cmdln_index], "-r") == 0)
+        {
+            if (cmdln_index + 1 >= argc) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Missing argument for '%s'\n", argv[cmdln_index]);
+                return 1;
+            }
+            if (sscanf(argv[cmdln_index + 1], "%u", &repeat) != 1 || repeat == 0) {
+                print_usage(argv[0]);
+                fprintf(stderr, "Invalid argument '%s' for '%s'\n", argv[cmdln_index + 1], argv[cmdln_index]);
+                return 1;
+            }
+            cmdln_index++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (cmdln_index >= argc) {
+        print_usage(argv[0]);
+        return argc == 1 ? 0 : 1;
+    }
+
+    bool mismatch = false;
+    vector<unsigned char> dense_data;
+    create_dense_data(&dense_data);
+    size_t i;
+    for (i = 0; i < get_num_start_code_prefix_impls(); i++) {
+        const char *name;
+        FindStartCodePrefixFunc find_func = get_start_code_prefix_impl(i, &name);
+        if (!check_impl("dense data", name, find_func, dense_data))
+            mismatch = true;
+    }
+
+    for (; cmdln_index < argc; cmdln_index++) {
+        vector<unsigned char> data;
+        if (!read_file(argv[cmdln_index], &data))
+            return 1;
+
+        printf("%s (%u bytes, %u passes):\n", argv[cmdln_index], (uint32_t)data.size(), repeat);
+        run("byte loop", count_byte_loop, 0, data, repeat);
+        for (i = 0; i < get_num_start_code_prefix_impls(); i++) {
+            const char *name;
+            FindStartCodePrefixFunc find_func = get_start_code_prefix_impl(i, &name);
+            run(name, count_find, find_func, data, repeat);
+            if (!check_impl(argv[cmdln_index], name, find_func, data))
+                mismatch = true;
+        }
+        printf("  selected: %s\n", get_start_code_prefix_impl_name());
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+# Check the start code prefix search implementations supported by the CPU against the byte at a
+# time search, using generated MPEG-2 Long GOP and AVC-Intra streams
+
+set(stream_files)
+foreach(type 14 24 7)
+    execute_process(COMMAND ${CREATE_TEST_ESSENCE}
+            -t ${type}
+            -d 3
+            start_code_${type}.raw
+        OUTPUT_QUIET
+        RESULT_VARIABLE ret
+    )
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "Failed to create test essence type ${type}: ${ret}")
+    endif()
+
+    list(APPEND stream_files start_code_${type}.raw)
+endforeach()
+
+execute_process(COMMAND ${START_CODE_BENCH}
+        -r 1
+        ${stream_files}
+    RESULT_VARIABLE ret
+)
+if(NOT ret EQUAL 0)
+    message(FATAL_ERROR "Start code search check failed: ${ret}")
+endif()
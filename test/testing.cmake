@@ -326,7 +326,7 @@ function(setup_test dir_name test_name args)
             -D TEST_MODE=samples
             ${args}
     )
-    add_dependencies(${test_name}_samples create_test_essence file_truncate)
+    add_dependencies(${test_name}_samples create_test_essence file_truncate file_append)
     add_dependencies(bmx_test_${dir_name}_samples ${test_name}_samples)
 
     # Adds target for creating test data (checksums)
@@ -335,7 +335,7 @@ function(setup_test dir_name test_name args)
             -D TEST_MODE=data
             ${args}
     )
-    add_dependencies(${test_name}_data create_test_essence file_truncate)
+    add_dependencies(${test_name}_data create_test_essence file_truncate file_append)
     add_dependencies(bmx_test_${dir_name}_data ${test_name}_data)
 endfunction()
 
@@ -358,6 +358,7 @@ function(setup_test_dir dir_name)
         -D RAW2BMX=$<TARGET_FILE:raw2bmx>
         -D CREATE_TEST_ESSENCE=$<TARGET_FILE:create_test_essence>
         -D FILE_TRUNCATE=$<TARGET_FILE:file_truncate>
+        -D FILE_APPEND=$<TARGET_FILE:file_append>
         -D TEST_SOURCE_DIR=${CMAKE_CURRENT_SOURCE_DIR}
         -D BMX_TEST_SAMPLES_DIR=${BMX_TEST_SAMPLES_DIR}/${dir_name}
         PARENT_SCOPE